@@ -21,7 +21,10 @@ using namespace Genode;
 void Ram_session_component::_export_ram_ds(Dataspace_component *ds) { }
 void Ram_session_component::_revoke_ram_ds(Dataspace_component *ds) { }
 
-void Ram_session_component::_clear_ds(Dataspace_component *ds)
+bool Ram_session_component::_clear_ds_before_export() { return true; }
+
+bool Ram_session_component::_clear_ds(Dataspace_component *ds)
 {
 	memset((void *)ds->phys_addr(), 0, ds->size());
+	return true;
 }
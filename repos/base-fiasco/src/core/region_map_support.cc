@@ -47,3 +47,10 @@ void Rm_client::unmap(addr_t core_local_base, addr_t virt_base, size_t size)
 		l4_fpage_unmap(l4_fpage(addr, L4_LOG2_PAGESIZE, 0, 0),
 		               L4_FP_FLUSH_PAGE);
 }
+
+
+bool Rm_client::install_mapping(Mapping &)
+{
+	/* mappings are established as reply to page faults only */
+	return false;
+}
@@ -22,3 +22,10 @@ void Rm_client::unmap(addr_t core_local_base, addr_t virt_base, size_t size)
 	// TODO unmap it only from target space
 	unmap_local(core_local_base, size >> get_page_size_log2());
 }
+
+
+bool Rm_client::install_mapping(Mapping &)
+{
+	/* mappings are established as reply to page faults only */
+	return false;
+}
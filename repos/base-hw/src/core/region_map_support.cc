@@ -38,6 +38,28 @@ void Rm_client::unmap(addr_t, addr_t virt_base, size_t size)
 }
 
 
+/*
+ * As for page faults, 'constrain_map_size_log2' limits the mappings to
+ * 4 KiB and 1 MiB. With the short-descriptor page tables of ARMv6/v7,
+ * 1 MiB mappings become sections. The page tables of x86_64, RISC-V, and
+ * Cortex-A15 (LPAE) have no 1 MiB pages, so the mappings are split into
+ * 4 KiB pages. Populating then saves the page faults but not the
+ * page-table entries.
+ */
+bool Rm_client::install_mapping(Mapping &mapping)
+{
+	Locked_ptr<Address_space> locked_address_space(_address_space);
+
+	if (!locked_address_space.valid())
+		return false;
+
+	/* core manages the page tables, so we can insert the translation directly */
+	Hw::Address_space * as = static_cast<Hw::Address_space*>(&*locked_address_space);
+	return as->insert_translation(mapping.virt(), mapping.phys(),
+	                              mapping.size(), mapping.flags());
+}
+
+
 /**********************
  ** Pager_entrypoint **
  **********************/
@@ -64,4 +64,11 @@ void Ram_session_component::_revoke_ram_ds(Dataspace_component *ds)
 }
 
 
-void Ram_session_component::_clear_ds(Dataspace_component *ds) { }
+bool Ram_session_component::_clear_ds(Dataspace_component *ds) { return true; }
+
+
+/*
+ * RAM dataspaces are backed by files created on export, which are cleared
+ * by the kernel. Hence, there is nothing to clear ahead of time.
+ */
+bool Ram_session_component::_clear_ds_before_export() { return false; }
@@ -0,0 +1,32 @@
+/*
+ * \brief  Shared-memory IPC channels
+ * \author Genode Labs
+ * \date   2017-04-11
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__BASE__INTERNAL__IPC_CHANNELS_H_
+#define _INCLUDE__BASE__INTERNAL__IPC_CHANNELS_H_
+
+/* base-internal includes */
+#include <base/internal/native_thread.h>
+
+namespace Genode {
+
+	/**
+	 * Release the IPC channels of a thread
+	 *
+	 * This function must be called after the thread stopped executing.
+	 * The servers are notified such that they can free their ends of the
+	 * channels.
+	 */
+	void release_ipc_channels(Native_thread &);
+}
+
+#endif /* _INCLUDE__BASE__INTERNAL__IPC_CHANNELS_H_ */
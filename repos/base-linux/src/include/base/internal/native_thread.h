@@ -48,6 +48,15 @@ struct Genode::Native_thread
 
 	Socket_pair socket_pair;
 
+	struct Ipc_channels;
+
+	/**
+	 * Shared-memory IPC channels used by the thread as client or server
+	 *
+	 * The channels are created on demand by the IPC library.
+	 */
+	Ipc_channels *ipc_channels = nullptr;
+
 	Native_thread() { }
 };
 
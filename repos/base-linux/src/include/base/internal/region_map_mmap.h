@@ -116,7 +116,8 @@ class Genode::Region_map_mmap : public Region_map, public Dataspace
 		 **************************/
 
 		Local_addr attach(Dataspace_capability ds, size_t size,
-		                  off_t, bool, Local_addr, bool executable);
+		                  off_t, bool, Local_addr, bool executable,
+		                  bool writeable);
 
 		void detach(Local_addr local_addr);
 
@@ -18,12 +18,23 @@
 
 namespace Genode {
 
+	struct Ipc_channel;
+
 	struct Rpc_destination
 	{
 		int socket = -1;
 
+		/*
+		 * Shared-memory channel of the caller, valid for reply capabilities
+		 * of requests received via the channel
+		 */
+		Ipc_channel *channel = nullptr;
+
 		explicit Rpc_destination(int socket) : socket(socket) { }
 
+		Rpc_destination(int socket, Ipc_channel &channel)
+		: socket(socket), channel(&channel) { }
+
 		Rpc_destination() { }
 	};
 
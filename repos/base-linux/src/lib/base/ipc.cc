@@ -17,6 +17,9 @@
 #include <base/thread.h>
 #include <base/blocking.h>
 #include <base/env.h>
+#include <cpu/atomic.h>
+#include <cpu/memory_barrier.h>
+#include <util/construct_at.h>
 #include <linux_native_cpu/linux_native_cpu.h>
 
 /* base-internal includes */
@@ -25,6 +28,7 @@
 #include <base/internal/ipc_server.h>
 #include <base/internal/server_socket_pair.h>
 #include <base/internal/capability_space_tpl.h>
+#include <base/internal/ipc_channels.h>
 
 /* Linux includes */
 #include <linux_syscalls.h>
@@ -317,12 +321,11 @@ static void extract_sds_from_message(unsigned start_index,
 
 
 /**
- * Send reply to client
+ * Send reply to client via socket
  */
-static inline void lx_reply(int reply_socket, Rpc_exception_code exception_code,
-                            Genode::Msgbuf_base &snd_msgbuf)
+static inline int send_reply(int reply_socket, Rpc_exception_code exception_code,
+                             Genode::Msgbuf_base &snd_msgbuf)
 {
-
 	Protocol_header &header = snd_msgbuf.header<Protocol_header>();
 
 	header.protocol_word = exception_code.value;
@@ -332,7 +335,18 @@ static inline void lx_reply(int reply_socket, Rpc_exception_code exception_code,
 	/* marshall capabilities to be transferred to the client */
 	insert_sds_into_message(msg, header, snd_msgbuf);
 
-	int const ret = lx_sendmsg(reply_socket, msg.msg(), 0);
+	/* a vanished client must not raise SIGPIPE at the socket of a channel */
+	return lx_sendmsg(reply_socket, msg.msg(), MSG_NOSIGNAL);
+}
+
+
+/**
+ * Send reply to client and close the reply socket
+ */
+static inline void lx_reply(int reply_socket, Rpc_exception_code exception_code,
+                            Genode::Msgbuf_base &snd_msgbuf)
+{
+	int const ret = send_reply(reply_socket, exception_code, snd_msgbuf);
 
 	/* ignore reply send error caused by disappearing client */
 	if (ret >= 0 || ret == -LX_ECONNREFUSED) {
@@ -345,6 +359,704 @@ static inline void lx_reply(int reply_socket, Rpc_exception_code exception_code,
 }
 
 
+/*********************************
+ ** Shared-memory IPC channels **
+ *********************************/
+
+/*
+ * An RPC that transfers no capabilities can be passed via a channel, which
+ * is a memory area shared by the calling thread and the entrypoint. In
+ * contrast to the socket-based path, such a call needs neither a new reply
+ * socket pair nor the transfer of socket descriptors.
+ *
+ * With its first eligible call, a client thread attaches a channel to the
+ * entrypoint by sending the file descriptor of the channel memory along with
+ * the remote end of a reply socket pair. The entrypoint responds with the
+ * descriptor of its doorbell, which tells whether the entrypoint blocks at
+ * its socket. The reply socket pair is connection-oriented, which lets the
+ * entrypoint detect a client that vanished without detaching its channel.
+ *
+ * To call, the client writes the request into the channel and waits for the
+ * reply using a futex on the channel state. Because the entrypoint receives
+ * regular requests via its socket, it cannot block on a futex. Instead, it
+ * checks its channels before blocking at the socket. If it announced to
+ * block, the client sends a wakeup message without payload and socket
+ * descriptors. Replies that carry capabilities or do not fit into the
+ * channel are sent via the reply socket.
+ */
+
+namespace {
+
+	enum {
+		ATTACH_BADGE = ~2UL,  /* attach channel to entrypoint */
+		WAKEUP_BADGE = ~3UL,  /* wake up entrypoint blocking at its socket */
+	};
+
+	/**
+	 * Memory shared by a client thread and an entrypoint
+	 */
+	struct Channel_area
+	{
+		enum { SIZE = 8*1024, CAPACITY = SIZE - 4*sizeof(long) };
+
+		enum State { IDLE, REQUEST, SERVING, REPLY, REPLY_SOCKET, CLOSED };
+
+		int volatile state;
+
+		/* badge of invoked object (on call) / exception code (on reply) */
+		unsigned long protocol_word;
+
+		Genode::size_t data_size;
+
+		long data[CAPACITY/sizeof(long)];
+
+		bool transition(State from, State to) {
+			return Genode::cmpxchg(&state, from, to); }
+
+		void wake() { lx_futex((int *)&state, LX_FUTEX_WAKE, 1); }
+	};
+
+	/**
+	 * Memory shared by an entrypoint and all its clients
+	 */
+	struct Doorbell
+	{
+		enum { SIZE = 4096 };
+
+		int volatile waiting;  /* entrypoint blocks at its socket */
+		int volatile closed;   /* entrypoint is gone */
+	};
+
+	struct Client_channel
+	{
+		int           dst_socket = -1;       /* socket of the entrypoint */
+		Channel_area *area       = nullptr;  /* nullptr if attaching failed */
+		Doorbell     *doorbell   = nullptr;
+		int           reply_sd   = -1;       /* local end of reply socket pair */
+
+		/* canceled call that is still processed by the entrypoint */
+		bool pending = false;
+	};
+}
+
+
+struct Genode::Ipc_channel
+{
+	Channel_area *area     = nullptr;
+	int           reply_sd = -1;     /* remote end of the reply socket pair */
+	bool          serving  = false;  /* request is processed */
+};
+
+
+struct Genode::Native_thread::Ipc_channels
+{
+	enum { MAX_CLIENT = 32, MAX_SERVER = 64 };
+
+	/* channels used by the thread as client */
+	Client_channel client[MAX_CLIENT];
+
+	/* channels used by the thread as entrypoint */
+	Ipc_channel server[MAX_SERVER];
+	unsigned    next_server = 0;
+	Doorbell   *doorbell    = nullptr;
+	int         doorbell_fd = -1;
+};
+
+
+static bool mmap_failed(void *addr)
+{
+	return ((long)addr < 0) && ((long)addr > -4095);
+}
+
+
+/*
+ * Seals of shared memory, which prevent the peer from resizing the memory
+ * underneath our mapping, which would raise SIGBUS on access
+ */
+enum { SHARED_SEALS = LX_F_SEAL_SHRINK | LX_F_SEAL_GROW };
+
+
+/**
+ * Map shared memory and close its file descriptor
+ *
+ * The memory is provided by the peer. It is mapped only if it is sealed
+ * against resizing and large enough.
+ */
+static void *map_shared(int fd, Genode::size_t size)
+{
+	int const seals = lx_fcntl(fd, LX_F_GET_SEALS, 0);
+
+	bool const sealed = seals >= 0 && (seals & SHARED_SEALS) == SHARED_SEALS
+	                 && lx_lseek(fd, 0, SEEK_END) >= (long)size;
+
+	void * const addr = sealed
+	                  ? lx_mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+	                  : nullptr;
+	lx_close(fd);
+	return (!addr || mmap_failed(addr)) ? nullptr : addr;
+}
+
+
+/**
+ * Create shared memory sealed against resizing
+ *
+ * \return  file descriptor, or a negative error code
+ */
+static int create_shared(Genode::size_t size)
+{
+	int const fd = lx_memfd_create("ipc_channel", LX_MFD_CLOEXEC | LX_MFD_ALLOW_SEALING);
+	if (fd < 0)
+		return fd;
+
+	if (lx_ftruncate(fd, size) < 0 || lx_fcntl(fd, LX_F_ADD_SEALS, SHARED_SEALS) < 0) {
+		lx_close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+
+static Native_thread::Ipc_channels *ipc_channels(Native_thread &native_thread)
+{
+	if (native_thread.ipc_channels)
+		return native_thread.ipc_channels;
+
+	void * const mem = lx_mmap(0, sizeof(Native_thread::Ipc_channels),
+	                           PROT_READ | PROT_WRITE,
+	                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mmap_failed(mem))
+		return nullptr;
+
+	native_thread.ipc_channels = construct_at<Native_thread::Ipc_channels>(mem);
+	return native_thread.ipc_channels;
+}
+
+
+/**
+ * Atomically replace value, which implies a memory barrier
+ */
+static int exchange(int volatile &dst, int value)
+{
+	for (;;) {
+		int const old = dst;
+		if (Genode::cmpxchg(&dst, old, value))
+			return old;
+	}
+}
+
+
+static int send_badge(int socket, unsigned long badge)
+{
+	Protocol_header header;
+	header.protocol_word = badge;
+	header.num_caps      = 0;
+
+	Message msg(header.msg_start(), sizeof(Protocol_header));
+	return lx_sendmsg(socket, msg.msg(), 0);
+}
+
+
+/**
+ * Wake up entrypoint if it announced to block at its socket
+ */
+static int wake_entrypoint(Client_channel &channel)
+{
+	if (!exchange(channel.doorbell->waiting, 0))
+		return 0;
+
+	return send_badge(channel.dst_socket, WAKEUP_BADGE);
+}
+
+
+/**
+ * Attach channel to the entrypoint
+ *
+ * \return  0 on success, or a negative error code
+ */
+static int attach_channel(Client_channel &channel)
+{
+	int const area_fd = create_shared(Channel_area::SIZE);
+	if (area_fd < 0)
+		return area_fd;
+
+	int sd[2];
+	if (lx_socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sd) < 0) {
+		lx_close(area_fd);
+		return -1;
+	}
+
+	Protocol_header header;
+	header.protocol_word = ATTACH_BADGE;
+	header.num_caps      = 0;
+
+	/* hand out the channel memory and the reply socket to the entrypoint */
+	Message snd_msg(header.msg_start(), sizeof(Protocol_header));
+	snd_msg.marshal_socket(sd[1]);
+	snd_msg.marshal_socket(area_fd);
+
+	int ret = lx_sendmsg(channel.dst_socket, snd_msg.msg(), 0);
+	lx_close(sd[1]);
+
+	Channel_area * const area = (Channel_area *)map_shared(area_fd, Channel_area::SIZE);
+
+	/* receive doorbell of the entrypoint */
+	Message rcv_msg(header.msg_start(), sizeof(Protocol_header));
+	rcv_msg.accept_sockets(1);
+	header.protocol_word = ~0UL;
+
+	if (ret >= 0)
+		do { ret = lx_recvmsg(sd[0], rcv_msg.msg(), 0); } while (ret == -LX_EINTR);
+
+	bool const accepted = ret >= 0 && header.protocol_word == 0
+	                   && rcv_msg.num_sockets() == 1;
+
+	Doorbell * const doorbell = accepted
+	                          ? (Doorbell *)map_shared(rcv_msg.socket_at_index(0),
+	                                                   Doorbell::SIZE)
+	                          : nullptr;
+	if (!area || !doorbell) {
+		if (area)     lx_munmap(area,     Channel_area::SIZE);
+		if (doorbell) lx_munmap(doorbell, Doorbell::SIZE);
+		lx_close(sd[0]);
+		return -1;
+	}
+
+	channel.area     = area;
+	channel.doorbell = doorbell;
+	channel.reply_sd = sd[0];
+	return 0;
+}
+
+
+static void detach_channel(Client_channel &channel)
+{
+	if (channel.area) {
+		exchange(channel.area->state, Channel_area::CLOSED);
+
+		/* let the entrypoint free its end of the channel */
+		if (!channel.doorbell->closed)
+			wake_entrypoint(channel);
+
+		lx_munmap(channel.area,     Channel_area::SIZE);
+		lx_munmap(channel.doorbell, Doorbell::SIZE);
+		lx_close(channel.reply_sd);
+	}
+	channel = Client_channel();
+}
+
+
+static Rpc_exception_code receive_channel_reply(Client_channel &, Msgbuf_base &);
+
+
+/**
+ * Return channel to entrypoint, or nullptr if the socket must be used
+ */
+static Client_channel *client_channel(int dst_socket)
+{
+	/* cleared if the kernel does not support 'memfd_create' */
+	static bool supported = true;
+
+	Thread * const myself = Thread::myself();
+	if (!supported || !myself)
+		return nullptr;
+
+	Native_thread::Ipc_channels * const channels = ipc_channels(myself->native_thread());
+	if (!channels)
+		return nullptr;
+
+	Client_channel *unused = nullptr;
+	for (Client_channel &channel : channels->client) {
+
+		if (channel.dst_socket == -1) {
+			if (!unused) unused = &channel;
+			continue;
+		}
+
+		if (channel.dst_socket != dst_socket)
+			continue;
+
+		if (!channel.area)
+			return nullptr;
+
+		/* the socket may get reused for another entrypoint */
+		if (channel.doorbell->closed) {
+			detach_channel(channel);
+			unused = &channel;
+			break;
+		}
+
+		if (channel.pending) {
+			int const state = channel.area->state;
+			if (state != Channel_area::REPLY && state != Channel_area::REPLY_SOCKET)
+				return nullptr;
+
+			/* drop reply of canceled call */
+			Msgbuf<64> discarded;
+			receive_channel_reply(channel, discarded);
+			channel.pending = false;
+		}
+		return &channel;
+	}
+
+	if (!unused)
+		return nullptr;
+
+	/* the entry is kept if attaching fails to not try again */
+	unused->dst_socket = dst_socket;
+
+	int const err = attach_channel(*unused);
+	if (!err)
+		return unused;
+
+	if (err == -38 /* ENOSYS */)
+		supported = false;
+
+	return nullptr;
+}
+
+
+static Rpc_exception_code receive_channel_reply(Client_channel &channel,
+                                                Msgbuf_base &rcv_msgbuf)
+{
+	Channel_area &area = *channel.area;
+
+	Protocol_header &rcv_header = rcv_msgbuf.header<Protocol_header>();
+	rcv_msgbuf.reset();
+
+	if (area.state == Channel_area::REPLY) {
+
+		/* do not read the reply before observing its publication */
+		Genode::memory_barrier();
+
+		rcv_header.protocol_word = area.protocol_word;
+		rcv_header.num_caps      = 0;
+		Genode::memcpy(rcv_msgbuf.data(), area.data,
+		       min(area.data_size, rcv_msgbuf.capacity()));
+
+		area.transition(Channel_area::REPLY, Channel_area::IDLE);
+		return Rpc_exception_code(rcv_header.protocol_word);
+	}
+
+	/* the reply was sent via the reply socket */
+	rcv_header.protocol_word = 0;
+
+	Message rcv_msg(rcv_header.msg_start(),
+	                sizeof(Protocol_header) + rcv_msgbuf.capacity());
+	rcv_msg.accept_sockets(Message::MAX_SDS_PER_MSG);
+
+	int ret;
+	do { ret = lx_recvmsg(channel.reply_sd, rcv_msg.msg(), 0); } while (ret == -LX_EINTR);
+
+	area.transition(Channel_area::REPLY_SOCKET, Channel_area::IDLE);
+
+	/* 0 if the entrypoint closed the socket without replying */
+	if (ret <= 0) {
+		PRAW("[%d] lx_recvmsg failed with %d in ipc_call()", lx_getpid(), ret);
+		throw Genode::Ipc_error();
+	}
+
+	extract_sds_from_message(0, rcv_msg, rcv_header, rcv_msgbuf);
+
+	return Rpc_exception_code(rcv_header.protocol_word);
+}
+
+
+static Rpc_exception_code channel_call(Client_channel &channel, unsigned long badge,
+                                       Msgbuf_base &snd_msgbuf, Msgbuf_base &rcv_msgbuf)
+{
+	Channel_area &area = *channel.area;
+
+	area.protocol_word = badge;
+	area.data_size     = snd_msgbuf.data_size();
+	Genode::memcpy(area.data, snd_msgbuf.data(), snd_msgbuf.data_size());
+
+	/* publish the request only after it is complete */
+	Genode::memory_barrier();
+	area.transition(Channel_area::IDLE, Channel_area::REQUEST);
+
+	int const send_ret = wake_entrypoint(channel);
+	if (send_ret < 0) {
+		raw(Pid(), " lx_sendmsg to sd ", channel.dst_socket,
+		    " failed with ", send_ret, " in ipc_call()");
+		if (area.transition(Channel_area::REQUEST, Channel_area::IDLE))
+			throw Genode::Ipc_error();
+	}
+
+	for (;;) {
+		int const state = area.state;
+		if (state == Channel_area::REPLY || state == Channel_area::REPLY_SOCKET)
+			break;
+
+		/* system call got interrupted by a signal */
+		if (lx_futex((int *)&area.state, LX_FUTEX_WAIT, state) == -LX_EINTR) {
+
+			/* withdraw the request if the entrypoint has not picked it up */
+			if (!area.transition(Channel_area::REQUEST, Channel_area::IDLE))
+				channel.pending = true;
+
+			throw Genode::Blocking_canceled();
+		}
+	}
+
+	return receive_channel_reply(channel, rcv_msgbuf);
+}
+
+
+static void free_server_channel(Ipc_channel &channel)
+{
+	lx_munmap(channel.area, Channel_area::SIZE);
+	lx_close(channel.reply_sd);
+	channel = Ipc_channel();
+}
+
+
+/**
+ * Return true if the client of the channel vanished without detaching
+ *
+ * The client never sends via the reply socket pair. Once its end is closed,
+ * e.g., because the client process got killed, a non-blocking receive at
+ * the remote end returns 0 instead of failing with EAGAIN.
+ */
+static bool client_vanished(Ipc_channel const &channel)
+{
+	char byte;
+	iovec iov;
+	iov.iov_base = &byte;
+	iov.iov_len  = sizeof(byte);
+
+	msghdr msg;
+	Genode::memset(&msg, 0, sizeof(msg));
+	msg.msg_iov    = &iov;
+	msg.msg_iovlen = 1;
+
+	return lx_recvmsg(channel.reply_sd, &msg, MSG_DONTWAIT) == 0;
+}
+
+
+/**
+ * Return unused server channel, or nullptr if all channels are in use
+ *
+ * If no channel is unused, the channels of vanished clients are freed.
+ */
+static Ipc_channel *unused_server_channel(Native_thread::Ipc_channels &channels)
+{
+	for (Ipc_channel &c : channels.server)
+		if (!c.area) return &c;
+
+	Ipc_channel *unused = nullptr;
+	for (Ipc_channel &c : channels.server) {
+		if (c.serving || !client_vanished(c))
+			continue;
+
+		free_server_channel(c);
+		if (!unused) unused = &c;
+	}
+	return unused;
+}
+
+
+/**
+ * Handle attach request of a client
+ */
+static void attach_server_channel(Native_thread &native_thread, Message const &msg)
+{
+	unsigned const num_sds = msg.num_sockets();
+	if (num_sds != 2) {
+		for (unsigned i = 0; i < num_sds; i++)
+			lx_close(msg.socket_at_index(i));
+		return;
+	}
+
+	int const reply_sd = msg.socket_at_index(0);
+	int const area_fd  = msg.socket_at_index(1);
+
+	Protocol_header header;
+	header.protocol_word = ~0UL;
+	header.num_caps      = 0;
+
+	Message reply(header.msg_start(), sizeof(Protocol_header));
+
+	Native_thread::Ipc_channels * const channels = ipc_channels(native_thread);
+
+	/* create doorbell with the first channel */
+	if (channels && !channels->doorbell) {
+		int const fd = create_shared(Doorbell::SIZE);
+		void * const doorbell = fd < 0 ? nullptr
+		                      : lx_mmap(0, Doorbell::SIZE, PROT_READ | PROT_WRITE,
+		                                MAP_SHARED, fd, 0);
+		if (doorbell && !mmap_failed(doorbell)) {
+			channels->doorbell    = (Doorbell *)doorbell;
+			channels->doorbell_fd = fd;
+		} else if (fd >= 0) {
+			lx_close(fd);
+		}
+	}
+
+	Ipc_channel * const channel = channels && channels->doorbell
+	                            ? unused_server_channel(*channels) : nullptr;
+
+	Channel_area * const area = channel
+	                          ? (Channel_area *)map_shared(area_fd, Channel_area::SIZE)
+	                          : nullptr;
+	if (!channel)
+		lx_close(area_fd);
+
+	if (area) {
+		channel->area     = area;
+		channel->reply_sd = reply_sd;
+
+		header.protocol_word = 0;
+		reply.marshal_socket(channels->doorbell_fd);
+	}
+
+	lx_sendmsg(reply_sd, reply.msg(), MSG_NOSIGNAL);
+
+	if (!area)
+		lx_close(reply_sd);
+}
+
+
+/**
+ * Return channel with pending request, or nullptr
+ */
+static Ipc_channel *next_channel_request(Native_thread::Ipc_channels &channels)
+{
+	enum { NUM = Native_thread::Ipc_channels::MAX_SERVER };
+
+	for (unsigned i = 0; i < NUM; i++) {
+
+		unsigned const index   = (channels.next_server + i) % NUM;
+		Ipc_channel   &channel = channels.server[index];
+
+		if (!channel.area)
+			continue;
+
+		Channel_area &area = *channel.area;
+
+		if (area.state == Channel_area::CLOSED && !channel.serving) {
+			free_server_channel(channel);
+			continue;
+		}
+
+		if (area.state == Channel_area::REQUEST
+		 && area.transition(Channel_area::REQUEST, Channel_area::SERVING)) {
+
+			/* do not read the request before observing its publication */
+			Genode::memory_barrier();
+
+			channels.next_server = index + 1;
+			channel.serving      = true;
+			return &channel;
+		}
+	}
+	return nullptr;
+}
+
+
+static Rpc_request channel_request(Ipc_channel &channel, Msgbuf_base &request_msg)
+{
+	Channel_area &area = *channel.area;
+
+	Protocol_header &header = request_msg.header<Protocol_header>();
+	request_msg.reset();
+
+	header.protocol_word = area.protocol_word;
+	header.num_caps      = 0;
+
+	size_t const data_size = min(area.data_size, (size_t)Channel_area::CAPACITY);
+	Genode::memcpy(request_msg.data(), area.data, min(data_size, request_msg.capacity()));
+
+	return Rpc_request(Capability_space::import(Rpc_destination(channel.reply_sd, channel),
+	                                            Rpc_obj_key()), header.protocol_word);
+}
+
+
+static void channel_reply(Ipc_channel &channel, Rpc_exception_code exc,
+                          Msgbuf_base &snd_msgbuf)
+{
+	Channel_area &area = *channel.area;
+
+	channel.serving = false;
+
+	bool sent;
+	if (snd_msgbuf.used_caps() == 0
+	 && snd_msgbuf.data_size() <= Channel_area::CAPACITY) {
+
+		area.protocol_word = exc.value;
+		area.data_size     = snd_msgbuf.data_size();
+		Genode::memcpy(area.data, snd_msgbuf.data(), snd_msgbuf.data_size());
+
+		/* publish the reply only after it is complete */
+		Genode::memory_barrier();
+		sent = area.transition(Channel_area::SERVING, Channel_area::REPLY);
+
+	} else {
+
+		send_reply(channel.reply_sd, exc, snd_msgbuf);
+		sent = area.transition(Channel_area::SERVING, Channel_area::REPLY_SOCKET);
+	}
+
+	/* client thread vanished meanwhile */
+	if (!sent) {
+		free_server_channel(channel);
+		return;
+	}
+
+	area.wake();
+}
+
+
+static void release_server_channels(Native_thread::Ipc_channels &channels)
+{
+	if (!channels.doorbell)
+		return;
+
+	/* make clients detach their channels */
+	channels.doorbell->closed = 1;
+
+	for (Ipc_channel &channel : channels.server)
+		if (channel.area)
+			free_server_channel(channel);
+
+	lx_munmap(channels.doorbell, Doorbell::SIZE);
+	lx_close(channels.doorbell_fd);
+
+	channels.doorbell    = nullptr;
+	channels.doorbell_fd = -1;
+}
+
+
+void Genode::release_ipc_channels(Native_thread &native_thread)
+{
+	Native_thread::Ipc_channels * const channels = native_thread.ipc_channels;
+	if (!channels)
+		return;
+
+	for (Client_channel &channel : channels->client)
+		detach_channel(channel);
+
+	release_server_channels(*channels);
+
+	lx_munmap(channels, sizeof(*channels));
+	native_thread.ipc_channels = nullptr;
+}
+
+
+/**
+ * Send reply to caller via channel or socket
+ */
+static void reply(Native_capability caller, Rpc_exception_code exc,
+                  Msgbuf_base &snd_msgbuf)
+{
+	Rpc_destination const dst = Capability_space::ipc_cap_data(caller).dst;
+
+	if (dst.channel)
+		channel_reply(*dst.channel, exc, snd_msgbuf);
+	else
+		lx_reply(dst.socket, exc, snd_msgbuf);
+}
+
+
 /****************
  ** IPC client **
  ****************/
@@ -353,6 +1065,14 @@ Rpc_exception_code Genode::ipc_call(Native_capability dst,
                                     Msgbuf_base &snd_msgbuf, Msgbuf_base &rcv_msgbuf,
                                     size_t)
 {
+	int const dst_socket = Capability_space::ipc_cap_data(dst).dst.socket;
+
+	/* use shared-memory channel for calls without capability arguments */
+	if (snd_msgbuf.used_caps() == 0
+	 && snd_msgbuf.data_size() <= Channel_area::CAPACITY)
+		if (Client_channel *channel = client_channel(dst_socket))
+			return channel_call(*channel, dst.local_name(), snd_msgbuf, rcv_msgbuf);
+
 	Protocol_header &snd_header = snd_msgbuf.header<Protocol_header>();
 	snd_header.protocol_word = dst.local_name();
 
@@ -399,8 +1119,6 @@ Rpc_exception_code Genode::ipc_call(Native_capability dst,
 	/* marshal capabilities contained in 'snd_msgbuf' */
 	insert_sds_into_message(snd_msg, snd_header, snd_msgbuf);
 
-	int const dst_socket = Capability_space::ipc_cap_data(dst).dst.socket;
-
 	int const send_ret = lx_sendmsg(dst_socket, snd_msg.msg(), 0);
 	if (send_ret < 0) {
 		raw(Pid(), " lx_sendmsg to sd ", dst_socket,
@@ -442,9 +1160,7 @@ Rpc_exception_code Genode::ipc_call(Native_capability dst,
 void Genode::ipc_reply(Native_capability caller, Rpc_exception_code exc,
                        Msgbuf_base &snd_msg)
 {
-	int const reply_socket = Capability_space::ipc_cap_data(caller).dst.socket;
-
-	try { lx_reply(reply_socket, exc, snd_msg); } catch (Ipc_error) { }
+	try { reply(caller, exc, snd_msg); } catch (Ipc_error) { }
 }
 
 
@@ -455,7 +1171,7 @@ Genode::Rpc_request Genode::ipc_reply_wait(Reply_capability const &last_caller,
 {
 	/* when first called, there was no request yet */
 	if (last_caller.valid() && exc.value != Rpc_exception_code::INVALID_OBJECT)
-		lx_reply(Capability_space::ipc_cap_data(last_caller).dst.socket, exc, reply_msg);
+		reply(last_caller, exc, reply_msg);
 
 	/*
 	 * Block infinitely if called from the main thread. This may happen if the
@@ -466,18 +1182,39 @@ Genode::Rpc_request Genode::ipc_reply_wait(Reply_capability const &last_caller,
 		for (;;) lx_nanosleep(&ts, 0);
 	}
 
+	Native_thread &native_thread = Thread::myself()->native_thread();
+
 	for (;;) {
 
+		Native_thread::Ipc_channels * const channels = native_thread.ipc_channels;
+
+		if (channels && channels->doorbell) {
+
+			Ipc_channel *channel = next_channel_request(*channels);
+
+			/* announce to block at the socket, re-check to not miss a request */
+			if (!channel && !channels->doorbell->waiting) {
+				exchange(channels->doorbell->waiting, 1);
+				channel = next_channel_request(*channels);
+			}
+
+			if (channel) {
+				channels->doorbell->waiting = 0;
+				return channel_request(*channel, request_msg);
+			}
+		}
+
 		Protocol_header &header = request_msg.header<Protocol_header>();
 		Message msg(header.msg_start(), sizeof(Protocol_header) + request_msg.capacity());
 
 		msg.accept_sockets(Message::MAX_SDS_PER_MSG);
 
-		Native_thread &native_thread = Thread::myself()->native_thread();
-
 		request_msg.reset();
 		int const ret = lx_recvmsg(native_thread.socket_pair.server_sd, msg.msg(), 0);
 
+		if (channels && channels->doorbell)
+			channels->doorbell->waiting = 0;
+
 		/* system call got interrupted by a signal */
 		if (ret == -LX_EINTR)
 			continue;
@@ -488,8 +1225,17 @@ Genode::Rpc_request Genode::ipc_reply_wait(Reply_capability const &last_caller,
 			continue;
 		}
 
-		int           const reply_socket = msg.socket_at_index(0);
-		unsigned long const badge        = header.protocol_word;
+		unsigned long const badge = header.protocol_word;
+
+		if (badge == WAKEUP_BADGE)
+			continue;
+
+		if (badge == ATTACH_BADGE) {
+			attach_server_channel(native_thread, msg);
+			continue;
+		}
+
+		int const reply_socket = msg.socket_at_index(0);
 
 		/* start at offset 1 to skip the reply channel */
 		extract_sds_from_message(1, msg, header, request_msg);
@@ -547,6 +1293,9 @@ Ipc_server::~Ipc_server()
 	Genode::ep_sd_registry()->disassociate(native_thread.socket_pair.client_sd);
 	native_thread.is_ipc_server = false;
 
+	if (native_thread.ipc_channels)
+		release_server_channels(*native_thread.ipc_channels);
+
 	destroy_server_socket_pair(native_thread.socket_pair);
 	native_thread.socket_pair = Socket_pair();
 }
@@ -172,7 +172,7 @@ Region_map::Local_addr Region_map_mmap::attach(Dataspace_capability ds,
                                                size_t size, off_t offset,
                                                bool use_local_addr,
                                                Region_map::Local_addr local_addr,
-                                               bool executable)
+                                               bool executable, bool writeable)
 {
 	Lock::Guard lock_guard(lock());
 
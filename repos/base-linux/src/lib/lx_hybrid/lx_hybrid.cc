@@ -21,6 +21,7 @@
 #include <base/internal/native_thread.h>
 #include <base/internal/globals.h>
 #include <base/internal/platform_env.h>
+#include <base/internal/ipc_channels.h>
 
 
 /**
@@ -543,6 +544,8 @@ Thread::~Thread()
 			        "with ", ret, " (errno=", errno, ")");
 	}
 
+	release_ipc_channels(native_thread());
+
 	Thread_meta_data_created *meta_data =
 		dynamic_cast<Thread_meta_data_created *>(native_thread().meta_data);
 
@@ -213,6 +213,53 @@ inline int lx_munmap(void *addr, Genode::size_t length)
 }
 
 
+/**************************************************************
+ ** Functions used by core's RAM session and the IPC library **
+ **************************************************************/
+
+inline int lx_ftruncate(int fd, unsigned long length)
+{
+	return lx_syscall(SYS_ftruncate, fd, length);
+}
+
+
+inline long lx_lseek(int fd, long offset, int whence)
+{
+	return lx_syscall(SYS_lseek, fd, offset, whence);
+}
+
+
+inline int lx_fcntl(int fd, int cmd, unsigned long arg)
+{
+	return lx_syscall(SYS_fcntl, fd, cmd, arg);
+}
+
+
+enum { LX_MFD_CLOEXEC = 1, LX_MFD_ALLOW_SEALING = 2 };
+
+enum {
+	LX_F_ADD_SEALS   = 1033,
+	LX_F_GET_SEALS   = 1034,
+	LX_F_SEAL_SHRINK = 2,
+	LX_F_SEAL_GROW   = 4,
+};
+
+/**
+ * Create anonymous file for shared memory
+ *
+ * \return  file descriptor, or negative error code if the kernel lacks
+ *          support for 'memfd_create' (prior to Linux 3.17)
+ */
+inline int lx_memfd_create(char const *name, unsigned flags)
+{
+#ifdef SYS_memfd_create
+	return lx_syscall(SYS_memfd_create, name, flags);
+#else
+	return -38; /* ENOSYS */
+#endif
+}
+
+
 /***********************************************************************
  ** Functions used by thread lib and core's cancel-blocking mechanism **
  ***********************************************************************/
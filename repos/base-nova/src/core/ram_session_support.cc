@@ -13,6 +13,7 @@
 
 /* Genode includes */
 #include <base/thread.h>
+#include <base/log.h>
 
 /* core includes */
 #include <ram_session_component.h>
@@ -29,7 +30,7 @@ using namespace Genode;
 void Ram_session_component::_revoke_ram_ds(Dataspace_component *ds) { }
 
 
-static inline void * alloc_region(Dataspace_component *ds, const size_t size)
+static inline void * alloc_region(const size_t size)
 {
 	/*
 	 * Allocate range in core's virtual address space
@@ -38,7 +39,7 @@ static inline void * alloc_region(Dataspace_component *ds, const size_t size)
 	 * successively weaken the alignment constraint until we hit the page size.
 	 */
 	void *virt_addr = 0;
-	size_t align_log2 = log2(ds->size());
+	size_t align_log2 = log2(size);
 	for (; align_log2 >= get_page_size_log2(); align_log2--) {
 		if (platform()->region_alloc()->alloc_aligned(size,
 		                                              &virt_addr, align_log2).ok())
@@ -49,50 +50,71 @@ static inline void * alloc_region(Dataspace_component *ds, const size_t size)
 }
 
 
-void Ram_session_component::_clear_ds(Dataspace_component *ds)
+/**
+ * Clear physical memory via a temporary core-local mapping
+ *
+ * \return false if the memory could not be mapped
+ */
+static bool clear_mapped(addr_t phys, size_t size)
 {
-	size_t page_rounded_size = align_addr(ds->size(), get_page_size_log2());
+	/* allocate the virtual region contiguous for the memory */
+	void * virt_ptr = alloc_region(size);
+	if (!virt_ptr)
+		return false;
+
+	addr_t const virt      = reinterpret_cast<addr_t>(virt_ptr);
+	size_t const num_pages = size >> get_page_size_log2();
+
+	Nova::Utcb * const utcb = reinterpret_cast<Nova::Utcb *>(Thread::myself()->utcb());
+	const Nova::Rights rights_rw(true, true, false);
+
+	if (map_local(utcb, phys, virt, num_pages, rights_rw, true)) {
+		platform()->region_alloc()->free(virt_ptr, size);
+		return false;
+	}
 
-	size_t memset_count = page_rounded_size / 4;
-	addr_t memset_ptr   = ds->core_local_addr();
+	size_t memset_count = size / 4;
+	addr_t memset_ptr   = virt;
 
-	if ((memset_count * 4 == page_rounded_size) && !(memset_ptr & 0x3))
+	if ((memset_count * 4 == size) && !(memset_ptr & 0x3))
 		asm volatile ("rep stosl" : "+D" (memset_ptr), "+c" (memset_count)
 		                          : "a" (0)  : "memory");
 	else
-		memset(reinterpret_cast<void *>(memset_ptr), 0, page_rounded_size);
+		memset(virt_ptr, 0, size);
 
 	/* we don't keep any core-local mapping */
-	unmap_local(reinterpret_cast<Nova::Utcb *>(Thread::myself()->utcb()),
-	            ds->core_local_addr(),
-	            page_rounded_size >> get_page_size_log2());
-
-	platform()->region_alloc()->free((void*)ds->core_local_addr(),
-	                                 page_rounded_size);
+	unmap_local(utcb, virt, num_pages);
 
-	ds->assign_core_local_addr(nullptr);
+	platform()->region_alloc()->free(virt_ptr, size);
+	return true;
 }
 
 
-void Ram_session_component::_export_ram_ds(Dataspace_component *ds) {
-
+/*
+ * The dataspace is mapped into core only while being cleared. Hence, the
+ * clearing does not depend on '_export_ram_ds' and can be performed for
+ * memory that is not yet exported.
+ */
+bool Ram_session_component::_clear_ds(Dataspace_component *ds)
+{
 	size_t page_rounded_size = align_addr(ds->size(), get_page_size_log2());
 
-	/* allocate the virtual region contiguous for the dataspace */
-	void * virt_ptr = alloc_region(ds, page_rounded_size);
-	if (!virt_ptr)
-		throw Out_of_metadata();
-
-	/* map it writeable for _clear_ds */
-	Nova::Utcb * const utcb = reinterpret_cast<Nova::Utcb *>(Thread::myself()->utcb());
-	const Nova::Rights rights_rw(true, true, false);
+	if (clear_mapped(ds->phys_addr(), page_rounded_size))
+		return true;
 
-	if (map_local(utcb, ds->phys_addr(), reinterpret_cast<addr_t>(virt_ptr),
-	              page_rounded_size >> get_page_size_log2(), rights_rw, true)) {
-		platform()->region_alloc()->free(virt_ptr, page_rounded_size);
-		throw Out_of_metadata();
-	}
+	/* core's virtual address space is too fragmented, clear page by page */
+	for (addr_t offset = 0; offset < page_rounded_size; offset += get_page_size())
+		if (!clear_mapped(ds->phys_addr() + offset, get_page_size())) {
+			error("could not clear RAM dataspace at ",
+			      Hex(ds->phys_addr() + offset));
+			return false;
+		}
 
-	/* assign virtual address to the dataspace to be used by clear_ds */
-	ds->assign_core_local_addr(virt_ptr);
+	return true;
 }
+
+
+void Ram_session_component::_export_ram_ds(Dataspace_component *) { }
+
+
+bool Ram_session_component::_clear_ds_before_export() { return true; }
@@ -12,8 +12,12 @@
  * under the terms of the GNU Affero General Public License version 3.
  */
 
+/* Genode includes */
+#include <base/thread.h>
+
 /* core includes */
 #include <rm_session_component.h>
+#include <nova_util.h>
 
 using namespace Genode;
 
@@ -29,3 +33,30 @@ void Rm_client::unmap(addr_t, addr_t virt_base, size_t size)
 	if (locked_address_space.valid())
 		locked_address_space->flush(virt_base, size);
 }
+
+
+bool Rm_client::install_mapping(Mapping &mapping)
+{
+	if (pd_sel() == Native_thread::INVALID_INDEX)
+		return false;
+
+	/*
+	 * Delegate the flexpage from core to the target PD like a page-fault
+	 * reply does, yet without a preceding fault
+	 */
+	Nova::Utcb *utcb = (Nova::Utcb *)Thread::myself()->utcb();
+	utcb->set_msg_word(0);
+	bool res = utcb->append_item(mapping.mem_crd(), 0, true, false,
+	                             false, mapping.dma(), mapping.write_combined());
+	/* one item ever fits on the UTCB */
+	(void)res;
+
+	/* receive window in destination pd */
+	Nova::Mem_crd crd_mem(mapping.dst_addr() >> 12, mapping.mem_crd().order(),
+	                      Nova::Rights(true, true, true));
+
+	addr_t const pd_core = platform_specific()->core_pd_sel();
+
+	return syscall_retry(*this, [&] () {
+		return Nova::delegate(pd_core, pd_sel(), crd_mem); }) == Nova::NOVA_OK;
+}
@@ -32,6 +32,8 @@ using namespace Genode;
 void Ram_session_component::_export_ram_ds(Dataspace_component *ds) { }
 void Ram_session_component::_revoke_ram_ds(Dataspace_component *ds) { }
 
+bool Ram_session_component::_clear_ds_before_export() { return true; }
+
 void Ram_session_component::_clear_ds (Dataspace_component *ds)
 {
 	size_t page_rounded_size = (ds->size() + get_page_size() - 1) & get_page_mask();
@@ -43,3 +43,10 @@ void Rm_client::unmap(addr_t core_local_base, addr_t virt_base, size_t size)
 		L4_Unmap(L4_FpageAddRightsTo(&fp, L4_FullyAccessible));
 	}
 }
+
+
+bool Rm_client::install_mapping(Mapping &)
+{
+	/* mappings are established as reply to page faults only */
+	return false;
+}
@@ -37,6 +37,13 @@ void Ram_session_component::_revoke_ram_ds(Dataspace_component *ds)
 }
 
 
+/*
+ * Mapping the memory for clearing requires the page frames created by
+ * '_export_ram_ds'. Furthermore, the kernel clears memory when retyping it.
+ */
+bool Ram_session_component::_clear_ds_before_export() { return false; }
+
+
 void Ram_session_component::_clear_ds (Dataspace_component *ds)
 {
 	size_t const page_rounded_size = (ds->size() + get_page_size() - 1) & get_page_mask();
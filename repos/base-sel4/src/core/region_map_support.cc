@@ -24,3 +24,10 @@ void Rm_client::unmap(addr_t core_local_base, addr_t virt_base, size_t size)
 	if (locked_address_space.valid())
 		locked_address_space->flush(virt_base, size);
 }
+
+
+bool Rm_client::install_mapping(Mapping &)
+{
+	/* mappings are established as reply to page faults only */
+	return false;
+}
@@ -67,11 +67,7 @@ class Genode::Entrypoint : Genode::Noncopyable
 		{
 			enum { STACK_SIZE = 2*1024*sizeof(long) };
 			Entrypoint &ep;
-			Signal_proxy_thread(Env &env, Entrypoint &ep)
-			:
-				Thread(env, "signal_proxy", STACK_SIZE),
-				ep(ep)
-			{ start(); }
+			Signal_proxy_thread(Env &env, Entrypoint &ep, Location location);
 
 			void entry() override { ep._process_incoming_signals(); }
 		};
@@ -131,7 +127,14 @@ class Genode::Entrypoint : Genode::Noncopyable
 
 	public:
 
-		Entrypoint(Env &env, size_t stack_size, char const *name);
+		/**
+		 * Constructor
+		 *
+		 * \param location  CPU affinity of the entrypoint thread and its
+		 *                  signal-proxy thread
+		 */
+		Entrypoint(Env &env, size_t stack_size, char const *name,
+		           Affinity::Location location = Affinity::Location());
 
 		~Entrypoint()
 		{
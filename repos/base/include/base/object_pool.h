@@ -20,6 +20,7 @@
 #include <util/noncopyable.h>
 #include <base/capability.h>
 #include <base/weak_ptr.h>
+#include <base/reader_writer_lock.h>
 
 namespace Genode { template <typename> class Object_pool; }
 
@@ -31,6 +32,10 @@ namespace Genode { template <typename> class Object_pool; }
  *
  * The local names of a capabilities are used to differentiate multiple server
  * objects managed by one and the same object pool.
+ *
+ * Lookups are far more frequent than modifications of the pool. Hence,
+ * concurrent lookups do not serialize each other. Only the insertion and
+ * removal of objects is exclusive.
  */
 template <typename OBJ_TYPE>
 class Genode::Object_pool
@@ -93,14 +98,21 @@ class Genode::Object_pool
 
 	private:
 
+		typedef Reader_writer_lock Lookup_lock;
+
 		Avl_tree<Entry> _tree;
-		Lock            _lock;
+		Lookup_lock     _lock;
+
+		Entry *_lookup(unsigned long capid)
+		{
+			return _tree.first() ? _tree.first()->find_by_obj_id(capid) : nullptr;
+		}
 
 	protected:
 
 		bool empty()
 		{
-			Lock::Guard lock_guard(_lock);
+			typename Lookup_lock::Read_guard guard(_lock);
 			return _tree.first() == nullptr;
 		}
 
@@ -108,16 +120,44 @@ class Genode::Object_pool
 
 		void insert(OBJ_TYPE *obj)
 		{
-			Lock::Guard lock_guard(_lock);
+			typename Lookup_lock::Write_guard guard(_lock);
 			_tree.insert(obj);
 		}
 
 		void remove(OBJ_TYPE *obj)
 		{
-			Lock::Guard lock_guard(_lock);
+			typename Lookup_lock::Write_guard guard(_lock);
 			_tree.remove(obj);
 		}
 
+		/**
+		 * Return true if the object referred to by 'capid' is in the pool
+		 *
+		 * In contrast to 'apply', the object is not locked.
+		 */
+		bool contains(unsigned long capid)
+		{
+			typename Lookup_lock::Read_guard guard(_lock);
+			return _lookup(capid) != nullptr;
+		}
+
+		bool contains(Untyped_capability cap) { return contains(cap.local_name()); }
+
+		/**
+		 * Wait until all functors applied to 'obj' returned
+		 *
+		 * The object must have been removed from the pool already. Hence,
+		 * no further functor can be applied to it.
+		 */
+		void wait_for_apply(OBJ_TYPE *obj)
+		{
+			using Weak_ptr   = Weak_ptr<typename Entry::Entry_lock>;
+			using Locked_ptr = Locked_ptr<typename Entry::Entry_lock>;
+
+			Weak_ptr ptr = obj->_lock.weak_ptr();
+			Locked_ptr lock_ptr(ptr);
+		}
+
 		template <typename FUNC>
 		auto apply(unsigned long capid, FUNC func)
 		-> typename Trait::Functor<decltype(&FUNC::operator())>::Return_type
@@ -130,10 +170,9 @@ class Genode::Object_pool
 			Weak_ptr ptr;
 
 			{
-				Lock::Guard lock_guard(_lock);
+				typename Lookup_lock::Read_guard guard(_lock);
 
-				Entry * entry = _tree.first() ?
-					_tree.first()->find_by_obj_id(capid) : nullptr;
+				Entry * entry = _lookup(capid);
 
 				if (entry) ptr = entry->_lock.weak_ptr();
 			}
@@ -163,7 +202,7 @@ class Genode::Object_pool
 				OBJ_TYPE * obj;
 
 				{
-					Lock::Guard lock_guard(_lock);
+					typename Lookup_lock::Write_guard guard(_lock);
 
 					if (!((obj = (OBJ_TYPE*) _tree.first()))) return;
 
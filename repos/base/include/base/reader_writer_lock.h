@@ -0,0 +1,110 @@
+/*
+ * \brief  Lock that admits multiple readers or one writer
+ * \author Genode Labs
+ * \date   2017-04-18
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__BASE__READER_WRITER_LOCK_H_
+#define _INCLUDE__BASE__READER_WRITER_LOCK_H_
+
+#include <base/lock.h>
+#include <util/noncopyable.h>
+#include <cpu/atomic.h>
+
+namespace Genode { class Reader_writer_lock; }
+
+
+/**
+ * Lock that admits multiple readers or one writer
+ *
+ * Readers merely count themselves in '_state'. A writer marks '_state' with
+ * the 'WRITER' bit and waits until the last reader left. Readers that
+ * encounter the 'WRITER' bit wait for the writer by acquiring '_write_lock'.
+ *
+ * The lock is not recursive. A reader must not acquire the lock again, as
+ * it would block forever if a writer is waiting meanwhile.
+ */
+class Genode::Reader_writer_lock : Noncopyable
+{
+	private:
+
+		enum { WRITER = 1 << 30 };
+
+		int volatile _state = 0;
+
+		Lock _write_lock;
+		Lock _drained { Lock::LOCKED };
+
+	public:
+
+		void lock_read()
+		{
+			for (;;) {
+				int const state = _state;
+
+				if (state & WRITER) {
+					Lock::Guard guard(_write_lock);
+					continue;
+				}
+
+				if (cmpxchg(&_state, state, state + 1))
+					return;
+			}
+		}
+
+		void unlock_read()
+		{
+			for (;;) {
+				int const state = _state;
+
+				if (!cmpxchg(&_state, state, state - 1))
+					continue;
+
+				/* wake up writer waiting for the last reader */
+				if (state - 1 == WRITER)
+					_drained.unlock();
+				return;
+			}
+		}
+
+		void lock_write()
+		{
+			_write_lock.lock();
+
+			int state;
+			do { state = _state; }
+			while (!cmpxchg(&_state, state, state | WRITER));
+
+			if (state)
+				_drained.lock();
+		}
+
+		void unlock_write()
+		{
+			cmpxchg(&_state, WRITER, 0);
+			_write_lock.unlock();
+		}
+
+		struct Read_guard
+		{
+			Reader_writer_lock &lock;
+			Read_guard(Reader_writer_lock &lock) : lock(lock) { lock.lock_read(); }
+			~Read_guard() { lock.unlock_read(); }
+		};
+
+		struct Write_guard
+		{
+			Reader_writer_lock &lock;
+			Write_guard(Reader_writer_lock &lock) : lock(lock) { lock.lock_write(); }
+			~Write_guard() { lock.unlock_write(); }
+		};
+};
+
+#endif /* _INCLUDE__BASE__READER_WRITER_LOCK_H_ */
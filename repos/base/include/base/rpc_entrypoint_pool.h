@@ -0,0 +1,158 @@
+/*
+ * \brief  Pool of RPC entrypoints
+ * \author Genode Labs
+ * \date   2017-04-12
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__BASE__RPC_ENTRYPOINT_POOL_H_
+#define _INCLUDE__BASE__RPC_ENTRYPOINT_POOL_H_
+
+#include <base/rpc_server.h>
+#include <util/reconstructible.h>
+#include <util/string.h>
+
+namespace Genode { class Rpc_entrypoint_pool; }
+
+
+/**
+ * RPC entrypoints that serve RPC objects in parallel
+ *
+ * Each RPC object is assigned to one thread of the pool when managed, namely
+ * the thread with the least number of objects. All RPCs of the object are
+ * served by this thread. Hence, the state of one object is never accessed
+ * by multiple threads whereas different objects, e.g., the sessions of
+ * different clients, are served in parallel. State shared between objects
+ * must be protected by the server.
+ */
+class Genode::Rpc_entrypoint_pool : Noncopyable
+{
+	public:
+
+		enum { MAX_THREADS = 16 };
+
+	private:
+
+		struct Thread_ep
+		{
+			Rpc_entrypoint ep;
+			unsigned       objects = 0;
+
+			Thread_ep(Pd_session &pd, size_t stack_size, char const *name,
+			          Affinity::Location location)
+			: ep(&pd, stack_size, name, true, location) { }
+		};
+
+		Constructible<Thread_ep> _threads[MAX_THREADS];
+
+		unsigned const _num_threads;
+
+		Lock _lock;
+
+		/**
+		 * Return thread that manages the object referred to by 'cap'
+		 */
+		Thread_ep *_thread(Untyped_capability cap)
+		{
+			for (unsigned i = 0; i < _num_threads; i++)
+				if (_threads[i]->ep.contains(cap))
+					return &*_threads[i];
+			return nullptr;
+		}
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param pd           'Pd_session' for creating capabilities
+		 * \param stack_size   stack size of each entrypoint thread
+		 * \param name         name prefix of the entrypoint threads
+		 * \param num_threads  number of entrypoint threads, limited to
+		 *                     'MAX_THREADS'
+		 * \param space        affinity space, the threads are assigned
+		 *                     to its locations in ascending order
+		 */
+		Rpc_entrypoint_pool(Pd_session &pd, size_t stack_size, char const *name,
+		                    unsigned num_threads,
+		                    Affinity::Space space = Affinity::Space(1))
+		:
+			_num_threads(max(1U, min(num_threads, (unsigned)MAX_THREADS)))
+		{
+			for (unsigned i = 0; i < _num_threads; i++)
+				_threads[i].construct(pd, stack_size,
+				                      String<32>(name, ".", i).string(),
+				                      space.location_of_index(i));
+		}
+
+		unsigned num_threads() const { return _num_threads; }
+
+		/**
+		 * Associate RPC object with the least loaded entrypoint
+		 */
+		template <typename RPC_INTERFACE, typename RPC_SERVER>
+		Capability<RPC_INTERFACE>
+		manage(Rpc_object<RPC_INTERFACE, RPC_SERVER> *obj)
+		{
+			Lock::Guard guard(_lock);
+
+			Thread_ep *thread = &*_threads[0];
+			for (unsigned i = 1; i < _num_threads; i++)
+				if (_threads[i]->objects < thread->objects)
+					thread = &*_threads[i];
+
+			thread->objects++;
+			return thread->ep.manage(obj);
+		}
+
+		/**
+		 * Dissolve RPC object from its entrypoint
+		 *
+		 * The method returns when no RPC of the object is served anymore.
+		 * Hence, it must not be called from within the functor passed to
+		 * 'apply' or while holding a lock that an RPC function of the object
+		 * may acquire. Otherwise, the caller would wait for an entrypoint
+		 * thread that, in turn, waits for the caller.
+		 */
+		template <typename RPC_INTERFACE, typename RPC_SERVER>
+		void dissolve(Rpc_object<RPC_INTERFACE, RPC_SERVER> *obj)
+		{
+			Thread_ep *thread = nullptr;
+
+			{
+				Lock::Guard guard(_lock);
+
+				thread = _thread(obj->cap());
+				if (!thread)
+					return;
+
+				thread->objects--;
+			}
+
+			thread->ep.dissolve(obj);
+			thread->ep.wait_for_apply(obj);
+		}
+
+		/**
+		 * Apply functor to the RPC object referred to by 'cap'
+		 *
+		 * Like 'Object_pool::apply', the functor is called with a nullptr
+		 * if the capability does not refer to an object of the pool.
+		 */
+		template <typename FUNC>
+		auto apply(Untyped_capability cap, FUNC func)
+		-> typename Trait::Functor<decltype(&FUNC::operator())>::Return_type
+		{
+			Thread_ep *thread = _thread(cap);
+
+			return (thread ? thread->ep : _threads[0]->ep).apply(cap, func);
+		}
+};
+
+#endif /* _INCLUDE__BASE__RPC_ENTRYPOINT_POOL_H_ */
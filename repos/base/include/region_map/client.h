@@ -44,9 +44,11 @@ class Genode::Region_map_client : public Rpc_client<Region_map>
 		Local_addr attach(Dataspace_capability ds, size_t size = 0,
 		                  off_t offset = 0, bool use_local_addr = false,
 		                  Local_addr local_addr = (void *)0,
-		                  bool executable = false) override;
+		                  bool executable = false,
+		                  bool writeable = true) override;
 
 		void                 detach(Local_addr)                       override;
+		void                 populate(Local_addr, size_t = 0)         override;
 		void                 fault_handler(Signal_context_capability) override;
 		State                state()                                  override;
 		Dataspace_capability dataspace()                              override;
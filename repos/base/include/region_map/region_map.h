@@ -108,6 +108,10 @@ struct Genode::Region_map
 	 *                         the specified 'local_addr'
 	 * \param local_addr       local destination address
 	 * \param executable       if the mapping should be executable
+	 * \param writeable        if the mapping should be writeable, a
+	 *                         read-only mapping of a writeable dataspace
+	 *                         reflects write accesses as region-map
+	 *                         faults
 	 *
 	 * \throw Attach_failed    if dataspace or offset is invalid,
 	 *                         or on region conflict
@@ -120,7 +124,8 @@ struct Genode::Region_map
 	                          size_t size = 0, off_t offset = 0,
 	                          bool use_local_addr = false,
 	                          Local_addr local_addr = (void *)0,
-	                          bool executable = false) = 0;
+	                          bool executable = false,
+	                          bool writeable = true) = 0;
 
 	/**
 	 * Shortcut for attaching a dataspace at a predefined local address
@@ -141,6 +146,24 @@ struct Genode::Region_map
 	 */
 	virtual void detach(Local_addr local_addr) = 0;
 
+	/**
+	 * Establish the mappings of an attached region ahead of its first use
+	 *
+	 * \param local_addr  address within the region
+	 * \param size        size of the range to populate, the range is
+	 *                    limited to the region at 'local_addr',
+	 *                    default (0) is the rest of the region
+	 *
+	 * By default, the memory of an attached dataspace is mapped lazily, one
+	 * page fault at a time. This function asks for the mappings of the
+	 * whole range in one batch, using the largest page sizes supported by
+	 * the kernel. It is merely a hint. It is ignored if the kernel resolves
+	 * page faults by itself, for regions backed by managed dataspaces, for
+	 * region maps not used as address space, and on kernels that establish
+	 * mappings only in response to page faults.
+	 */
+	virtual void populate(Local_addr local_addr, size_t size = 0) { }
+
 	/**
 	 * Register signal handler for region-manager faults
 	 *
@@ -169,14 +192,16 @@ struct Genode::Region_map
 	GENODE_RPC_THROW(Rpc_attach, Local_addr, attach,
 	                 GENODE_TYPE_LIST(Invalid_dataspace, Region_conflict,
 	                                  Out_of_metadata, Invalid_args),
-	                 Dataspace_capability, size_t, off_t, bool, Local_addr, bool);
+	                 Dataspace_capability, size_t, off_t, bool, Local_addr,
+	                 bool, bool);
 	GENODE_RPC(Rpc_detach, void, detach, Local_addr);
+	GENODE_RPC(Rpc_populate, void, populate, Local_addr, size_t);
 	GENODE_RPC(Rpc_fault_handler, void, fault_handler, Signal_context_capability);
 	GENODE_RPC(Rpc_state, State, state);
 	GENODE_RPC(Rpc_dataspace, Dataspace_capability, dataspace);
 
-	GENODE_RPC_INTERFACE(Rpc_attach, Rpc_detach, Rpc_fault_handler, Rpc_state,
-	                     Rpc_dataspace);
+	GENODE_RPC_INTERFACE(Rpc_attach, Rpc_detach, Rpc_populate,
+	                     Rpc_fault_handler, Rpc_state, Rpc_dataspace);
 };
 
 #endif /* _INCLUDE__REGION_MAP__REGION_MAP_H_ */
@@ -20,6 +20,7 @@
 #include <root/root.h>
 #include <base/allocator.h>
 #include <base/rpc_server.h>
+#include <base/rpc_entrypoint_pool.h>
 #include <base/entrypoint.h>
 #include <base/service.h>
 #include <util/arg_string.h>
@@ -107,6 +108,11 @@ class Genode::Root_component : public Rpc_object<Typed_root<SESSION_TYPE> >,
 		 */
 		Rpc_entrypoint *_ep;
 
+		/*
+		 * Entrypoint pool that serves the sessions instead of '_ep'
+		 */
+		Rpc_entrypoint_pool *_ep_pool = nullptr;
+
 		/*
 		 * Allocator for allocating session objects.
 		 * This allocator must be used by the derived
@@ -115,6 +121,19 @@ class Genode::Root_component : public Rpc_object<Typed_root<SESSION_TYPE> >,
 		 */
 		Allocator *_md_alloc;
 
+		void _manage(SESSION_TYPE *s)
+		{
+			if (_ep_pool) _ep_pool->manage(s);
+			else          _ep->manage(s);
+		}
+
+		template <typename FUNC>
+		void _apply(Session_capability cap, FUNC const &fn)
+		{
+			if (_ep_pool) _ep_pool->apply(cap, fn);
+			else          _ep->apply(cap, fn);
+		}
+
 		/*
 		 * Used by both the legacy 'Root::session' and the new 'Factory::create'
 		 */
@@ -173,7 +192,7 @@ class Genode::Root_component : public Rpc_object<Typed_root<SESSION_TYPE> >,
 				throw Root::Unavailable();
 			}
 
-			_ep->manage(s);
+			_manage(s);
 
 			aquire_guard.ack = true;
 			return *s;
@@ -262,6 +281,24 @@ class Genode::Root_component : public Rpc_object<Typed_root<SESSION_TYPE> >,
 			_ep(&ep.rpc_ep()), _md_alloc(&md_alloc)
 		{ }
 
+		/**
+		 * Constructor
+		 *
+		 * \param ep        entry point that serves the root interface
+		 * \param ep_pool   entrypoint pool that serves the sessions of
+		 *                  this root interface
+		 * \param md_alloc  meta-data allocator providing the backing store
+		 *                  for session objects
+		 *
+		 * The sessions are served in parallel by the threads of 'ep_pool'.
+		 * Each session is assigned to one thread of the pool.
+		 */
+		Root_component(Entrypoint &ep, Rpc_entrypoint_pool &ep_pool,
+		               Allocator &md_alloc)
+		:
+			_ep(&ep.rpc_ep()), _ep_pool(&ep_pool), _md_alloc(&md_alloc)
+		{ }
+
 		/**
 		 * Constructor
 		 *
@@ -316,7 +353,7 @@ class Genode::Root_component : public Rpc_object<Typed_root<SESSION_TYPE> >,
 		{
 			if (!args.valid_string()) throw Root::Invalid_args();
 
-			_ep->apply(session, [&] (SESSION_TYPE *s) {
+			_apply(session, [&] (SESSION_TYPE *s) {
 				if (!s) return;
 
 				_upgrade_session(s, args.string());
@@ -327,15 +364,22 @@ class Genode::Root_component : public Rpc_object<Typed_root<SESSION_TYPE> >,
 		{
 			SESSION_TYPE * session;
 
-			_ep->apply(session_cap, [&] (SESSION_TYPE *s) {
+			_apply(session_cap, [&] (SESSION_TYPE *s) {
 				session = s;
 
 				/* let the entry point forget the session object */
-				if (session) _ep->dissolve(session);
+				if (session && !_ep_pool) _ep->dissolve(session);
 			});
 
 			if (!session) return;
 
+			/*
+			 * Dissolving waits for the pool thread that serves the session,
+			 * which may wait for the session lock held by '_apply'. Hence,
+			 * the session is dissolved after the lock is released.
+			 */
+			if (_ep_pool) _ep_pool->dissolve(session);
+
 			_destroy_session(session);
 
 			POLICY::release();
@@ -0,0 +1,321 @@
+/*
+ * \brief  Physical memory cleared ahead of its allocation
+ * \author Genode Labs
+ * \date   2017-04-12
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _CORE__INCLUDE__CLEARED_RAM_POOL_H_
+#define _CORE__INCLUDE__CLEARED_RAM_POOL_H_
+
+/* Genode includes */
+#include <base/allocator_avl.h>
+#include <base/semaphore.h>
+#include <base/thread.h>
+#include <base/log.h>
+#include <util/list.h>
+#include <util/misc_math.h>
+
+/* core includes */
+#include <ram_session_component.h>
+
+namespace Genode { class Cleared_ram_pool; }
+
+
+/**
+ * Pool of physical memory that is cleared by a background thread
+ *
+ * The pool takes memory from core's RAM allocator in chunks up to its limit
+ * and clears it in the background. It starts growing with the first
+ * allocation that had to be cleared synchronously. Unconstrained cached RAM
+ * dataspaces are allocated from the pool if possible, which avoids clearing
+ * the memory during the 'Ram_session::alloc' RPC. The memory of such
+ * dataspaces returns to the pool when freed and is cleared again before it
+ * is reused.
+ */
+class Genode::Cleared_ram_pool : Thread_deprecated<2048*sizeof(long)>
+{
+	public:
+
+		struct Stats
+		{
+			unsigned long sync_count   = 0;  /* cleared during allocation */
+			size_t        sync_bytes   = 0;
+			unsigned long pooled_count = 0;  /* taken from the pool */
+			size_t        pooled_bytes = 0;
+
+			void print(Output &out) const
+			{
+				Genode::print(out, sync_count, " synchronous (",
+				              sync_bytes/1024, " KiB), ", pooled_count,
+				              " from pool (", pooled_bytes/1024, " KiB)");
+			}
+		};
+
+	private:
+
+		enum {
+			CHUNK_SIZE_LOG2 = 20,
+			CHUNK_SIZE      = 1 << CHUNK_SIZE_LOG2,
+
+			/* interval of reporting the statistics */
+			REPORT_BYTES    = 256*1024*1024,
+
+			/* weight of the background thread */
+			LOW_WEIGHT      = 1,
+		};
+
+		struct Range : List<Range>::Element
+		{
+			addr_t const addr;
+			size_t const size;
+
+			Range(addr_t addr, size_t size) : addr(addr), size(size) { }
+		};
+
+		Range_allocator &_ram_alloc;
+		Allocator       &_md_alloc;
+		size_t const     _limit;
+
+		Lock          _lock;
+		Allocator_avl _alloc;        /* cleared memory of the pool */
+		List<Range>   _chunks;       /* memory taken from '_ram_alloc' */
+		List<Range>   _dirty;        /* freed, still allocated at '_alloc' */
+		size_t        _owned = 0;
+		bool          _exhausted = false;  /* no chunk could be taken */
+		Stats         _stats;
+		size_t        _reported = 0;
+
+		Semaphore _work;
+
+		/**
+		 * Clear memory
+		 *
+		 * \return false if the memory could not be cleared and must not
+		 *         be handed out anymore
+		 */
+		static bool _clear(addr_t phys, size_t size)
+		{
+			Dataspace_component ds(size, phys, CACHED, true, nullptr);
+			return Ram_session_component::_clear_ds(&ds);
+		}
+
+		bool _owns(addr_t phys)
+		{
+			for (Range *r = _chunks.first(); r; r = r->next())
+				if (phys >= r->addr && phys - r->addr < r->size)
+					return true;
+			return false;
+		}
+
+		/**
+		 * Clear freed memory
+		 *
+		 * \return false if no freed memory was pending
+		 */
+		bool _clear_dirty()
+		{
+			Range *range = nullptr;
+			{
+				Lock::Guard guard(_lock);
+				range = _dirty.first();
+				if (range)
+					_dirty.remove(range);
+			}
+
+			if (!range)
+				return false;
+
+			bool const cleared = _clear(range->addr, range->size);
+
+			Lock::Guard guard(_lock);
+
+			/* memory that is not cleared stays allocated at '_alloc' */
+			if (cleared)
+				_alloc.free((void *)range->addr);
+			else
+				error("discard uncleared RAM at ", Hex(range->addr));
+
+			destroy(_md_alloc, range);
+			return true;
+		}
+
+		/**
+		 * Take and clear a new chunk of memory
+		 *
+		 * \return false if the pool cannot grow
+		 */
+		bool _grow()
+		{
+			{
+				Lock::Guard guard(_lock);
+				if (_exhausted || _owned + CHUNK_SIZE > _limit)
+					return false;
+			}
+
+			/* prefer high memory like 'Ram_session_component::alloc' */
+			addr_t const high_start = (sizeof(void *) == 4 ? 3UL : 4UL) << 30;
+
+			void *chunk = nullptr;
+			bool  ok    = _ram_alloc.alloc_aligned(CHUNK_SIZE, &chunk, CHUNK_SIZE_LOG2,
+			                                       high_start).ok()
+			           || _ram_alloc.alloc_aligned(CHUNK_SIZE, &chunk, CHUNK_SIZE_LOG2).ok();
+
+			Range *range = nullptr;
+			if (ok) {
+				try { range = new (_md_alloc) Range((addr_t)chunk, CHUNK_SIZE); }
+				catch (Allocator::Out_of_memory) {
+					_ram_alloc.free(chunk, CHUNK_SIZE);
+					ok = false;
+				}
+			}
+
+			if (ok && !_clear(range->addr, range->size)) {
+				_ram_alloc.free(chunk, CHUNK_SIZE);
+				destroy(_md_alloc, range);
+				ok = false;
+			}
+
+			if (!ok) {
+				Lock::Guard guard(_lock);
+				_exhausted = true;
+				return false;
+			}
+
+			Lock::Guard guard(_lock);
+			_chunks.insert(range);
+			_alloc.add_range(range->addr, range->size);
+			_owned += range->size;
+			return true;
+		}
+
+		void _report()
+		{
+			Stats stats;
+			{
+				Lock::Guard guard(_lock);
+				size_t const total = _stats.sync_bytes + _stats.pooled_bytes;
+				if (total - _reported < REPORT_BYTES)
+					return;
+
+				_reported = total;
+				stats     = _stats;
+			}
+			log("cleared RAM: ", stats);
+		}
+
+		/**
+		 * Thread interface
+		 */
+		void entry() override
+		{
+			for (;;) {
+				_work.down();
+
+				while (_clear_dirty() || _grow());
+
+				_report();
+			}
+		}
+
+	public:
+
+		/**
+		 * Return true if the platform can clear memory ahead of its export
+		 */
+		static bool supported() {
+			return Ram_session_component::_clear_ds_before_export(); }
+
+		/**
+		 * Constructor
+		 *
+		 * \param ram_alloc  core's allocator of physical memory
+		 * \param md_alloc   meta-data allocator
+		 * \param limit      maximum amount of memory held by the pool
+		 */
+		Cleared_ram_pool(Range_allocator &ram_alloc, Allocator &md_alloc,
+		                 size_t limit)
+		:
+			Thread_deprecated(LOW_WEIGHT, "clear_ram"),
+			_ram_alloc(ram_alloc), _md_alloc(md_alloc), _limit(limit),
+			_alloc(&md_alloc)
+		{
+			start();
+		}
+
+		/**
+		 * Allocate cleared memory
+		 *
+		 * \return true if the memory was taken from the pool
+		 */
+		bool alloc(size_t size, addr_t &phys)
+		{
+			Lock::Guard guard(_lock);
+
+			for (size_t align_log2 = log2(size); align_log2 >= 12; align_log2--) {
+				void *addr = nullptr;
+				if (!_alloc.alloc_aligned(size, &addr, align_log2).ok())
+					continue;
+
+				phys = (addr_t)addr;
+				_stats.pooled_count++;
+				_stats.pooled_bytes += size;
+				return true;
+			}
+			return false;
+		}
+
+		/**
+		 * Return memory to the pool
+		 *
+		 * \return false if the memory does not belong to the pool
+		 */
+		bool free(addr_t phys, size_t size)
+		{
+			Lock::Guard guard(_lock);
+
+			if (!_owns(phys))
+				return false;
+
+			try { _dirty.insert(new (_md_alloc) Range(phys, size)); }
+			catch (Allocator::Out_of_memory) {
+				if (_clear(phys, size))
+					_alloc.free((void *)phys);
+				else
+					error("discard uncleared RAM at ", Hex(phys));
+				return true;
+			}
+
+			_work.up();
+			return true;
+		}
+
+		/**
+		 * Account memory cleared during the allocation
+		 */
+		void cleared_synchronously(size_t size)
+		{
+			Lock::Guard guard(_lock);
+			_stats.sync_count++;
+			_stats.sync_bytes += size;
+
+			/* let the pool grow, memory may have been freed meanwhile */
+			_exhausted = false;
+			if (_owned < _limit)
+				_work.up();
+		}
+
+		Stats stats()
+		{
+			Lock::Guard guard(_lock);
+			return _stats;
+		}
+};
+
+#endif /* _CORE__INCLUDE__CLEARED_RAM_POOL_H_ */
@@ -24,8 +24,9 @@ namespace Genode {
 	{
 		private:
 
-			Range_allocator *_ram_alloc;
-			Rpc_entrypoint  *_ds_ep;
+			Range_allocator  *_ram_alloc;
+			Rpc_entrypoint   *_ds_ep;
+			Cleared_ram_pool *_cleared_ram;
 
 		protected:
 
@@ -33,7 +34,7 @@ namespace Genode {
 			{
 				return new (md_alloc())
 					Ram_session_component(_ds_ep, ep(), _ram_alloc,
-					                      md_alloc(), args);
+					                      md_alloc(), args, 0, _cleared_ram);
 			}
 
 			void _upgrade_session(Ram_session_component *ram, const char *args)
@@ -51,14 +52,16 @@ namespace Genode {
 			 * \param ds_ep       entry point for managing dataspaces
 			 * \param ram_alloc   pool of memory to be assigned to ram sessions
 			 * \param md_alloc    meta-data allocator to be used by root component
+			 * \param cleared_ram pool of pre-cleared memory for ram sessions
 			 */
-			Ram_root(Rpc_entrypoint  *session_ep,
-			         Rpc_entrypoint  *ds_ep,
-			         Range_allocator *ram_alloc,
-			         Allocator       *md_alloc)
+			Ram_root(Rpc_entrypoint   *session_ep,
+			         Rpc_entrypoint   *ds_ep,
+			         Range_allocator  *ram_alloc,
+			         Allocator        *md_alloc,
+			         Cleared_ram_pool *cleared_ram = nullptr)
 			:
 				Root_component<Ram_session_component>(session_ep, md_alloc),
-				_ram_alloc(ram_alloc), _ds_ep(ds_ep) { }
+				_ram_alloc(ram_alloc), _ds_ep(ds_ep), _cleared_ram(cleared_ram) { }
 	};
 }
 
@@ -29,6 +29,7 @@
 namespace Genode {
 
 	class Ram_session_component;
+	class Cleared_ram_pool;
 	typedef List<Ram_session_component> Ram_ref_account_members;
 
 	class Ram_session_component : public Rpc_object<Ram_session>,
@@ -37,6 +38,8 @@ namespace Genode {
 	{
 		private:
 
+			friend class Cleared_ram_pool;
+
 			class Invalid_dataspace : public Exception { };
 
 			/*
@@ -57,6 +60,7 @@ namespace Genode {
 			Ram_session_component  *_ref_account;  /* reference ram session       */
 			addr_t                  _phys_start;
 			addr_t                  _phys_end;
+			Cleared_ram_pool       *_cleared_ram;  /* pre-cleared memory */
 
 			enum { MAX_LABEL_LEN = 64 };
 			char _label[MAX_LABEL_LEN];
@@ -93,6 +97,11 @@ namespace Genode {
 			 */
 			int _transfer_quota(Ram_session_component *dst, size_t amount);
 
+			/**
+			 * Free physical memory that was backing a dataspace
+			 */
+			void _free_phys(addr_t phys, size_t size);
+
 
 			/********************************************
 			 ** Platform-implemented support functions **
@@ -101,17 +110,33 @@ namespace Genode {
 			/**
 			 * Export RAM dataspace as shared memory block
 			 */
-			void _export_ram_ds(Dataspace_component *ds);
+			static void _export_ram_ds(Dataspace_component *ds);
 
 			/**
 			 * Revert export of RAM dataspace
 			 */
-			void _revoke_ram_ds(Dataspace_component *ds);
+			static void _revoke_ram_ds(Dataspace_component *ds);
 
 			/**
 			 * Zero-out content of dataspace
+			 *
+			 * If '_clear_ds_before_export' returns true, this function is
+			 * also called by the background thread of the 'Cleared_ram_pool'
+			 * for dataspaces that are not exported.
+			 *
+			 * \return false if the content could not be cleared, in which
+			 *         case the memory must not be handed out
+			 */
+			static bool _clear_ds(Dataspace_component *ds);
+
+			/**
+			 * Return true if '_clear_ds' works for dataspaces that are not
+			 * exported via '_export_ram_ds'
+			 *
+			 * Only on such platforms, memory is cleared ahead of its
+			 * allocation by the 'Cleared_ram_pool'.
 			 */
-			void _clear_ds(Dataspace_component *ds);
+			static bool _clear_ds_before_export();
 
 		public:
 
@@ -127,6 +152,7 @@ namespace Genode {
 			 * \param md_alloc        meta-data allocator
 			 * \param md_ram_quota    limit of meta-data backing store
 			 * \param quota_limit     initial quota limit
+			 * \param cleared_ram     pool of pre-cleared memory, or nullptr
 			 *
 			 * The 'quota_limit' parameter is only used for the very
 			 * first ram session in the system. All other ram session
@@ -137,7 +163,8 @@ namespace Genode {
 			                      Range_allocator *ram_alloc,
 			                      Allocator       *md_alloc,
 			                      const char      *args,
-			                      size_t           quota_limit = 0);
+			                      size_t           quota_limit = 0,
+			                      Cleared_ram_pool *cleared_ram = nullptr);
 
 			/**
 			 * Destructor
@@ -206,6 +206,14 @@ class Genode::Rm_client : public Pager_object, public Rm_faulter,
 		 */
 		void unmap(addr_t core_local_base, addr_t virt_base, size_t size);
 
+		/**
+		 * Install mapping without waiting for a page fault
+		 *
+		 * \return false if the kernel accepts mappings only in response
+		 *         to page faults
+		 */
+		bool install_mapping(Mapping &mapping);
+
 		bool has_same_address_space(Rm_client const &other)
 		{
 			return other._address_space == _address_space;
@@ -404,8 +412,9 @@ class Genode::Region_map_component : public Genode::Weak_object<Genode::Region_m
 		 ** Region map interface **
 		 **************************/
 
-		Local_addr       attach        (Dataspace_capability, size_t, off_t, bool, Local_addr, bool) override;
+		Local_addr       attach        (Dataspace_capability, size_t, off_t, bool, Local_addr, bool, bool) override;
 		void             detach        (Local_addr) override;
+		void             populate      (Local_addr, size_t) override;
 		void             fault_handler (Signal_context_capability handler) override;
 		State            state         () override;
 
@@ -29,6 +29,7 @@
 #include <platform.h>
 #include <core_env.h>
 #include <ram_root.h>
+#include <cleared_ram_pool.h>
 #include <rom_root.h>
 #include <rm_root.h>
 #include <cpu_root.h>
@@ -262,7 +263,22 @@ int main()
 
 	static Pager_entrypoint pager_ep(rpc_cap_factory);
 
-	static Ram_root     ram_root     (e, e, platform()->ram_alloc(), &sliced_heap);
+	/*
+	 * Memory for RAM dataspaces cleared in the background, limited to a
+	 * small fraction of the physical memory
+	 */
+	enum { CLEARED_RAM_LIMIT = 16*1024*1024 };
+	size_t const cleared_ram_limit = !Cleared_ram_pool::supported() ? 0
+	                               : min((size_t)CLEARED_RAM_LIMIT,
+	                                     platform()->ram_alloc()->avail()/32);
+	static Constructible<Cleared_ram_pool> cleared_ram;
+	if (cleared_ram_limit)
+		cleared_ram.construct(*platform()->ram_alloc(),
+		                      *env_deprecated()->heap(), cleared_ram_limit);
+
+	static Ram_root     ram_root     (e, e, platform()->ram_alloc(), &sliced_heap,
+	                                  cleared_ram.constructed() ? &*cleared_ram
+	                                                            : nullptr);
 	static Rom_root     rom_root     (e, e, platform()->rom_fs(), &sliced_heap);
 	static Rm_root      rm_root      (e, &sliced_heap, pager_ep);
 	static Cpu_root     cpu_root     (e, e, &pager_ep, &sliced_heap,
@@ -296,13 +312,15 @@ int main()
 
 	/*
 	 * Transfer all left memory to init, but leave some memory left for core
+	 * and the pool of cleared RAM
 	 *
 	 * NOTE: exception objects thrown in core components are currently
 	 * allocated on core's heap and not accounted by the component's meta data
 	 * allocator
 	 */
 
-	Genode::size_t const ram_quota = platform()->ram_alloc()->avail() - 224*1024;
+	Genode::size_t const ram_quota = platform()->ram_alloc()->avail() - 224*1024
+	                               - cleared_ram_limit;
 	log("", ram_quota / (1024*1024), " MiB RAM assigned to init");
 
 	static Reconstructible<Core_child>
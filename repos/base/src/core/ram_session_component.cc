@@ -17,6 +17,7 @@
 
 /* core includes */
 #include <ram_session_component.h>
+#include <cleared_ram_pool.h>
 
 using namespace Genode;
 
@@ -54,7 +55,7 @@ void Ram_session_component::_free_ds(Dataspace_capability ds_cap)
 		_revoke_ram_ds(ds);
 
 		/* free physical memory that was backing the dataspace */
-		_ram_alloc->free((void *)ds->phys_addr(), ds_size);
+		_free_phys(ds->phys_addr(), ds_size);
 
 		/* adjust payload */
 		Lock::Guard lock_guard(_ref_members_lock);
@@ -67,6 +68,15 @@ void Ram_session_component::_free_ds(Dataspace_capability ds_cap)
 }
 
 
+void Ram_session_component::_free_phys(addr_t phys, size_t size)
+{
+	if (_cleared_ram && _cleared_ram->free(phys, size))
+		return;
+
+	_ram_alloc->free((void *)phys, size);
+}
+
+
 int Ram_session_component::_transfer_quota(Ram_session_component *dst, size_t amount)
 {
 	/* check if recipient is a valid Ram_session_component */
@@ -145,13 +155,27 @@ Ram_dataspace_capability Ram_session_component::alloc(size_t ds_size, Cache_attr
 	void *ds_addr = 0;
 	bool alloc_succeeded = false;
 
+	/*
+	 * Take memory that is already cleared if no physical constraint exists.
+	 * Uncached dataspaces are excluded because their clearing involves
+	 * cache maintenance.
+	 */
+	bool cleared = false;
+	if (_cleared_ram && cached == CACHED && _phys_start == 0 && _phys_end == ~0UL) {
+		addr_t phys = 0;
+		if (_cleared_ram->alloc(ds_size, phys)) {
+			ds_addr = (void *)phys;
+			alloc_succeeded = cleared = true;
+		}
+	}
+
 	/*
 	 * If no physical constraint exists, try to allocate physical memory at
 	 * high locations (3G for 32-bit / 4G for 64-bit platforms) in order to
 	 * preserve lower physical regions for device drivers, which may have DMA
 	 * constraints.
 	 */
-	if (_phys_start == 0 && _phys_end == ~0UL) {
+	if (!alloc_succeeded && _phys_start == 0 && _phys_end == ~0UL) {
 		addr_t const high_start = (sizeof(void *) == 4 ? 3UL : 4UL) << 30;
 		for (size_t align_log2 = log2(ds_size); align_log2 >= 12; align_log2--) {
 			if (_ram_alloc->alloc_aligned(ds_size, &ds_addr, align_log2,
@@ -198,7 +222,7 @@ Ram_dataspace_capability Ram_session_component::alloc(size_t ds_size, Cache_attr
 	} catch (Allocator::Out_of_memory) {
 		warning("could not allocate metadata");
 		/* cleanup unneeded resources */
-		_ram_alloc->free(ds_addr);
+		_free_phys((addr_t)ds_addr, ds_size);
 
 		throw Out_of_metadata();
 	}
@@ -210,7 +234,7 @@ Ram_dataspace_capability Ram_session_component::alloc(size_t ds_size, Cache_attr
 		warning("could not export RAM dataspace of size ", ds->size());
 		/* cleanup unneeded resources */
 		destroy(&_ds_slab, ds);
-		_ram_alloc->free(ds_addr);
+		_free_phys((addr_t)ds_addr, ds_size);
 
 		throw Quota_exceeded();
 	}
@@ -220,7 +244,20 @@ Ram_dataspace_capability Ram_session_component::alloc(size_t ds_size, Cache_attr
 	 * function must also make sure to flush all cache lines related to the
 	 * address range used by the dataspace.
 	 */
-	_clear_ds(ds);
+	if (!cleared) {
+		if (!_clear_ds(ds)) {
+			warning("could not clear RAM dataspace of size ", ds->size());
+			/* cleanup unneeded resources */
+			_revoke_ram_ds(ds);
+			destroy(&_ds_slab, ds);
+			_free_phys((addr_t)ds_addr, ds_size);
+
+			throw Quota_exceeded();
+		}
+
+		if (_cleared_ram)
+			_cleared_ram->cleared_synchronously(ds_size);
+	}
 
 	Dataspace_capability result = _ds_ep->manage(ds);
 
@@ -277,13 +314,15 @@ Ram_session_component::Ram_session_component(Rpc_entrypoint  *ds_ep,
                                              Range_allocator *ram_alloc,
                                              Allocator       *md_alloc,
                                              const char      *args,
-                                             size_t           quota_limit)
+                                             size_t           quota_limit,
+                                             Cleared_ram_pool *cleared_ram)
 :
 	_ds_ep(ds_ep), _ram_session_ep(ram_session_ep), _ram_alloc(ram_alloc),
 	_quota_limit(quota_limit), _payload(0),
 	_md_alloc(md_alloc, Arg_string::find_arg(args, "ram_quota").ulong_value(0)),
 	_ds_slab(&_md_alloc), _ref_account(0),
-	_phys_start(Arg_string::find_arg(args, "phys_start").ulong_value(0))
+	_phys_start(Arg_string::find_arg(args, "phys_start").ulong_value(0)),
+	_cleared_ram(cleared_ram)
 {
 	Arg_string::find_arg(args, "label").string(_label, sizeof(_label), "");
 
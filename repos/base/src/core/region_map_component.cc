@@ -161,6 +161,52 @@ static void print_page_fault(char const *msg,
 }
 
 
+/**
+ * Create mapping of the largest flexpage around 'dst_addr'
+ *
+ * The flexpage lies within the region as well as within the dataspace and
+ * has a size supported by the kernel.
+ *
+ * \param ds_offset      offset of 'dst_addr' within the dataspace
+ * \param region_offset  offset of the region map within the address space
+ * \param dst_base       returns the virtual base address of the mapping
+ * \param size_log2      returns the size of the mapping
+ */
+static Mapping create_map_item(Rm_region const &region, Dataspace_component &dsc,
+                               addr_t ds_offset, addr_t region_offset,
+                               addr_t dst_addr, addr_t &dst_base,
+                               size_t &size_log2)
+{
+	using Fault_area = Region_map_component::Fault_area;
+
+	addr_t ds_base = dsc.map_src_addr();
+	Fault_area src_fault_area(ds_base + ds_offset);
+	Fault_area dst_fault_area(dst_addr);
+	src_fault_area.constrain(ds_base, dsc.size());
+	dst_fault_area.constrain(region_offset + region.base(), region.size());
+
+	/*
+	 * Determine mapping size compatible with source and destination,
+	 * and apply platform-specific constraint of mapping sizes.
+	 */
+	size_t map_size_log2 = dst_fault_area.common_size_log2(dst_fault_area,
+	                                                       src_fault_area);
+	map_size_log2 = constrain_map_size_log2(map_size_log2);
+
+	src_fault_area.constrain(map_size_log2);
+	dst_fault_area.constrain(map_size_log2);
+	if (!src_fault_area.valid() || !dst_fault_area.valid())
+		error("invalid mapping");
+
+	dst_base  = dst_fault_area.base();
+	size_log2 = map_size_log2;
+
+	return Mapping(dst_fault_area.base(), src_fault_area.base(),
+	               dsc.cacheability(), dsc.io_mem(),
+	               map_size_log2, dsc.writable() && region.write());
+}
+
+
 /***********************
  ** Region-map client **
  ***********************/
@@ -171,8 +217,6 @@ static void print_page_fault(char const *msg,
 
 int Rm_client::pager(Ipc_pager &pager)
 {
-	using Fault_area = Region_map_component::Fault_area;
-
 	Region_map::State::Fault_type pf_type = pager.write_fault() ? Region_map::State::WRITE_FAULT
 	                                                            : Region_map::State::READ_FAULT;
 	addr_t pf_addr = pager.fault_addr();
@@ -208,42 +252,31 @@ int Rm_client::pager(Ipc_pager &pager)
 			return 1;
 		}
 
-		addr_t ds_base = dsc->map_src_addr();
-		Fault_area src_fault_area(ds_base + ds_offset);
-		Fault_area dst_fault_area(pf_addr);
-		src_fault_area.constrain(ds_base, dsc->size());
-		dst_fault_area.constrain(region_offset + region->base(), region->size());
-
-		/*
-		 * Determine mapping size compatible with source and destination,
-		 * and apply platform-specific constraint of mapping sizes.
-		 */
-		size_t map_size_log2 = dst_fault_area.common_size_log2(dst_fault_area,
-		                                                       src_fault_area);
-		map_size_log2 = constrain_map_size_log2(map_size_log2);
-
-		src_fault_area.constrain(map_size_log2);
-		dst_fault_area.constrain(map_size_log2);
-		if (!src_fault_area.valid() || !dst_fault_area.valid())
-			error("invalid mapping");
-
 		/*
-		 * Check if dataspace is compatible with page-fault type
+		 * Check if dataspace and region are compatible with page-fault type
 		 */
-		if (pf_type == Region_map::State::WRITE_FAULT && !dsc->writable()) {
+		if (pf_type == Region_map::State::WRITE_FAULT
+		 && (!dsc->writable() || !region->write())) {
 
-			/* attempted there is no attachment return an error condition */
-			print_page_fault("attempted write at read-only memory",
-			                 pf_addr, pf_ip, pf_type, *this);
+			/*
+			 * Write accesses to read-only regions of writeable dataspaces
+			 * are expected to be resolved by the region-map fault handler,
+			 * e.g., for implementing copy-on-write.
+			 */
+			if (!dsc->writable())
+				print_page_fault("attempted write at read-only memory",
+				                 pf_addr, pf_ip, pf_type, *this);
 
 			/* register fault at responsible region map */
-			region_map->fault(this, src_fault_area.fault_addr(), pf_type);
+			region_map->fault(this, pf_addr - region_offset, pf_type);
 			return 2;
 		}
 
-		Mapping mapping(dst_fault_area.base(), src_fault_area.base(),
-		                dsc->cacheability(), dsc->io_mem(),
-		                map_size_log2, dsc->writable());
+		addr_t dst_base      = 0;
+		size_t map_size_log2 = 0;
+		Mapping mapping = create_map_item(*region, *dsc, ds_offset,
+		                                  region_offset, pf_addr, dst_base,
+		                                  map_size_log2);
 
 		/*
 		 * On kernels with a mapping database, the 'dsc' dataspace is a leaf
@@ -317,7 +350,7 @@ Region_map::Local_addr
 Region_map_component::attach(Dataspace_capability ds_cap, size_t size,
                              off_t offset, bool use_local_addr,
                              Region_map::Local_addr local_addr,
-                             bool executable)
+                             bool executable, bool writeable)
 {
 	/* serialize access */
 	Lock::Guard lock_guard(_lock);
@@ -392,7 +425,7 @@ Region_map_component::attach(Dataspace_capability ds_cap, size_t size,
 		}
 
 		/* store attachment info in meta data */
-		_map.metadata(r, Rm_region((addr_t)r, size, true, dsc, offset, this));
+		_map.metadata(r, Rm_region((addr_t)r, size, writeable, dsc, offset, this));
 		Rm_region *region = _map.metadata(r);
 
 		/* inform dataspace about attachment */
@@ -419,23 +452,39 @@ Region_map_component::attach(Dataspace_capability ds_cap, size_t size,
 }
 
 
-static void unmap_managed(Region_map_component *rm, Rm_region *region, int level)
+/**
+ * Unmap part of a region map from all address spaces that use it
+ *
+ * \param rm               region map used as managed dataspace
+ * \param core_local_base  core-local address of the unmapped memory
+ * \param base             start of the unmapped range within 'rm'
+ * \param size             size of the unmapped range
+ *
+ * The region map may be attached to other managed dataspaces, e.g., to the
+ * stack area of an address space. Hence, the range is translated to each
+ * region map the region map is attached to, recursively.
+ */
+static void unmap_managed(Region_map_component *rm, addr_t core_local_base,
+                          addr_t base, size_t size, int level)
 {
 	for (Rm_region *managed = rm->dataspace_component()->regions()->first();
 	     managed;
 	     managed = managed->List<Rm_region>::Element::next()) {
 
-		if (managed->base() - managed->offset() >= region->base() - region->offset()
-		    && managed->base() - managed->offset() + managed->size()
-		       <= region->base() - region->offset() + region->size())
-			unmap_managed(managed->rm(), managed, level + 1);
-
-		/* found a leaf node (here a leaf is an Region_map whose dataspace has no regions) */
-		if (!managed->rm()->dataspace_component()->regions()->first())
-			for (Rm_client *rc = managed->rm()->clients()->first();
-			     rc; rc = rc->List<Rm_client>::Element::next())
-				rc->unmap(region->dataspace()->core_local_addr() + region->offset(),
-				          managed->base() + region->base() - managed->offset(), region->size());
+		/* part of the range that is visible through the attachment */
+		addr_t const start = max(base, (addr_t)managed->offset());
+		addr_t const end   = min(base + size, managed->offset() + managed->size());
+		if (start >= end)
+			continue;
+
+		addr_t const local = core_local_base + (start - base);
+		addr_t const virt  = managed->base() + (start - managed->offset());
+
+		unmap_managed(managed->rm(), local, virt, end - start, level + 1);
+
+		for (Rm_client *rc = managed->rm()->clients()->first();
+		     rc; rc = rc->List<Rm_client>::Element::next())
+			rc->unmap(local, virt, end - start);
 	}
 }
 
@@ -548,7 +597,63 @@ void Region_map_component::detach(Local_addr local_addr)
 	 * If region map is used as nested dataspace, unmap this dataspace from all
 	 * region maps.
 	 */
-	unmap_managed(this, &region, 1);
+	unmap_managed(this, dsc->core_local_addr() + region.offset(),
+	              region.base(), region.size(), 1);
+}
+
+
+void Region_map_component::populate(Local_addr local_addr, size_t size)
+{
+	/* serialize access */
+	Lock::Guard lock_guard(_lock);
+
+	Rm_region *region = _map.metadata(local_addr);
+	if (!region)
+		return;
+
+	/* regions of managed dataspaces are populated on demand */
+	Dataspace_component *dsc = region->dataspace();
+	if (!dsc || dsc->sub_rm().valid())
+		return;
+
+	addr_t const start = (addr_t)local_addr & ~(get_page_size() - 1);
+	addr_t const limit = region->base() + region->size() - (addr_t)local_addr;
+	addr_t const end   = (addr_t)local_addr + ((size && size < limit) ? size : limit);
+
+	for (Rm_client *rc = _clients.first(); rc;
+	     rc = rc->List<Rm_client>::Element::next()) {
+
+		/* populate each address space only once */
+		bool populated = false;
+		for (Rm_client *other = _clients.first(); other != rc;
+		     other = other->List<Rm_client>::Element::next())
+			populated |= other->has_same_address_space(*rc);
+
+		if (populated)
+			continue;
+
+		for (addr_t addr = start; addr < end; ) {
+
+			addr_t dst_base  = 0;
+			size_t size_log2 = 0;
+			Mapping mapping = create_map_item(*region, *dsc,
+			                                  addr - region->base() + region->offset(),
+			                                  0, addr, dst_base, size_log2);
+
+			if (!dsc->io_mem())
+				mapping.prepare_map_operation();
+
+			if (!rc->install_mapping(mapping))
+				return;
+
+			/* stop at an invalid mapping, which would not advance */
+			addr_t const next = dst_base + (1UL << size_log2);
+			if (next <= addr)
+				break;
+
+			addr = next;
+		}
+	}
 }
 
 
@@ -23,10 +23,10 @@ Region_map_client::Region_map_client(Capability<Region_map> cap)
 Region_map::Local_addr
 Region_map_client::attach(Dataspace_capability ds, size_t size, off_t offset,
                           bool use_local_addr, Local_addr local_addr,
-                          bool executable)
+                          bool executable, bool writeable)
 {
 	return call<Rpc_attach>(ds, size, offset, use_local_addr, local_addr,
-	                        executable);
+	                        executable, writeable);
 }
 
 
@@ -34,6 +34,10 @@ void Region_map_client::detach(Local_addr local_addr) {
 	call<Rpc_detach>(local_addr); }
 
 
+void Region_map_client::populate(Local_addr local_addr, size_t size) {
+	call<Rpc_populate>(local_addr, size); }
+
+
 void Region_map_client::fault_handler(Signal_context_capability cap) {
 	call<Rpc_fault_handler>(cap); }
 
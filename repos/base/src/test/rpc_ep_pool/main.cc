@@ -0,0 +1,197 @@
+/*
+ * \brief  Test closing sessions served by an entrypoint pool
+ * \author Genode Labs
+ * \date   2017-04-12
+ *
+ * Client threads call their sessions in a tight loop while the sessions are
+ * closed via the root component. Closing a session must neither deadlock
+ * with the pool thread serving an RPC of the session nor destroy the
+ * session while an RPC is in progress.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <base/rpc_server.h>
+#include <base/rpc_client.h>
+#include <base/rpc_entrypoint_pool.h>
+#include <root/component.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Session;
+	struct Client;
+	struct Session_component;
+	struct Root;
+	struct Client_thread;
+	struct Main;
+}
+
+
+struct Test::Session : Genode::Session
+{
+	static const char *service_name() { return "RPC_EP_POOL_TEST"; }
+
+	GENODE_RPC(Rpc_work, void, work);
+	GENODE_RPC_INTERFACE(Rpc_work);
+};
+
+
+struct Test::Client : Genode::Rpc_client<Session>
+{
+	Client(Capability<Session> cap) : Rpc_client<Session>(cap) { }
+
+	void work() { call<Rpc_work>(); }
+};
+
+
+struct Test::Session_component : Genode::Rpc_object<Session, Session_component>
+{
+	unsigned &destroyed;
+	bool     &failed;
+
+	bool volatile busy = false;
+
+	Session_component(unsigned &destroyed, bool &failed)
+	: destroyed(destroyed), failed(failed) { }
+
+	~Session_component()
+	{
+		if (busy) {
+			error("session destroyed during RPC");
+			failed = true;
+		}
+		destroyed++;
+	}
+
+	void work()
+	{
+		busy = true;
+
+		/* widen the window for a concurrent close */
+		for (unsigned volatile i = 0; i < 1000; i++);
+
+		busy = false;
+	}
+};
+
+
+struct Test::Root : Genode::Root_component<Session_component>
+{
+	unsigned destroyed = 0;
+	bool     failed    = false;
+
+	Session_component *_create_session(const char *) override
+	{
+		return new (md_alloc()) Session_component(destroyed, failed);
+	}
+
+	Root(Entrypoint &ep, Rpc_entrypoint_pool &pool, Allocator &md_alloc)
+	: Root_component<Session_component>(ep, pool, md_alloc) { }
+};
+
+
+/**
+ * Thread that calls its session until the session is closed
+ */
+struct Test::Client_thread : Genode::Thread
+{
+	enum { CALLS_BEFORE_CLOSE = 100 };
+
+	Client client;
+
+	Lock calling { Lock::LOCKED };
+
+	void entry() override
+	{
+		try {
+			for (unsigned long calls = 0; ; calls++) {
+				client.work();
+
+				if (calls == CALLS_BEFORE_CLOSE)
+					calling.unlock();
+			}
+		} catch (Ipc_error) { }
+
+		/* the session may be closed before enough calls were done */
+		calling.unlock();
+	}
+
+	Client_thread(Env &env, Capability<Session> cap)
+	:
+		Thread(env, "client", 4*1024*sizeof(long)), client(cap)
+	{
+		start();
+	}
+};
+
+
+struct Test::Main
+{
+	enum { STACK_SIZE = 4*1024*sizeof(long), ROUNDS = 50, SESSIONS = 4 };
+
+	Env &env;
+
+	Heap heap { env.ram(), env.rm() };
+
+	Rpc_entrypoint_pool pool { env.pd(), STACK_SIZE, "pool", 2 };
+
+	Root root { env.ep(), pool, heap };
+
+	Capability<Session> _session()
+	{
+		Session_capability cap =
+			root.session("ram_quota=16384", Affinity());
+
+		return static_cap_cast<Session>(cap);
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- test-rpc_ep_pool started ---");
+
+		for (unsigned round = 0; round < ROUNDS; round++) {
+
+			Capability<Session> caps[SESSIONS];
+			Client_thread      *clients[SESSIONS];
+
+			for (unsigned i = 0; i < SESSIONS; i++) {
+				caps[i]    = _session();
+				clients[i] = new (heap) Client_thread(env, caps[i]);
+			}
+
+			/* close the sessions while their clients are calling */
+			for (unsigned i = 0; i < SESSIONS; i++) {
+				clients[i]->calling.lock();
+				root.close(caps[i]);
+			}
+
+			for (unsigned i = 0; i < SESSIONS; i++) {
+				clients[i]->join();
+				destroy(heap, clients[i]);
+			}
+		}
+
+		if (root.failed || root.destroyed != ROUNDS*SESSIONS) {
+			error("destroyed ", root.destroyed, " of ", ROUNDS*SESSIONS, " sessions");
+			env.parent().exit(-1);
+			return;
+		}
+
+		log("--- test-rpc_ep_pool finished ---");
+		env.parent().exit(0);
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
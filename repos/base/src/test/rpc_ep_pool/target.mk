@@ -0,0 +1,3 @@
+TARGET = test-rpc_ep_pool
+SRC_CC = main.cc
+LIBS   = base
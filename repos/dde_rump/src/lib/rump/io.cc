@@ -37,6 +37,48 @@ class Backend
 		Block::Session::Operations         _blk_ops;
 		Genode::Lock                       _session_lock;
 
+		/**
+		 * Submit request and wait for its completion
+		 *
+		 * Must be called with the session lock held.
+		 */
+		bool _io(Block::Packet_descriptor::Opcode opcode, int64_t offset,
+		         size_t length, void *data)
+		{
+			using namespace Block;
+
+			/* requests without payload occupy a single block */
+			size_t const size = length ? length : _blk_size;
+
+			/* allocate packet */
+			try {
+				Packet_descriptor packet( _session.dma_alloc_packet(size),
+				                         opcode, offset / _blk_size,
+				                         length / _blk_size);
+
+				/* out packet -> copy data */
+				if (opcode == Packet_descriptor::WRITE)
+					Genode::memcpy(_session.tx()->packet_content(packet), data, length);
+
+				_session.tx()->submit_packet(packet);
+			} catch(Block::Session::Tx::Source::Packet_alloc_failed) {
+				Genode::error("I/O back end: Packet allocation failed!");
+				return false;
+			}
+
+			/* wait and process result */
+			Packet_descriptor packet = _session.tx()->get_acked_packet();
+
+			/* in packet */
+			if (opcode == Packet_descriptor::READ)
+				Genode::memcpy(data, _session.tx()->packet_content(packet), length);
+
+			bool succeeded = packet.succeeded();
+			_session.tx()->release_packet(packet);
+
+			return succeeded;
+		}
+
 	public:
 
 		Backend()
@@ -55,7 +97,15 @@ class Backend
 		void sync()
 		{
 			Genode::Lock::Guard guard(_session_lock);
-			_session.sync();
+
+			/*
+			 * A 'SYNC' request is ordered within the packet stream and
+			 * does not block the server while it processes other requests
+			 */
+			if (_blk_ops.supported(Block::Packet_descriptor::SYNC))
+				_io(Block::Packet_descriptor::SYNC, 0, 0, nullptr);
+			else
+				_session.sync();
 		}
 
 		bool submit(int op, int64_t offset, size_t length, void *data)
@@ -70,36 +120,9 @@ class Backend
 
 			Genode::Lock::Guard guard(_session_lock);
 
-			Packet_descriptor::Opcode opcode;
-			opcode = op & RUMPUSER_BIO_WRITE ? Packet_descriptor::WRITE :
-			                                   Packet_descriptor::READ;
-			/* allocate packet */
-			try {
-				Packet_descriptor packet( _session.dma_alloc_packet(length),
-				                         opcode, offset / _blk_size,
-				                         length / _blk_size);
-
-				/* out packet -> copy data */
-				if (opcode == Packet_descriptor::WRITE)
-					Genode::memcpy(_session.tx()->packet_content(packet), data, length);
-
-				_session.tx()->submit_packet(packet);
-			} catch(Block::Session::Tx::Source::Packet_alloc_failed) {
-				Genode::error("I/O back end: Packet allocation failed!");
-				return false;
-			}
-
-			/* wait and process result */
-			Packet_descriptor packet = _session.tx()->get_acked_packet();
-
-			/* in packet */
-			if (opcode == Packet_descriptor::READ)
-				Genode::memcpy(data, _session.tx()->packet_content(packet), length);
-
-			bool succeeded = packet.succeeded();
-			_session.tx()->release_packet(packet);
-
-			return succeeded;
+			return _io(op & RUMPUSER_BIO_WRITE ? Packet_descriptor::WRITE
+			                                   : Packet_descriptor::READ,
+			           offset, length, data);
 		}
 };
 
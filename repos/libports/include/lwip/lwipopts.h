@@ -59,6 +59,14 @@
 
 #define LWIP_CHECKSUM_ON_COPY       1  /* calculate checksum during memcpy */
 
+/* sum up with the vectorized implementation of Genode's net library */
+#define LWIP_CHKSUM                 genode_lwip_chksum
+
+#ifdef __cplusplus
+extern "C"
+#endif
+unsigned short genode_lwip_chksum(void const *data, int len);
+
 /*********************
  ** Memory settings **
  *********************/
@@ -8,7 +8,7 @@ LWIP_PORT_DIR := $(call select_from_ports,lwip)
 LWIP_DIR      := $(LWIP_PORT_DIR)/src/lib/lwip
 
 # Genode platform files
-SRC_CC   = nic.cc printf.cc sys_arch.cc
+SRC_CC   = nic.cc printf.cc sys_arch.cc chksum.cc
 
 # Core files
 SRC_C    = init.c mem.c memp.c netif.c pbuf.c stats.c udp.c raw.c sys.c \
@@ -24,7 +24,7 @@ SRC_C   += err.c api_lib.c api_msg.c netbuf.c netdb.c netifapi.c sockets.c \
 # Network interface files
 SRC_C   += etharp.c
 
-LIBS     = alarm libc timed_semaphore
+LIBS     = alarm libc timed_semaphore net
 
 D_OPTS   = ERRNO
 D_OPTS  := $(addprefix -D,$(D_OPTS))
@@ -29,11 +29,13 @@
 #include <fcntl.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 /* libc-internal includes */
 #include "libc_file.h"
+#include "libc_kqueue.h"
 #include "libc_mem_alloc.h"
 #include "libc_mmap_registry.h"
 
@@ -220,6 +222,8 @@ extern "C" int chdir(const char *path)
 
 extern "C" int _close(int libc_fd)
 {
+	Libc::kqueue_fd_closed(libc_fd);
+
 	FD_FUNC_WRAPPER(close, libc_fd);
 }
 
@@ -433,7 +437,8 @@ extern "C" void *mmap(void *addr, ::size_t length, int prot, int flags,
 	}
 
 	void *start = fd->plugin->mmap(addr, length, prot, flags, fd, offset);
-	mmap_registry()->insert(start, length, fd->plugin);
+	if (start != MAP_FAILED)
+		mmap_registry()->insert(start, length, fd->plugin);
 	return start;
 }
 
@@ -446,6 +451,17 @@ extern "C" int munmap(void *start, ::size_t length)
 		return -1;
 	}
 
+	/*
+	 * Unmapping a part of a region is not supported. Reject it instead of
+	 * releasing the whole region behind the back of the caller.
+	 */
+	if (!mmap_registry()->covers(start, length)) {
+		Genode::warning("munmap: partial unmap of region at ", start, " "
+		                "not supported");
+		errno = EINVAL;
+		return -1;
+	}
+
 	/*
 	 * Lookup plugin that was used for mmap
 	 *
@@ -464,6 +480,19 @@ extern "C" int munmap(void *start, ::size_t length)
 }
 
 
+extern "C" int msync(void *addr, ::size_t len, int flags)
+{
+	Plugin *plugin = 0;
+	if (!mmap_registry()->lookup_by_range(addr, plugin)) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	/* anonymous mappings have no backing store to synchronize */
+	return plugin ? plugin->msync(addr, len, flags) : 0;
+}
+
+
 extern "C" int _open(const char *pathname, int flags, ::mode_t mode)
 {
 	Absolute_path resolved_path;
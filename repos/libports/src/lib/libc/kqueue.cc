@@ -0,0 +1,674 @@
+/*
+ * \brief  kqueue() and kevent() implementation
+ * \author Genode Labs
+ * \date   2017-04-07
+ *
+ * A kqueue keeps the registered events and their readiness between calls.
+ * Only the events on a list of active events are checked by 'kevent':
+ * events that were registered, enabled, or notified since the last check,
+ * and events found ready by the last check. The readiness itself is
+ * determined by the same plugin 'select' functions as used by 'select()'.
+ *
+ * I/O responses of the VFS name the context of the affected fd, which
+ * activates the events of this fd only. Notifications that do not name
+ * an fd, i.e., by plugins via 'libc_select_notify' or VFS responses
+ * without context, activate all events of a kqueue.
+ *
+ * An edge-triggered event ('EV_CLEAR') is reported when its fd becomes
+ * ready or when a notification concerns the fd after the last report,
+ * but not by each call while the fd stays ready.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/lock.h>
+#include <util/list.h>
+
+/* Genode-specific libc interfaces */
+#include <libc/allocator.h>
+#include <libc-plugin/fd_alloc.h>
+#include <libc-plugin/plugin.h>
+
+/* libc includes */
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/event.h>
+#include <sys/select.h>
+#include <sys/time.h>
+
+/* libc-internal includes */
+#include "libc_errno.h"
+#include "libc_kqueue.h"
+#include "task.h"
+
+
+namespace Libc {
+
+	int select_scan(int nfds,
+	                fd_set *in_readfds,  fd_set *in_writefds,  fd_set *in_exceptfds,
+	                fd_set *out_readfds, fd_set *out_writefds, fd_set *out_exceptfds);
+
+	void init_select_notify();
+
+	struct Knote;
+	struct Kqueue;
+	struct Kqueue_plugin;
+}
+
+
+/**
+ * Event registered at a kqueue
+ */
+struct Libc::Knote
+{
+	uintptr_t        const ident;
+	short            const filter;
+	Plugin_context * const context;  /* fd context, used as key only */
+
+	u_short  flags  = 0;
+	u_int    fflags = 0;
+	void    *udata  = nullptr;
+
+	bool enabled   = true;
+	bool ready     = false;  /* readiness found by the last check     */
+	bool triggered = true;   /* changed or notified since last check */
+	bool active    = false;  /* member of the active list            */
+
+	Knote *fd_next      = nullptr;
+	Knote *context_next = nullptr;
+	Knote *active_prev  = nullptr;
+	Knote *active_next  = nullptr;
+
+	Knote(uintptr_t ident, short filter, Plugin_context *context)
+	: ident(ident), filter(filter), context(context) { }
+};
+
+
+struct Libc::Kqueue : Plugin_context, Genode::List<Kqueue>::Element
+{
+	enum { CONTEXT_BUCKETS = 64, MAX_PENDING = 32 };
+
+	Genode::Allocator &alloc;
+
+	/* protects the knotes */
+	Genode::Lock lock;
+
+	Knote *fd_knotes[FD_SETSIZE];
+	Knote *context_knotes[CONTEXT_BUCKETS];
+	Knote *active_head = nullptr;
+	Knote *active_tail = nullptr;
+
+	/*
+	 * Notifications and closed fds are recorded separately because an
+	 * I/O response may arrive while 'kevent' holds 'lock', e.g., if the
+	 * readiness check of a plugin dispatches signals.
+	 */
+	Genode::Lock    pending_lock;
+	Plugin_context *pending[MAX_PENDING];
+	unsigned        num_pending = 0;
+	bool            pending_all = false;
+	fd_set          closed_fds;
+	bool            any_closed  = false;
+
+	/* lifetime, protected by the registry lock */
+	unsigned users  = 0;
+	bool     closed = false;
+
+	Kqueue(Genode::Allocator &alloc) : alloc(alloc)
+	{
+		for (unsigned i = 0; i < FD_SETSIZE; i++)
+			fd_knotes[i] = nullptr;
+
+		for (unsigned i = 0; i < CONTEXT_BUCKETS; i++)
+			context_knotes[i] = nullptr;
+
+		FD_ZERO(&closed_fds);
+	}
+
+	~Kqueue()
+	{
+		for (unsigned i = 0; i < FD_SETSIZE; i++)
+			remove_fd(i);
+	}
+
+	Knote *&context_bucket(Plugin_context *context)
+	{
+		return context_knotes[((Genode::addr_t)context >> 4) % CONTEXT_BUCKETS];
+	}
+
+	Knote *lookup(uintptr_t ident, short filter)
+	{
+		for (Knote *kn = fd_knotes[ident]; kn; kn = kn->fd_next)
+			if (kn->filter == filter)
+				return kn;
+		return nullptr;
+	}
+
+	void activate(Knote &kn)
+	{
+		if (kn.active)
+			return;
+
+		kn.active      = true;
+		kn.active_prev = active_tail;
+		kn.active_next = nullptr;
+
+		if (active_tail) active_tail->active_next = &kn;
+		else             active_head              = &kn;
+
+		active_tail = &kn;
+	}
+
+	void deactivate(Knote &kn)
+	{
+		if (!kn.active)
+			return;
+
+		if (kn.active_prev) kn.active_prev->active_next = kn.active_next;
+		else                active_head                 = kn.active_next;
+
+		if (kn.active_next) kn.active_next->active_prev = kn.active_prev;
+		else                active_tail                 = kn.active_prev;
+
+		kn.active      = false;
+		kn.active_prev = kn.active_next = nullptr;
+	}
+
+	void insert(Knote &kn)
+	{
+		kn.fd_next = fd_knotes[kn.ident];
+		fd_knotes[kn.ident] = &kn;
+
+		Knote *&bucket = context_bucket(kn.context);
+		kn.context_next = bucket;
+		bucket = &kn;
+	}
+
+	void remove(Knote &kn)
+	{
+		deactivate(kn);
+
+		for (Knote **k = &fd_knotes[kn.ident]; *k; k = &(*k)->fd_next)
+			if (*k == &kn) {
+				*k = kn.fd_next;
+				break;
+			}
+
+		for (Knote **k = &context_bucket(kn.context); *k; k = &(*k)->context_next)
+			if (*k == &kn) {
+				*k = kn.context_next;
+				break;
+			}
+
+		destroy(alloc, &kn);
+	}
+
+	void remove_fd(uintptr_t ident)
+	{
+		while (Knote *kn = fd_knotes[ident])
+			remove(*kn);
+	}
+
+
+	/*********************************************************
+	 ** Recording of notifications, without holding 'lock' **
+	 *********************************************************/
+
+	void notify(Plugin_context *context)
+	{
+		Genode::Lock::Guard guard(pending_lock);
+
+		if (!context || num_pending == MAX_PENDING) {
+			pending_all = true;
+			return;
+		}
+
+		for (unsigned i = 0; i < num_pending; i++)
+			if (pending[i] == context)
+				return;
+
+		pending[num_pending++] = context;
+	}
+
+	void fd_closed(int libc_fd)
+	{
+		Genode::Lock::Guard guard(pending_lock);
+
+		FD_SET(libc_fd, &closed_fds);
+		any_closed = true;
+	}
+
+	bool notified()
+	{
+		Genode::Lock::Guard guard(pending_lock);
+		return num_pending || pending_all;
+	}
+
+
+	/******************************
+	 ** Operations under 'lock' **
+	 ******************************/
+
+	/**
+	 * Apply the recorded notifications and closed fds
+	 */
+	void update()
+	{
+		Plugin_context *contexts[MAX_PENDING];
+		unsigned        num_contexts = 0;
+		bool            all          = false;
+		fd_set          closed;
+		bool            closed_valid = false;
+
+		{
+			Genode::Lock::Guard guard(pending_lock);
+
+			for (unsigned i = 0; i < num_pending; i++)
+				contexts[i] = pending[i];
+
+			num_contexts = num_pending;
+			all          = pending_all;
+			closed       = closed_fds;
+			closed_valid = any_closed;
+
+			num_pending = 0;
+			pending_all = false;
+			any_closed  = false;
+			FD_ZERO(&closed_fds);
+		}
+
+		if (closed_valid)
+			for (unsigned i = 0; i < FD_SETSIZE; i++)
+				if (FD_ISSET(i, &closed))
+					remove_fd(i);
+
+		/*
+		 * A notification without fd may concern any event. Edge-triggered
+		 * events are reported again if still ready, which is spurious at
+		 * worst, whereas ignoring it could lose new I/O.
+		 */
+		if (all)
+			for (unsigned i = 0; i < FD_SETSIZE; i++)
+				for (Knote *kn = fd_knotes[i]; kn; kn = kn->fd_next) {
+					kn->triggered = true;
+					activate(*kn);
+				}
+
+		for (unsigned i = 0; i < num_contexts; i++)
+			for (Knote *kn = context_bucket(contexts[i]); kn; kn = kn->context_next)
+				if (kn->context == contexts[i]) {
+					kn->triggered = true;
+					activate(*kn);
+				}
+	}
+
+	/**
+	 * Apply change to the registered events
+	 *
+	 * \return 0 or errno value
+	 */
+	int apply(struct kevent const &change)
+	{
+		if (change.filter != EVFILT_READ && change.filter != EVFILT_WRITE)
+			return EINVAL;
+
+		if (change.ident >= FD_SETSIZE)
+			return EBADF;
+
+		File_descriptor *fd =
+			file_descriptor_allocator()->find_by_libc_fd(change.ident);
+		if (!fd)
+			return EBADF;
+
+		Knote *kn = lookup(change.ident, change.filter);
+
+		if (change.flags & EV_DELETE) {
+			if (!kn)
+				return ENOENT;
+			remove(*kn);
+			return 0;
+		}
+
+		if (change.flags & EV_ADD) {
+			if (!kn) {
+				kn = new (alloc) Knote(change.ident, change.filter, fd->context);
+				insert(*kn);
+			}
+			kn->flags  = change.flags & (EV_ONESHOT | EV_CLEAR);
+			kn->fflags = change.fflags;
+			kn->udata  = change.udata;
+		}
+
+		if (!kn)
+			return ENOENT;
+
+		if (change.flags & EV_DISABLE)
+			kn->enabled = false;
+
+		if (change.flags & (EV_ENABLE | EV_ADD)) {
+			kn->enabled   = true;
+			kn->triggered = true;
+			activate(*kn);
+		}
+		return 0;
+	}
+
+	/**
+	 * Check the active events and report the ready ones
+	 *
+	 * \return number of events stored in 'events'
+	 */
+	int deliver(struct kevent *events, int nevents)
+	{
+		fd_set in_readfds, in_writefds, in_exceptfds;
+		FD_ZERO(&in_readfds);
+		FD_ZERO(&in_writefds);
+		FD_ZERO(&in_exceptfds);
+
+		int nfds = 0;
+		for (Knote *kn = active_head; kn; kn = kn->active_next) {
+			if (!kn->enabled)
+				continue;
+
+			FD_SET(kn->ident, kn->filter == EVFILT_READ ? &in_readfds
+			                                            : &in_writefds);
+			nfds = Genode::max(nfds, (int)kn->ident + 1);
+		}
+
+		fd_set readfds, writefds, exceptfds;
+		FD_ZERO(&readfds);
+		FD_ZERO(&writefds);
+
+		if (nfds)
+			Libc::select_scan(nfds, &in_readfds, &in_writefds, &in_exceptfds,
+			                  &readfds, &writefds, &exceptfds);
+
+		/* reported events that stay active are checked last next time */
+		Knote *reported_head = nullptr, *reported_tail = nullptr;
+
+		int n = 0;
+		for (Knote *kn = active_head, *next; kn; kn = next) {
+			next = kn->active_next;
+
+			if (!kn->enabled) {
+				deactivate(*kn);
+				continue;
+			}
+
+			bool const ready = FD_ISSET(kn->ident, kn->filter == EVFILT_READ
+			                                       ? &readfds : &writefds);
+
+			/*
+			 * An edge-triggered event is reported if the fd became ready
+			 * or if I/O happened since the last report
+			 */
+			bool const report = ready && (!(kn->flags & EV_CLEAR)
+			                              || kn->triggered || !kn->ready);
+
+			/* keep the state for the next call if 'events' is full */
+			if (report && n == nevents)
+				continue;
+
+			kn->ready     = ready;
+			kn->triggered = false;
+
+			/* a ready event is checked again to observe its next change */
+			if (!ready) {
+				deactivate(*kn);
+				continue;
+			}
+
+			if (!report)
+				continue;
+
+			struct kevent &ev = events[n++];
+			ev.ident  = kn->ident;
+			ev.filter = kn->filter;
+			ev.flags  = kn->flags;
+			ev.fflags = 0;
+			ev.data   = 1;
+			ev.udata  = kn->udata;
+
+			if (kn->flags & EV_ONESHOT) {
+				remove(*kn);
+				continue;
+			}
+
+			deactivate(*kn);
+			kn->active      = true;
+			kn->active_prev = reported_tail;
+			if (reported_tail) reported_tail->active_next = kn;
+			else               reported_head              = kn;
+			reported_tail = kn;
+		}
+
+		/* append the reported events to the active list */
+		if (reported_head) {
+			reported_head->active_prev = active_tail;
+			if (active_tail) active_tail->active_next = reported_head;
+			else             active_head              = reported_head;
+			active_tail = reported_tail;
+		}
+		return n;
+	}
+};
+
+
+namespace Libc {
+
+	/**
+	 * Registry of all kqueues, consulted by notifications and by 'close'
+	 */
+	struct Kqueue_registry
+	{
+		Genode::Lock         lock;
+		Genode::List<Kqueue> kqueues;
+	};
+
+	static Kqueue_registry &kqueue_registry()
+	{
+		static Kqueue_registry registry;
+		return registry;
+	}
+}
+
+
+struct Libc::Kqueue_plugin : Plugin
+{
+	int close(File_descriptor *fd) override
+	{
+		Kqueue_registry &registry = kqueue_registry();
+		Genode::Lock::Guard guard(registry.lock);
+
+		/* a concurrent 'kevent' destroys the kqueue when done */
+		Kqueue *kq = static_cast<Kqueue *>(fd->context);
+		registry.kqueues.remove(kq);
+		kq->closed = true;
+
+		file_descriptor_allocator()->free(fd);
+
+		if (!kq->users)
+			destroy(kq->alloc, kq);
+
+		return 0;
+	}
+};
+
+
+static Libc::Kqueue_plugin &kqueue_plugin()
+{
+	static Libc::Kqueue_plugin plugin;
+	return plugin;
+}
+
+
+static Libc::Allocator &kqueue_alloc()
+{
+	static Libc::Allocator alloc;
+	return alloc;
+}
+
+
+bool Libc::kqueue_notify(Plugin_context *context)
+{
+	Kqueue_registry &registry = kqueue_registry();
+	Genode::Lock::Guard guard(registry.lock);
+
+	for (Kqueue *kq = registry.kqueues.first(); kq; kq = kq->next())
+		kq->notify(context);
+
+	return registry.kqueues.first() != nullptr;
+}
+
+
+void Libc::kqueue_fd_closed(int libc_fd)
+{
+	if (libc_fd < 0 || libc_fd >= FD_SETSIZE)
+		return;
+
+	Kqueue_registry &registry = kqueue_registry();
+	Genode::Lock::Guard guard(registry.lock);
+
+	for (Kqueue *kq = registry.kqueues.first(); kq; kq = kq->next())
+		kq->fd_closed(libc_fd);
+}
+
+
+extern "C" int kqueue(void)
+{
+	Libc::Kqueue *kq = nullptr;
+	try { kq = new (kqueue_alloc()) Libc::Kqueue(kqueue_alloc()); }
+	catch (...) { return Libc::Errno(ENOMEM); }
+
+	Libc::File_descriptor *fd =
+		Libc::file_descriptor_allocator()->alloc(&kqueue_plugin(), kq);
+	if (!fd) {
+		destroy(kqueue_alloc(), kq);
+		return Libc::Errno(EMFILE);
+	}
+
+	/* plugins that report ready fds by 'libc_select_notify' */
+	Libc::init_select_notify();
+
+	Libc::Kqueue_registry &registry = Libc::kqueue_registry();
+	{
+		Genode::Lock::Guard guard(registry.lock);
+		registry.kqueues.insert(kq);
+	}
+	return fd->libc_fd;
+}
+
+
+extern "C" int kevent(int libc_fd,
+                      struct kevent const *changelist, int nchanges,
+                      struct kevent *eventlist, int nevents,
+                      struct timespec const *timeout)
+{
+	using namespace Libc;
+
+	/*
+	 * Keep the kqueue alive while in use, the fd may be closed
+	 * concurrently
+	 */
+	struct Use
+	{
+		Kqueue *kq = nullptr;
+
+		Use(int libc_fd)
+		{
+			Genode::Lock::Guard guard(kqueue_registry().lock);
+
+			File_descriptor *fd =
+				file_descriptor_allocator()->find_by_libc_fd(libc_fd);
+			if (!fd || fd->plugin != &kqueue_plugin())
+				return;
+
+			kq = static_cast<Kqueue *>(fd->context);
+			kq->users++;
+		}
+
+		~Use()
+		{
+			if (!kq)
+				return;
+
+			Genode::Lock::Guard guard(kqueue_registry().lock);
+
+			if (--kq->users == 0 && kq->closed)
+				destroy(kq->alloc, kq);
+		}
+	} use { libc_fd };
+
+	if (!use.kq)
+		return Errno(EBADF);
+
+	Kqueue &kq = *use.kq;
+
+	int n = 0;
+	{
+		Genode::Lock::Guard guard(kq.lock);
+
+		/* forget the events of fds closed in the meantime */
+		kq.update();
+
+		/* apply changes, errors are reported as events if possible */
+		for (int i = 0; i < nchanges; i++) {
+			int const err = kq.apply(changelist[i]);
+			if (!err)
+				continue;
+
+			if (n == nevents)
+				return Errno(err);
+
+			eventlist[n]       = changelist[i];
+			eventlist[n].flags = EV_ERROR;
+			eventlist[n].data  = err;
+			n++;
+		}
+	}
+
+	if (n || !nevents)
+		return n;
+
+	unsigned long duration_ms = timeout ? timeout->tv_sec*1000
+	                                    + timeout->tv_nsec/1000000 : 0;
+	bool const polling = timeout && duration_ms == 0;
+
+	for (;;) {
+		{
+			Genode::Lock::Guard guard(kq.lock);
+
+			kq.update();
+
+			n = kq.deliver(eventlist, nevents);
+			if (n || polling)
+				return n;
+		}
+
+		/* wait for notifications */
+		struct Check : Suspend_functor
+		{
+			Kqueue &kq;
+
+			Check(Kqueue &kq) : kq(kq) { }
+
+			bool suspend() override { return !kq.notified(); }
+
+		} check { kq };
+
+		if (!timeout) {
+			suspend(check);
+			continue;
+		}
+
+		duration_ms = suspend(check, duration_ms);
+		if (duration_ms == 0)
+			return 0;
+	}
+}
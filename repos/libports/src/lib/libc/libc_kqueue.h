@@ -0,0 +1,47 @@
+/*
+ * \brief  Libc-internal interface of the kqueue implementation
+ * \author Genode Labs
+ * \date   2017-04-07
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _LIBC_KQUEUE_H_
+#define _LIBC_KQUEUE_H_
+
+/* Genode-specific libc interfaces */
+#include <libc-plugin/fd_alloc.h>
+
+namespace Libc {
+
+	/**
+	 * Record I/O progress for the kqueues
+	 *
+	 * \param context  context of the fds that may have become ready, or
+	 *                 nullptr if the fds are unknown
+	 *
+	 * \return true if a kqueue exists
+	 */
+	bool kqueue_notify(Plugin_context *context);
+
+	/**
+	 * Remove the events of a closed fd from the kqueues
+	 */
+	void kqueue_fd_closed(int libc_fd);
+
+	/**
+	 * Let the I/O responses of the VFS handle of 'fd' refer to 'context'
+	 *
+	 * By default, the responses refer to the context of 'fd' itself. A
+	 * plugin that implements its fds on top of VFS fds, e.g., sockets,
+	 * directs the responses to the context of its own fd.
+	 */
+	void vfs_io_context(File_descriptor *fd, Plugin_context *context);
+}
+
+#endif /* _LIBC_KQUEUE_H_ */
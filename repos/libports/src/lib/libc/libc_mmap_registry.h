@@ -11,6 +11,7 @@
 #include <base/lock.h>
 #include <base/env.h>
 #include <base/log.h>
+#include <util/misc_math.h>
 #include <libc/allocator.h>
 
 /* libc-internal includes */
@@ -36,11 +37,12 @@ class Libc::Mmap_registry
 
 		struct Entry : Genode::List<Entry>::Element
 		{
-			void   * const start;
-			Plugin * const plugin;
+			void          * const start;
+			Genode::size_t  const length;
+			Plugin        * const plugin;
 
-			Entry(void *start, Plugin *plugin)
-			: start(start), plugin(plugin) { }
+			Entry(void *start, Genode::size_t length, Plugin *plugin)
+			: start(start), length(length), plugin(plugin) { }
 		};
 
 	private:
@@ -86,7 +88,7 @@ class Libc::Mmap_registry
 				return;
 			}
 
-			_list.insert(new (&_md_alloc) Entry(start, plugin));
+			_list.insert(new (&_md_alloc) Entry(start, len, plugin));
 		}
 
 		Plugin *lookup_plugin_by_addr(void *start) const
@@ -104,6 +106,47 @@ class Libc::Mmap_registry
 			return _lookup_by_addr_unsynchronized(start) != 0;
 		}
 
+		/**
+		 * Return true if the range covers the region registered at 'start'
+		 *
+		 * The lengths are compared in units of pages because a mapping
+		 * always spans whole pages.
+		 */
+		bool covers(void *start, Genode::size_t length) const
+		{
+			Genode::Lock::Guard guard(_lock);
+
+			enum { PAGE_SIZE_LOG2 = 12 };
+
+			Entry const * const e = _lookup_by_addr_unsynchronized(start);
+
+			return e && length
+			    && Genode::align_addr(length,    (int)PAGE_SIZE_LOG2)
+			    == Genode::align_addr(e->length, (int)PAGE_SIZE_LOG2);
+		}
+
+		/**
+		 * Look up region that contains 'addr'
+		 *
+		 * \param plugin  plugin that was used for the mmap, or 0 for
+		 *                anonymous memory
+		 *
+		 * \return false if 'addr' is not part of any registered region
+		 */
+		bool lookup_by_range(void *addr, Plugin *&plugin) const
+		{
+			Genode::Lock::Guard guard(_lock);
+
+			for (Entry const *e = _list.first(); e; e = e->next())
+				if ((char *)addr >= (char *)e->start
+				 && (char *)addr <  (char *)e->start + e->length) {
+					plugin = e->plugin;
+					return true;
+				}
+
+			return false;
+		}
+
 		void remove(void *start)
 		{
 			Genode::Lock::Guard guard(_lock);
@@ -16,6 +16,7 @@
 #include <base/env.h>
 #include <base/log.h>
 #include <base/slab.h>
+#include <base/thread.h>
 #include <util/construct_at.h>
 #include <util/string.h>
 #include <util/misc_math.h>
@@ -63,12 +64,29 @@ namespace Genode {
 
 /**
  * Allocator that uses slabs for small objects sizes
+ *
+ * The slabs are shared by all threads and protected by a lock. To avoid
+ * taking the lock for each allocation, each thread caches free blocks of
+ * each slab size in a magazine. An empty magazine is refilled with a batch
+ * of blocks taken from the slab, a full magazine is drained into the slab
+ * by half. A block freed by another thread than the allocating one goes to
+ * the magazine of the freeing thread, which is fine because the blocks of
+ * a slab are interchangeable.
+ *
+ * The cache of a thread is located via the stack pointer: each thread owns
+ * a distinct stack within the stack area, and the index of the stack
+ * selects the cache. Hence, a cache is accessed by its owner only and
+ * needs no synchronization. The cache of an exited thread is inherited by
+ * the next thread that uses the same stack. Threads outside the stack
+ * area, i.e., the initial thread of the component, use the slabs
+ * directly.
  */
 class Malloc : public Genode::Allocator
 {
 	private:
 
 		typedef Genode::size_t size_t;
+		typedef Genode::addr_t addr_t;
 
 		enum {
 			SLAB_START = 2,  /* 4 Byte (log2) */
@@ -76,10 +94,42 @@ class Malloc : public Genode::Allocator
 			NUM_SLABS = (SLAB_STOP - SLAB_START) + 1
 		};
 
+		enum {
+			MAGAZINE_SIZE  = 64,
+			MAGAZINE_BYTES = 16*1024, /* limit of cached bytes per slab */
+		};
+
+		struct Magazine
+		{
+			unsigned count = 0;
+			unsigned capacity = 0;
+			void    *blocks[MAGAZINE_SIZE];
+		};
+
+		struct Thread_cache
+		{
+			Magazine magazine[NUM_SLABS];
+
+			Thread_cache()
+			{
+				for (unsigned i = SLAB_START; i <= SLAB_STOP; i++)
+					magazine[i - SLAB_START].capacity =
+						Genode::max(8U, Genode::min((unsigned)MAGAZINE_SIZE,
+						                            (unsigned)MAGAZINE_BYTES >> i));
+			}
+		};
+
 		Genode::Allocator  *_backing_store;        /* back-end allocator */
 		Genode::Slab_alloc *_allocator[NUM_SLABS]; /* slab allocators */
 		Genode::Lock        _lock;
 
+		/* thread caches indexed by stack */
+		addr_t  const  _stack_area_base = Genode::Thread::stack_area_virtual_base();
+		size_t  const  _stack_area_size = Genode::Thread::stack_area_virtual_size();
+		size_t  const  _stack_size      = Genode::Thread::stack_virtual_size();
+		unsigned const _num_caches      = _stack_area_size / _stack_size;
+		Thread_cache **_caches          = nullptr;
+
 		unsigned long _slab_log2(unsigned long size) const
 		{
 			unsigned msb = Genode::log2(size);
@@ -94,6 +144,83 @@ class Malloc : public Genode::Allocator
 			return msb;
 		}
 
+		/**
+		 * Return cache of the calling thread or nullptr
+		 */
+		Thread_cache *_thread_cache()
+		{
+			int dummy = 0; /* used for determining the stack pointer */
+
+			addr_t const sp = (addr_t)&dummy;
+			if (!_caches || sp < _stack_area_base
+			 || sp >= _stack_area_base + _stack_area_size)
+				return nullptr;
+
+			Thread_cache *&cache = _caches[(sp - _stack_area_base) / _stack_size];
+			if (!cache) {
+				Genode::Lock::Guard lock_guard(_lock);
+				try { cache = new (_backing_store) Thread_cache; }
+				catch (...) { }
+			}
+			return cache;
+		}
+
+		/**
+		 * Fill half of the magazine with blocks of the slab
+		 */
+		void _refill(Magazine &m, unsigned long msb)
+		{
+			Genode::Lock::Guard lock_guard(_lock);
+
+			Genode::Slab_alloc &slab = *_allocator[msb - SLAB_START];
+			while (m.count < m.capacity/2)
+				if (!(m.blocks[m.count] = slab.alloc()))
+					return;
+				else
+					m.count++;
+		}
+
+		/**
+		 * Return half of the magazine to the slab
+		 */
+		void _drain(Magazine &m, unsigned long msb)
+		{
+			Genode::Lock::Guard lock_guard(_lock);
+
+			Genode::Slab_alloc &slab = *_allocator[msb - SLAB_START];
+			while (m.count > m.capacity/2)
+				slab.free(m.blocks[--m.count]);
+		}
+
+		void *_slab_alloc(unsigned long msb)
+		{
+			if (Thread_cache *cache = _thread_cache()) {
+				Magazine &m = cache->magazine[msb - SLAB_START];
+				if (!m.count)
+					_refill(m, msb);
+
+				return m.count ? m.blocks[--m.count] : 0;
+			}
+
+			Genode::Lock::Guard lock_guard(_lock);
+			return _allocator[msb - SLAB_START]->alloc();
+		}
+
+		void _slab_free(void *addr, unsigned long msb)
+		{
+			if (Thread_cache *cache = _thread_cache()) {
+				Magazine &m = cache->magazine[msb - SLAB_START];
+				if (m.count == m.capacity)
+					_drain(m, msb);
+
+				m.blocks[m.count++] = addr;
+				return;
+			}
+
+			Genode::Lock::Guard lock_guard(_lock);
+			_allocator[msb - SLAB_START]->free(addr);
+		}
+
 	public:
 
 		Malloc(Genode::Allocator *backing_store) : _backing_store(backing_store)
@@ -102,6 +229,12 @@ class Malloc : public Genode::Allocator
 				_allocator[i - SLAB_START] = new (backing_store)
 				                                 Genode::Slab_alloc(1U << i, backing_store);
 			}
+
+			size_t const caches_size = _num_caches*sizeof(Thread_cache *);
+			if (_backing_store->alloc(caches_size, (void **)&_caches))
+				Genode::memset(_caches, 0, caches_size);
+			else
+				_caches = nullptr;
 		}
 
 		~Malloc() { Genode::warning(__func__, " unexpectedly called"); }
@@ -112,8 +245,6 @@ class Malloc : public Genode::Allocator
 
 		bool alloc(size_t size, void **out_addr) override
 		{
-			Genode::Lock::Guard lock_guard(_lock);
-
 			/* enforce size to be a multiple of 4 bytes */
 			size = (size + 3) & ~3;
 
@@ -130,11 +261,12 @@ class Malloc : public Genode::Allocator
 			/* use backing store if requested memory is larger than largest slab */
 			if (msb > SLAB_STOP) {
 
+				Genode::Lock::Guard lock_guard(_lock);
 				if (!(_backing_store->alloc(real_size, &addr)))
 					return false;
 			}
 			else
-				if (!(addr = _allocator[msb - SLAB_START]->alloc()))
+				if (!(addr = _slab_alloc(msb)))
 					return false;
 
 			*(Block_header *)addr = real_size;
@@ -144,16 +276,14 @@ class Malloc : public Genode::Allocator
 
 		void free(void *ptr, size_t /* size */) override
 		{
-			Genode::Lock::Guard lock_guard(_lock);
-
 			unsigned long *addr = ((unsigned long *)ptr) - 1;
 			unsigned long  real_size = *addr;
 
-			if (real_size > (1U << SLAB_STOP))
+			if (real_size > (1U << SLAB_STOP)) {
+				Genode::Lock::Guard lock_guard(_lock);
 				_backing_store->free(addr, real_size);
-			else {
-				unsigned long msb = _slab_log2(real_size);
-				_allocator[msb - SLAB_START]->free(addr);
+			} else {
+				_slab_free(addr, _slab_log2(real_size));
 			}
 		}
 
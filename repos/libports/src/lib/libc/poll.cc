@@ -19,6 +19,7 @@
 #include <libc-plugin/plugin.h>
 #include <sys/select.h>
 #include <sys/poll.h>
+#include <errno.h>
 #include <stdlib.h>
 
 using namespace Libc;
@@ -54,12 +55,16 @@ poll(struct pollfd fds[], nfds_t nfds, int timeout)
 	for (i = 0; i < nfds; i++) {
 		fd = fds[i].fd;
 		if (fd >= (int)FD_SETSIZE) {
-			/*errno = EINVAL;*/
+			errno = EINVAL;
 			return -1;
 		}
 		maxfd = MAX(maxfd, fd);
 	}
 
+	FD_ZERO(&readfds);
+	FD_ZERO(&writefds);
+	FD_ZERO(&exceptfds);
+
 	/* populate event bit vectors for the events we're interested in */
 	for (i = 0; i < nfds; i++) {
 		fd = fds[i].fd;
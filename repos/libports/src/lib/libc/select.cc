@@ -32,12 +32,30 @@
 #include <sys/select.h>
 #include <signal.h>
 
+#include "libc_kqueue.h"
 #include "task.h"
 
 
 namespace Libc {
 	struct Select_cb;
 	struct Select_cb_list;
+
+	/**
+	 * Determine ready fds of all plugins without blocking
+	 */
+	int select_scan(int nfds,
+	                fd_set *in_readfds,  fd_set *in_writefds,  fd_set *in_exceptfds,
+	                fd_set *out_readfds, fd_set *out_writefds, fd_set *out_exceptfds);
+
+	/**
+	 * Install the notification function called by plugins for ready fds
+	 */
+	void init_select_notify();
+
+	/**
+	 * Resume the select() calls that wait for fds that became ready
+	 */
+	void select_wakeup();
 }
 
 
@@ -174,8 +192,7 @@ static int selscan(int nfds,
 }
 
 
-/* this function gets called by plugin backends when file descripors become ready */
-static void select_notify()
+void Libc::select_wakeup()
 {
 	bool resume_all = false;
 	fd_set tmp_readfds, tmp_writefds, tmp_exceptfds;
@@ -201,6 +218,33 @@ static void select_notify()
 }
 
 
+/* this function gets called by plugin backends when file descripors become ready */
+static void select_notify()
+{
+	/* the plugin does not tell which fds became ready */
+	if (Libc::kqueue_notify(nullptr))
+		Libc::resume_all();
+
+	Libc::select_wakeup();
+}
+
+
+int Libc::select_scan(int nfds,
+                      fd_set *in_readfds,  fd_set *in_writefds,  fd_set *in_exceptfds,
+                      fd_set *out_readfds, fd_set *out_writefds, fd_set *out_exceptfds)
+{
+	return selscan(nfds, in_readfds, in_writefds, in_exceptfds,
+	               out_readfds, out_writefds, out_exceptfds);
+}
+
+
+void Libc::init_select_notify()
+{
+	if (!libc_select_notify)
+		libc_select_notify = select_notify;
+}
+
+
 static void print(Genode::Output &output, timeval *tv)
 {
 	if (!tv) {
@@ -35,6 +35,7 @@
 #include "socket_fs_plugin.h"
 #include "libc_file.h"
 #include "libc_errno.h"
+#include "libc_kqueue.h"
 #include "task.h"
 
 
@@ -98,6 +99,11 @@ namespace {
 				Genode::error(__func__, ": ", file_name, " file not accessible");
 				throw Inaccessible();
 			}
+
+			/* I/O of the file concerns the socket */
+			Libc::vfs_io_context(
+				Libc::file_descriptor_allocator()->find_by_libc_fd(fd), this);
+
 			return fd;
 		}
 
@@ -762,6 +768,10 @@ int Socket_plugin::select(int nfds,
 
 	for (int fd = 0; fd < nfds; ++fd) {
 
+		/* look up the requested fds only */
+		if (!FD_ISSET(fd, &in_readfds) && !FD_ISSET(fd, &in_writefds))
+			continue;
+
 		Libc::File_descriptor *fdo =
 			Libc::file_descriptor_allocator()->find_by_libc_fd(fd);
 
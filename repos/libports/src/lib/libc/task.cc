@@ -35,6 +35,7 @@
 #include <base/internal/unmanaged_singleton.h>
 #include "vfs_plugin.h"
 #include "libc_init.h"
+#include "libc_kqueue.h"
 #include "task.h"
 
 
@@ -323,13 +324,18 @@ struct Libc::Pthreads
 
 extern void (*libc_select_notify)();
 
+namespace Libc { void select_wakeup(); }
+
 struct Libc::Io_response_handler : Vfs::Io_response_handler
 {
-	void handle_io_response(Vfs::Vfs_handle::Context *) override
+	void handle_io_response(Vfs::Vfs_handle::Context *context) override
 	{
+		/* the contexts of the libc's VFS handles are fd contexts */
+		Libc::kqueue_notify(reinterpret_cast<Libc::Plugin_context *>(context));
+
 		/* some contexts may have been deblocked from select() */
 		if (libc_select_notify)
-			libc_select_notify();
+			Libc::select_wakeup();
 
 		/* resume all as any context may have been deblocked from blocking I/O */
 		Libc::resume_all();
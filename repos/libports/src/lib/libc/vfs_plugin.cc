@@ -16,6 +16,7 @@
 /* Genode includes */
 #include <base/env.h>
 #include <base/log.h>
+#include <dataspace/client.h>
 #include <vfs/dir_file_system.h>
 
 /* libc includes */
@@ -39,6 +40,7 @@
 /* libc-internal includes */
 #include "libc_mem_alloc.h"
 #include "libc_errno.h"
+#include "libc_kqueue.h"
 #include "task.h"
 
 
@@ -54,6 +56,13 @@ static Libc::Plugin_context *vfs_context(Vfs::Vfs_handle *vfs_handle)
 }
 
 
+void Libc::vfs_io_context(Libc::File_descriptor *fd, Libc::Plugin_context *context)
+{
+	/* the I/O response handler converts the context back, see 'task.cc' */
+	vfs_handle(fd)->context = reinterpret_cast<Vfs::Vfs_handle::Context *>(context);
+}
+
+
 /**
  * Utility to convert VFS stat struct to the libc stat struct
  *
@@ -190,6 +199,8 @@ Libc::File_descriptor *Libc::Vfs_plugin::open(char const *path, int flags,
 	Libc::File_descriptor *fd =
 		Libc::file_descriptor_allocator()->alloc(this, vfs_context(handle), libc_fd);
 
+	vfs_io_context(fd, fd->context);
+
 	fd->status = flags;
 
 	if ((flags & O_TRUNC) && (ftruncate(fd, 0) == -1)) {
@@ -737,38 +748,174 @@ int Libc::Vfs_plugin::rename(char const *from_path, char const *to_path)
 }
 
 
-void *Libc::Vfs_plugin::mmap(void *addr_in, ::size_t length, int prot, int flags,
-                             Libc::File_descriptor *fd, ::off_t offset)
+Libc::Vfs_plugin::Mapping *Libc::Vfs_plugin::_lookup_mapping(void *addr)
 {
-	if (prot != PROT_READ) {
-		Genode::error("mmap for prot=", Genode::Hex(prot), " not supported");
-		errno = EACCES;
-		return (void *)-1;
+	for (Mapping *m = _mappings.first(); m; m = m->next())
+		if ((char *)addr >= (char *)m->addr
+		 && (char *)addr <  (char *)m->addr + m->length)
+			return m;
+
+	return nullptr;
+}
+
+
+/**
+ * Attach the dataspace provided by the VFS for the mapped file
+ *
+ * ROM modules are handed out without copying. File systems that have to
+ * copy the file into a fresh dataspace, e.g., the ram file system, are
+ * still cheaper than a read of the same size through the libc.
+ *
+ * \return nullptr if no suitable dataspace is available
+ */
+void *Libc::Vfs_plugin::_attach_dataspace(Libc::File_descriptor *fd,
+                                          ::size_t length, ::off_t offset,
+                                          bool executable)
+{
+	if (!fd->fd_path)
+		return nullptr;
+
+	Genode::Dataspace_capability ds = _root_dir.dataspace(fd->fd_path);
+	if (!ds.valid())
+		return nullptr;
+
+	/* the dataspace must back the whole mapping */
+	::size_t const ds_size = Genode::Dataspace_client(ds).size();
+	if ((::size_t)offset >= ds_size || ds_size - offset < length) {
+		_root_dir.release(fd->fd_path, ds);
+		return nullptr;
+	}
+
+	void *addr = nullptr;
+	try {
+		addr = _env.rm().attach(ds, length, offset, false, (Genode::addr_t)0,
+		                        executable);
+	} catch (...) {
+		_root_dir.release(fd->fd_path, ds);
+		return nullptr;
+	}
+
+	Genode::Lock::Guard guard(_mappings_lock);
+	_mappings.insert(new (_alloc)
+		Mapping(addr, length, ds, fd->fd_path, nullptr, 0, 0));
+
+	return addr;
+}
+
+
+/**
+ * Write range of a shared mapping back to the file
+ *
+ * \param from  offset relative to the start of the mapping
+ */
+int Libc::Vfs_plugin::_write_back(Mapping const &m, ::size_t from, ::size_t len)
+{
+	typedef Vfs::File_io_service::Write_result Result;
+
+	/* the part of the mapping beyond the end of the file is not written */
+	if (!m.sync_handle || from >= m.sync_length)
+		return 0;
+
+	len = Genode::min(len, m.sync_length - from);
+
+	char const *src = (char const *)m.addr + from;
+
+	Vfs::Vfs_handle &handle = *m.sync_handle;
+
+	handle.seek(m.offset + from);
+	while (len) {
+		Vfs::file_size n = 0;
+		if (handle.fs().write(&handle, src, len, n) != Result::WRITE_OK || !n) {
+			errno = EIO;
+			return -1;
+		}
+		handle.advance_seek(n);
+		src += n;
+		len -= n;
 	}
+	return 0;
+}
 
+
+void *Libc::Vfs_plugin::mmap(void *addr_in, ::size_t length, int prot, int flags,
+                             Libc::File_descriptor *fd, ::off_t offset)
+{
 	if (addr_in != 0) {
 		Genode::error("mmap for predefined address not supported");
 		errno = EINVAL;
-		return (void *)-1;
+		return MAP_FAILED;
+	}
+
+	if (!length || (offset & ((1 << PAGE_SHIFT) - 1))) {
+		errno = EINVAL;
+		return MAP_FAILED;
 	}
 
+	bool const writeable = prot & PROT_WRITE;
+	bool const shared    = flags & MAP_SHARED;
+
+	/* the file must be readable and, for a shared writeable mapping, writeable */
+	int const mode = fd->status & O_ACCMODE;
+	if (mode == O_WRONLY || (writeable && shared && mode == O_RDONLY)) {
+		errno = EACCES;
+		return MAP_FAILED;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) == -1)
+		return MAP_FAILED;
+
+	/* number of mapped bytes that are backed by the file */
+	::size_t const file_size = st.st_size;
+	::size_t const in_file   = (::size_t)offset < file_size
+	                         ? Genode::min(length, file_size - offset) : 0;
+
 	/*
-	 * XXX attempt to obtain memory mapping via
-	 *     'Vfs::Directory_service::dataspace'.
+	 * Read-only mappings are backed by the dataspace of the file if the
+	 * mapping covers the major part of the file. Otherwise, a file system
+	 * that copies the whole file into the dataspace would do more work than
+	 * reading the mapped range.
 	 */
+	if (!writeable && in_file && in_file*2 >= file_size)
+		if (void *addr = _attach_dataspace(fd, length, offset, prot & PROT_EXEC))
+			return addr;
 
 	void *addr = Libc::mem_alloc()->alloc(length, PAGE_SHIFT);
-	if (addr == (void *)-1) {
+	if (addr == (void *)-1 || addr == nullptr) {
 		errno = ENOMEM;
-		return (void *)-1;
+		return MAP_FAILED;
 	}
 
-	if (::pread(fd->libc_fd, addr, length, offset) < 0) {
+	/* read the mapped range only, the remainder reads as zero */
+	if (in_file && ::pread(fd->libc_fd, addr, in_file, offset) < 0) {
 		Genode::error("mmap could not obtain file content");
-		::munmap(addr, length);
+		Libc::mem_alloc()->free(addr);
 		errno = EACCES;
-		return (void *)-1;
+		return MAP_FAILED;
 	}
+	::memset((char *)addr + in_file, 0, length - in_file);
+
+	/* private or read-only mappings need no bookkeeping */
+	if (!writeable || !shared)
+		return addr;
+
+	/*
+	 * The application may close 'fd' while the mapping exists. Hence, open
+	 * the file anew for writing back the mapping.
+	 */
+	Vfs::Vfs_handle *sync_handle = nullptr;
+	if (!fd->fd_path
+	 || _root_dir.open(fd->fd_path, O_WRONLY, &sync_handle, _alloc)
+	    != Vfs::Directory_service::OPEN_OK) {
+		Libc::mem_alloc()->free(addr);
+		errno = EACCES;
+		return MAP_FAILED;
+	}
+
+	Genode::Lock::Guard guard(_mappings_lock);
+	_mappings.insert(new (_alloc)
+		Mapping(addr, length, Genode::Dataspace_capability(), fd->fd_path,
+		        sync_handle, offset, in_file));
 
 	return addr;
 }
@@ -776,7 +923,56 @@ void *Libc::Vfs_plugin::mmap(void *addr_in, ::size_t length, int prot, int flags
 
 int Libc::Vfs_plugin::munmap(void *addr, ::size_t)
 {
-	Libc::mem_alloc()->free(addr);
+	Mapping *m = nullptr;
+	{
+		Genode::Lock::Guard guard(_mappings_lock);
+		m = _lookup_mapping(addr);
+		if (m)
+			_mappings.remove(m);
+	}
+
+	if (!m) {
+		Libc::mem_alloc()->free(addr);
+		return 0;
+	}
+
+	int result = 0;
+	if (m->ds.valid()) {
+		_env.rm().detach(m->addr);
+		_root_dir.release(m->path.string(), m->ds);
+	} else {
+		result = _write_back(*m, 0, m->length);
+		m->sync_handle->ds().close(m->sync_handle);
+		Libc::mem_alloc()->free(m->addr);
+	}
+
+	destroy(_alloc, m);
+	return result;
+}
+
+
+int Libc::Vfs_plugin::msync(void *addr, ::size_t length, int flags)
+{
+	/*
+	 * The lock is held while writing back so that a concurrent 'munmap'
+	 * cannot free the mapping.
+	 */
+	Genode::Lock::Guard guard(_mappings_lock);
+
+	Mapping * const m = _lookup_mapping(addr);
+
+	/* private and read-only mappings have nothing to write back */
+	if (!m || !m->sync_handle)
+		return 0;
+
+	::size_t const from = (char *)addr - (char *)m->addr;
+
+	if (_write_back(*m, from, Genode::min(length, m->length - from)) == -1)
+		return -1;
+
+	if (flags & MS_SYNC)
+		_root_dir.sync(m->path.string());
+
 	return 0;
 }
 
@@ -818,6 +1014,10 @@ int Libc::Vfs_plugin::select(int nfds,
 
 	for (int fd = 0; fd < nfds; ++fd) {
 
+		/* look up the requested fds only */
+		if (!FD_ISSET(fd, &in_readfds) && !FD_ISSET(fd, &in_writefds))
+			continue;
+
 		Libc::File_descriptor *fdo =
 			Libc::file_descriptor_allocator()->find_by_libc_fd(fd);
 
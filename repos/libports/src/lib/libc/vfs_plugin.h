@@ -17,6 +17,8 @@
 #define _LIBC_VFS__PLUGIN_H_
 
 /* Genode includes */
+#include <base/lock.h>
+#include <util/list.h>
 #include <libc/component.h>
 
 /* libc includes */
@@ -34,10 +36,54 @@ class Libc::Vfs_plugin : public Libc::Plugin
 {
 	private:
 
+		/**
+		 * File-backed memory mapping
+		 *
+		 * A mapping is either a dataspace obtained from the VFS and attached
+		 * read-only, or a copy of the mapped file range. The copy of a
+		 * writeable 'MAP_SHARED' mapping is written back via 'sync_handle',
+		 * a VFS handle of its own that stays valid after the application
+		 * closed the mapped file. It is not registered as a file descriptor
+		 * and thereby invisible to the application.
+		 */
+		struct Mapping : Genode::List<Mapping>::Element
+		{
+			typedef Genode::String<Vfs::MAX_PATH_LEN> Path;
+
+			void                       * const addr;
+			::size_t                     const length;
+			Genode::Dataspace_capability const ds;
+			Path                         const path;
+			Vfs::Vfs_handle            * const sync_handle;
+			::off_t                      const offset;
+			::size_t                     const sync_length;
+
+			Mapping(void *addr, ::size_t length,
+			        Genode::Dataspace_capability ds, char const *path,
+			        Vfs::Vfs_handle *sync_handle, ::off_t offset,
+			        ::size_t sync_length)
+			:
+				addr(addr), length(length), ds(ds), path(path),
+				sync_handle(sync_handle), offset(offset),
+				sync_length(sync_length)
+			{ }
+		};
+
+		Genode::Env       &_env;
 		Genode::Allocator &_alloc;
 
 		Vfs::File_system &_root_dir;
 
+		Genode::List<Mapping> _mappings;
+		Genode::Lock          _mappings_lock;
+
+		Mapping *_lookup_mapping(void *addr);
+
+		void *_attach_dataspace(Libc::File_descriptor *, ::size_t, ::off_t,
+		                        bool executable);
+
+		int _write_back(Mapping const &, ::size_t from, ::size_t len);
+
 		void _open_stdio(Genode::Xml_node const &node, char const *attr,
 		                 int libc_fd, unsigned flags)
 		{
@@ -76,7 +122,7 @@ class Libc::Vfs_plugin : public Libc::Plugin
 
 		Vfs_plugin(Libc::Env &env, Genode::Allocator &alloc)
 		:
-			_alloc(alloc), _root_dir(env.vfs())
+			_env(env), _alloc(alloc), _root_dir(env.vfs())
 		{
 			using Genode::Xml_node;
 
@@ -142,6 +188,7 @@ class Libc::Vfs_plugin : public Libc::Plugin
 		ssize_t write(Libc::File_descriptor *, const void *, ::size_t ) override;
 		void   *mmap(void *, ::size_t, int, int, Libc::File_descriptor *, ::off_t) override;
 		int     munmap(void *, ::size_t) override;
+		int     msync(void *, ::size_t, int) override;
 		int     select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct timeval *timeout) override;
 };
 
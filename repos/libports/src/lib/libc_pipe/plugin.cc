@@ -346,6 +346,10 @@ namespace Libc_pipe {
 
 		for (int libc_fd = 0; libc_fd < nfds; libc_fd++) {
 
+			/* look up the requested fds only */
+			if (!FD_ISSET(libc_fd, &in_readfds) && !FD_ISSET(libc_fd, &in_writefds))
+				continue;
+
 			fdo = Libc::file_descriptor_allocator()->find_by_libc_fd(libc_fd);
 
 			/* handle only libc_fds that belong to this plugin */
@@ -0,0 +1,26 @@
+/*
+ * \brief  Checksum routine of lwIP backed by Genode's net library
+ * \author Genode Labs
+ * \date   2017-03-24
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <net/checksum.h>
+
+
+/**
+ * Return the non-inverted one's-complement sum as expected by 'LWIP_CHKSUM'
+ *
+ * Like lwIP's own implementations, the sum is in network byte order.
+ */
+extern "C" unsigned short genode_lwip_chksum(void const *data, int len)
+{
+	return Net::internet_sum(data, len);
+}
@@ -0,0 +1,183 @@
+/*
+ * \brief  Test kqueue() and kevent() in libc
+ * \author Genode Labs
+ * \date   2017-04-07
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* libc includes */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/event.h>
+#include <sys/time.h>
+#include <sys/types.h>
+
+
+static struct timespec const zero_timeout = { 0, 0 };
+
+
+static void fail(char const *msg)
+{
+	fprintf(stderr, "Error: %s\n", msg);
+	exit(1);
+}
+
+
+static void change(int kq, int fd, short filter, u_short flags)
+{
+	struct kevent ev;
+	EV_SET(&ev, fd, filter, flags, 0, 0, 0);
+
+	if (kevent(kq, &ev, 1, 0, 0, 0) != 0)
+		fail("could not change event");
+}
+
+
+/**
+ * Return number of ready events, check that 'fd' is the only one reported
+ */
+static int poll_events(int kq, int fd, struct timespec const *timeout = &zero_timeout)
+{
+	struct kevent ev[4];
+
+	int const n = kevent(kq, 0, 0, ev, 4, timeout);
+	if (n < 0)
+		fail("kevent failed");
+
+	for (int i = 0; i < n; i++)
+		if ((int)ev[i].ident != fd)
+			fail("unexpected event reported");
+
+	return n;
+}
+
+
+static void write_byte(int fd)
+{
+	if (write(fd, "x", 1) != 1)
+		fail("could not write to pipe");
+}
+
+
+static void read_byte(int fd)
+{
+	char c;
+	if (read(fd, &c, 1) != 1)
+		fail("could not read from pipe");
+}
+
+
+int main(int argc, char *argv[])
+{
+	int const kq = kqueue();
+	if (kq < 0)
+		fail("could not create kqueue");
+
+	int level[2], edge[2];
+	if (pipe(level) != 0 || pipe(edge) != 0)
+		fail("could not create pipes");
+
+	/* level-triggered events are reported while the fd is ready */
+	change(kq, level[0], EVFILT_READ, EV_ADD);
+
+	if (poll_events(kq, level[0]) != 0)
+		fail("empty pipe reported ready");
+
+	write_byte(level[1]);
+
+	if (poll_events(kq, level[0]) != 1 || poll_events(kq, level[0]) != 1)
+		fail("level-triggered event not reported repeatedly");
+
+	read_byte(level[0]);
+
+	if (poll_events(kq, level[0]) != 0)
+		fail("drained pipe reported ready");
+
+	printf("level-triggered event ok\n");
+
+	/* edge-triggered events are reported once per I/O */
+	change(kq, level[0], EVFILT_READ, EV_DELETE);
+	change(kq, edge[0],  EVFILT_READ, EV_ADD | EV_CLEAR);
+
+	write_byte(edge[1]);
+
+	if (poll_events(kq, edge[0]) != 1)
+		fail("edge-triggered event not reported");
+
+	if (poll_events(kq, edge[0]) != 0)
+		fail("edge-triggered event reported again without I/O");
+
+	write_byte(edge[1]);
+
+	if (poll_events(kq, edge[0]) != 1)
+		fail("edge-triggered event not reported after I/O");
+
+	printf("edge-triggered event ok\n");
+
+	/* one-shot events are removed when reported */
+	change(kq, edge[0], EVFILT_READ, EV_DELETE);
+
+	int const file = open("/tmp/file", O_RDWR | O_CREAT, 0600);
+	if (file < 0)
+		fail("could not create file");
+
+	change(kq, file, EVFILT_WRITE, EV_ADD | EV_ONESHOT);
+
+	if (poll_events(kq, file) != 1 || poll_events(kq, file) != 0)
+		fail("one-shot event not reported exactly once");
+
+	struct kevent del, err;
+	EV_SET(&del, file, EVFILT_WRITE, EV_DELETE, 0, 0, 0);
+	if (kevent(kq, &del, 1, &err, 1, &zero_timeout) != 1
+	 || !(err.flags & EV_ERROR) || err.data != ENOENT)
+		fail("one-shot event still registered");
+
+	printf("one-shot event ok\n");
+
+	/* events of a closed fd are removed, also if the fd is reused */
+	change(kq, file, EVFILT_READ, EV_ADD);
+	close(file);
+
+	int const reused = open("/tmp/file", O_RDWR);
+	if (reused != file)
+		fail("closed fd not reused");
+
+	if (poll_events(kq, reused) != 0)
+		fail("event of closed fd reported");
+
+	EV_SET(&del, reused, EVFILT_READ, EV_DELETE, 0, 0, 0);
+	if (kevent(kq, &del, 1, &err, 1, &zero_timeout) != 1
+	 || !(err.flags & EV_ERROR) || err.data != ENOENT)
+		fail("event of closed fd still registered");
+
+	printf("close ok\n");
+
+	/* a kevent with timeout returns without event */
+	change(kq, edge[0], EVFILT_READ, EV_ADD);
+	read_byte(edge[0]);
+	read_byte(edge[0]);
+
+	struct timespec const timeout = { 0, 100*1000*1000 };
+	if (poll_events(kq, edge[0], &timeout) != 0)
+		fail("timeout not respected");
+
+	printf("timeout ok\n");
+
+	/* a closed kqueue is gone */
+	close(kq);
+
+	if (kevent(kq, 0, 0, 0, 0, 0) != -1 || errno != EBADF)
+		fail("closed kqueue still usable");
+
+	printf("--- test finished ---\n");
+	return 0;
+}
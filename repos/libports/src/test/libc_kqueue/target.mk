@@ -0,0 +1,3 @@
+TARGET = test-libc_kqueue
+SRC_CC = main.cc
+LIBS   = posix libc_pipe
@@ -0,0 +1,227 @@
+/*
+ * \brief  Throughput of malloc and free with concurrent threads
+ * \author Genode Labs
+ * \date   2017-04-06
+ *
+ * The benchmark runs 1, 2, 4, ... threads up to the configured number, each
+ * placed at a different CPU if available. In the "local" pass, each thread
+ * allocates a batch of blocks of varying sizes and frees them again. In the
+ * "remote" pass, the threads form producer-consumer pairs: the producer
+ * allocates the blocks that the consumer frees.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/attached_rom_dataspace.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <base/semaphore.h>
+#include <base/thread.h>
+#include <libc/component.h>
+#include <timer_session/connection.h>
+
+/* libc includes */
+#include <stdlib.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Handoff;
+	struct Worker;
+	struct Main;
+}
+
+
+/**
+ * Batch of blocks passed from a producer to a consumer
+ */
+struct Test::Handoff
+{
+	enum { BATCH = 256 };
+
+	void     *blocks[BATCH];
+	Semaphore filled  { 0 };
+	Semaphore emptied { 1 };
+};
+
+
+struct Test::Worker : Thread
+{
+	enum Mode { LOCAL, PRODUCER, CONSUMER };
+	enum { BATCH = Handoff::BATCH, STACK_SIZE = 16*1024 };
+
+	Mode      const _mode;
+	unsigned  const _rounds;
+	Handoff        &_handoff;
+	Semaphore      &_done;
+	bool            _failed = false;
+
+	static size_t _size(unsigned i)
+	{
+		/* mostly small objects, occasionally up to 2 KiB */
+		static size_t const sizes[] = { 8, 16, 24, 32, 48, 64, 96, 128,
+		                                16, 32, 256, 64, 512, 1024, 2000, 40 };
+		return sizes[i % (sizeof(sizes)/sizeof(sizes[0]))];
+	}
+
+	bool _alloc_batch(void **blocks, unsigned round)
+	{
+		for (unsigned i = 0; i < BATCH; i++) {
+			size_t const size = _size(i + round);
+			char *p = (char *)malloc(size);
+			if (!p)
+				return false;
+
+			p[0] = p[size - 1] = (char)i;
+			blocks[i] = p;
+		}
+		return true;
+	}
+
+	static void _free_batch(void **blocks)
+	{
+		for (unsigned i = BATCH; i > 0; i--)
+			free(blocks[i - 1]);
+	}
+
+	void entry() override
+	{
+		void *blocks[BATCH];
+
+		for (unsigned r = 0; r < _rounds && !_failed; r++) {
+			switch (_mode) {
+			case LOCAL:
+				_failed = !_alloc_batch(blocks, r);
+				if (!_failed)
+					_free_batch(blocks);
+				break;
+
+			case PRODUCER:
+				_handoff.emptied.down();
+				_failed = !_alloc_batch(_handoff.blocks, r);
+				_handoff.filled.up();
+				break;
+
+			case CONSUMER:
+				_handoff.filled.down();
+				_free_batch(_handoff.blocks);
+				_handoff.emptied.up();
+				break;
+			}
+		}
+		_done.up();
+	}
+
+	Worker(Env &env, Location location, Mode mode, unsigned rounds,
+	       Handoff &handoff, Semaphore &done)
+	:
+		Thread(env, Name("malloc_bench"), STACK_SIZE, location, Weight(),
+		       env.cpu()),
+		_mode(mode), _rounds(rounds), _handoff(handoff), _done(done)
+	{ }
+
+	bool failed() const { return _failed; }
+};
+
+
+struct Test::Main
+{
+	Libc::Env              &_env;
+	Heap                    _heap   { _env.ram(), _env.rm() };
+	Attached_rom_dataspace  _config { _env, "config" };
+	Timer::Connection       _timer  { _env };
+
+	enum { MAX_THREADS = 64 };
+
+	Affinity::Space const _cpus = _env.cpu().affinity_space();
+
+	unsigned const _max_threads =
+		min((unsigned)MAX_THREADS,
+		    _config.xml().attribute_value("max_threads", max(2U, _cpus.total())));
+
+	unsigned const _rounds =
+		_config.xml().attribute_value("rounds", 4000U);
+
+	/**
+	 * Run 'num_threads' workers
+	 *
+	 * \return false on allocation failure
+	 */
+	bool _run(char const *what, unsigned num_threads, bool remote)
+	{
+		Semaphore done;
+		Handoff  *handoffs[MAX_THREADS/2];
+		Worker   *workers[MAX_THREADS];
+
+		for (unsigned i = 0; i < num_threads; i++) {
+			Worker::Mode const mode = !remote ? Worker::LOCAL
+			                        : (i & 1) ? Worker::CONSUMER
+			                                  : Worker::PRODUCER;
+			if (!(i & 1))
+				handoffs[i/2] = new (_heap) Handoff;
+
+			workers[i] = new (_heap)
+				Worker(_env, _cpus.location_of_index(i % _cpus.total()),
+				       mode, _rounds, *handoffs[i/2], done);
+		}
+
+		unsigned long const start_ms = _timer.elapsed_ms();
+
+		for (unsigned i = 0; i < num_threads; i++)
+			workers[i]->start();
+		for (unsigned i = 0; i < num_threads; i++)
+			done.down();
+
+		unsigned long const ms = _timer.elapsed_ms() - start_ms;
+
+		bool failed = false;
+		for (unsigned i = 0; i < num_threads; i++) {
+			workers[i]->join();
+			failed |= workers[i]->failed();
+			destroy(_heap, workers[i]);
+			if (!(i & 1))
+				destroy(_heap, handoffs[i/2]);
+		}
+
+		/* each block is allocated and freed once */
+		unsigned long long const ops =
+			(unsigned long long)(remote ? num_threads/2 : num_threads)
+			* _rounds * Worker::BATCH * 2;
+
+		log(what, " threads ", num_threads, ": ", ms, " ms, ",
+		    ms ? ops/ms : 0, " ops/ms");
+
+		return !failed;
+	}
+
+	Main(Libc::Env &env) : _env(env)
+	{
+		log("--- malloc benchmark started (", _cpus.total(), " CPUs) ---");
+
+		bool ok = true;
+		for (unsigned n = 1; ok && n <= _max_threads; n *= 2)
+			ok = _run("local ", n, false);
+
+		for (unsigned n = 2; ok && n <= _max_threads; n *= 2)
+			ok = _run("remote", n, true);
+
+		if (!ok) {
+			error("allocation failed");
+			_env.parent().exit(-1);
+			return;
+		}
+
+		log("--- malloc benchmark finished ---");
+		_env.parent().exit(0);
+	}
+};
+
+
+void Libc::Component::construct(Libc::Env &env) { static Test::Main main(env); }
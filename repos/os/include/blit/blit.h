@@ -31,4 +31,60 @@
 extern "C" void blit(void const *src, unsigned src_w,
                      void *dst, unsigned dst_w, int w, int h);
 
+
+/*
+ * The following functions operate on pixels. In contrast to 'blit', 'w'
+ * denotes the number of pixels per line. Line lengths are given in bytes.
+ * The implementation is selected at the first call depending on the SIMD
+ * capabilities of the CPU.
+ */
+
+/**
+ * Fill rectangle with a 16-bit or 32-bit pixel value
+ *
+ * \param dst    address of the first destination pixel
+ * \param dst_w  line length of destination buffer in bytes
+ * \param w      number of pixels per line
+ * \param h      number of lines
+ */
+extern "C" void blit_fill_16(void *dst, unsigned dst_w, unsigned short pixel,
+                             int w, int h);
+extern "C" void blit_fill_32(void *dst, unsigned dst_w, unsigned pixel,
+                             int w, int h);
+
+/**
+ * Copy 16-bit or 32-bit pixels, skipping source pixels with value 0
+ */
+extern "C" void blit_masked_16(void const *src, unsigned src_w,
+                               void *dst, unsigned dst_w, int w, int h);
+extern "C" void blit_masked_32(void const *src, unsigned src_w,
+                               void *dst, unsigned dst_w, int w, int h);
+
+/**
+ * Mix RGB888 source pixels into the destination according to an alpha channel
+ *
+ * \param alpha    address of the alpha value of the first source pixel
+ * \param alpha_w  line length of alpha buffer in bytes
+ *
+ * For each pixel with a non-zero alpha value, the result corresponds to
+ * 'Genode::Pixel_rgb888::mix'. Destination pixels with an alpha value of 0
+ * are not modified.
+ */
+extern "C" void blit_blend_rgb888(void const *src, unsigned src_w,
+                                  unsigned char const *alpha, unsigned alpha_w,
+                                  void *dst, unsigned dst_w, int w, int h);
+
+/**
+ * Convert pixels between the RGB565 and RGB888 formats
+ */
+extern "C" void blit_rgb565_to_rgb888(void const *src, unsigned src_w,
+                                      void *dst, unsigned dst_w, int w, int h);
+extern "C" void blit_rgb888_to_rgb565(void const *src, unsigned src_w,
+                                      void *dst, unsigned dst_w, int w, int h);
+
+/**
+ * Return name of the implementation used for the pixel operations
+ */
+extern "C" char const *blit_backend();
+
 #endif /* _INCLUDE__BLIT__BLIT_H_ */
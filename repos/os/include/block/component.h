@@ -76,6 +76,8 @@ class Block::Session_component : public Block::Session_component_base,
 		bool                              _ack_queue_full;
 		Packet_descriptor                 _p_to_handle;
 		unsigned                          _p_in_fly;
+		bool                              _ordered_in_fly;
+		bool                              _barrier_sync;
 
 		/**
 		 * Acknowledge a packet already handled
@@ -93,9 +95,17 @@ class Block::Session_component : public Block::Session_component_base,
 		 * Range check packet request
 		 */
 		inline bool _range_check(Packet_descriptor &p) {
-			return p.block_number() + p.block_count() - 1
+			return p.operation() == Block::Packet_descriptor::SYNC
+			    || p.block_number() + p.block_count() - 1
 			       < _driver.block_count(); }
 
+		/**
+		 * Return true if the request must be executed in order
+		 */
+		static bool _ordered(Packet_descriptor const &p) {
+			return p.barrier()
+			    || p.operation() == Block::Packet_descriptor::SYNC; }
+
 		/**
 		 * Handle a single request
 		 */
@@ -110,6 +120,19 @@ class Block::Session_component : public Block::Session_component_base,
 				return;
 			}
 
+			/*
+			 * Defer the request like a congested one while an ordered
+			 * request is in flight, or while an ordered request has to
+			 * wait for the completion of the requests submitted before.
+			 * The in-flight counter includes the request itself.
+			 */
+			if (_ordered_in_fly || (_ordered(packet) && _p_in_fly > 1)) {
+				_req_queue_full = true;
+				return;
+			}
+
+			_ordered_in_fly = _ordered(packet);
+
 			try {
 				switch (_p_to_handle.operation()) {
 
@@ -139,12 +162,23 @@ class Block::Session_component : public Block::Session_component_base,
 						              _p_to_handle);
 					break;
 
+				case Block::Packet_descriptor::SYNC:
+					_driver.synchronize(_p_to_handle);
+					break;
+
+				case Block::Packet_descriptor::TRIM:
+					_driver.trim(packet.block_number(), packet.block_count(),
+					             _p_to_handle);
+					break;
+
 				default:
 					throw Driver::Io_error();
 				}
 			} catch (Driver::Request_congestion) {
+				_ordered_in_fly = false;
 				_req_queue_full = true;
 			} catch (Driver::Io_error) {
+				_ordered_in_fly = false;
 				_ack_packet(_p_to_handle);
 			}
 		}
@@ -162,8 +196,11 @@ class Block::Session_component : public Block::Session_component_base,
 			for (_ack_queue_full = (_p_in_fly >= tx_sink()->ack_slots_free());
 			     !_req_queue_full && !_ack_queue_full
 			     && tx_sink()->packet_avail();
-				 _ack_queue_full = (++_p_in_fly >= tx_sink()->ack_slots_free()))
+			     _ack_queue_full = (_p_in_fly >= tx_sink()->ack_slots_free()))
+			{
+				_p_in_fly++;
 				_handle_packet(tx_sink()->get_packet());
+			}
 		}
 
 	public:
@@ -185,7 +222,9 @@ class Block::Session_component : public Block::Session_component_base,
 		  _sink_ack(ep, *this, &Session_component::_signal),
 		  _sink_submit(ep, *this, &Session_component::_signal),
 		  _req_queue_full(false),
-		  _p_in_fly(0)
+		  _p_in_fly(0),
+		  _ordered_in_fly(false),
+		  _barrier_sync(false)
 		{
 			_tx.sigh_ready_to_ack(_sink_ack);
 			_tx.sigh_packet_avail(_sink_submit);
@@ -205,6 +244,24 @@ class Block::Session_component : public Block::Session_component_base,
 		 */
 		void ack_packet(Packet_descriptor &packet, bool success)
 		{
+			/* make a completed barrier write persistent before acking it */
+			if (packet.barrier() && success && !_barrier_sync &&
+			    packet.operation() == Block::Packet_descriptor::WRITE) {
+
+				_barrier_sync = true;
+				try {
+					_driver.synchronize(packet);
+					return;
+				}
+				catch (Driver::Request_congestion) { success = false; }
+				catch (Driver::Io_error)           { success = false; }
+			}
+
+			if (_ordered(packet)) {
+				_ordered_in_fly = false;
+				_barrier_sync   = false;
+			}
+
 			packet.succeeded(success);
 			_ack_packet(packet);
 
@@ -235,6 +292,9 @@ class Block::Session_component : public Block::Session_component_base,
 			*blk_count = _driver.block_count();
 			*blk_size  = _driver.block_size();
 			*ops       = _driver.ops();
+
+			/* ordered requests are handled by the session component */
+			ops->set_operation(Block::Packet_descriptor::SYNC);
 		}
 
 		void sync() { _driver.sync(); }
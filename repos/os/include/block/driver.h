@@ -193,6 +193,23 @@ class Block::Driver
 		                       Packet_descriptor &packet) {
 			throw Io_error(); }
 
+		/**
+		 * Discard content of blocks
+		 *
+		 * \param block_number  number of first block to discard
+		 * \param block_count   number of blocks to discard
+		 * \param packet        packet descriptor from the client
+		 *
+		 * \throw Request_congestion
+		 *
+		 * Note: should be overridden by devices that announce the 'TRIM'
+		 *       operation
+		 */
+		virtual void trim(sector_t           block_number,
+		                  Genode::size_t     block_count,
+		                  Packet_descriptor &packet) {
+			throw Io_error(); }
+
 		/**
 		 * Check if DMA is enabled for driver
 		 *
@@ -227,6 +244,25 @@ class Block::Driver
 		 */
 		virtual void sync() {}
 
+		/**
+		 * Synchronize with device and acknowledge the packet afterwards
+		 *
+		 * \param packet  'SYNC' packet or barrier write from the client
+		 *
+		 * \throw Request_congestion
+		 *
+		 * This method is called only while no other request of the
+		 * session is in flight.
+		 *
+		 * Note: should be overriden by drivers that synchronize with the
+		 *       device asynchronously
+		 */
+		virtual void synchronize(Packet_descriptor &packet)
+		{
+			sync();
+			ack_packet(packet);
+		}
+
 		/**
 		 * Informs the driver that the client session was closed
 		 *
@@ -36,12 +36,23 @@ namespace Block {
  * The data associated with the 'Packet_descriptor' is either
  * the data read from or written to the block indicated by
  * its number.
+ *
+ * 'SYNC' requests all data written by previously acknowledged requests to
+ * be stored persistently. 'TRIM' tells the device that the content of the
+ * given blocks is no longer needed. Both carry no payload but must refer
+ * to an allocated part of the packet-stream buffer like any other request.
+ *
+ * A request marked as barrier is executed not before all previously
+ * submitted requests are completed, and all subsequently submitted
+ * requests are executed not before the barrier is completed. A barrier
+ * write is acknowledged only after its data is stored persistently. Every
+ * server that supports 'SYNC' requests honours the barrier flag.
  */
 class Block::Packet_descriptor : public Genode::Packet_descriptor
 {
 	public:
 
-		enum Opcode    { READ, WRITE, END };
+		enum Opcode    { READ, WRITE, SYNC, TRIM, END };
 		enum Alignment { PACKET_ALIGNMENT = 11 };
 
 	private:
@@ -50,6 +61,7 @@ class Block::Packet_descriptor : public Genode::Packet_descriptor
 		sector_t        _block_number; /* requested block number */
 		Genode::size_t  _block_count;  /* number of blocks to transfer */
 		unsigned        _success :1;   /* indicates success of operation */
+		unsigned        _barrier :1;   /* order against other requests */
 
 	public:
 
@@ -59,26 +71,30 @@ class Block::Packet_descriptor : public Genode::Packet_descriptor
 		Packet_descriptor(Genode::off_t offset=0, Genode::size_t size = 0)
 		:
 			Genode::Packet_descriptor(offset, size),
-			_op(READ), _block_number(0), _block_count(0), _success(false)
+			_op(READ), _block_number(0), _block_count(0), _success(false),
+			_barrier(false)
 		{ }
 
 		/**
 		 * Constructor
 		 */
 		Packet_descriptor(Packet_descriptor p, Opcode op,
-		                  sector_t blk_nr, Genode::size_t blk_count = 1)
+		                  sector_t blk_nr, Genode::size_t blk_count = 1,
+		                  bool barrier = false)
 		:
 			Genode::Packet_descriptor(p.offset(), p.size()),
 			_op(op), _block_number(blk_nr),
-			_block_count(blk_count), _success(false)
+			_block_count(blk_count), _success(false), _barrier(barrier)
 		{ }
 
 		Opcode         operation()    const { return _op;           }
 		sector_t       block_number() const { return _block_number; }
 		Genode::size_t block_count()  const { return _block_count;  }
 		bool           succeeded()    const { return _success;      }
+		bool           barrier()      const { return _barrier;      }
 
 		void succeeded(bool b) { _success = b ? 1 : 0; }
+		void barrier(bool b)   { _barrier = b ? 1 : 0; }
 };
 
 
@@ -144,6 +160,9 @@ struct Block::Session : public Genode::Session
 
 	/**
 	 * Synchronize with block device, like ensuring data to be written
+	 *
+	 * If the server supports 'SYNC' requests, submitting such a request
+	 * should be preferred because it does not block the client.
 	 */
 	virtual void sync() = 0;
 
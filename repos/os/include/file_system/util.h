@@ -118,107 +118,317 @@ namespace File_system {
 
 
 	/**
-	 * Read file content
+	 * Packets of a streamed read or write that are in flight
+	 *
+	 * The packets are kept in submission order. Because a server may
+	 * acknowledge packets out of order, the window matches each
+	 * acknowledgement with its submitted packet and hands out the packets
+	 * in submission order.
+	 *
+	 * A window of more than one packet must be used only for seekable file
+	 * nodes. On a stream node, like a terminal or a pipe, a short read does
+	 * not mark the end of the data, so the data of the reads still in
+	 * flight would get lost.
 	 */
-	static inline size_t read(Session &fs, Node_handle const &node_handle,
-	                          void *dst, size_t count, seek_off_t seek_offset = 0)
+	class Packet_window
 	{
-		bool success = true;
-		Session::Tx::Source &source = *fs.tx();
+		public:
+
+			enum {
+				DEFAULT_WINDOW = 1,
+				FILE_WINDOW    = 8, /* suitable window for seekable files */
+				MAX_WINDOW     = Session::TX_QUEUE_SIZE
+			};
+
+		private:
+
+			struct Slot
+			{
+				Packet_descriptor packet;
+				size_t            requested;
+				bool              acked;
+			};
+
+			Session::Tx::Source &_source;
+
+			unsigned const _window;
+			size_t   const _packet_size;
+
+			Slot     _slots[MAX_WINDOW];
+			unsigned _head  = 0;
+			unsigned _count = 0;
+
+			Slot &_slot(unsigned i) { return _slots[(_head + i) % MAX_WINDOW]; }
+
+			/*
+			 * Noncopyable
+			 */
+			Packet_window(Packet_window const &);
+			Packet_window &operator = (Packet_window const &);
+
+		public:
+
+			/**
+			 * Constructor
+			 *
+			 * \param window  maximum number of packets in flight, the
+			 *                bulk buffer is divided among them
+			 */
+			Packet_window(Session::Tx::Source &source, unsigned window)
+			:
+				_source(source),
+				_window(Genode::max(1U, Genode::min(window, (unsigned)MAX_WINDOW))),
+				_packet_size(source.bulk_buffer_size() / Genode::max(_window, 2U))
+			{
+				/* acknowledgements of earlier requests are of no interest */
+				while (_source.ack_avail())
+					_source.release_packet(_source.get_acked_packet());
+			}
+
+			/**
+			 * Destructor, waits for all packets still in flight
+			 */
+			~Packet_window()
+			{
+				while (!empty())
+					release_head();
+			}
+
+			bool   empty()       const { return _count == 0; }
+			bool   full()        const { return _count == _window; }
+			size_t packet_size() const { return _packet_size; }
+
+			/**
+			 * Submit packet
+			 *
+			 * \param fill  functor called with the packet content
+			 *              ('void *') before the packet gets submitted
+			 *
+			 * \return false if the bulk buffer is exhausted, in this case
+			 *         the caller should wait for the head packet
+			 *
+			 * \throw Packet_alloc_failed  no packet fits into the empty
+			 *                             bulk buffer
+			 */
+			template <typename FN>
+			bool submit(Node_handle const &node_handle,
+			            Packet_descriptor::Opcode op,
+			            size_t length, seek_off_t offset, FN const &fill)
+			{
+				Packet_descriptor packet;
+				try {
+					packet = Packet_descriptor(_source.alloc_packet(length),
+					                           node_handle, op, length, offset);
+				} catch (Session::Tx::Source::Packet_alloc_failed) {
+					if (empty()) throw;
+					return false;
+				}
+
+				fill(_source.packet_content(packet));
+
+				_slot(_count++) = Slot { packet, length, false };
+				_source.submit_packet(packet);
+				return true;
+			}
+
+			/**
+			 * Wait for the acknowledgement of the oldest packet in flight
+			 *
+			 * \param requested  length of the packet as submitted
+			 */
+			Packet_descriptor const &head(size_t &requested)
+			{
+				while (!_slot(0).acked) {
+
+					Packet_descriptor const packet = _source.get_acked_packet();
+
+					/* packets in flight occupy distinct parts of the bulk buffer */
+					bool matched = false;
+					for (unsigned i = 0; i < _count && !matched; i++) {
+						Slot &slot = _slot(i);
+						if (slot.acked || slot.packet.offset() != packet.offset())
+							continue;
+
+						slot.packet = packet;
+						slot.acked  = true;
+						matched     = true;
+					}
+
+					if (!matched)
+						_source.release_packet(packet);
+				}
+
+				requested = _slot(0).requested;
+				return _slot(0).packet;
+			}
+
+			/**
+			 * Release oldest packet, waits for it if still in flight
+			 */
+			void release_head()
+			{
+				size_t requested = 0;
+				_source.release_packet(head(requested));
+
+				_head = (_head + 1) % MAX_WINDOW;
+				_count--;
+			}
+	};
+
 
-		size_t const max_packet_size = source.bulk_buffer_size() / 2;
+	/**
+	 * Read file content while keeping multiple packets in flight
+	 *
+	 * \param fn      functor called with each consecutive part of the file
+	 *                content as 'void const *' and 'size_t' arguments, the
+	 *                data is passed in place within the bulk buffer
+	 * \param window  maximum number of packets in flight
+	 *
+	 * \return number of bytes passed to 'fn'
+	 */
+	template <typename FN>
+	static inline size_t read_streamed(Session &fs, Node_handle const &node_handle,
+	                                   size_t count, seek_off_t seek_offset,
+	                                   FN const &fn,
+	                                   unsigned window = Packet_window::DEFAULT_WINDOW)
+	{
+		Session::Tx::Source &source = *fs.tx();
+		Packet_window packets(source, window);
 
-		size_t remaining_count = count;
+		size_t submitted = 0, delivered = 0;
 
-		while (remaining_count && success) {
+		for (;;) {
 
-			collect_acknowledgements(source);
+			while (submitted < count && !packets.full()) {
 
-			size_t const curr_packet_size =
-				Genode::min(remaining_count, max_packet_size);
+				size_t const length =
+					Genode::min(count - submitted, packets.packet_size());
 
-			Packet_descriptor
-				packet(source.alloc_packet(curr_packet_size),
-				       node_handle,
-				       File_system::Packet_descriptor::READ,
-				       curr_packet_size,
-				       seek_offset);
+				if (!packets.submit(node_handle, Packet_descriptor::READ,
+				                    length, seek_offset + submitted,
+				                    [] (void *) { }))
+					break;
 
-			/* pass packet to server side */
-			source.submit_packet(packet);
+				submitted += length;
+			}
 
-			packet = source.get_acked_packet();
-			success = packet.succeeded();
+			if (packets.empty())
+				break;
 
-			size_t const read_num_bytes =
-				Genode::min(packet.length(), curr_packet_size);
+			size_t requested = 0;
+			Packet_descriptor const &packet = packets.head(requested);
 
-			/* copy-out payload into destination buffer */
-			Genode::memcpy(dst, source.packet_content(packet), read_num_bytes);
+			size_t const read_num_bytes = Genode::min(packet.length(), requested);
 
-			source.release_packet(packet);
+			if (read_num_bytes)
+				fn((void const *)source.packet_content(packet), read_num_bytes);
 
-			/* prepare next iteration */
-			seek_offset += read_num_bytes;
-			dst = (void *)((Genode::addr_t)dst + read_num_bytes);
-			remaining_count -= read_num_bytes;
+			delivered += read_num_bytes;
 
 			/*
 			 * If we received less bytes than requested, we reached the end
-			 * of the file.
+			 * of the file. The packets still in flight are released by the
+			 * destructor of the window.
 			 */
-			if (read_num_bytes < curr_packet_size)
+			if (!packet.succeeded() || read_num_bytes < requested)
 				break;
+
+			packets.release_head();
 		}
 
-		return count - remaining_count;
+		return delivered;
 	}
 
 
 	/**
-	 * Write file content
+	 * Write file content while keeping multiple packets in flight
+	 *
+	 * \param fn      functor called with the content of each packet as
+	 *                'void *' and 'size_t' arguments, it must fill the
+	 *                packet with the next consecutive part of the data
+	 * \param window  maximum number of packets in flight
+	 *
+	 * \return number of bytes written until the first failed packet
 	 */
-	static inline size_t write(Session &fs, Node_handle const &node_handle,
-	                          void const *src, size_t count, seek_off_t seek_offset = 0)
+	template <typename FN>
+	static inline size_t write_streamed(Session &fs, Node_handle const &node_handle,
+	                                    size_t count, seek_off_t seek_offset,
+	                                    FN const &fn,
+	                                    unsigned window = Packet_window::DEFAULT_WINDOW)
 	{
-		bool success = true;
-		Session::Tx::Source &source = *fs.tx();
+		Packet_window packets(*fs.tx(), window);
 
-		size_t const max_packet_size = source.bulk_buffer_size() / 2;
+		size_t submitted = 0, written = 0;
 
-		size_t remaining_count = count;
+		for (;;) {
 
-		while (remaining_count && success) {
+			while (submitted < count && !packets.full()) {
 
-			collect_acknowledgements(source);
+				size_t const length =
+					Genode::min(count - submitted, packets.packet_size());
 
-			size_t const curr_packet_size =
-				Genode::min(remaining_count, max_packet_size);
+				if (!packets.submit(node_handle, Packet_descriptor::WRITE,
+				                    length, seek_offset + submitted,
+				                    [&] (void *content) { fn(content, length); }))
+					break;
 
-			Packet_descriptor
-				packet(source.alloc_packet(curr_packet_size),
-				       node_handle,
-				       File_system::Packet_descriptor::WRITE,
-				       curr_packet_size,
-				       seek_offset);
+				submitted += length;
+			}
 
-			/* copy-out source buffer into payload */
-			Genode::memcpy(source.packet_content(packet), src, curr_packet_size);
+			if (packets.empty())
+				break;
 
-			/* pass packet to server side */
-			source.submit_packet(packet);
+			size_t requested = 0;
+			Packet_descriptor const &packet = packets.head(requested);
 
-			packet = source.get_acked_packet();;
-			success = packet.succeeded();
-			source.release_packet(packet);
+			if (!packet.succeeded())
+				break;
 
-			/* prepare next iteration */
-			seek_offset += curr_packet_size;
-			src = (void *)((Genode::addr_t)src + curr_packet_size);
-			remaining_count -= curr_packet_size;
+			written += Genode::min(packet.length(), requested);
+			packets.release_head();
 		}
 
-		return count - remaining_count;
+		return written;
+	}
+
+
+	/**
+	 * Read file content
+	 *
+	 * \param window  maximum number of packets in flight, see
+	 *                'Packet_window'
+	 */
+	static inline size_t read(Session &fs, Node_handle const &node_handle,
+	                          void *dst, size_t count, seek_off_t seek_offset = 0,
+	                          unsigned window = Packet_window::DEFAULT_WINDOW)
+	{
+		char *ptr = (char *)dst;
+
+		return read_streamed(fs, node_handle, count, seek_offset,
+		                     [&] (void const *src, size_t len) {
+			Genode::memcpy(ptr, src, len);
+			ptr += len;
+		}, window);
+	}
+
+
+	/**
+	 * Write file content
+	 *
+	 * \param window  maximum number of packets in flight, see
+	 *                'Packet_window'
+	 */
+	static inline size_t write(Session &fs, Node_handle const &node_handle,
+	                          void const *src, size_t count, seek_off_t seek_offset = 0,
+	                          unsigned window = Packet_window::DEFAULT_WINDOW)
+	{
+		char const *ptr = (char const *)src;
+
+		return write_streamed(fs, node_handle, count, seek_offset,
+		                      [&] (void *dst, size_t len) {
+			Genode::memcpy(dst, ptr, len);
+			ptr += len;
+		}, window);
 	}
 
 
@@ -220,6 +220,12 @@ struct File_system::Control { /* to manipulate the executable bit */ };
 
 /**
  * Data structure returned when reading from a directory node
+ *
+ * A read at offset 'n*sizeof(Directory_entry)' returns the directory entry
+ * with index 'n'. If the packet is large enough to hold further entries,
+ * the server may fill it with the consecutive entries. A client must
+ * determine the number of returned entries from the length of the
+ * acknowledged packet.
  */
 struct File_system::Directory_entry
 {
@@ -0,0 +1,117 @@
+/*
+ * \brief  Internet checksum (RFC 1071) and incremental update (RFC 1624)
+ * \author Genode Labs
+ * \date   2017-03-24
+ *
+ * All sums and checksums handled by this interface are kept in the byte
+ * order in which they appear inside a packet. Hence, a checksum returned
+ * by these functions can be stored to a packet field without conversion,
+ * and the 16-bit words that are summed up can be read from memory as is.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _NET__CHECKSUM_H_
+#define _NET__CHECKSUM_H_
+
+/* Genode includes */
+#include <base/stdint.h>
+#include <util/endian.h>
+#include <net/ipv4.h>
+#include <net/port.h>
+
+namespace Net {
+
+	/**
+	 * Return the folded one's-complement sum of a memory range
+	 *
+	 * \param data  start of the range, no alignment required
+	 * \param size  size of the range in bytes, an odd size is padded
+	 *              with a zero byte
+	 * \param sum   partial sum to continue, e.g., a pseudo-header sum
+	 *
+	 * The summation is done with the widest vector unit available.
+	 */
+	Genode::uint16_t internet_sum(void const *data, Genode::size_t size,
+	                              Genode::uint32_t sum = 0);
+
+	/**
+	 * Return the internet checksum of a memory range
+	 *
+	 * The checksum field inside the range must be zero or be accounted
+	 * for by the caller.
+	 */
+	inline Genode::uint16_t internet_checksum(void const       *data,
+	                                          Genode::size_t    size,
+	                                          Genode::uint32_t  sum = 0)
+	{
+		return ~internet_sum(data, size, sum);
+	}
+
+	/**
+	 * Return the partial sum of an IPv4 pseudo header
+	 *
+	 * \param prot    IP protocol ID of the transport packet
+	 * \param length  size of the transport packet in bytes
+	 */
+	Genode::uint32_t internet_pseudo_header_sum(Ipv4_address const &src,
+	                                            Ipv4_address const &dst,
+	                                            Genode::uint8_t     prot,
+	                                            Genode::size_t      length);
+
+	/**
+	 * Return checksum adapted to the change of a 16-bit word (RFC 1624)
+	 *
+	 * Computes HC' = ~(~HC + ~m + m') as given by equation 3 of RFC 1624.
+	 * Both words must lie at an even offset of the checksummed data.
+	 */
+	inline Genode::uint16_t internet_checksum_update(Genode::uint16_t checksum,
+	                                                 Genode::uint16_t old_word,
+	                                                 Genode::uint16_t new_word)
+	{
+		Genode::uint32_t sum = (Genode::uint16_t)~checksum
+		                     + (Genode::uint16_t)~old_word
+		                     + new_word;
+		sum = (sum & 0xffff) + (sum >> 16);
+		sum = (sum & 0xffff) + (sum >> 16);
+		return ~sum;
+	}
+
+	/**
+	 * Return checksum adapted to the change of an IPv4 address
+	 */
+	inline Genode::uint16_t internet_checksum_update(Genode::uint16_t    checksum,
+	                                                 Ipv4_address const &old_ip,
+	                                                 Ipv4_address const &new_ip)
+	{
+		Genode::uint8_t const *o = old_ip.addr;
+		Genode::uint8_t const *n = new_ip.addr;
+		for (unsigned i = 0; i < IPV4_ADDR_LEN; i += 2) {
+			Genode::uint16_t const old_word = o[i] << 8 | o[i + 1];
+			Genode::uint16_t const new_word = n[i] << 8 | n[i + 1];
+			checksum = internet_checksum_update(checksum,
+			                                    host_to_big_endian(old_word),
+			                                    host_to_big_endian(new_word));
+		}
+		return checksum;
+	}
+
+	/**
+	 * Return checksum adapted to the change of a TCP or UDP port
+	 */
+	inline Genode::uint16_t internet_checksum_update(Genode::uint16_t checksum,
+	                                                 Port             old_port,
+	                                                 Port             new_port)
+	{
+		return internet_checksum_update(checksum,
+		                                host_to_big_endian(old_port.value),
+		                                host_to_big_endian(new_port.value));
+	}
+}
+
+#endif /* _NET__CHECKSUM_H_ */
@@ -199,6 +199,12 @@ class Net::Ipv4_packet
 		void dst(Ipv4_address ip) { ip.copy(&_dst_addr); }
 		void src(Ipv4_address ip) { ip.copy(&_src_addr); }
 
+		/**
+		 * Adapt header checksum to a changed source or destination address
+		 */
+		void adapt_checksum(Ipv4_address const &old_ip,
+		                    Ipv4_address const &new_ip);
+
 		/***************
 		 ** Operators **
 		 ***************/
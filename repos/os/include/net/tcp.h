@@ -22,6 +22,7 @@
 #include <net/ipv4.h>
 #include <util/register.h>
 #include <net/port.h>
+#include <net/checksum.h>
 
 namespace Net
 {
@@ -103,33 +104,25 @@ class Net::Tcp_packet
 		{
 			/* have to reset the checksum field for calculation */
 			_checksum = 0;
+			_checksum = internet_checksum(this, tcp_size,
+				internet_pseudo_header_sum(ip_src, ip_dst, IP_ID, tcp_size));
+		}
 
-			/* sum up pseudo header */
-			uint32_t sum = 0;
-			for (size_t i = 0; i < Ipv4_packet::ADDR_LEN; i += sizeof(uint16_t)) {
-				uint16_t s = ip_src.addr[i] << 8 | ip_src.addr[i + 1];
-				uint16_t d = ip_dst.addr[i] << 8 | ip_dst.addr[i + 1];
-				sum += s + d;
-			}
-			uint8_t prot[] = { 0, IP_ID };
-			sum += host_to_big_endian(*(uint16_t *)&prot) + tcp_size;
-
-			/* sum up TCP packet itself */
-			size_t max = (tcp_size & 1) ? (tcp_size - 1) : tcp_size;
-			uint16_t * tcp = (uint16_t *)this;
-			for (size_t i = 0; i < max; i = i + sizeof(*tcp)) {
-				sum += host_to_big_endian(*tcp++); }
-
-			/* if TCP size is odd, append a zero byte */
-			if (tcp_size & 1) {
-				uint8_t last[] = { *((uint8_t *)this + (tcp_size - 1)), 0 };
-				sum += host_to_big_endian(*(uint16_t *)&last);
-			}
-			/* keep the last 16 bits of the 32 bit sum and add the carries */
-			while (sum >> 16) { sum = (sum & 0xffff) + (sum >> 16); }
-
-			/* one's complement of sum */
-			_checksum = host_to_big_endian((uint16_t)~sum);
+		/**
+		 * Adapt checksum to a changed address of the IPv4 pseudo header
+		 */
+		void adapt_checksum(Ipv4_address const &old_ip,
+		                    Ipv4_address const &new_ip)
+		{
+			_checksum = internet_checksum_update(_checksum, old_ip, new_ip);
+		}
+
+		/**
+		 * Adapt checksum to a changed source or destination port
+		 */
+		void adapt_checksum(Port old_port, Port new_port)
+		{
+			_checksum = internet_checksum_update(_checksum, old_port, new_port);
 		}
 
 		/**
@@ -21,6 +21,7 @@
 #include <util/endian.h>
 #include <net/ethernet.h>
 #include <net/ipv4.h>
+#include <net/checksum.h>
 
 namespace Net { class Udp_packet; }
 
@@ -49,6 +50,12 @@ class Net::Udp_packet
 		Genode::uint16_t _checksum;
 		unsigned         _data[0];
 
+		/**
+		 * A zero UDP checksum means "no checksum", so transmit it as 0xffff
+		 */
+		static Genode::uint16_t _transmitted(Genode::uint16_t checksum) {
+			return checksum ? checksum : 0xffff; }
+
 	public:
 
 		enum Protocol_id { IP_ID = 0x11 };
@@ -117,43 +124,29 @@ class Net::Udp_packet
 		{
 			/* have to reset the checksum field for calculation */
 			_checksum = 0;
+			_checksum = _transmitted(internet_checksum(this, length(),
+				internet_pseudo_header_sum(src, dst, IP_ID, length())));
+		}
+
+		/**
+		 * Adapt checksum to a changed address of the IPv4 pseudo header
+		 */
+		void adapt_checksum(Ipv4_address const &old_ip,
+		                    Ipv4_address const &new_ip)
+		{
+			if (_checksum) {
+				_checksum = _transmitted(
+					internet_checksum_update(_checksum, old_ip, new_ip)); }
+		}
 
-			/*
-			 * sum up pseudo header
-			 */
-			Genode::uint32_t sum = 0;
-			for (unsigned i = 0; i < Ipv4_packet::ADDR_LEN; i=i+2) {
-				Genode::uint16_t s = src.addr[i] << 8 | src.addr[i + 1];
-				Genode::uint16_t d = dst.addr[i] << 8 | dst.addr[i + 1];
-				sum += s + d;
-			}
-			Genode::uint8_t prot[] = { 0, IP_ID };
-			sum += host_to_big_endian(*(Genode::uint16_t*)&prot) + length();
-
-			/*
-			 * sum up udp packet itself
-			 */
-			unsigned max = (length() & 1) ? (length() - 1) : length();
-			Genode::uint16_t *udp = (Genode::uint16_t*) this;
-			for (unsigned i = 0; i < max; i=i+2)
-				sum += host_to_big_endian(*udp++);
-
-			/* if udp length is odd, append a zero byte */
-			if (length() & 1) {
-				Genode::uint8_t last[] =
-					{ *((Genode::uint8_t*)this + (length()-1)), 0 };
-				sum += host_to_big_endian(*(Genode::uint16_t*)&last);
-			}
-
-			/*
-			 * keep only the last 16 bits of the 32 bit calculated sum
-			 * and add the carries
-			 */
-			while (sum >> 16)
-				sum = (sum & 0xffff) + (sum >> 16);
-
-			/* one's complement of sum */
-			_checksum = host_to_big_endian((Genode::uint16_t) ~sum);
+		/**
+		 * Adapt checksum to a changed source or destination port
+		 */
+		void adapt_checksum(Port old_port, Port new_port)
+		{
+			if (_checksum) {
+				_checksum = _transmitted(
+					internet_checksum_update(_checksum, old_port, new_port)); }
 		}
 
 
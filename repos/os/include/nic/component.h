@@ -16,7 +16,9 @@
 #define _INCLUDE__NIC__COMPONENT_H_
 
 #include <base/attached_ram_dataspace.h>
+#include <base/entrypoint.h>
 #include <base/env.h>
+#include <util/reconstructible.h>
 #include <nic/packet_allocator.h>
 #include <nic_session/rpc_object.h>
 
@@ -24,6 +26,8 @@ namespace Nic {
 
 	class Communication_buffers;
 	class Session_component;
+	class Session_queue;
+	class Multi_queue_session_component;
 }
 
 
@@ -125,4 +129,200 @@ class Nic::Session_component : Communication_buffers, public Session_rpc_object
 };
 
 
+/**
+ * Additional queue pair of a multi-queue session
+ *
+ * Each queue pair has its own communication buffers and is served by its
+ * own entrypoint, so packets of different queues are processed in
+ * parallel without any synchronization between the queues.
+ */
+class Nic::Session_queue : Communication_buffers
+{
+	private:
+
+		friend class Multi_queue_session_component;
+
+		enum { STACK_SIZE = 8*1024*sizeof(long) };
+
+		/*
+		 * Estimated consumption of each of the two threads of the
+		 * entrypoint besides the entrypoint stack, covering the stack of
+		 * the signal-proxy thread, the UTCB, and the thread meta data
+		 */
+		enum { THREAD_OVERHEAD = 24*1024 };
+
+		Multi_queue_session_component &_session;
+		unsigned const                 _index;
+
+		Genode::Entrypoint _ep;
+
+		Packet_stream_tx::Rpc_object<Session::Tx> _tx;
+		Packet_stream_rx::Rpc_object<Session::Rx> _rx;
+
+		inline void _dispatch();
+
+		Genode::Signal_handler<Session_queue> _packet_stream_dispatcher {
+			_ep, *this, &Session_queue::_dispatch };
+
+	public:
+
+		/**
+		 * Return RAM consumed by a queue pair besides its buffers
+		 */
+		static constexpr Genode::size_t quota()
+		{
+			return sizeof(Session_queue) + STACK_SIZE + 2*THREAD_OVERHEAD;
+		}
+
+		/**
+		 * Constructor
+		 *
+		 * \param index     index of the queue pair within the session
+		 * \param location  CPU the entrypoint of the queue is pinned to
+		 */
+		Session_queue(Multi_queue_session_component &session,
+		              unsigned const                 index,
+		              Genode::size_t const           tx_buf_size,
+		              Genode::size_t const           rx_buf_size,
+		              Genode::Allocator             &rx_block_md_alloc,
+		              Genode::Env                   &env,
+		              Genode::Affinity::Location     location)
+		:
+			Communication_buffers(rx_block_md_alloc, env.ram(), env.rm(),
+			                      tx_buf_size, rx_buf_size),
+			_session(session), _index(index),
+			_ep(env, STACK_SIZE, "nic_queue", location),
+			_tx(_tx_ds.cap(), env.rm(), _ep.rpc_ep()),
+			_rx(_rx_ds.cap(), env.rm(), _rx_packet_alloc, _ep.rpc_ep())
+		{
+			_tx.sigh_ready_to_ack(_packet_stream_dispatcher);
+			_tx.sigh_packet_avail(_packet_stream_dispatcher);
+			_rx.sigh_ready_to_submit(_packet_stream_dispatcher);
+			_rx.sigh_ack_avail(_packet_stream_dispatcher);
+		}
+};
+
+
+/**
+ * NIC session component that serves multiple queue pairs in parallel
+ *
+ * The first queue pair is served by the entrypoint of the component, each
+ * further pair by an entrypoint of its own that is pinned to the CPU of
+ * the corresponding index within the affinity space of the component.
+ * Because the packet-stream handler of the session is called concurrently
+ * for different queues, it must only touch state that is local to the
+ * queue or properly synchronized.
+ */
+class Nic::Multi_queue_session_component : public Session_component
+{
+	private:
+
+		friend class Session_queue;
+
+		unsigned const _queues;
+
+		Genode::Constructible<Session_queue> _extra_queues[MAX_QUEUES - 1];
+
+		void _handle_packet_stream() override {
+			_handle_queue(0, *_tx.sink(), *_rx.source()); }
+
+	protected:
+
+		/**
+		 * Sub-classes must implement this function, it is called upon all
+		 * packet-stream signals of the queue pair with index 'queue'
+		 */
+		virtual void _handle_queue(unsigned             queue,
+		                           Session::Tx::Sink   &tx_sink,
+		                           Session::Rx::Source &rx_source) = 0;
+
+		/**
+		 * Stop serving the queue pairs beyond the first one
+		 *
+		 * The entrypoints of these queue pairs call '_handle_queue' until
+		 * they are destructed. A sub-class must therefore call this method
+		 * in its destructor before it destroys the state used by
+		 * '_handle_queue'. The method returns after a call of
+		 * '_handle_queue' in progress is finished.
+		 */
+		void _destruct_queues()
+		{
+			for (unsigned i = 1; i < _queues; i++)
+				_extra_queues[i - 1].destruct();
+		}
+
+		/**
+		 * Return packet-stream endpoints of the queue pair with index 'queue'
+		 */
+		Session::Tx::Sink &_queue_sink(unsigned queue) {
+			return queue ? *_extra_queues[queue - 1]->_tx.sink() : *_tx.sink(); }
+
+		Session::Rx::Source &_queue_source(unsigned queue) {
+			return queue ? *_extra_queues[queue - 1]->_rx.source() : *_rx.source(); }
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param queues  number of queue pairs, limited to 'MAX_QUEUES'
+		 *
+		 * For the other arguments, see 'Session_component'. The buffer
+		 * sizes apply to each queue pair.
+		 */
+		Multi_queue_session_component(Genode::size_t const tx_buf_size,
+		                              Genode::size_t const rx_buf_size,
+		                              unsigned       const queues,
+		                              Genode::Allocator   &rx_block_md_alloc,
+		                              Genode::Env         &env)
+		:
+			Session_component(tx_buf_size, rx_buf_size, rx_block_md_alloc, env),
+			_queues(Genode::max(1U, Genode::min(queues, (unsigned)MAX_QUEUES)))
+		{
+			Genode::Affinity::Space const space = env.cpu().affinity_space();
+
+			for (unsigned i = 1; i < _queues; i++)
+				_extra_queues[i - 1].construct(*this, i, tx_buf_size, rx_buf_size,
+				                               rx_block_md_alloc, env,
+				                               space.location_of_index(i));
+		}
+
+		/**
+		 * Return RAM needed for the queue pairs of a session besides their
+		 * communication buffers
+		 *
+		 * A server must deduct this amount from the session quota before
+		 * checking the quota for the communication buffers.
+		 */
+		static Genode::size_t queues_quota(unsigned queues)
+		{
+			static_assert(Session_queue::quota() <= QUEUE_THREAD_QUOTA,
+			              "queue-thread quota too small");
+
+			return queues > 1 ? (queues - 1)*Session_queue::quota() : 0;
+		}
+
+		unsigned queues() override { return _queues; }
+
+		Genode::Capability<Tx> _queue_tx_cap(unsigned queue) override
+		{
+			if (queue >= _queues)
+				return Genode::Capability<Tx>();
+
+			return queue ? _extra_queues[queue - 1]->_tx.cap() : _tx.cap();
+		}
+
+		Genode::Capability<Rx> _queue_rx_cap(unsigned queue) override
+		{
+			if (queue >= _queues)
+				return Genode::Capability<Rx>();
+
+			return queue ? _extra_queues[queue - 1]->_rx.cap() : _rx.cap();
+		}
+};
+
+
+void Nic::Session_queue::_dispatch() {
+	_session._handle_queue(_index, *_tx.sink(), *_rx.source()); }
+
 #endif /* _INCLUDE__NIC__COMPONENT_H_ */
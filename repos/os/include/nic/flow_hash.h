@@ -0,0 +1,114 @@
+/*
+ * \brief  Flow steering of Ethernet frames to NIC-session queues
+ * \author Genode Labs
+ * \date   2017-03-28
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__NIC__FLOW_HASH_H_
+#define _INCLUDE__NIC__FLOW_HASH_H_
+
+#include <base/stdint.h>
+
+namespace Nic {
+
+	inline Genode::uint32_t flow_hash(void const *frame, Genode::size_t size);
+
+	inline unsigned flow_queue(void const *frame, Genode::size_t size,
+	                           unsigned queues);
+}
+
+
+/**
+ * Return hash value of the flow an Ethernet frame belongs to
+ *
+ * For IPv4 frames, the hash covers the addresses, the protocol, and - for
+ * unfragmented TCP and UDP packets - the ports. Source and destination are
+ * ordered before hashing, so both directions of a connection yield the
+ * same value and are thus steered to the same queue. All other frames
+ * yield 0.
+ */
+Genode::uint32_t Nic::flow_hash(void const *frame, Genode::size_t size)
+{
+	using Genode::uint32_t;
+	using Genode::uint8_t;
+
+	enum {
+		ETH_HDR_SIZE  = 14,
+		ETH_TYPE      = 12,
+		ETH_TYPE_IPV4 = 0x0800,
+		IP_HDR_SIZE   = 20,
+		IP_FRAGMENT   = 6,
+		IP_PROTOCOL   = 9,
+		IP_SRC        = 12,
+		IP_DST        = 16,
+		IP_TCP        = 6,
+		IP_UDP        = 17,
+	};
+
+	uint8_t const *eth = (uint8_t const *)frame;
+	if (size < ETH_HDR_SIZE + IP_HDR_SIZE ||
+	    (eth[ETH_TYPE] << 8 | eth[ETH_TYPE + 1]) != ETH_TYPE_IPV4)
+		return 0;
+
+	uint8_t const *ip = eth + ETH_HDR_SIZE;
+
+	auto word = [] (uint8_t const *p) {
+		return (uint32_t)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3]; };
+
+	uint32_t       src  = word(ip + IP_SRC);
+	uint32_t       dst  = word(ip + IP_DST);
+	uint32_t       port = 0;
+	uint8_t  const prot = ip[IP_PROTOCOL];
+
+	/*
+	 * Only the first fragment carries the ports, so ignore them for all
+	 * fragments (more-fragments flag or non-zero offset).
+	 */
+	Genode::size_t const ip_hdr_size = (ip[0] & 0xf) * 4;
+	bool const fragment = (ip[IP_FRAGMENT] & 0x3f) || ip[IP_FRAGMENT + 1];
+
+	if ((prot == IP_TCP || prot == IP_UDP) && !fragment &&
+	    size >= ETH_HDR_SIZE + ip_hdr_size + 4)
+	{
+		uint32_t src_port = ip[ip_hdr_size]     << 8 | ip[ip_hdr_size + 1];
+		uint32_t dst_port = ip[ip_hdr_size + 2] << 8 | ip[ip_hdr_size + 3];
+		if (src > dst || (src == dst && src_port > dst_port)) {
+			uint32_t const tmp = src_port; src_port = dst_port; dst_port = tmp; }
+
+		port = src_port << 16 | dst_port;
+	}
+	if (src > dst) {
+		uint32_t const tmp = src; src = dst; dst = tmp; }
+
+	/* final mix of Bob Jenkins' lookup3 hash */
+	auto rot = [] (uint32_t x, unsigned k) { return (x << k) | (x >> (32 - k)); };
+	uint32_t a = src, b = dst, c = port ^ prot;
+	c ^= b; c -= rot(b, 14);
+	a ^= c; a -= rot(c, 11);
+	b ^= a; b -= rot(a, 25);
+	c ^= b; c -= rot(b, 16);
+	a ^= c; a -= rot(c,  4);
+	b ^= a; b -= rot(a, 14);
+	c ^= b; c -= rot(b, 24);
+	return c;
+}
+
+
+/**
+ * Return index of the queue that serves the flow of an Ethernet frame
+ *
+ * \param queues  number of queues provided by the NIC session
+ */
+unsigned Nic::flow_queue(void const *frame, Genode::size_t size, unsigned queues)
+{
+	return queues > 1 ? flow_hash(frame, size) % queues : 0;
+}
+
+#endif /* _INCLUDE__NIC__FLOW_HASH_H_ */
@@ -0,0 +1,142 @@
+/*
+ * \brief  Connection to NIC service with multiple queue pairs
+ * \author Genode Labs
+ * \date   2017-03-28
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__NIC_SESSION__MULTI_QUEUE_CONNECTION_H_
+#define _INCLUDE__NIC_SESSION__MULTI_QUEUE_CONNECTION_H_
+
+#include <nic_session/client.h>
+#include <nic/packet_allocator.h>
+#include <nic/flow_hash.h>
+#include <base/connection.h>
+#include <util/reconstructible.h>
+
+namespace Nic { class Multi_queue_connection; }
+
+
+/**
+ * NIC connection that requests up to 'Session::MAX_QUEUES' queue pairs
+ *
+ * The first queue pair is the one of the plain 'Session_client' and uses
+ * the tx allocator handed over by the caller. The transmission buffers of
+ * all further queue pairs are managed by allocators of the connection.
+ * If the server supports fewer queues than requested, 'queues' returns
+ * the number actually provided, which is 1 for single-queue servers.
+ */
+class Nic::Multi_queue_connection : public Genode::Connection<Session>,
+                                    public Session_client
+{
+	private:
+
+		struct Queue
+		{
+			Nic::Packet_allocator        tx_alloc;
+			Packet_stream_tx::Client<Tx> tx;
+			Packet_stream_rx::Client<Rx> rx;
+
+			Queue(Genode::Allocator      &md_alloc,
+			      Genode::Region_map     &rm,
+			      Genode::Capability<Tx>  tx_cap,
+			      Genode::Capability<Rx>  rx_cap)
+			:
+				tx_alloc(&md_alloc),
+				tx(tx_cap, rm, tx_alloc),
+				rx(rx_cap, rm)
+			{ }
+		};
+
+		unsigned const _queues;
+
+		Genode::Constructible<Queue> _extra_queues[MAX_QUEUES - 1];
+
+		Capability<Nic::Session> _session(Genode::Parent &parent,
+		                                  char const     *label,
+		                                  Genode::size_t  tx_buf_size,
+		                                  Genode::size_t  rx_buf_size,
+		                                  unsigned        queues)
+		{
+			return session(parent,
+			               "ram_quota=%ld, tx_buf_size=%ld, rx_buf_size=%ld, "
+			               "queues=%u, label=\"%s\"",
+			               32*1024*sizeof(long) +
+			               queues*(tx_buf_size + rx_buf_size) +
+			               (queues - 1)*QUEUE_THREAD_QUOTA,
+			               tx_buf_size, rx_buf_size, queues, label);
+		}
+
+		Queue &_queue(unsigned queue) { return *_extra_queues[queue - 1]; }
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param tx_block_alloc  allocator used for managing the
+		 *                        transmission buffer of the first queue
+		 * \param md_alloc        backing store of the allocators of the
+		 *                        transmission buffers of further queues
+		 * \param tx_buf_size     size of each transmission buffer in bytes
+		 * \param rx_buf_size     size of each reception buffer in bytes
+		 * \param queues          number of requested queue pairs
+		 */
+		Multi_queue_connection(Genode::Env             &env,
+		                       Genode::Range_allocator &tx_block_alloc,
+		                       Genode::Allocator       &md_alloc,
+		                       Genode::size_t           tx_buf_size,
+		                       Genode::size_t           rx_buf_size,
+		                       unsigned                 queues,
+		                       char const              *label = "")
+		:
+			Genode::Connection<Session>(env,
+				_session(env.parent(), label, tx_buf_size, rx_buf_size,
+				         Genode::max(1U, Genode::min(queues,
+				                                     (unsigned)MAX_QUEUES)))),
+			Session_client(cap(), tx_block_alloc, env.rm()),
+			_queues(Genode::max(1U, Genode::min(Session_client::queues(),
+			                                    (unsigned)MAX_QUEUES)))
+		{
+			for (unsigned i = 1; i < _queues; i++)
+				_extra_queues[i - 1].construct(md_alloc, env.rm(),
+				                               call<Rpc_queue_tx_cap>(i),
+				                               call<Rpc_queue_rx_cap>(i));
+		}
+
+		/**
+		 * Return number of queue pairs provided by the server
+		 */
+		unsigned queues() override { return _queues; }
+
+		/**
+		 * Return queue that serves the flow of an Ethernet frame
+		 */
+		unsigned flow_queue(void const *frame, Genode::size_t size) const {
+			return Nic::flow_queue(frame, size, _queues); }
+
+		using Session_client::tx_channel;
+		using Session_client::rx_channel;
+		using Session_client::tx;
+		using Session_client::rx;
+
+		Tx *tx_channel(unsigned queue) {
+			return queue ? &_queue(queue).tx : tx_channel(); }
+
+		Rx *rx_channel(unsigned queue) {
+			return queue ? &_queue(queue).rx : rx_channel(); }
+
+		Tx::Source *tx(unsigned queue) {
+			return queue ? _queue(queue).tx.source() : tx(); }
+
+		Rx::Sink *rx(unsigned queue) {
+			return queue ? _queue(queue).rx.sink() : rx(); }
+};
+
+#endif /* _INCLUDE__NIC_SESSION__MULTI_QUEUE_CONNECTION_H_ */
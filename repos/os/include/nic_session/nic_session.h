@@ -49,10 +49,20 @@ namespace Nic {
  * interface via a pointer to the abstract 'Session' class. This way, we can
  * transparently co-locate the packet-stream server with the client in same
  * program.
+ *
+ * A client may request up to 'MAX_QUEUES' pairs of tx and rx channels via
+ * the session argument 'queues'. Each pair has its own communication
+ * buffers of the requested sizes, so a server can serve the queue pairs
+ * independently from each other, e.g., by one thread per CPU. Servers
+ * that do not support multiple queues provide only the first pair. The
+ * pair used for a packet is selected via 'Nic::flow_queue'. For each pair
+ * beyond the first, the client donates 'QUEUE_THREAD_QUOTA' in addition
+ * to the communication buffers, which covers the server-side thread that
+ * serves the pair.
  */
 struct Nic::Session : Genode::Session
 {
-	enum { QUEUE_SIZE = 1024 };
+	enum { QUEUE_SIZE = 1024, MAX_QUEUES = 8, QUEUE_THREAD_QUOTA = 128*1024 };
 
 	/*
 	 * Types used by the client stub code and server implementation
@@ -95,6 +105,11 @@ struct Nic::Session : Genode::Session
 	 */
 	virtual Rx::Sink *rx() { return 0; }
 
+	/**
+	 * Request number of queue pairs provided by the session
+	 */
+	virtual unsigned queues() { return 1; }
+
 	/**
 	 * Request current link state of network adapter (true means link detected)
 	 */
@@ -115,9 +130,13 @@ struct Nic::Session : Genode::Session
 	GENODE_RPC(Rpc_link_state, bool, link_state);
 	GENODE_RPC(Rpc_link_state_sigh, void, link_state_sigh,
 	           Genode::Signal_context_capability);
+	GENODE_RPC(Rpc_queues, unsigned, queues);
+	GENODE_RPC(Rpc_queue_tx_cap, Genode::Capability<Tx>, _queue_tx_cap, unsigned);
+	GENODE_RPC(Rpc_queue_rx_cap, Genode::Capability<Rx>, _queue_rx_cap, unsigned);
 
 	GENODE_RPC_INTERFACE(Rpc_mac_address, Rpc_link_state,
-	                     Rpc_link_state_sigh, Rpc_tx_cap, Rpc_rx_cap);
+	                     Rpc_link_state_sigh, Rpc_tx_cap, Rpc_rx_cap,
+	                     Rpc_queues, Rpc_queue_tx_cap, Rpc_queue_rx_cap);
 };
 
 #endif /* _INCLUDE__NIC_SESSION__NIC_SESSION_H_ */
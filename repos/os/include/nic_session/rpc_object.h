@@ -66,6 +66,16 @@ class Nic::Session_rpc_object : public Genode::Rpc_object<Session, Session_rpc_o
 
 		Genode::Capability<Tx> _tx_cap() { return _tx.cap(); }
 		Genode::Capability<Rx> _rx_cap() { return _rx.cap(); }
+
+		/*
+		 * Only the first queue pair is provided by default. Servers that
+		 * support multiple queues override these methods and 'queues'.
+		 */
+		virtual Genode::Capability<Tx> _queue_tx_cap(unsigned queue) {
+			return queue ? Genode::Capability<Tx>() : _tx.cap(); }
+
+		virtual Genode::Capability<Rx> _queue_rx_cap(unsigned queue) {
+			return queue ? Genode::Capability<Rx>() : _rx.cap(); }
 };
 
 #endif /* _INCLUDE__NIC_SESSION__RPC_OBJECT_H_ */
@@ -16,6 +16,8 @@
 
 #include <blit/blit.h>
 #include <os/texture.h>
+#include <os/pixel_rgb565.h>
+#include <os/pixel_rgb888.h>
 
 
 struct Texture_painter
@@ -43,6 +45,58 @@ struct Texture_painter
 	typedef Genode::Surface_base::Rect  Rect;
 
 
+	/*
+	 * Alpha blending and masked copy of pixel rectangles
+	 *
+	 * The overloads for the common pixel formats use the SIMD
+	 * implementations of the blit library.
+	 */
+
+	template <typename PT>
+	static void _blend(PT const *src, unsigned char const *alpha, int src_w,
+	                   PT *dst, int dst_w, int w, int h)
+	{
+		for (; h--; src += src_w, alpha += src_w, dst += dst_w) {
+			PT            const *s = src;
+			unsigned char const *a = alpha;
+			PT                  *d = dst;
+			for (int i = w; i--; s++, d++, a++)
+				if (*a)
+					*d = PT::mix(*d, *s, *a);
+		}
+	}
+
+	static void _blend(Genode::Pixel_rgb888 const *src, unsigned char const *alpha,
+	                   int src_w, Genode::Pixel_rgb888 *dst, int dst_w, int w, int h)
+	{
+		blit_blend_rgb888(src, src_w*sizeof(*src), alpha, src_w,
+		                  dst, dst_w*sizeof(*dst), w, h);
+	}
+
+	template <typename PT>
+	static void _masked(PT const *src, int src_w, PT *dst, int dst_w, int w, int h)
+	{
+		for (; h--; src += src_w, dst += dst_w) {
+			PT const *s = src;
+			PT       *d = dst;
+			for (int i = w; i--; s++, d++)
+				if (s->pixel) *d = *s;
+		}
+	}
+
+	static void _masked(Genode::Pixel_rgb888 const *src, int src_w,
+	                    Genode::Pixel_rgb888 *dst, int dst_w, int w, int h)
+	{
+		blit_masked_32(src, src_w*sizeof(*src), dst, dst_w*sizeof(*dst), w, h);
+	}
+
+	static void _masked(Genode::Pixel_rgb565 const *src, int src_w,
+	                    Genode::Pixel_rgb565 *dst, int dst_w, int w, int h)
+	{
+		blit_masked_16(src, src_w*sizeof(*src), dst, dst_w*sizeof(*dst), w, h);
+	}
+
+
 	template <typename PT>
 	static inline void paint(Genode::Surface<PT>       &surface,
 	                         Genode::Texture<PT> const &texture,
@@ -75,9 +129,8 @@ struct Texture_painter
 		PT const mix_pixel(mix_color.r, mix_color.g, mix_color.b);
 
 		int i, j;
-		PT            const *s;
-		PT                  *d;
-		unsigned char const *a;
+		PT const *s;
+		PT       *d;
 
 		switch (mode) {
 
@@ -97,10 +150,7 @@ struct Texture_painter
 			/*
 			 * Copy texture with alpha blending
 			 */
-			for (j = clipped.h(); j--; src += src_w, alpha += src_w, dst += dst_w)
-				for (i = clipped.w(), s = src, a = alpha, d = dst; i--; s++, d++, a++)
-					if (*a)
-						*d = PT::mix(*d, *s, *a);
+			_blend(src, alpha, src_w, dst, dst_w, clipped.w(), clipped.h());
 			break;
 
 		case MIXED:
@@ -112,9 +162,7 @@ struct Texture_painter
 
 		case MASKED:
 
-			for (j = clipped.h(); j--; src += src_w, dst += dst_w)
-				for (i = clipped.w(), s = src, d = dst; i--; s++, d++)
-					if (s->pixel) *d = *s;
+			_masked(src, src_w, dst, dst_w, clipped.w(), clipped.h());
 			break;
 		}
 
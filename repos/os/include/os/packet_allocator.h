@@ -16,7 +16,8 @@
 #define _INCLUDE__OS__PACKET_ALLOCATOR__
 
 #include <base/allocator.h>
-#include <util/bit_array.h>
+#include <util/misc_math.h>
+#include <util/string.h>
 
 namespace Genode { class Packet_allocator; }
 
@@ -25,29 +26,194 @@ namespace Genode { class Packet_allocator; }
  * This allocator is designed to be used as packet allocator for the
  * packet stream interface. It uses a minimal block size, which is the
  * granularity packets will be allocated with. As backend, it uses a
- * simple bit array to manage free, and allocated blocks.
+ * bitmap to manage free, and allocated blocks.
+ *
+ * In addition to the block bitmap, the allocator maintains a summary bitmap
+ * with one bit per bitmap word, which is set if all blocks of the word are
+ * allocated. Allocations thereby skip fully used words in steps of a whole
+ * machine word and locate free blocks via find-first-set operations, which
+ * keeps the allocation latency low even for an almost fully used buffer.
+ * Multi-block allocations are placed at the first sufficiently large run of
+ * free blocks, which may span word boundaries.
+ * Neither allocation nor deallocation raise exceptions.
  */
 class Genode::Packet_allocator : public Genode::Range_allocator
 {
 	private:
 
-		Allocator      *_md_alloc;   /* meta-data allocator                 */
-		size_t          _block_size; /* granularity of packet allocations   */
-		void           *_bits;       /* memory chunk containing the bits    */
-		Bit_array_base *_array;      /* bit array managing available blocks */
-		addr_t          _base;       /* allocation base                     */
-		addr_t          _next;       /* next free bit index                 */
+		enum { BITS_PER_WORD = sizeof(addr_t)*8 };
+
+		Allocator *_md_alloc;          /* meta-data allocator                 */
+		size_t     _block_size;        /* granularity of packet allocations   */
+		addr_t    *_words    = nullptr; /* bitmap, set bits are allocated     */
+		addr_t    *_full     = nullptr; /* summary bitmap of full words       */
+		size_t     _word_cnt = 0;       /* number of words in '_words'        */
+		size_t     _md_size  = 0;       /* size of meta-data allocation       */
+		addr_t     _base     = 0;       /* allocation base                    */
+		addr_t     _next     = 0;       /* word index to start searching at   */
+		size_t     _free_cnt = 0;       /* number of free blocks              */
 
 		/*
 		 * Returns the count of blocks fitting the given size
 		 *
 		 * The block count returned is aligned to the bit count
-		 * of a machine word to fit the needs of the used bit array.
+		 * of a machine word to fit the needs of the used bitmap.
 		 */
 		inline size_t _block_cnt(size_t bytes)
 		{
 			bytes /= _block_size;
-			return bytes - (bytes % (sizeof(addr_t)*8));
+			return bytes - (bytes % BITS_PER_WORD);
+		}
+
+		size_t _blocks(size_t size) const
+		{
+			size_t const cnt = (size % _block_size) ? size / _block_size + 1
+			                                        : size / _block_size;
+			return cnt ? cnt : 1;
+		}
+
+		static size_t _summary_cnt(size_t word_cnt) {
+			return (word_cnt + BITS_PER_WORD - 1) / BITS_PER_WORD; }
+
+		static unsigned _first_set(addr_t word) { return __builtin_ctzl(word); }
+
+		static addr_t _mask(unsigned shift, size_t width)
+		{
+			return (width >= BITS_PER_WORD) ? ~0UL << shift
+			                                : ((1UL << width) - 1) << shift;
+		}
+
+		void _update_summary(size_t w)
+		{
+			addr_t const bit = 1UL << (w % BITS_PER_WORD);
+
+			if (_words[w] == ~0UL)
+				_full[w / BITS_PER_WORD] |=  bit;
+			else
+				_full[w / BITS_PER_WORD] &= ~bit;
+		}
+
+		/**
+		 * Return index of first not fully allocated word at or after 'from'
+		 *
+		 * \return false if there is no such word
+		 */
+		bool _find_word(size_t from, size_t &out_w) const
+		{
+			size_t const summary_cnt = _summary_cnt(_word_cnt);
+
+			for (size_t s = from / BITS_PER_WORD; s < summary_cnt; s++) {
+
+				/* mask out words before 'from' in the first summary word */
+				addr_t free = ~_full[s];
+				if (s == from / BITS_PER_WORD)
+					free &= ~0UL << (from % BITS_PER_WORD);
+
+				if (!free)
+					continue;
+
+				size_t const w = s*BITS_PER_WORD + _first_set(free);
+				if (w >= _word_cnt)
+					return false;
+
+				out_w = w;
+				return true;
+			}
+			return false;
+		}
+
+		/**
+		 * Set or clear the bits of a block range and update the summary
+		 */
+		void _mark(size_t index, size_t cnt, bool used)
+		{
+			while (cnt) {
+				size_t   const w     = index / BITS_PER_WORD;
+				unsigned const shift = index % BITS_PER_WORD;
+				size_t   const width = min(cnt, (size_t)(BITS_PER_WORD - shift));
+				addr_t   const mask  = _mask(shift, width);
+
+				if (used) _words[w] |=  mask;
+				else      _words[w] &= ~mask;
+
+				_update_summary(w);
+
+				index += width;
+				cnt   -= width;
+			}
+		}
+
+		/**
+		 * Find 'cnt' consecutive free blocks starting in words ['from', 'to')
+		 *
+		 * Runs of free blocks may span word boundaries and start at any
+		 * block. A run starting before 'to' may extend beyond 'to'. Fully
+		 * allocated words interrupt a run and are skipped via the summary
+		 * bitmap.
+		 *
+		 * \return false if no sufficiently large run exists
+		 */
+		bool _find_run(size_t cnt, size_t from, size_t to,
+		               size_t &out_index) const
+		{
+			size_t run = 0, run_start = 0;
+
+			for (size_t expected = from; ; ) {
+
+				size_t w;
+				if (!_find_word(expected, w))
+					return false;
+
+				/* skipped words are fully allocated */
+				if (w != expected)
+					run = 0;
+
+				/* runs must not start at or beyond 'to' */
+				if (!run && w >= to)
+					return false;
+
+				if (!run)
+					run_start = w*BITS_PER_WORD;
+
+				/* free blocks at the bottom of the word extend the run */
+				addr_t const used = _words[w];
+				size_t const low  = used ? _first_set(used) : BITS_PER_WORD;
+
+				if (run + low >= cnt) {
+					out_index = run_start;
+					return true;
+				}
+
+				expected = w + 1;
+
+				if (!used) {
+					run += BITS_PER_WORD;
+					continue;
+				}
+
+				/*
+				 * Look for a gap enclosed by allocated blocks of the word.
+				 * Reduce the set bits of 'free' to those followed by at
+				 * least 'cnt - 1' further set bits.
+				 */
+				if (cnt < BITS_PER_WORD) {
+					addr_t free = ~used;
+					for (size_t r = 1; r < cnt && free; ) {
+						size_t const shift = min(r, cnt - r);
+						free &= free >> shift;
+						r    += shift;
+					}
+
+					if (free) {
+						out_index = w*BITS_PER_WORD + _first_set(free);
+						return true;
+					}
+				}
+
+				/* free blocks at the top of the word start a new run */
+				run       = __builtin_clzl(used);
+				run_start = (w + 1)*BITS_PER_WORD - run;
+			}
 		}
 
 	public:
@@ -59,8 +225,7 @@ class Genode::Packet_allocator : public Genode::Range_allocator
 		 * \param block_size     Granularity of packets in stream
 		 */
 		Packet_allocator(Allocator *md_alloc, size_t block_size)
-		: _md_alloc(md_alloc), _block_size(block_size), _bits(0),
-		  _array(nullptr), _base(0) {}
+		: _md_alloc(md_alloc), _block_size(block_size) { }
 
 
 		/*******************************
@@ -69,13 +234,20 @@ class Genode::Packet_allocator : public Genode::Range_allocator
 
 		int add_range(addr_t base, size_t size) override
 		{
-			if (_base || _array) return -1;
+			if (_base || _words) return -1;
+
+			size_t const block_cnt = _block_cnt(size);
+			if (!block_cnt) return -1;
+
+			_word_cnt = block_cnt / BITS_PER_WORD;
+			_md_size  = (_word_cnt + _summary_cnt(_word_cnt))*sizeof(addr_t);
+			_words    = (addr_t *)_md_alloc->alloc(_md_size);
+			_full     = _words + _word_cnt;
+			_base     = base;
+			_next     = 0;
+			_free_cnt = block_cnt;
 
-			_base  = base;
-			_bits  = _md_alloc->alloc(_block_cnt(size)/8);
-			_array = new (_md_alloc) Bit_array_base(_block_cnt(size),
-			                                        (addr_t*)_bits,
-			                                        true);
+			memset(_words, 0, _md_size);
 			return 0;
 		}
 
@@ -83,8 +255,12 @@ class Genode::Packet_allocator : public Genode::Range_allocator
 		{
 			if (_base != base) return -1;
 
-			if (_array) destroy(_md_alloc, _array);
-			if (_bits)  _md_alloc->free(_bits, _block_cnt(size)/8);
+			if (_words) _md_alloc->free(_words, _md_size);
+
+			_words    = nullptr;
+			_full     = nullptr;
+			_word_cnt = 0;
+			_free_cnt = 0;
 			return 0;
 		}
 
@@ -97,42 +273,53 @@ class Genode::Packet_allocator : public Genode::Range_allocator
 
 		bool alloc(size_t size, void **out_addr) override
 		{
-			addr_t const cnt = (size % _block_size) ? size / _block_size + 1
-			                                        : size / _block_size;
-			addr_t max = ~0UL;
-
-			do {
-				try {
-					/* throws exception if array is accessed outside bounds */
-					for (addr_t i = _next & ~(cnt - 1); i < max; i += cnt) {
-						if (_array->get(i, cnt))
-							continue;
-
-						_array->set(i, cnt);
-						_next = i + cnt;
-						*out_addr = reinterpret_cast<void *>(i * _block_size
-						                                     + _base);
-						return true;
-					}
-				} catch (typename Bit_array_base::Invalid_index_access) { }
+			size_t const cnt = _blocks(size);
+			size_t       index;
 
-				max = _next;
-				_next = 0;
+			if (cnt > _free_cnt)
+				return false;
 
-			} while (max != 0);
+			if (cnt == 1) {
+				size_t w;
+				if (!_find_word(_next, w) && !_find_word(0, w))
+					return false;
 
-			return false;
+				index = w*BITS_PER_WORD + _first_set(~_words[w]);
+
+			} else {
+
+				/*
+				 * Search from the most recently used word first and wrap
+				 * around for runs starting before it.
+				 */
+				if (!_find_run(cnt, _next, _word_cnt, index)
+				 && !_find_run(cnt, 0, _next, index))
+					return false;
+			}
+
+			_mark(index, cnt, true);
+			_free_cnt -= cnt;
+			_next      = index / BITS_PER_WORD;
+
+			*out_addr = reinterpret_cast<void *>(index*_block_size + _base);
+			return true;
 		}
 
 		void free(void *addr, size_t size) override
 		{
-			addr_t i   = (((addr_t)addr) - _base) / _block_size;
-			size_t cnt = (size % _block_size) ? size / _block_size + 1
-			                                  : size / _block_size;
-			try { _array->clear(i, cnt); } catch(...) { }
-			_next = i;
+			size_t const index = (((addr_t)addr) - _base) / _block_size;
+			size_t const cnt   = _blocks(size);
+
+			if ((addr_t)addr < _base || index + cnt > _word_cnt*BITS_PER_WORD)
+				return;
+
+			_mark(index, cnt, false);
+			_free_cnt += cnt;
+			_next      = index / BITS_PER_WORD;
 		}
 
+		size_t avail() const override { return _free_cnt*_block_size; }
+
 
 		/*************
 		 ** Dummies **
@@ -141,7 +328,6 @@ class Genode::Packet_allocator : public Genode::Range_allocator
 		bool need_size_for_free() const override { return false; }
 		void free(void *addr) override { }
 		size_t overhead(size_t) const override {  return 0;}
-		size_t avail() const override { return 0; }
 		bool valid_addr(addr_t) const override { return 0; }
 		Alloc_return alloc_addr(size_t, addr_t) override {
 			return Alloc_return(Alloc_return::OUT_OF_METADATA); }
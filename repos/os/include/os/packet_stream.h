@@ -61,6 +61,20 @@
  * acknowledge buffers using the methods 'packet_avail',
  * 'ready_to_submit', 'ready_to_ack', and 'ack_avail'.
  *
+ * For high packet rates, the batch variants 'submit_packets', 'get_packets',
+ * 'acknowledge_packets', and 'get_acked_packets' transfer multiple packet
+ * descriptors at once while updating the shared queue state and delivering
+ * signals only once per batch.
+ *
+ * Both source and sink support an optional signal-coalescing mode, enabled
+ * via 'coalesce_signals'. In this mode, the signals for available packets
+ * and acknowledgements are deferred until a configured number of packets is
+ * pending and are suppressed as long as the peer is known to drain the
+ * queue. Deferred signals are delivered by calling 'flush_signals', which
+ * is expected to happen after a bounded delay whenever 'signals_deferred'
+ * returns true, e.g., driven by a timer as done by the
+ * 'Packet_stream_coalescing' utility (os/packet_stream_coalescing.h).
+ *
  * If bidirectional data exchange between two processes is desired, two pairs
  * of 'Packet_stream_source' and 'Packet_stream_sink' should be instantiated.
  */
@@ -81,11 +95,15 @@
 #include <dataspace/client.h>
 #include <util/string.h>
 #include <util/construct_at.h>
+#include <cpu/memory_barrier.h>
+#include <cpu/atomic.h>
 
 namespace Genode {
 
 	class Packet_descriptor;
 
+	struct Packet_stream_signal_stats;
+
 	template <typename, int> class Packet_descriptor_queue;
 	template <typename>      class Packet_descriptor_transmitter;
 	template <typename>      class Packet_descriptor_receiver;
@@ -146,19 +164,116 @@ class Genode::Packet_descriptor
 };
 
 
+/**
+ * Counters of signals delivered to the peer of a packet-stream endpoint
+ */
+struct Genode::Packet_stream_signal_stats
+{
+	unsigned long sent;   /* signals actually delivered */
+	unsigned long saved;  /* signals omitted due to coalescing */
+
+	Packet_stream_signal_stats() : sent(0), saved(0) { }
+
+	Packet_stream_signal_stats &operator += (Packet_stream_signal_stats const &other)
+	{
+		sent  += other.sent;
+		saved += other.saved;
+		return *this;
+	}
+};
+
+
 /**
  * Ring buffer shared between source and sink, containing packet descriptors
  *
  * This class is private to the packet-stream interface.
+ *
+ * The queue is accessed by exactly one producer and one consumer. The
+ * producer-driven and the consumer-driven state reside on distinct cache
+ * lines so that both parties do not contend for the same line. Each party
+ * additionally keeps a cached copy of the peer's index on its own line. On
+ * the single-packet paths, the peer's line is consulted only if the cached
+ * value indicates a full or empty queue. The indices are free-running
+ * counters, which are mapped to queue slots by masking. Hence, 'QUEUE_SIZE'
+ * must be a power of two.
+ *
+ * As with the original head/tail ring buffer, the queue holds at most
+ * 'QUEUE_SIZE - 1' elements. The free-running indices would permit the use
+ * of all slots, but clients size their in-flight accounting by the number
+ * of usable slots, which therefore stays unchanged.
  */
 template <typename PACKET_DESCRIPTOR, int QUEUE_SIZE>
 class Genode::Packet_descriptor_queue
 {
 	private:
 
-		unsigned          _head;
-		unsigned          _tail;
-		PACKET_DESCRIPTOR _queue[QUEUE_SIZE];
+		static_assert(QUEUE_SIZE > 1 && !(QUEUE_SIZE & (QUEUE_SIZE - 1)),
+		              "packet-descriptor queue size must be a power of two");
+
+		enum { CACHE_LINE_SIZE = 64, MASK = QUEUE_SIZE - 1 };
+
+		/* state driven by the producer */
+		unsigned _head        __attribute__((aligned(CACHE_LINE_SIZE)));
+		unsigned _cached_tail;
+
+		/* state driven by the consumer */
+		unsigned     _tail        __attribute__((aligned(CACHE_LINE_SIZE)));
+		unsigned     _cached_head;
+		int volatile _consumer_active;
+
+		PACKET_DESCRIPTOR _queue[QUEUE_SIZE] __attribute__((aligned(CACHE_LINE_SIZE)));
+
+		/**
+		 * Read index written by the peer
+		 *
+		 * The barrier orders the read before any subsequent access of
+		 * queue elements (acquire semantics).
+		 */
+		static unsigned _load_acquire(unsigned const &index)
+		{
+			unsigned const value = *(unsigned const volatile *)&index;
+			Genode::memory_barrier();
+			return value;
+		}
+
+		/**
+		 * Publish index to the peer
+		 *
+		 * The barrier orders all preceding accesses of queue elements before
+		 * the index update (release semantics).
+		 */
+		static void _store_release(unsigned &index, unsigned value)
+		{
+			Genode::memory_barrier();
+			*(unsigned volatile *)&index = value;
+		}
+
+		/**
+		 * Return number of used slots
+		 *
+		 * The result is limited to the queue size to stay robust against
+		 * a peer that corrupts its index.
+		 */
+		unsigned _used(unsigned head, unsigned tail) const
+		{
+			unsigned const used = head - tail;
+			return used > QUEUE_SIZE ? QUEUE_SIZE : used;
+		}
+
+		/**
+		 * Return number of free slots as known by the producer
+		 *
+		 * The peer's index is read only if the cached copy indicates a
+		 * full queue.
+		 */
+		unsigned _slots_free_cached()
+		{
+			if (_used(_head, _cached_tail) >= CAPACITY)
+				_cached_tail = _load_acquire(_tail);
+
+			unsigned const used = _used(_head, _cached_tail);
+			return used >= CAPACITY ? 0 : CAPACITY - used;
+		}
 
 	public:
 
@@ -166,6 +281,8 @@ class Genode::Packet_descriptor_queue
 
 		enum Role { PRODUCER, CONSUMER };
 
+		enum { CAPACITY = QUEUE_SIZE - 1 };
+
 		/**
 		 * Constructor
 		 *
@@ -177,10 +294,14 @@ class Genode::Packet_descriptor_queue
 		Packet_descriptor_queue(Role role)
 		{
 			if (role == PRODUCER) {
-				_head = 0;
+				_head        = 0;
+				_cached_tail = 0;
 				Genode::memset(_queue, 0, sizeof(_queue));
-			} else
-				_tail = 0;
+			} else {
+				_tail            = 0;
+				_cached_head     = 0;
+				_consumer_active = 0;
+			}
 		}
 
 		/**
@@ -188,63 +309,178 @@ class Genode::Packet_descriptor_queue
 		 *
 		 * \return true on success, or
 		 *         false if queue is full
+		 *
+		 * Must be called by the producer only.
 		 */
 		bool add(PACKET_DESCRIPTOR packet)
 		{
-			if (full()) return false;
+			if (_slots_free_cached() == 0) return false;
 
-			_queue[_head%QUEUE_SIZE] = packet;
-			_head = (_head + 1)%QUEUE_SIZE;
+			_queue[_head & MASK] = packet;
+			_store_release(_head, _head + 1);
 			return true;
 		}
 
+		/**
+		 * Place up to 'count' packet descriptors into queue
+		 *
+		 * \return number of packet descriptors added
+		 *
+		 * In contrast to calling 'add' for each packet, the new head is
+		 * published to the consumer only once for the whole batch.
+		 * Must be called by the producer only.
+		 */
+		unsigned add(PACKET_DESCRIPTOR const *packets, unsigned count)
+		{
+			_cached_tail = _load_acquire(_tail);
+
+			unsigned const used = _used(_head, _cached_tail);
+			unsigned const free = used >= CAPACITY ? 0 : CAPACITY - used;
+			unsigned const n    = count < free ? count : free;
+
+			unsigned const head = _head;
+			for (unsigned i = 0; i < n; i++)
+				_queue[(head + i) & MASK] = packets[i];
+
+			_store_release(_head, head + n);
+			return n;
+		}
+
 		/**
 		 * Take packet descriptor from queue
 		 *
 		 * \return  packet descriptor
+		 *
+		 * Must be called by the consumer only.
 		 */
 		PACKET_DESCRIPTOR get()
 		{
-			PACKET_DESCRIPTOR packet = _queue[_tail%QUEUE_SIZE];
-			_tail = (_tail + 1)%QUEUE_SIZE;
+			PACKET_DESCRIPTOR packet = _queue[_tail & MASK];
+			_store_release(_tail, _tail + 1);
 			return packet;
 		}
 
+		/**
+		 * Take up to 'max_count' packet descriptors from queue
+		 *
+		 * \return number of packet descriptors written to 'out_packets'
+		 *
+		 * Must be called by the consumer only.
+		 */
+		unsigned get(PACKET_DESCRIPTOR *out_packets, unsigned max_count)
+		{
+			_cached_head = _load_acquire(_head);
+
+			unsigned const avail = _used(_cached_head, _tail);
+			unsigned const n     = max_count < avail ? max_count : avail;
+
+			unsigned const tail = _tail;
+			for (unsigned i = 0; i < n; i++)
+				out_packets[i] = _queue[(tail + i) & MASK];
+
+			_store_release(_tail, tail + n);
+			return n;
+		}
+
 		/**
 		 * Return current packet descriptor
 		 */
 		PACKET_DESCRIPTOR peek() const
 		{
-			return _queue[_tail%QUEUE_SIZE];
+			return _queue[_tail & MASK];
+		}
+
+		/**
+		 * Return number of elements stored in the queue
+		 */
+		unsigned elements() {
+			return _used(_load_acquire(_head), _load_acquire(_tail)); }
+
+		/**
+		 * Return true if a packet descriptor can be taken from the queue
+		 *
+		 * The producer's index is read only if the cached copy indicates an
+		 * empty queue. Must be called by the consumer only.
+		 */
+		bool avail()
+		{
+			if (_cached_head == _tail)
+				_cached_head = _load_acquire(_head);
+
+			return _cached_head != _tail;
 		}
 
 		/**
 		 * Return true if packet-descriptor queue is empty
 		 */
-		bool empty() { return _tail == _head; }
+		bool empty() { return _load_acquire(_tail) == _load_acquire(_head); }
 
 		/**
 		 * Return true if packet-descriptor queue is full
 		 */
-		bool full() { return (_head + 1)%QUEUE_SIZE == _tail; }
+		bool full() { return elements() >= CAPACITY; }
 
 		/**
 		 * Return true if a single element is stored in the queue
 		 */
-		bool single_element() { return (_tail + 1)%QUEUE_SIZE == _head; }
-
+		bool single_element() { return elements() == 1; }
 
 		/**
 		 * Return true if a single slot is left to be put into the queue
 		 */
-		bool single_slot_free() { return (_head + 2)%QUEUE_SIZE == _tail; }
+		bool single_slot_free() { return elements() == CAPACITY - 1; }
 
 		/**
 		 * Return number of slots left to be put into the queue
 		 */
-		unsigned slots_free() {
-			return ((_tail > _head) ? _tail - _head
-			                        : QUEUE_SIZE - _head + _tail) - 1; }
+		unsigned slots_free()
+		{
+			unsigned const used = elements();
+			return used >= CAPACITY ? 0 : CAPACITY - used;
+		}
+
+		/**
+		 * Mark consumer as actively draining the queue
+		 *
+		 * Must be called by the consumer only.
+		 */
+		void mark_consumer_active()
+		{
+			if (!_consumer_active)
+				_consumer_active = 1;
+		}
+
+		/**
+		 * Mark consumer as idle
+		 *
+		 * \return true if the queue is still empty after the consumer was
+		 *         marked idle
+		 *
+		 * The consumer must not wait for a signal unless this method
+		 * returned true. Because 'cmpxchg' acts as full memory barrier, a
+		 * producer that observes an active consumer has published its
+		 * elements before the consumer re-checks the queue.
+		 * Must be called by the consumer only.
+		 */
+		bool mark_consumer_idle()
+		{
+			Genode::cmpxchg(&_consumer_active, 1, 0);
+			return empty();
+		}
+
+		/**
+		 * Return true if the consumer is known to drain the queue
+		 *
+		 * Must be called by the producer after publishing new elements.
+		 * The barrier orders the publication before the read of the flag,
+		 * which pairs with the 'cmpxchg' in 'mark_consumer_idle'. A plain
+		 * load suffices and keeps the consumer's cache line shared.
+		 */
+		bool consumer_active()
+		{
+			Genode::memory_barrier();
+			return _consumer_active;
+		}
 };
 
 
@@ -269,6 +505,71 @@ class Genode::Packet_descriptor_transmitter
 		Genode::Lock _tx_queue_lock;
 		TX_QUEUE    *_tx_queue;
 
+		/*
+		 * Signal coalescing, a batch size of 0 disables coalescing
+		 */
+		unsigned _coalesce_batch = 0;
+		unsigned _unsignalled    = 0;
+
+		unsigned long _signals_needed = 0;
+		unsigned long _signals_sent   = 0;
+
+		void _submit_rx_ready()
+		{
+			_unsignalled = 0;
+			_signals_sent++;
+			_rx_ready.submit();
+		}
+
+		/**
+		 * Notify receiver about 'n' packets just added to the queue
+		 */
+		void _rx_ready_after_add(unsigned n)
+		{
+			/*
+			 * If the queue holds no more than the just added packets, the
+			 * receiver may have observed an empty queue and waits for a
+			 * signal.
+			 */
+			unsigned const elements = _tx_queue->elements();
+			bool     const needed   = elements && elements <= n;
+
+			if (needed)
+				_signals_needed++;
+
+			if (!_coalesce_batch) {
+				if (needed)
+					_submit_rx_ready();
+				return;
+			}
+
+			_unsignalled += n;
+
+			/* the receiver will pick up the packets without a signal */
+			if (_tx_queue->consumer_active())
+				return;
+
+			if (_unsignalled >= _coalesce_batch || _tx_queue->full())
+				_submit_rx_ready();
+		}
+
+		void _flush_unsynchronized()
+		{
+			if (_unsignalled && !_tx_queue->empty())
+				_submit_rx_ready();
+
+			_unsignalled = 0;
+		}
+
+		/**
+		 * Block until the receiver frees queue slots
+		 */
+		void _wait_for_tx_ready()
+		{
+			_flush_unsynchronized();
+			_tx_ready.wait_for_signal();
+		}
+
 	public:
 
 		/**
@@ -303,11 +604,7 @@ class Genode::Packet_descriptor_transmitter
 				_rx_ready.submit();
 		}
 
-		bool ready_for_tx()
-		{
-			Genode::Lock::Guard lock_guard(_tx_queue_lock);
-			return !_tx_queue->full();
-		}
+		bool ready_for_tx() { return !_tx_queue->full(); }
 
 		void tx(typename TX_QUEUE::Packet_descriptor packet)
 		{
@@ -316,7 +613,7 @@ class Genode::Packet_descriptor_transmitter
 			do {
 				/* block for signal if tx queue is full */
 				if (_tx_queue->full())
-					_tx_ready.wait_for_signal();
+					_wait_for_tx_ready();
 
 				/*
 				 * It could happen that pending signals do not refer to the
@@ -326,14 +623,85 @@ class Genode::Packet_descriptor_transmitter
 
 			} while (_tx_queue->add(packet) == false);
 
-			if (_tx_queue->single_element())
-				_rx_ready.submit();
+			_rx_ready_after_add(1);
+		}
+
+		/**
+		 * Transmit batch of packets
+		 *
+		 * The method blocks until all packets are placed into the tx queue.
+		 * Each portion of the batch that fits into the queue is published
+		 * at once, and the receiver is signalled at most once per portion.
+		 */
+		void tx(typename TX_QUEUE::Packet_descriptor const *packets,
+		        unsigned count)
+		{
+			Genode::Lock::Guard lock_guard(_tx_queue_lock);
+
+			while (count) {
+
+				/* block for signal if tx queue is full */
+				if (_tx_queue->full())
+					_wait_for_tx_ready();
+
+				unsigned const n = _tx_queue->add(packets, count);
+				if (!n)
+					continue;
+
+				_rx_ready_after_add(n);
+
+				packets += n;
+				count   -= n;
+			}
 		}
 
 		/**
 		 * Return number of slots left to be put into the tx queue
 		 */
 		unsigned tx_slots_free() { return _tx_queue->slots_free(); }
+
+		/**
+		 * Configure signal coalescing
+		 *
+		 * \param batch  number of packets to accumulate before signalling
+		 *               the receiver, 0 disables coalescing
+		 */
+		void coalesce(unsigned batch)
+		{
+			Genode::Lock::Guard lock_guard(_tx_queue_lock);
+
+			_coalesce_batch = batch;
+			_flush_unsynchronized();
+		}
+
+		/**
+		 * Deliver deferred signal to the receiver
+		 */
+		void flush()
+		{
+			Genode::Lock::Guard lock_guard(_tx_queue_lock);
+			_flush_unsynchronized();
+		}
+
+		/**
+		 * Return true if a signal to the receiver is deferred
+		 */
+		bool deferred()
+		{
+			Genode::Lock::Guard lock_guard(_tx_queue_lock);
+			return _unsignalled && !_tx_queue->empty();
+		}
+
+		Packet_stream_signal_stats signal_stats()
+		{
+			Genode::Lock::Guard lock_guard(_tx_queue_lock);
+
+			Packet_stream_signal_stats stats;
+			stats.sent  = _signals_sent;
+			stats.saved = _signals_needed > _signals_sent
+			            ? _signals_needed - _signals_sent : 0;
+			return stats;
+		}
 };
 
 
@@ -355,8 +723,72 @@ class Genode::Packet_descriptor_receiver
 		/* facility to send ready-to-transmit signals */
 		Genode::Signal_transmitter        _tx_ready;
 
-		Genode::Lock mutable  _rx_queue_lock;
-		RX_QUEUE             *_rx_queue;
+		Genode::Lock  _rx_queue_lock;
+		RX_QUEUE     *_rx_queue;
+
+		/*
+		 * Signal coalescing, a batch size of 0 disables coalescing
+		 */
+		unsigned _coalesce_batch   = 0;
+		bool     _tx_ready_pending = false;
+
+		unsigned long _signals_needed = 0;
+		unsigned long _signals_sent   = 0;
+
+		void _submit_tx_ready()
+		{
+			_tx_ready_pending = false;
+			_signals_sent++;
+			_tx_ready.submit();
+		}
+
+		/**
+		 * Notify transmitter about 'n' queue slots just freed
+		 */
+		void _tx_ready_after_get(unsigned n)
+		{
+			/*
+			 * If the queue is filled up to the just freed slots, the
+			 * transmitter may have observed a full queue and waits for a
+			 * signal.
+			 */
+			unsigned const elements = _rx_queue->elements();
+
+			if (elements + n >= RX_QUEUE::CAPACITY) {
+				_signals_needed++;
+				_tx_ready_pending = true;
+			}
+
+			if (!_tx_ready_pending)
+				return;
+
+			/* with coalescing, wait until a batch of slots is free */
+			if (!_coalesce_batch || elements == 0
+			 || RX_QUEUE::CAPACITY - elements >= _coalesce_batch)
+				_submit_tx_ready();
+		}
+
+		void _flush_unsynchronized()
+		{
+			if (_tx_ready_pending)
+				_submit_tx_ready();
+		}
+
+		/**
+		 * Block until the transmitter adds packets to the queue
+		 */
+		void _wait_for_rx_ready()
+		{
+			while (!_rx_queue->avail()) {
+
+				if (!_rx_queue->mark_consumer_idle())
+					continue;
+
+				_flush_unsynchronized();
+				_rx_ready.wait_for_signal();
+			}
+			_rx_queue->mark_consumer_active();
+		}
 
 	public:
 
@@ -392,30 +824,115 @@ class Genode::Packet_descriptor_receiver
 				_tx_ready.submit();
 		}
 
-		bool ready_for_rx()
+		bool ready_for_rx() { return !_rx_queue->empty(); }
+
+		/**
+		 * Announce that the caller stops draining the queue
+		 *
+		 * \return true if the queue is empty, or
+		 *         false if packets arrived meanwhile
+		 *
+		 * Once marked idle, the transmitter signals subsequent packets.
+		 * If the method returns false, the caller must continue draining
+		 * the queue before waiting for a signal.
+		 */
+		bool idle()
 		{
 			Genode::Lock::Guard lock_guard(_rx_queue_lock);
-			return !_rx_queue->empty();
+
+			if (!_rx_queue->mark_consumer_idle())
+				return false;
+
+			_flush_unsynchronized();
+			return true;
 		}
 
 		void rx(typename RX_QUEUE::Packet_descriptor *out_packet)
 		{
 			Genode::Lock::Guard lock_guard(_rx_queue_lock);
 
-			while (_rx_queue->empty())
-				_rx_ready.wait_for_signal();
+			_wait_for_rx_ready();
 
 			*out_packet = _rx_queue->get();
 
-			if (_rx_queue->single_slot_free())
-				_tx_ready.submit();
+			_tx_ready_after_get(1);
 		}
 
-		typename RX_QUEUE::Packet_descriptor rx_peek() const
+		/**
+		 * Receive batch of packets
+		 *
+		 * \param out_packets  destination array
+		 * \param max_count    capacity of 'out_packets'
+		 * \return             number of received packets
+		 *
+		 * The method blocks until at least one packet is available and
+		 * takes as many packets as available, up to 'max_count'.
+		 */
+		unsigned rx(typename RX_QUEUE::Packet_descriptor *out_packets,
+		            unsigned max_count)
 		{
+			if (!max_count)
+				return 0;
+
 			Genode::Lock::Guard lock_guard(_rx_queue_lock);
+
+			_wait_for_rx_ready();
+
+			unsigned const n = _rx_queue->get(out_packets, max_count);
+
+			_tx_ready_after_get(n);
+
+			return n;
+		}
+
+		typename RX_QUEUE::Packet_descriptor rx_peek() const
+		{
 			return _rx_queue->peek();
 		}
+
+		/**
+		 * Configure signal coalescing
+		 *
+		 * \param batch  number of free queue slots to accumulate before
+		 *               signalling a transmitter that waits for a non-full
+		 *               queue, 0 disables coalescing
+		 */
+		void coalesce(unsigned batch)
+		{
+			Genode::Lock::Guard lock_guard(_rx_queue_lock);
+
+			_coalesce_batch = batch;
+			_flush_unsynchronized();
+		}
+
+		/**
+		 * Deliver deferred signal to the transmitter
+		 */
+		void flush()
+		{
+			Genode::Lock::Guard lock_guard(_rx_queue_lock);
+			_flush_unsynchronized();
+		}
+
+		/**
+		 * Return true if a signal to the transmitter is deferred
+		 */
+		bool deferred()
+		{
+			Genode::Lock::Guard lock_guard(_rx_queue_lock);
+			return _tx_ready_pending;
+		}
+
+		Packet_stream_signal_stats signal_stats()
+		{
+			Genode::Lock::Guard lock_guard(_rx_queue_lock);
+
+			Packet_stream_signal_stats stats;
+			stats.sent  = _signals_sent;
+			stats.saved = _signals_needed > _signals_sent
+			            ? _signals_needed - _signals_sent : 0;
+			return stats;
+		}
 };
 
 
@@ -689,11 +1206,38 @@ class Genode::Packet_stream_source : private Packet_stream_base
 			_submit_transmitter.tx(packet);
 		}
 
+		/**
+		 * Tell sink about a batch of packets to process
+		 *
+		 * This method blocks until all packets are placed into the submit
+		 * queue. Compared to calling 'submit_packet' for each packet, the
+		 * queue state is published to the sink and the sink is signalled
+		 * only once per batch.
+		 */
+		void submit_packets(Packet_descriptor const *packets, unsigned count)
+		{
+			_submit_transmitter.tx(packets, count);
+		}
+
 		/**
 		 * Returns true if one or more packet acknowledgements are available
 		 */
 		bool ack_avail() { return _ack_receiver.ready_for_rx(); }
 
+		/**
+		 * Announce that the source stops processing acknowledgements
+		 *
+		 * \return true if no acknowledgement is available, or
+		 *         false if acknowledgements arrived meanwhile
+		 *
+		 * With signal coalescing enabled, a source that processes
+		 * acknowledgements in response to 'ack_avail' signals must call this
+		 * method before waiting for the next signal and, if it returns
+		 * false, process the remaining acknowledgements first. Otherwise,
+		 * the sink suppresses signals while considering the source as busy.
+		 */
+		bool ack_idle() { return _ack_receiver.idle(); }
+
 		/**
 		 * Get acknowledged packet
 		 */
@@ -704,6 +1248,20 @@ class Genode::Packet_stream_source : private Packet_stream_base
 			return packet;
 		}
 
+		/**
+		 * Get batch of acknowledged packets
+		 *
+		 * \param packets    destination array
+		 * \param max_count  capacity of 'packets'
+		 * \return           number of packets written to 'packets'
+		 *
+		 * This method blocks until at least one acknowledgement is available.
+		 */
+		unsigned get_acked_packets(Packet_descriptor *packets, unsigned max_count)
+		{
+			return _ack_receiver.rx(packets, max_count);
+		}
+
 		/**
 		 * Release bulk-buffer space consumed by the packet
 		 */
@@ -713,6 +1271,50 @@ class Genode::Packet_stream_source : private Packet_stream_base
 				_packet_alloc.free((void *)packet.offset(), packet.size());
 		}
 
+		/**
+		 * Enable or disable signal coalescing
+		 *
+		 * \param batch  number of packets to accumulate before signalling
+		 *               the sink, 0 disables coalescing
+		 *
+		 * With coalescing enabled, the caller must call 'flush_signals'
+		 * while 'signals_deferred' is true to bound the latency of
+		 * deferred signals, and
+		 * 'ack_idle' whenever it stops processing acknowledgements.
+		 */
+		void coalesce_signals(unsigned batch)
+		{
+			_submit_transmitter.coalesce(batch);
+			_ack_receiver.coalesce(batch);
+		}
+
+		/**
+		 * Deliver signals deferred by signal coalescing
+		 */
+		void flush_signals()
+		{
+			_submit_transmitter.flush();
+			_ack_receiver.flush();
+		}
+
+		/**
+		 * Return true if a signal to the sink is deferred
+		 */
+		bool signals_deferred()
+		{
+			return _submit_transmitter.deferred() || _ack_receiver.deferred();
+		}
+
+		/**
+		 * Return statistics about the signals delivered to the sink
+		 */
+		Packet_stream_signal_stats signal_stats()
+		{
+			Packet_stream_signal_stats stats = _submit_transmitter.signal_stats();
+			stats += _ack_receiver.signal_stats();
+			return stats;
+		}
+
 		void debug_print_buffers() {
 			Packet_stream_base::_debug_print_buffers(); }
 
@@ -800,6 +1402,20 @@ class Genode::Packet_stream_sink : private Packet_stream_base
 		 */
 		bool packet_avail() { return _submit_receiver.ready_for_rx(); }
 
+		/**
+		 * Announce that the sink stops processing packets
+		 *
+		 * \return true if no packet is available, or
+		 *         false if packets arrived meanwhile
+		 *
+		 * With signal coalescing enabled, a sink that processes packets in
+		 * response to 'packet_avail' signals must call this method before
+		 * waiting for the next signal and, if it returns false, process the
+		 * remaining packets first. Otherwise, the source suppresses signals
+		 * while considering the sink as busy.
+		 */
+		bool idle() { return _submit_receiver.idle(); }
+
 		/**
 		 * Check if packet descriptor refers to a range within the bulk buffer
 		 */
@@ -822,6 +1438,20 @@ class Genode::Packet_stream_sink : private Packet_stream_base
 			return packet;
 		}
 
+		/**
+		 * Get batch of packets from source
+		 *
+		 * \param packets    destination array
+		 * \param max_count  capacity of 'packets'
+		 * \return           number of packets written to 'packets'
+		 *
+		 * This method blocks until at least one packet is available.
+		 */
+		unsigned get_packets(Packet_descriptor *packets, unsigned max_count)
+		{
+			return _submit_receiver.rx(packets, max_count);
+		}
+
 		/**
 		 * Return but do not dequeue next packet
 		 *
@@ -866,6 +1496,61 @@ class Genode::Packet_stream_sink : private Packet_stream_base
 			_ack_transmitter.tx(packet);
 		}
 
+		/**
+		 * Acknowledge a batch of processed packets
+		 *
+		 * This method blocks until all acknowledgements are placed into the
+		 * acknowledgement queue.
+		 */
+		void acknowledge_packets(Packet_descriptor const *packets, unsigned count)
+		{
+			_ack_transmitter.tx(packets, count);
+		}
+
+		/**
+		 * Enable or disable signal coalescing
+		 *
+		 * \param batch  number of packets to accumulate before signalling
+		 *               the source, 0 disables coalescing
+		 *
+		 * With coalescing enabled, the caller must call 'flush_signals'
+		 * while 'signals_deferred' is true to bound the latency of
+		 * deferred signals, and
+		 * 'idle' whenever it stops processing packets.
+		 */
+		void coalesce_signals(unsigned batch)
+		{
+			_ack_transmitter.coalesce(batch);
+			_submit_receiver.coalesce(batch);
+		}
+
+		/**
+		 * Deliver signals deferred by signal coalescing
+		 */
+		void flush_signals()
+		{
+			_ack_transmitter.flush();
+			_submit_receiver.flush();
+		}
+
+		/**
+		 * Return true if a signal to the source is deferred
+		 */
+		bool signals_deferred()
+		{
+			return _ack_transmitter.deferred() || _submit_receiver.deferred();
+		}
+
+		/**
+		 * Return statistics about the signals delivered to the source
+		 */
+		Packet_stream_signal_stats signal_stats()
+		{
+			Packet_stream_signal_stats stats = _ack_transmitter.signal_stats();
+			stats += _submit_receiver.signal_stats();
+			return stats;
+		}
+
 		void debug_print_buffers() {
 			Packet_stream_base::_debug_print_buffers(); }
 
@@ -0,0 +1,105 @@
+/*
+ * \brief  Timer-driven signal coalescing for packet-stream endpoints
+ * \author Genode Labs
+ * \date   2017-03-21
+ *
+ * The utility enables the signal-coalescing mode of a packet-stream source
+ * or sink and flushes deferred signals after a timeout. Thereby, the latency
+ * added by coalescing is bounded by the configured timeout. The timer is
+ * armed only while a signal is deferred, so an idle stream causes no
+ * timeouts.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__OS__PACKET_STREAM_COALESCING_H_
+#define _INCLUDE__OS__PACKET_STREAM_COALESCING_H_
+
+/* Genode includes */
+#include <base/entrypoint.h>
+#include <os/packet_stream.h>
+#include <timer_session/connection.h>
+#include <util/noncopyable.h>
+
+namespace Genode { template <typename> class Packet_stream_coalescing; }
+
+
+/**
+ * Signal coalescing for a packet-stream endpoint
+ *
+ * \param ENDPOINT  'Packet_stream_source' or 'Packet_stream_sink' type
+ *
+ * The timer session is used exclusively by this utility. The user must call
+ * 'schedule_flush' after each batch of packet operations on the endpoint,
+ * from the context of the entrypoint passed to the constructor.
+ */
+template <typename ENDPOINT>
+class Genode::Packet_stream_coalescing : Noncopyable
+{
+	private:
+
+		ENDPOINT          &_endpoint;
+		Timer::Connection &_timer;
+		unsigned    const  _timeout_us;
+		bool               _armed = false;
+
+		Signal_handler<Packet_stream_coalescing> _timeout_handler;
+
+		void _handle_timeout()
+		{
+			_armed = false;
+			_endpoint.flush_signals();
+		}
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param ep          entrypoint for handling timeout signals
+		 * \param timer       timer session used for the delayed flush
+		 * \param endpoint    packet-stream endpoint
+		 * \param batch       number of packets to accumulate before
+		 *                    signalling the peer
+		 * \param timeout_us  maximum delay of a deferred signal
+		 */
+		Packet_stream_coalescing(Entrypoint &ep, Timer::Connection &timer,
+		                         ENDPOINT &endpoint, unsigned batch,
+		                         unsigned timeout_us)
+		:
+			_endpoint(endpoint), _timer(timer), _timeout_us(timeout_us),
+			_timeout_handler(ep, *this, &Packet_stream_coalescing::_handle_timeout)
+		{
+			_endpoint.coalesce_signals(batch);
+			_timer.sigh(_timeout_handler);
+		}
+
+		~Packet_stream_coalescing()
+		{
+			_timer.sigh(Signal_context_capability());
+			_endpoint.coalesce_signals(0);
+		}
+
+		/**
+		 * Bound the delay of signals deferred by preceding packet operations
+		 *
+		 * Arms the timer if a signal is deferred and no timeout is pending.
+		 */
+		void schedule_flush()
+		{
+			if (_armed || !_endpoint.signals_deferred())
+				return;
+
+			_armed = true;
+			_timer.trigger_once(_timeout_us);
+		}
+
+		Packet_stream_signal_stats stats() { return _endpoint.signal_stats(); }
+};
+
+#endif /* _INCLUDE__OS__PACKET_STREAM_COALESCING_H_ */
@@ -19,6 +19,7 @@
 
 /* local includes */
 #include <ram_fs/node.h>
+#include <ram_fs/directory_index.h>
 #include <ram_fs/file.h>
 #include <ram_fs/symlink.h>
 
@@ -29,45 +30,43 @@ class File_system::Directory : public Node
 {
 	private:
 
-		List<Node> _entries;
-		size_t     _num_entries;
+		Directory_index<Node> _entries;
 
 	public:
 
-		Directory(char const *name) : _num_entries(0) { Node::name(name); }
+		Directory(Allocator &alloc, char const *name) : _entries(alloc) {
+			Node::name(name); }
 
-		Node *entry_unsynchronized(size_t index)
-		{
-			Node *node = _entries.first();
-			for (unsigned i = 0; i < index && node; node = node->next(), i++);
-			return node;
-		}
+		Node *entry_unsynchronized(size_t index) { return _entries.at(index); }
 
-		bool has_sub_node_unsynchronized(char const *name) const
-		{
-			Node const *sub_node = _entries.first();
-			for (; sub_node; sub_node = sub_node->next())
-				if (strcmp(sub_node->name(), name) == 0)
-					return true;
-
-			return false;
-		}
+		bool has_sub_node_unsynchronized(char const *name) const {
+			return _entries.lookup(name) != nullptr; }
 
+		/**
+		 * Add node to directory
+		 *
+		 * \throw Allocator::Out_of_memory
+		 */
 		void adopt_unsynchronized(Node *node)
 		{
 			/*
 			 * XXX inc ref counter
 			 */
-			_entries.insert(node);
-			_num_entries++;
+			_entries.insert(*node);
 
 			mark_as_updated();
 		}
 
+		/**
+		 * Make room for adopting one more node
+		 *
+		 * \throw Allocator::Out_of_memory
+		 */
+		void reserve_unsynchronized() { _entries.reserve(); }
+
 		void discard_unsynchronized(Node *node)
 		{
-			_entries.remove(node);
-			_num_entries--;
+			_entries.remove(*node);
 
 			mark_as_updated();
 		}
@@ -102,12 +101,7 @@ class File_system::Directory : public Node
 			 */
 
 			/* try to find entry that matches the first path element */
-			Node *sub_node = _entries.first();
-			for (; sub_node; sub_node = sub_node->next())
-				if ((strlen(sub_node->name()) == i) &&
-					(strcmp(sub_node->name(), path, i) == 0))
-					break;
-
+			Node *sub_node = _entries.lookup(path, i);
 			if (!sub_node)
 				throw Lookup_failed();
 
@@ -199,23 +193,29 @@ class File_system::Directory : public Node
 				return 0;
 			}
 
-			Node *node = entry_unsynchronized(index);
+			/* fill buffer with as many consecutive entries as fit */
+			size_t res = 0;
+			for (; res + sizeof(Directory_entry) <= len;
+			     res += sizeof(Directory_entry), index++) {
 
-			/* index out of range */
-			if (!node)
-				return 0;
+				Node *node = entry_unsynchronized(index);
+
+				/* index out of range */
+				if (!node)
+					break;
 
-			Directory_entry *e = (Directory_entry *)(dst);
+				Directory_entry *e = (Directory_entry *)(dst + res);
 
-			e->inode = node->inode();
+				e->inode = node->inode();
 
-			if (dynamic_cast<File      *>(node)) e->type = Directory_entry::TYPE_FILE;
-			if (dynamic_cast<Directory *>(node)) e->type = Directory_entry::TYPE_DIRECTORY;
-			if (dynamic_cast<Symlink   *>(node)) e->type = Directory_entry::TYPE_SYMLINK;
+				if (dynamic_cast<File      *>(node)) e->type = Directory_entry::TYPE_FILE;
+				if (dynamic_cast<Directory *>(node)) e->type = Directory_entry::TYPE_DIRECTORY;
+				if (dynamic_cast<Symlink   *>(node)) e->type = Directory_entry::TYPE_SYMLINK;
 
-			strncpy(e->name, node->name(), sizeof(e->name));
+				strncpy(e->name, node->name(), sizeof(e->name));
+			}
 
-			return sizeof(Directory_entry);
+			return res;
 		}
 
 		size_t write(char const *src, size_t len, seek_off_t seek_offset)
@@ -224,7 +224,7 @@ class File_system::Directory : public Node
 			return 0;
 		}
 
-		size_t num_entries() const { return _num_entries; }
+		size_t num_entries() const { return _entries.count(); }
 };
 
 #endif /* _INCLUDE__RAM_FS__DIRECTORY_H_ */
@@ -0,0 +1,367 @@
+/*
+ * \brief  Index of the entries of a directory
+ * \author Genode Labs
+ * \date   2017-03-30
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__RAM_FS__DIRECTORY_INDEX_H_
+#define _INCLUDE__RAM_FS__DIRECTORY_INDEX_H_
+
+/* Genode includes */
+#include <base/allocator.h>
+#include <util/string.h>
+
+namespace File_system { template <typename> class Directory_index; }
+
+
+/**
+ * Directory entries indexed by name and by position
+ *
+ * The entries are kept in insertion order in an array. Removing an entry
+ * leaves a hole in the array, which is closed by compacting the array once
+ * the holes outnumber the entries. A Fenwick tree over the array counts the
+ * entries in front of each array slot, which turns the lookup of the n-th
+ * entry into a binary search. The common case of reading a directory entry
+ * by entry is served in constant time by continuing at the previous
+ * position. The lookup by name uses a hash table with linear probing that
+ * refers to the array slots.
+ *
+ * 'NODE' must provide a method 'char const *name()'. The name of a node
+ * must not change while the node is part of the index.
+ */
+template <typename NODE>
+class File_system::Directory_index
+{
+	private:
+
+		enum { MIN_CAPACITY = 16, NO_POS = ~0U };
+
+		struct Slot
+		{
+			Genode::uint32_t hash;
+			unsigned         pos;   /* index into '_entries' */
+		};
+
+		Genode::Allocator &_alloc;
+
+		/* entries in insertion order, 'nullptr' marks a hole */
+		NODE     **_entries  = nullptr;
+		unsigned  *_tree     = nullptr;  /* Fenwick tree, 1-based */
+		unsigned   _capacity = 0;        /* size of both arrays   */
+		unsigned   _used     = 0;        /* used array slots      */
+		unsigned   _count    = 0;        /* number of entries     */
+
+		/* hash table referring to array slots */
+		Slot      *_slots          = nullptr;
+		unsigned   _slots_capacity = 0;
+
+		/* position of the entry returned by the previous 'at' call */
+		unsigned   _cursor_index = NO_POS;
+		unsigned   _cursor_pos   = 0;
+
+		static Genode::uint32_t _hash(char const *name, Genode::size_t len)
+		{
+			/* FNV-1a */
+			Genode::uint32_t h = 2166136261U;
+			for (Genode::size_t i = 0; i < len; i++)
+				h = (h ^ (unsigned char)name[i]) * 16777619U;
+			return h;
+		}
+
+		template <typename T>
+		T *_alloc_array(unsigned n) {
+			return (T *)_alloc.alloc(n*sizeof(T)); }
+
+		template <typename T>
+		void _free_array(T *array, unsigned n) {
+			if (array) _alloc.free(array, n*sizeof(T)); }
+
+		void _tree_add(unsigned pos, int delta)
+		{
+			for (unsigned i = pos + 1; i <= _capacity; i += i & -i)
+				_tree[i - 1] += delta;
+		}
+
+		void _build_tree()
+		{
+			for (unsigned i = 0; i < _capacity; i++)
+				_tree[i] = (i < _used && _entries[i]) ? 1 : 0;
+
+			for (unsigned i = 1; i <= _capacity; i++) {
+				unsigned const parent = i + (i & -i);
+				if (parent <= _capacity)
+					_tree[parent - 1] += _tree[i - 1];
+			}
+		}
+
+		/**
+		 * Return array position of the entry with the given index
+		 */
+		unsigned _find_pos(unsigned index) const
+		{
+			unsigned pos = 0;
+			unsigned step = 1;
+			for (; step*2 <= _capacity; step *= 2);
+
+			for (; step; step /= 2) {
+				if (pos + step <= _capacity && _tree[pos + step - 1] <= index) {
+					pos   += step;
+					index -= _tree[pos - 1];
+				}
+			}
+			return pos;
+		}
+
+		void _place(Slot const &slot)
+		{
+			unsigned const mask = _slots_capacity - 1;
+			unsigned i = slot.hash & mask;
+			for (; _slots[i].pos != NO_POS; i = (i + 1) & mask);
+			_slots[i] = slot;
+		}
+
+		void _build_slots()
+		{
+			for (unsigned i = 0; i < _slots_capacity; i++)
+				_slots[i].pos = NO_POS;
+
+			for (unsigned pos = 0; pos < _used; pos++) {
+				NODE * const node = _entries[pos];
+				if (!node) continue;
+
+				char const *name = node->name();
+				_place(Slot { _hash(name, Genode::strlen(name)), pos });
+			}
+		}
+
+		/**
+		 * Return hash-table slot that refers to the given node
+		 */
+		unsigned _slot_of(NODE const &node) const
+		{
+			unsigned const mask = _slots_capacity - 1;
+			char const *name = const_cast<NODE &>(node).name();
+
+			for (unsigned i = _hash(name, Genode::strlen(name)) & mask;
+			     _slots[i].pos != NO_POS; i = (i + 1) & mask)
+				if (_entries[_slots[i].pos] == &node)
+					return i;
+
+			return NO_POS;
+		}
+
+		void _remove_slot(unsigned hole)
+		{
+			unsigned const mask = _slots_capacity - 1;
+
+			_slots[hole].pos = NO_POS;
+
+			/* move back followers that may not stay behind the hole */
+			for (unsigned i = (hole + 1) & mask; _slots[i].pos != NO_POS;
+			     i = (i + 1) & mask) {
+
+				unsigned const probe = (i - _slots[i].hash) & mask;
+				if (probe < ((i - hole) & mask))
+					continue;
+
+				_slots[hole]     = _slots[i];
+				_slots[i].pos    = NO_POS;
+				hole             = i;
+			}
+		}
+
+		/**
+		 * Resize array and close its holes
+		 */
+		void _resize_entries(unsigned capacity)
+		{
+			NODE    **entries = _alloc_array<NODE *>(capacity);
+			unsigned *tree;
+			try { tree = _alloc_array<unsigned>(capacity); }
+			catch (...) {
+				_free_array(entries, capacity);
+				throw;
+			}
+
+			unsigned used = 0;
+			for (unsigned pos = 0; pos < _used; pos++)
+				if (_entries[pos])
+					entries[used++] = _entries[pos];
+
+			_free_array(_entries, _capacity);
+			_free_array(_tree,    _capacity);
+
+			_entries  = entries;
+			_tree     = tree;
+			_capacity = capacity;
+			_used     = used;
+
+			_build_tree();
+			_build_slots();
+			_cursor_index = NO_POS;
+		}
+
+		void _resize_slots(unsigned capacity)
+		{
+			Slot *slots = _alloc_array<Slot>(capacity);
+
+			_free_array(_slots, _slots_capacity);
+			_slots          = slots;
+			_slots_capacity = capacity;
+
+			_build_slots();
+		}
+
+		/*
+		 * Noncopyable
+		 */
+		Directory_index(Directory_index const &);
+		Directory_index &operator = (Directory_index const &);
+
+	public:
+
+		Directory_index(Genode::Allocator &alloc) : _alloc(alloc) { }
+
+		~Directory_index()
+		{
+			_free_array(_entries, _capacity);
+			_free_array(_tree,    _capacity);
+			_free_array(_slots,   _slots_capacity);
+		}
+
+		/**
+		 * Make room for one more entry
+		 *
+		 * After a successful call, the next 'insert' does not allocate,
+		 * even if entries are removed in between. This way, a node can be
+		 * moved between indices without the risk of losing it.
+		 *
+		 * \throw Allocator::Out_of_memory  the entries stay unchanged
+		 */
+		void reserve()
+		{
+			if ((_count + 1)*4 > _slots_capacity*3)
+				_resize_slots(_slots_capacity ? _slots_capacity*2 : MIN_CAPACITY);
+
+			if (_used == _capacity) {
+				unsigned const holes = _used - _count;
+				_resize_entries(holes > _capacity/4 ? _capacity
+				                : _capacity ? _capacity*2 : MIN_CAPACITY);
+			}
+		}
+
+		/**
+		 * Add node as last entry
+		 *
+		 * \throw Allocator::Out_of_memory  the index stays unchanged
+		 */
+		void insert(NODE &node)
+		{
+			reserve();
+
+			unsigned const pos = _used++;
+			_entries[pos] = &node;
+			_tree_add(pos, 1);
+			_count++;
+
+			char const *name = node.name();
+			_place(Slot { _hash(name, Genode::strlen(name)), pos });
+		}
+
+		/**
+		 * Remove node from index
+		 */
+		void remove(NODE &node)
+		{
+			if (!_count)
+				return;
+
+			unsigned const slot = _slot_of(node);
+			if (slot == NO_POS)
+				return;
+
+			unsigned const pos = _slots[slot].pos;
+			_remove_slot(slot);
+
+			_entries[pos] = nullptr;
+			_tree_add(pos, -1);
+			_count--;
+
+			if (_cursor_index != NO_POS && pos <= _cursor_pos) {
+				if (pos == _cursor_pos) _cursor_index = NO_POS;
+				else                    _cursor_index--;
+			}
+
+			/* close the holes once they outnumber the entries */
+			unsigned const holes = _used - _count;
+			if (holes > _count && holes >= MIN_CAPACITY) {
+				try { _resize_entries(_capacity); }
+				catch (Genode::Allocator::Out_of_memory) { }
+			}
+		}
+
+		/**
+		 * Return node with the given name or 'nullptr'
+		 *
+		 * \param len  length of the name, which does not need to be
+		 *             null-terminated
+		 */
+		NODE *lookup(char const *name, Genode::size_t len) const
+		{
+			if (!_count)
+				return nullptr;
+
+			unsigned const mask = _slots_capacity - 1;
+			Genode::uint32_t const hash = _hash(name, len);
+
+			for (unsigned i = hash & mask; _slots[i].pos != NO_POS;
+			     i = (i + 1) & mask) {
+
+				if (_slots[i].hash != hash)
+					continue;
+
+				NODE * const node = _entries[_slots[i].pos];
+				char const *node_name = node->name();
+				if (Genode::strlen(node_name) == len &&
+				    Genode::strcmp(node_name, name, len) == 0)
+					return node;
+			}
+			return nullptr;
+		}
+
+		NODE *lookup(char const *name) const {
+			return lookup(name, Genode::strlen(name)); }
+
+		/**
+		 * Return entry at the given index or 'nullptr' if out of range
+		 */
+		NODE *at(Genode::size_t index)
+		{
+			if (index >= _count)
+				return nullptr;
+
+			unsigned pos;
+			if (_cursor_index != NO_POS && index == _cursor_index + 1) {
+				for (pos = _cursor_pos + 1; !_entries[pos]; pos++);
+			} else if (index == _cursor_index) {
+				pos = _cursor_pos;
+			} else {
+				pos = _find_pos(index);
+			}
+
+			_cursor_index = index;
+			_cursor_pos   = pos;
+			return _entries[pos];
+		}
+
+		Genode::size_t count() const { return _count; }
+};
+
+#endif /* _INCLUDE__RAM_FS__DIRECTORY_INDEX_H_ */
@@ -218,11 +218,14 @@ class Vfs::Dir_file_system : public File_system
 		{
 			using namespace Genode;
 
-			/* remember directory name */
-			if (node.has_type("fstab") || node.has_type("vfs"))
-				_name[0] = 0;
-			else
+			/*
+			 * Remember directory name, only '<dir>' nodes are named, all
+			 * others (e.g., '<vfs>' or '<cache>') host the root directory
+			 */
+			if (node.has_type("dir"))
 				node.attribute("name").value(_name, sizeof(_name));
+			else
+				_name[0] = 0;
 
 			for (unsigned i = 0; i < node.num_sub_nodes(); i++) {
 
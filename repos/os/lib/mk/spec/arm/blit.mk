@@ -1,5 +1,19 @@
-SRC_CC  = blit.cc
+SRC_CC  = blit.cc blit_ops.cc select_ops.cc
 REQUIRES = arm 32bit
-INC_DIR += $(REP_DIR)/src/lib/blit/spec/arm
+INC_DIR += $(REP_DIR)/src/lib/blit/spec/arm \
+           $(REP_DIR)/src/lib/blit
 
-vpath blit.cc $(REP_DIR)/src/lib/blit
+#
+# The NEON operations require the FPU, which is enabled for user threads on
+# the platforms with the 'fpu_vfpv3' spec. Only the NEON kernels are
+# compiled for NEON.
+#
+ifneq ($(filter fpu_vfpv3,$(SPECS)),)
+SRC_CC           += blit_neon.cc
+CC_OPT_blit_neon  = -mfpu=neon -mfloat-abi=softfp
+CC_OPT_select_ops = -DBLIT_NEON
+endif
+
+vpath select_ops.cc $(REP_DIR)/src/lib/blit/spec/arm
+vpath blit_neon.cc  $(REP_DIR)/src/lib/blit/spec/arm
+vpath %.cc          $(REP_DIR)/src/lib/blit
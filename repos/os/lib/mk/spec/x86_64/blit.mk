@@ -1,6 +1,11 @@
-SRC_CC  = blit.cc
+SRC_CC  = blit.cc blit_ops.cc select_ops.cc blit_avx2.cc
 REQUIRES = x86 64bit
 INC_DIR += $(REP_DIR)/src/lib/blit/spec/x86_64 \
-           $(REP_DIR)/src/lib/blit/spec/x86
+           $(REP_DIR)/src/lib/blit/spec/x86 \
+           $(REP_DIR)/src/lib/blit
 
-vpath blit.cc $(REP_DIR)/src/lib/blit
+CC_OPT_blit_avx2 = -mavx2
+
+vpath select_ops.cc $(REP_DIR)/src/lib/blit/spec/x86_64
+vpath blit_avx2.cc  $(REP_DIR)/src/lib/blit/spec/x86_64
+vpath %.cc          $(REP_DIR)/src/lib/blit
@@ -238,6 +238,27 @@ struct Command_fis : Genode::Mmio
 		write<Sector0_7::Tag>(slot);
 	}
 
+	void flush_cache_ext()
+	{
+		write<Bits::C>(1);
+		write<Device::Lba>(1);
+		write<Command>(0xea);
+	}
+
+	/**
+	 * TRIM the LBA ranges given by 'blocks' 512-byte blocks of range entries
+	 */
+	void data_set_management_trim(Genode::size_t blocks)
+	{
+		enum { TRIM = 1 };
+
+		write<Bits::C>(1);
+		write<Device::Lba>(1);
+		write<Command>(0x06);
+		write<Features>(TRIM);
+		write<Sector>(blocks);
+	}
+
 	void atapi()
 	{
 		write<Bits::C>(1);
@@ -42,6 +42,11 @@ struct Identity : Genode::Mmio
 
 	struct Sector_count : Register<0xc8, 64> { };
 
+	struct Data_set_management : Register<0x152, 16>
+	{
+		struct Trim : Bitfield<0, 1> { };
+	};
+
 	struct Logical_block  : Register<0xd4, 16>
 	{
 		struct Per_physical : Bitfield<0,  3> { }; /* 2^X logical per physical */
@@ -188,12 +193,22 @@ struct Ata_driver : Port_driver
 	Io_command                               *io_cmd = nullptr;
 	Block::Packet_descriptor                  pending[32];
 
+	/* LBA range entries of TRIM commands, 8 byte each */
+	enum { TRIM_BUFFER_SIZE = 0x1000, TRIM_RANGE_BLOCKS = 0xffff };
+
+	Genode::Ram_dataspace_capability trim_ds;
+	Genode::addr_t                   trim_ranges = 0;
+
 	Ata_driver(Genode::Allocator &alloc,
 	           Port &port, Genode::Ram_session &ram,
 	           Ahci_root &root, unsigned &sem)
 	: Port_driver(port, ram, root, sem), alloc(alloc)
 	{
 		Port::init();
+
+		trim_ds     = platform_hba.alloc_dma_buffer(TRIM_BUFFER_SIZE);
+		trim_ranges = rm.attach(trim_ds);
+
 		identify_device();
 	}
 
@@ -201,6 +216,41 @@ struct Ata_driver : Port_driver
 	{
 		if (io_cmd)
 			destroy(&alloc, io_cmd);
+
+		rm.detach((void *)trim_ranges);
+		platform_hba.free_dma_buffer(trim_ds);
+	}
+
+	bool idle()
+	{
+		for (unsigned slot = 0; slot < cmd_slots; slot++)
+			if (pending[slot].size())
+				return false;
+
+		return true;
+	}
+
+	/**
+	 * Issue a command that must not be queued with other commands
+	 */
+	template <typename FN>
+	void non_queued_command(Block::Packet_descriptor &packet,
+	                        addr_t phys, size_t bytes, bool write,
+	                        FN const &fn)
+	{
+		if (!idle())
+			throw Block::Driver::Request_congestion();
+
+		pending[0] = packet;
+
+		Command_table table(command_table_addr(0), phys, bytes);
+		fn(table.fis);
+
+		Command_header header(command_header_addr(0));
+		header.write<Command_header::Bits::W>(write ? 1 : 0);
+		header.clear_byte_count();
+
+		execute(0);
 	}
 
 	unsigned find_free_cmd_slot()
@@ -317,6 +367,11 @@ struct Ata_driver : Port_driver
 		case READY:
 
 			io_cmd->handle_irq(*this, status);
+
+			/* non-queued commands complete with a register FIS */
+			if (Port::Is::Dhrs::get(status))
+				ack_irq();
+
 			ack_packets();
 
 		default:
@@ -326,6 +381,11 @@ struct Ata_driver : Port_driver
 		stop();
 	}
 
+	bool trim_support()
+	{
+		return info->read<Identity::Data_set_management::Trim>();
+	}
+
 	bool ncq_support()
 	{
 		return info->read<Identity::Sata_caps::Ncq_support>() && hba.ncq();
@@ -366,6 +426,8 @@ struct Ata_driver : Port_driver
 		Block::Session::Operations o;
 		o.set_operation(Block::Packet_descriptor::READ);
 		o.set_operation(Block::Packet_descriptor::WRITE);
+		if (trim_support())
+			o.set_operation(Block::Packet_descriptor::TRIM);
 		return o;
 	}
 
@@ -385,6 +447,48 @@ struct Ata_driver : Port_driver
 		io(false, block_number, block_count, phys, packet);
 	}
 
+	void trim(Block::sector_t           block_number,
+	          size_t                    block_count,
+	          Block::Packet_descriptor &packet) override
+	{
+		if (!trim_support())
+			throw Io_error();
+
+		size_t const max_ranges = TRIM_BUFFER_SIZE / sizeof(Genode::uint64_t);
+		size_t const ranges     = (block_count + TRIM_RANGE_BLOCKS - 1)
+		                        / TRIM_RANGE_BLOCKS;
+		if (ranges > max_ranges) {
+			Genode::error("error: TRIM of more than ",
+			              max_ranges * TRIM_RANGE_BLOCKS, " blocks");
+			throw Io_error();
+		}
+
+		/* the range buffer is in use until the port is idle */
+		if (!idle())
+			throw Request_congestion();
+
+		/* range entry: LBA in bits 0-47, block count in bits 48-63 */
+		size_t const bytes = align_addr(ranges * sizeof(Genode::uint64_t), 9);
+		Genode::uint64_t *range = (Genode::uint64_t *)trim_ranges;
+		memset(range, 0, bytes);
+		for (; block_count; range++) {
+			size_t const count = min(block_count, (size_t)TRIM_RANGE_BLOCKS);
+			*range = block_number | (Genode::uint64_t)count << 48;
+			block_number += count;
+			block_count  -= count;
+		}
+
+		addr_t const phys = Dataspace_client(trim_ds).phys_addr();
+		non_queued_command(packet, phys, bytes, true, [&] (Command_fis &fis) {
+			fis.data_set_management_trim(bytes / 512); });
+	}
+
+	void synchronize(Block::Packet_descriptor &packet) override
+	{
+		non_queued_command(packet, 0, 0, false, [&] (Command_fis &fis) {
+			fis.flush_cache_ext(); });
+	}
+
 	Genode::size_t block_size() override
 	{
 		Genode::size_t size = 512;
@@ -0,0 +1,329 @@
+/*
+ * \brief  Pixel-processing kernels of the blit library
+ * \author Genode Labs
+ * \date   2017-04-10
+ *
+ * The kernels are written using the vector extensions of GCC. The vector
+ * width is a template argument. Depending on the compiler flags of the
+ * compilation unit that instantiates the kernels, the compiler maps the
+ * vector operations to SSE2, AVX2, or NEON instructions, or to scalar code
+ * if the target lacks SIMD support.
+ *
+ * This header must not include headers with inline functions because the
+ * kernels may be compiled with flags that enable instructions not present
+ * on each CPU.
+ *
+ * Vectors are never passed by value or returned by the helper functions.
+ * The calling convention for vector types differs depending on whether
+ * SIMD instructions are enabled, e.g., for SSE on x86_32.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _LIB__BLIT__BLIT_KERNELS_H_
+#define _LIB__BLIT__BLIT_KERNELS_H_
+
+#include <base/stdint.h>
+
+namespace Blit {
+
+	using Genode::uint16_t;
+	using Genode::uint32_t;
+
+	struct Ops;
+
+	template <unsigned> struct Vector;
+	template <unsigned> struct Kernels;
+
+	/**
+	 * Return operations suited for the CPU
+	 */
+	Ops const &select_ops();
+}
+
+
+/**
+ * Back end of the blit library
+ *
+ * Line lengths ('*_w') are given in bytes, widths ('w') in pixels.
+ */
+struct Blit::Ops
+{
+	char const *name;
+
+	void (*fill_16)(void *dst, unsigned dst_w, uint16_t pixel, int w, int h);
+	void (*fill_32)(void *dst, unsigned dst_w, uint32_t pixel, int w, int h);
+
+	void (*masked_16)(void const *src, unsigned src_w,
+	                  void *dst, unsigned dst_w, int w, int h);
+	void (*masked_32)(void const *src, unsigned src_w,
+	                  void *dst, unsigned dst_w, int w, int h);
+
+	void (*blend_rgb888)(void const *src, unsigned src_w,
+	                     unsigned char const *alpha, unsigned alpha_w,
+	                     void *dst, unsigned dst_w, int w, int h);
+
+	void (*rgb565_to_rgb888)(void const *src, unsigned src_w,
+	                         void *dst, unsigned dst_w, int w, int h);
+	void (*rgb888_to_rgb565)(void const *src, unsigned src_w,
+	                         void *dst, unsigned dst_w, int w, int h);
+};
+
+
+/*
+ * The 'vector_size' attribute is not evaluated for template-dependent
+ * arguments, hence the vector types are defined per size.
+ */
+#define BLIT_VECTOR(BYTES) \
+	template <> struct Blit::Vector<BYTES> \
+	{ \
+		typedef uint32_t V32 __attribute__((vector_size(BYTES))); \
+		typedef uint16_t V16 __attribute__((vector_size(BYTES))); \
+	};
+
+BLIT_VECTOR(8)
+BLIT_VECTOR(16)
+BLIT_VECTOR(32)
+
+#undef BLIT_VECTOR
+
+
+template <unsigned BYTES>
+struct Blit::Kernels
+{
+	enum { N32 = BYTES/4, N16 = BYTES/2 };
+
+	typedef typename Vector<BYTES>::V32 V32;
+	typedef typename Vector<BYTES>::V16 V16;
+
+	/*
+	 * Pixels are not necessarily aligned to the vector size
+	 */
+	template <typename V>
+	__attribute__((always_inline))
+	static inline void _load(V &v, void const *p) { __builtin_memcpy(&v, p, sizeof(v)); }
+
+	template <typename V>
+	__attribute__((always_inline))
+	static inline void _store(void *p, V const &v) { __builtin_memcpy(p, &v, sizeof(v)); }
+
+	template <typename V, typename T>
+	__attribute__((always_inline))
+	static inline void _splat(V &v, T value)
+	{
+		for (unsigned i = 0; i < sizeof(V)/sizeof(T); i++)
+			v[i] = value;
+	}
+
+	/**
+	 * Scale the color channels of an RGB888 pixel by 'alpha'
+	 *
+	 * Corresponds to 'Genode::Pixel_rgb888::blend'.
+	 */
+	static uint32_t _blend_pixel(uint32_t p, uint32_t alpha)
+	{
+		return ((alpha * ((p & 0xff00) >> 8)) & 0xff00)
+		     | (((alpha * (p & 0xff00ff)) >> 8) & 0xff00ff);
+	}
+
+	/**
+	 * Vector variant of '_blend_pixel'
+	 *
+	 * \param alpha2  alpha value replicated in both 16-bit halves of a lane
+	 *
+	 * The red and blue channels are scaled as 16-bit lanes at once, the
+	 * green channel separately, which avoids 32-bit multiplications.
+	 */
+	__attribute__((always_inline))
+	static inline void _blend(V32 &result, V32 const &p, V32 const &alpha2)
+	{
+		V32 const rb = (V32)(((V16)(p & 0x00ff00ff) * (V16)alpha2) >> 8);
+		V32 const g  = (V32)( (V16)((p >> 8) & 0x00ff00ff) * (V16)alpha2);
+
+		result = (rb & 0x00ff00ff) | (g & 0x0000ff00);
+	}
+
+	static uint32_t _rgb565_to_rgb888(uint32_t p)
+	{
+		return ((p & 0xf800) << 8) | ((p & 0x07e0) << 5) | ((p & 0x001f) << 3);
+	}
+
+	static uint32_t _rgb888_to_rgb565(uint32_t p)
+	{
+		return ((p >> 8) & 0xf800) | ((p >> 5) & 0x07e0) | ((p >> 3) & 0x001f);
+	}
+
+	template <typename T, typename V>
+	static void _fill(void *dst, unsigned dst_w, T pixel, int w, int h)
+	{
+		enum { N = sizeof(V)/sizeof(T) };
+
+		V v;
+		_splat(v, pixel);
+
+		for (char *line = (char *)dst; h-- > 0; line += dst_w) {
+			T *d = (T *)line;
+			int i = w;
+			for (; i >= (int)N; i -= N, d += N)
+				_store(d, v);
+			for (; i > 0; i--)
+				*d++ = pixel;
+		}
+	}
+
+	static void fill_16(void *dst, unsigned dst_w, uint16_t pixel, int w, int h) {
+		_fill<uint16_t, V16>(dst, dst_w, pixel, w, h); }
+
+	static void fill_32(void *dst, unsigned dst_w, uint32_t pixel, int w, int h) {
+		_fill<uint32_t, V32>(dst, dst_w, pixel, w, h); }
+
+	/**
+	 * Copy pixels except for those with value 0
+	 */
+	template <typename T, typename V>
+	static void _masked(void const *src, unsigned src_w,
+	                    void *dst, unsigned dst_w, int w, int h)
+	{
+		enum { N = sizeof(V)/sizeof(T) };
+
+		V zero;
+		_splat(zero, (T)0);
+
+		char const *src_line = (char const *)src;
+		char       *dst_line = (char       *)dst;
+
+		for (; h-- > 0; src_line += src_w, dst_line += dst_w) {
+			T const *s = (T const *)src_line;
+			T       *d = (T       *)dst_line;
+			int i = w;
+			for (; i >= (int)N; i -= N, s += N, d += N) {
+				V sv, dv;
+				_load(sv, s);
+				_load(dv, d);
+				V const keep = (V)(sv == zero);
+				_store(d, (keep & dv) | (~keep & sv));
+			}
+			for (; i > 0; i--, s++, d++)
+				if (*s) *d = *s;
+		}
+	}
+
+	static void masked_16(void const *src, unsigned src_w,
+	                      void *dst, unsigned dst_w, int w, int h) {
+		_masked<uint16_t, V16>(src, src_w, dst, dst_w, w, h); }
+
+	static void masked_32(void const *src, unsigned src_w,
+	                      void *dst, unsigned dst_w, int w, int h) {
+		_masked<uint32_t, V32>(src, src_w, dst, dst_w, w, h); }
+
+	/**
+	 * Mix RGB888 source pixels into the destination
+	 *
+	 * Corresponds to 'Genode::Pixel_rgb888::mix' for each pixel with a
+	 * non-zero alpha value.
+	 */
+	static void blend_rgb888(void const *src, unsigned src_w,
+	                         unsigned char const *alpha, unsigned alpha_w,
+	                         void *dst, unsigned dst_w, int w, int h)
+	{
+		V32 zero;
+		_splat(zero, (uint32_t)0);
+
+		char const *src_line = (char const *)src;
+		char       *dst_line = (char       *)dst;
+
+		for (; h-- > 0; src_line += src_w, dst_line += dst_w, alpha += alpha_w) {
+			uint32_t      const *s = (uint32_t const *)src_line;
+			uint32_t            *d = (uint32_t       *)dst_line;
+			unsigned char const *a = alpha;
+			int i = w;
+			for (; i >= (int)N32; i -= N32, s += N32, d += N32, a += N32) {
+
+				V32      av { };
+				uint32_t any = 0;
+				for (unsigned j = 0; j < N32; j++) {
+					av[j] = a[j];
+					any  |= a[j];
+				}
+
+				/* skip fully transparent pixels */
+				if (!any)
+					continue;
+
+				V32 const inv = 255 - av;
+				V32 dv, sv, dst_part, src_part;
+				_load(dv, d);
+				_load(sv, s);
+				_blend(dst_part, dv, inv | (inv << 16));
+				_blend(src_part, sv, av  | (av  << 16));
+				V32 const mix = dst_part + src_part;
+
+				V32 const keep = (V32)(av == zero);
+				_store(d, (keep & dv) | (~keep & mix));
+			}
+			for (; i > 0; i--, s++, d++, a++)
+				if (*a)
+					*d = _blend_pixel(*d, 255 - *a) + _blend_pixel(*s, *a);
+		}
+	}
+
+	static void rgb565_to_rgb888(void const *src, unsigned src_w,
+	                             void *dst, unsigned dst_w, int w, int h)
+	{
+		char const *src_line = (char const *)src;
+		char       *dst_line = (char       *)dst;
+
+		for (; h-- > 0; src_line += src_w, dst_line += dst_w) {
+			uint16_t const *s = (uint16_t const *)src_line;
+			uint32_t       *d = (uint32_t       *)dst_line;
+			int i = w;
+			for (; i >= (int)N32; i -= N32, s += N32, d += N32) {
+				V32 v { };
+				for (unsigned j = 0; j < N32; j++)
+					v[j] = s[j];
+
+				_store(d, ((v & 0xf800) << 8) | ((v & 0x07e0) << 5)
+				        | ((v & 0x001f) << 3));
+			}
+			for (; i > 0; i--)
+				*d++ = _rgb565_to_rgb888(*s++);
+		}
+	}
+
+	static void rgb888_to_rgb565(void const *src, unsigned src_w,
+	                             void *dst, unsigned dst_w, int w, int h)
+	{
+		char const *src_line = (char const *)src;
+		char       *dst_line = (char       *)dst;
+
+		for (; h-- > 0; src_line += src_w, dst_line += dst_w) {
+			uint32_t const *s = (uint32_t const *)src_line;
+			uint16_t       *d = (uint16_t       *)dst_line;
+			int i = w;
+			for (; i >= (int)N32; i -= N32, s += N32, d += N32) {
+				V32 v;
+				_load(v, s);
+				V32 const p = ((v >> 8) & 0xf800) | ((v >> 5) & 0x07e0)
+				            | ((v >> 3) & 0x001f);
+				for (unsigned j = 0; j < N32; j++)
+					d[j] = p[j];
+			}
+			for (; i > 0; i--)
+				*d++ = _rgb888_to_rgb565(*s++);
+		}
+	}
+
+	static Ops const &ops(char const *name)
+	{
+		static Ops const ops { name, fill_16, fill_32, masked_16, masked_32,
+		                       blend_rgb888, rgb565_to_rgb888, rgb888_to_rgb565 };
+		return ops;
+	}
+};
+
+#endif /* _LIB__BLIT__BLIT_KERNELS_H_ */
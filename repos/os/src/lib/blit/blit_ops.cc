@@ -0,0 +1,82 @@
+/*
+ * \brief  Pixel operations of the blit library
+ * \author Genode Labs
+ * \date   2017-04-10
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include <blit/blit.h>
+#include <blit_kernels.h>
+
+
+static Blit::Ops const &ops()
+{
+	static Blit::Ops const &ops = Blit::select_ops();
+	return ops;
+}
+
+
+extern "C" void blit_fill_16(void *dst, unsigned dst_w, unsigned short pixel,
+                             int w, int h)
+{
+	if (w > 0 && h > 0)
+		ops().fill_16(dst, dst_w, pixel, w, h);
+}
+
+
+extern "C" void blit_fill_32(void *dst, unsigned dst_w, unsigned pixel,
+                             int w, int h)
+{
+	if (w > 0 && h > 0)
+		ops().fill_32(dst, dst_w, pixel, w, h);
+}
+
+
+extern "C" void blit_masked_16(void const *src, unsigned src_w,
+                               void *dst, unsigned dst_w, int w, int h)
+{
+	if (w > 0 && h > 0)
+		ops().masked_16(src, src_w, dst, dst_w, w, h);
+}
+
+
+extern "C" void blit_masked_32(void const *src, unsigned src_w,
+                               void *dst, unsigned dst_w, int w, int h)
+{
+	if (w > 0 && h > 0)
+		ops().masked_32(src, src_w, dst, dst_w, w, h);
+}
+
+
+extern "C" void blit_blend_rgb888(void const *src, unsigned src_w,
+                                  unsigned char const *alpha, unsigned alpha_w,
+                                  void *dst, unsigned dst_w, int w, int h)
+{
+	if (w > 0 && h > 0)
+		ops().blend_rgb888(src, src_w, alpha, alpha_w, dst, dst_w, w, h);
+}
+
+
+extern "C" void blit_rgb565_to_rgb888(void const *src, unsigned src_w,
+                                      void *dst, unsigned dst_w, int w, int h)
+{
+	if (w > 0 && h > 0)
+		ops().rgb565_to_rgb888(src, src_w, dst, dst_w, w, h);
+}
+
+
+extern "C" void blit_rgb888_to_rgb565(void const *src, unsigned src_w,
+                                      void *dst, unsigned dst_w, int w, int h)
+{
+	if (w > 0 && h > 0)
+		ops().rgb888_to_rgb565(src, src_w, dst, dst_w, w, h);
+}
+
+
+extern "C" char const *blit_backend() { return ops().name; }
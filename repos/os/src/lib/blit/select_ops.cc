@@ -0,0 +1,20 @@
+/*
+ * \brief  Selection of the pixel operations, generic version
+ * \author Genode Labs
+ * \date   2017-04-10
+ *
+ * Without SIMD support, the compiler translates the vector operations of the
+ * kernels to scalar code.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include <blit_kernels.h>
+
+
+Blit::Ops const &Blit::select_ops() { return Kernels<16>::ops("generic"); }
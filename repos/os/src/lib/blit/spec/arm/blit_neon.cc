@@ -0,0 +1,22 @@
+/*
+ * \brief  Pixel operations using NEON
+ * \author Genode Labs
+ * \date   2017-04-10
+ *
+ * This file is compiled with '-mfpu=neon'. Its functions must be called
+ * only if the CPU supports NEON and the FPU is enabled.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include <blit_kernels.h>
+
+namespace Blit { Ops const &neon_ops(); }
+
+
+Blit::Ops const &Blit::neon_ops() { return Kernels<16>::ops("neon"); }
@@ -0,0 +1,31 @@
+/*
+ * \brief  Selection of the pixel operations for ARM
+ * \author Genode Labs
+ * \date   2017-04-10
+ *
+ * The feature registers of the CPU cannot be read in user mode, and NEON
+ * instructions fault if the kernel does not enable the FPU for user
+ * threads. Hence, the NEON operations are built and selected only for
+ * platforms that enable the FPU, which is denoted by 'BLIT_NEON'.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include <blit_kernels.h>
+
+namespace Blit { Ops const &neon_ops(); }
+
+
+Blit::Ops const &Blit::select_ops()
+{
+#ifdef BLIT_NEON
+	return neon_ops();
+#else
+	return Kernels<16>::ops("generic");
+#endif
+}
@@ -0,0 +1,27 @@
+/*
+ * \brief  CPUID instruction used for selecting the pixel operations
+ * \author Genode Labs
+ * \date   2017-04-10
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _LIB__BLIT__SPEC__X86__BLIT_CPUID_H_
+#define _LIB__BLIT__SPEC__X86__BLIT_CPUID_H_
+
+namespace Blit {
+
+	inline void cpuid(unsigned leaf, unsigned &a, unsigned &b,
+	                  unsigned &c, unsigned &d)
+	{
+		asm volatile ("cpuid" : "=a" (a), "=b" (b), "=c" (c), "=d" (d)
+		                      : "a" (leaf), "c" (0));
+	}
+}
+
+#endif /* _LIB__BLIT__SPEC__X86__BLIT_CPUID_H_ */
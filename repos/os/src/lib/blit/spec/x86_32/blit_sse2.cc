@@ -0,0 +1,22 @@
+/*
+ * \brief  Pixel operations using SSE2
+ * \author Genode Labs
+ * \date   2017-04-10
+ *
+ * This file is compiled with '-msse2'. Its functions must be called only
+ * if the CPU supports SSE2.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include <blit_kernels.h>
+
+namespace Blit { Ops const &sse2_ops(); }
+
+
+Blit::Ops const &Blit::sse2_ops() { return Kernels<16>::ops("sse2"); }
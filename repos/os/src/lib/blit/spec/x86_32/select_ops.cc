@@ -0,0 +1,37 @@
+/*
+ * \brief  Selection of the pixel operations for x86_32
+ * \author Genode Labs
+ * \date   2017-04-10
+ *
+ * SSE2 is not part of the x86_32 base architecture. It is used if the CPU
+ * supports it.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include <blit_kernels.h>
+#include <blit_cpuid.h>
+
+namespace Blit { Ops const &sse2_ops(); }
+
+
+static bool sse2_supported()
+{
+	unsigned a, b, c, d;
+	Blit::cpuid(1, a, b, c, d);
+	return d & (1 << 26);
+}
+
+
+Blit::Ops const &Blit::select_ops()
+{
+	if (sse2_supported())
+		return sse2_ops();
+
+	return Kernels<16>::ops("generic");
+}
@@ -0,0 +1,22 @@
+/*
+ * \brief  Pixel operations using AVX2
+ * \author Genode Labs
+ * \date   2017-04-10
+ *
+ * This file is compiled with '-mavx2'. Its functions must be called only
+ * if the CPU supports AVX2.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include <blit_kernels.h>
+
+namespace Blit { Ops const &avx2_ops(); }
+
+
+Blit::Ops const &Blit::avx2_ops() { return Kernels<32>::ops("avx2"); }
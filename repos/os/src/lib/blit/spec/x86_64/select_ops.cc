@@ -0,0 +1,55 @@
+/*
+ * \brief  Selection of the pixel operations for x86_64
+ * \author Genode Labs
+ * \date   2017-04-10
+ *
+ * SSE2 is part of the x86_64 base architecture. AVX2 is used if the CPU
+ * supports it and the kernel enabled the saving of the AVX register state.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include <blit_kernels.h>
+#include <blit_cpuid.h>
+
+namespace Blit { Ops const &avx2_ops(); }
+
+
+static bool avx2_supported()
+{
+	using Blit::cpuid;
+
+	unsigned a, b, c, d;
+
+	cpuid(0, a, b, c, d);
+	if (a < 7)
+		return false;
+
+	/* OSXSAVE and AVX */
+	cpuid(1, a, b, c, d);
+	if ((c & (1 << 27)) == 0 || (c & (1 << 28)) == 0)
+		return false;
+
+	/* SSE and AVX state enabled in XCR0 */
+	unsigned xcr0_lo, xcr0_hi;
+	asm volatile ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+	if ((xcr0_lo & 6) != 6)
+		return false;
+
+	cpuid(7, a, b, c, d);
+	return b & (1 << 5);
+}
+
+
+Blit::Ops const &Blit::select_ops()
+{
+	if (avx2_supported())
+		return avx2_ops();
+
+	return Kernels<16>::ops("sse2");
+}
@@ -0,0 +1,67 @@
+/*
+ * \brief  Internet checksum
+ * \author Genode Labs
+ * \date   2017-03-24
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <net/checksum.h>
+
+/* local includes */
+#include <checksum_sum.h>
+
+using namespace Genode;
+using namespace Net;
+
+
+struct Unaligned_word { uint16_t value; } __attribute__((packed));
+
+
+uint16_t Net::internet_sum(void const *data, size_t size, uint32_t initial)
+{
+	uint8_t const *bytes = (uint8_t const *)data;
+	uint64_t sum = initial;
+
+	/* bulk of the range */
+	sum += checksum_bulk_sum(bytes, size);
+
+	/* remaining 16-bit words */
+	for (; size >= 2; bytes += 2, size -= 2)
+		sum += ((Unaligned_word const *)bytes)->value;
+
+	/* pad odd byte with zero as if it was stored in memory */
+	if (size) {
+		Unaligned_word last { 0 };
+		*(uint8_t *)&last = *bytes;
+		sum += last.value;
+	}
+
+	/* fold 64-bit sum into 16 bits */
+	sum = (sum & 0xffffffff) + (sum >> 32);
+	sum = (sum & 0xffffffff) + (sum >> 32);
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+	return sum;
+}
+
+
+uint32_t Net::internet_pseudo_header_sum(Ipv4_address const &src,
+                                         Ipv4_address const &dst,
+                                         uint8_t      const  prot,
+                                         size_t       const  length)
+{
+	uint32_t sum = internet_sum(src.addr, sizeof(src.addr))
+	             + internet_sum(dst.addr, sizeof(dst.addr));
+
+	sum += host_to_big_endian((uint16_t)prot);
+	sum += host_to_big_endian((uint16_t)length);
+	return sum;
+}
@@ -0,0 +1,34 @@
+/*
+ * \brief  Generic wide-word summation used by the internet checksum
+ * \author Genode Labs
+ * \date   2017-03-24
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _CHECKSUM_SUM_H_
+#define _CHECKSUM_SUM_H_
+
+/* local includes */
+#include <checksum_vector.h>
+
+namespace Net {
+
+	/**
+	 * Sum up the bulk of a range with 128-bit vectors
+	 *
+	 * Targets without a vector unit fall back to 64-bit scalar code.
+	 */
+	inline Genode::uint64_t checksum_bulk_sum(Genode::uint8_t const *&data,
+	                                          Genode::size_t         &size)
+	{
+		return checksum_vector_sum<Checksum_vector_128>(data, size);
+	}
+}
+
+#endif /* _CHECKSUM_SUM_H_ */
@@ -0,0 +1,76 @@
+/*
+ * \brief  Vectorized one's-complement summation
+ * \author Genode Labs
+ * \date   2017-03-24
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _CHECKSUM_VECTOR_H_
+#define _CHECKSUM_VECTOR_H_
+
+/* Genode includes */
+#include <base/stdint.h>
+
+namespace Net {
+
+	typedef Genode::uint32_t Checksum_vector_128 __attribute__((vector_size(16)));
+	typedef Genode::uint32_t Checksum_vector_256 __attribute__((vector_size(32)));
+
+	/**
+	 * Sum up all complete vectors at the start of a range
+	 *
+	 * \param data  start of the range, advanced by the consumed bytes
+	 * \param size  size of the range, reduced by the consumed bytes
+	 *
+	 * \return  unfolded sum of the consumed 16-bit words
+	 *
+	 * The vectors are handled as 32-bit lanes, each split into its two
+	 * 16-bit halves. A lane thus grows by less than 2^17 per vector and
+	 * cannot overflow within 2^15 vectors, after which the lanes are
+	 * flushed into the 64-bit result. Summing whole 32-bit words keeps
+	 * the byte order of the 16-bit words because 2^16 equals 1 in
+	 * one's-complement arithmetic.
+	 *
+	 * The function is written with generic GCC vector types and compiles
+	 * to SSE2, AVX2, or NEON instructions depending on the target options
+	 * of its caller, which is why it must always be inlined.
+	 */
+	template <typename VECTOR>
+	inline __attribute__((always_inline))
+	Genode::uint64_t checksum_vector_sum(Genode::uint8_t const *&data,
+	                                     Genode::size_t         &size)
+	{
+		struct Unaligned { VECTOR value; } __attribute__((packed));
+
+		enum {
+			BYTES      = sizeof(VECTOR),
+			LANES      = BYTES / sizeof(Genode::uint32_t),
+			MAX_ROUNDS = 1 << 15,
+		};
+
+		Genode::uint64_t sum = 0;
+		while (size >= BYTES) {
+
+			Genode::size_t rounds = size / BYTES;
+			if (rounds > MAX_ROUNDS)
+				rounds = MAX_ROUNDS;
+
+			VECTOR acc = { };
+			for (; rounds; rounds--, data += BYTES, size -= BYTES) {
+				VECTOR const v = ((Unaligned const *)data)->value;
+				acc += (v & 0xffff) + (v >> 16);
+			}
+			for (unsigned i = 0; i < LANES; i++)
+				sum += acc[i];
+		}
+		return sum;
+	}
+}
+
+#endif /* _CHECKSUM_VECTOR_H_ */
@@ -17,6 +17,7 @@
 #include <net/udp.h>
 #include <net/tcp.h>
 #include <net/ipv4.h>
+#include <net/checksum.h>
 
 using namespace Genode;
 using namespace Net;
@@ -84,17 +85,17 @@ Ipv4_address Ipv4_packet::ip_from_string(const char *ip)
 
 Genode::uint16_t Ipv4_packet::calculate_checksum(Ipv4_packet const &packet)
 {
-	Genode::uint16_t const *data = packet.header<Genode::uint16_t>();
-	Genode::uint32_t const sum = host_to_big_endian(data[0])
-	                           + host_to_big_endian(data[1])
-	                           + host_to_big_endian(data[2])
-	                           + host_to_big_endian(data[3])
-	                           + host_to_big_endian(data[4])
-	                           + host_to_big_endian(data[6])
-	                           + host_to_big_endian(data[7])
-	                           + host_to_big_endian(data[8])
-	                           + host_to_big_endian(data[9]);
-	return ~((0xFFFF & sum) + (sum >> 16));
+	/* adding the complement of the checksum field cancels it out */
+	uint16_t const sum = internet_sum(&packet, packet._header_length * 4,
+	                                  (uint16_t)~packet._header_checksum);
+	return host_to_big_endian((uint16_t)~sum);
+}
+
+
+void Ipv4_packet::adapt_checksum(Ipv4_address const &old_ip,
+                                 Ipv4_address const &new_ip)
+{
+	_header_checksum = internet_checksum_update(_header_checksum, old_ip, new_ip);
 }
 
 
@@ -0,0 +1,81 @@
+/*
+ * \brief  Wide-word summation used by the internet checksum on x86_64
+ * \author Genode Labs
+ * \date   2017-03-24
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _CHECKSUM_SUM_H_
+#define _CHECKSUM_SUM_H_
+
+/* local includes */
+#include <checksum_vector.h>
+
+namespace Net {
+
+	/**
+	 * Return whether the CPU and the kernel support AVX2
+	 *
+	 * Besides the CPUID feature bits, the kernel must have enabled the
+	 * saving of the SSE and AVX register state in XCR0.
+	 */
+	inline bool checksum_avx2_available()
+	{
+		enum {
+			ECX_OSXSAVE = 1 << 27, ECX_AVX = 1 << 28, EBX_AVX2 = 1 << 5,
+			XCR0_SSE_AVX = 0x6,
+		};
+
+		unsigned eax, ebx, ecx, edx;
+		asm volatile ("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+		                      : "a"(0));
+		if (eax < 7)
+			return false;
+
+		asm volatile ("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+		                      : "a"(1));
+		if ((ecx & (ECX_OSXSAVE | ECX_AVX)) != (ECX_OSXSAVE | ECX_AVX))
+			return false;
+
+		unsigned xcr0_lo, xcr0_hi;
+		asm volatile ("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+		if ((xcr0_lo & XCR0_SSE_AVX) != XCR0_SSE_AVX)
+			return false;
+
+		asm volatile ("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+		                      : "a"(7), "c"(0));
+		return ebx & EBX_AVX2;
+	}
+
+	__attribute__((target("avx2"), noinline))
+	inline Genode::uint64_t checksum_avx2_sum(Genode::uint8_t const *&data,
+	                                          Genode::size_t         &size)
+	{
+		return checksum_vector_sum<Checksum_vector_256>(data, size);
+	}
+
+	/**
+	 * Sum up the bulk of a range with 256-bit AVX2 or 128-bit SSE2 vectors
+	 */
+	inline Genode::uint64_t checksum_bulk_sum(Genode::uint8_t const *&data,
+	                                          Genode::size_t         &size)
+	{
+		/* the CPU features do not change, a racy first detection is fine */
+		static int avx2 = -1;
+		if (avx2 < 0)
+			avx2 = checksum_avx2_available();
+
+		if (avx2)
+			return checksum_avx2_sum(data, size);
+
+		return checksum_vector_sum<Checksum_vector_128>(data, size);
+	}
+}
+
+#endif /* _CHECKSUM_SUM_H_ */
@@ -0,0 +1,826 @@
+/*
+ * \brief  Page cache for the file systems of a VFS sub tree
+ * \author Genode Labs
+ * \date   2017-04-05
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__VFS__CACHE_FILE_SYSTEM_H_
+#define _INCLUDE__VFS__CACHE_FILE_SYSTEM_H_
+
+/* Genode includes */
+#include <base/attached_ram_dataspace.h>
+#include <util/avl_string.h>
+#include <util/construct_at.h>
+#include <util/list.h>
+#include <vfs/dir_file_system.h>
+
+namespace Vfs { class Cache_file_system; }
+
+
+/**
+ * File system that caches the content of the regular files of its sub nodes
+ *
+ * The '<cache>' node hosts arbitrary VFS nodes, like a '<dir>' node without
+ * a name. The content of regular files is cached in pages of a fixed budget
+ * of RAM ('size' attribute), which is allocated at construction time. Pages
+ * are replaced in least-recently-used order. Sequential reads fetch up to
+ * 'read_ahead' bytes at once. Writes modify the cached pages only, which
+ * are written back on eviction, 'sync', 'ftruncate', or when the last
+ * writer of a file closes its handle. A page that cannot be written back
+ * stays dirty and the failure is reported by the next write to the file.
+ * Writes that need file content that cannot be read into the cache, e.g.,
+ * partial page writes via write-only handles, are written through.
+ *
+ * The cached content of a file is dropped when the file is modified via
+ * the cache, or if its inode or size changed when it is opened again.
+ * Modifications of the underlying file systems by other components while
+ * a file is open are not observed. Other files, e.g., device files, are
+ * passed through without caching.
+ */
+class Vfs::Cache_file_system : public File_system
+{
+	private:
+
+		typedef Genode::size_t size_t;
+
+		enum { PAGE_SIZE = 4096, MAX_READ_AHEAD_PAGES = 64 };
+
+		struct File;
+		struct Cache_handle;
+
+		struct Page
+		{
+			File      *file   = nullptr;
+			file_size  index  = 0;
+			size_t     length = 0;   /* valid bytes, less at the end of file */
+			bool       dirty  = false;
+			char      *data   = nullptr;
+
+			Page *hash_next = nullptr;
+			Page *lru_prev  = nullptr;
+			Page *lru_next  = nullptr;
+			Page *file_prev = nullptr;
+			Page *file_next = nullptr;
+		};
+
+		/*
+		 * Files are looked up by path, the pages of a file are chained
+		 * so that writing back or dropping them does not scan the cache.
+		 */
+		struct File : Genode::Avl_string<MAX_PATH_LEN>
+		{
+			unsigned long inode;
+			file_size     size;
+
+			unsigned handles     = 0;   /* open handles                  */
+			unsigned pages       = 0;   /* cached pages                  */
+			unsigned dirty       = 0;   /* cached pages not written back */
+			bool     removed     = false;
+			bool     write_error = false;
+
+			Page *page_list = nullptr;
+
+			Genode::List<Cache_handle> writers;
+
+			File(char const *path, unsigned long inode, file_size size)
+			: Avl_string(path), inode(inode), size(size) { }
+		};
+
+		struct Cache_handle : Vfs_handle, Genode::List<Cache_handle>::Element
+		{
+			Vfs_handle &sub;
+			File       &file;
+			bool        writer    = false;
+			file_size   next_read = 0;
+
+			Cache_handle(File_system &fs, Genode::Allocator &alloc,
+			             int status_flags, Vfs_handle &sub, File &file)
+			:
+				Vfs_handle(fs, fs, alloc, status_flags), sub(sub), file(file)
+			{ }
+		};
+
+		Genode::Allocator &_alloc;
+		Dir_file_system    _vfs;
+
+		size_t   const _size;
+		unsigned const _num_pages;
+		unsigned const _read_ahead_pages;
+
+		Genode::Attached_ram_dataspace _backing;
+
+		Page      *_pages;
+		Page     **_buckets;
+		unsigned   _bucket_mask;
+		Page      *_free     = nullptr;
+		Page      *_lru_head = nullptr;   /* least recently used */
+		Page      *_lru_tail = nullptr;
+
+		Genode::Avl_tree<Genode::Avl_string_base> _files;
+
+		/* buffer for reading multiple pages at once */
+		char *_buffer;
+
+		static unsigned _num_buckets(unsigned num_pages)
+		{
+			unsigned n = 1;
+			for (; n < num_pages; n *= 2);
+			return n;
+		}
+
+		static unsigned _pages_of(size_t bytes) { return bytes / PAGE_SIZE; }
+
+		template <typename T>
+		T *_alloc_array(unsigned n) { return (T *)_alloc.alloc(n*sizeof(T)); }
+
+		Page *&_bucket(File const &file, file_size index)
+		{
+			Genode::addr_t const h = ((Genode::addr_t)&file >> 4)
+			                       ^ (Genode::addr_t)(index * 2654435761UL);
+			return _buckets[h & _bucket_mask];
+		}
+
+		Page *_lookup(File const &file, file_size index)
+		{
+			for (Page *p = _bucket(file, index); p; p = p->hash_next)
+				if (p->file == &file && p->index == index)
+					return p;
+			return nullptr;
+		}
+
+		void _lru_remove(Page &page)
+		{
+			if (page.lru_prev) page.lru_prev->lru_next = page.lru_next;
+			else               _lru_head               = page.lru_next;
+
+			if (page.lru_next) page.lru_next->lru_prev = page.lru_prev;
+			else               _lru_tail               = page.lru_prev;
+
+			page.lru_prev = page.lru_next = nullptr;
+		}
+
+		void _lru_append(Page &page)
+		{
+			page.lru_prev = _lru_tail;
+			page.lru_next = nullptr;
+
+			if (_lru_tail) _lru_tail->lru_next = &page;
+			else           _lru_head           = &page;
+
+			_lru_tail = &page;
+		}
+
+		void _touch(Page &page)
+		{
+			if (_lru_tail == &page)
+				return;
+
+			_lru_remove(page);
+			_lru_append(page);
+		}
+
+		/**
+		 * Write dirty page to the underlying file system
+		 *
+		 * \return false if the page could not be written completely, in
+		 *         which case it stays dirty
+		 */
+		bool _write_back(Page &page)
+		{
+			File &file = *page.file;
+
+			Cache_handle *writer = file.writers.first();
+			if (!writer) {
+				Genode::error("no writer for dirty page of ", file.name());
+				file.write_error = true;
+				return false;
+			}
+
+			Vfs_handle &sub = writer->sub;
+			sub.seek(page.index*PAGE_SIZE);
+
+			for (size_t written = 0; written < page.length; ) {
+
+				file_size n = 0;
+				if (sub.fs().write(&sub, page.data + written,
+				                   page.length - written, n) != WRITE_OK || !n) {
+					Genode::error("write back to ", file.name(), " failed");
+					file.write_error = true;
+					return false;
+				}
+				written += n;
+				sub.advance_seek(n);
+			}
+
+			page.dirty = false;
+			file.dirty--;
+			return true;
+		}
+
+		/**
+		 * Remove page from the cache without writing it back
+		 */
+		void _free_page(Page &page)
+		{
+			File &file = *page.file;
+
+			for (Page **p = &_bucket(file, page.index); *p; p = &(*p)->hash_next)
+				if (*p == &page) {
+					*p = page.hash_next;
+					break;
+				}
+
+			_lru_remove(page);
+
+			if (page.file_prev) page.file_prev->file_next = page.file_next;
+			else                file.page_list            = page.file_next;
+
+			if (page.file_next) page.file_next->file_prev = page.file_prev;
+
+			page.file_prev = page.file_next = nullptr;
+
+			if (page.dirty)
+				file.dirty--;
+
+			file.pages--;
+
+			page.file      = nullptr;
+			page.dirty     = false;
+			page.hash_next = nullptr;
+			page.lru_next  = _free;
+			_free = &page;
+
+			_release_if_unused(file);
+		}
+
+		/**
+		 * Destroy file that is neither open nor cached
+		 */
+		void _release_if_unused(File &file)
+		{
+			if (file.handles || file.pages)
+				return;
+
+			if (!file.removed)
+				_files.remove(&file);
+
+			destroy(_alloc, &file);
+		}
+
+		/**
+		 * Obtain unused page for the given file position
+		 */
+		Page &_alloc_page(File &file, file_size index)
+		{
+			if (!_free) {
+
+				/* evict the least recently used page that is or becomes clean */
+				Page *victim = _lru_head;
+				while (victim && victim->dirty && !_write_back(*victim))
+					victim = victim->lru_next;
+
+				if (!victim) {
+					victim = _lru_head;
+					Genode::error("dropping modified page of ",
+					              victim->file->name(), ", write back failed");
+				}
+				_free_page(*victim);
+			}
+
+			Page &page = *_free;
+			_free = page.lru_next;
+
+			page.file      = &file;
+			page.index     = index;
+			page.length    = 0;
+			page.dirty     = false;
+			page.hash_next = _bucket(file, index);
+			_bucket(file, index) = &page;
+			_lru_append(page);
+
+			page.file_prev = nullptr;
+			page.file_next = file.page_list;
+			if (file.page_list)
+				file.page_list->file_prev = &page;
+			file.page_list = &page;
+
+			file.pages++;
+			return page;
+		}
+
+		/**
+		 * Write back the dirty pages of a file
+		 *
+		 * \return false if a page could not be written back
+		 */
+		bool _flush(File &file)
+		{
+			bool ok = true;
+			for (Page *p = file.page_list; p && file.dirty; p = p->file_next)
+				if (p->dirty && !_write_back(*p))
+					ok = false;
+			return ok;
+		}
+
+		void _flush_all()
+		{
+			for (unsigned i = 0; i < _num_pages; i++)
+				if (_pages[i].file && _pages[i].dirty)
+					_write_back(_pages[i]);
+		}
+
+		void _drop(File &file)
+		{
+			file.handles++;   /* keep 'file' alive while freeing its pages */
+
+			while (file.page_list)
+				_free_page(*file.page_list);
+
+			file.handles--;
+		}
+
+		/**
+		 * Write data to the underlying file system, bypassing the cache
+		 */
+		Write_result _write_through(Cache_handle &handle, char const *buf,
+		                            file_size count, file_size pos,
+		                            file_size &out_count)
+		{
+			File &file = handle.file;
+
+			out_count = 0;
+
+			/* the written data must not be overwritten by older pages */
+			if (!_flush(file))
+				return WRITE_ERR_IO;
+
+			_drop(file);
+
+			Vfs_handle &sub = handle.sub;
+			sub.seek(pos);
+
+			Write_result const result = sub.fs().write(&sub, buf, count, out_count);
+
+			if (result == WRITE_OK)
+				file.size = Genode::max(file.size, pos + out_count);
+
+			return result;
+		}
+
+		/**
+		 * Read pages starting at 'index' from the underlying file system
+		 *
+		 * \return page at 'index' or nullptr on error
+		 */
+		Page *_fill(Cache_handle &handle, file_size index, unsigned count)
+		{
+			File &file = handle.file;
+
+			/* fetch missing pages only, never beyond the end of the file */
+			file_size const end = (file.size + PAGE_SIZE - 1) / PAGE_SIZE;
+			unsigned n = 1;
+			while (n < count && index + n < end && !_lookup(file, index + n))
+				n++;
+
+			Vfs_handle &sub = handle.sub;
+			sub.seek(index*PAGE_SIZE);
+
+			size_t total = 0;
+			while (total < n*PAGE_SIZE) {
+				file_size got = 0;
+				if (sub.fs().read(&sub, _buffer + total, n*PAGE_SIZE - total, got)
+				    != READ_OK)
+					return nullptr;
+
+				if (!got)
+					break;
+
+				total += got;
+				sub.advance_seek(got);
+			}
+
+			Page *first = nullptr;
+			for (unsigned i = 0; i < n && (i == 0 || i*PAGE_SIZE < total); i++) {
+
+				Page &page = _alloc_page(file, index + i);
+
+				page.length = total > i*PAGE_SIZE
+				            ? Genode::min((size_t)PAGE_SIZE, total - i*PAGE_SIZE) : 0;
+				Genode::memcpy(page.data, _buffer + i*PAGE_SIZE, page.length);
+
+				if (!first) first = &page;
+			}
+			return first;
+		}
+
+		File *_lookup_file(char const *path)
+		{
+			Genode::Avl_string_base *f = _files.first();
+			return f ? static_cast<File *>(f->find_by_name(path)) : nullptr;
+		}
+
+		/**
+		 * Forget cached content of a file that was removed or renamed
+		 */
+		void _remove_file(char const *path)
+		{
+			File *file = _lookup_file(path);
+			if (!file)
+				return;
+
+			_files.remove(file);
+			file->removed = true;
+
+			_drop(*file);
+			_release_if_unused(*file);
+		}
+
+		/*
+		 * Noncopyable
+		 */
+		Cache_file_system(Cache_file_system const &);
+		Cache_file_system &operator = (Cache_file_system const &);
+
+	public:
+
+		Cache_file_system(Genode::Env         &env,
+		                  Genode::Allocator   &alloc,
+		                  Genode::Xml_node     config,
+		                  Io_response_handler &io_handler,
+		                  File_system_factory &fs_factory)
+		:
+			_alloc(alloc),
+			_vfs(env, alloc, config, io_handler, fs_factory),
+			_size(config.attribute_value("size",
+			                             Genode::Number_of_bytes(4*1024*1024))),
+			_num_pages(Genode::max(16U, _pages_of(_size))),
+			_read_ahead_pages(Genode::max(1U, Genode::min(
+				_pages_of(config.attribute_value("read_ahead",
+				                                 Genode::Number_of_bytes(32*1024))),
+				Genode::min((unsigned)MAX_READ_AHEAD_PAGES, _num_pages / 4)))),
+			_backing(env.ram(), env.rm(), _num_pages*PAGE_SIZE),
+			_pages(_alloc_array<Page>(_num_pages)),
+			_buckets(_alloc_array<Page *>(_num_buckets(_num_pages))),
+			_bucket_mask(_num_buckets(_num_pages) - 1),
+			_buffer(_alloc_array<char>(_read_ahead_pages*PAGE_SIZE))
+		{
+			for (unsigned i = 0; i <= _bucket_mask; i++)
+				_buckets[i] = nullptr;
+
+			for (unsigned i = _num_pages; i > 0; i--) {
+				Page &page = *Genode::construct_at<Page>(&_pages[i - 1]);
+				page.data     = _backing.local_addr<char>() + (i - 1)*PAGE_SIZE;
+				page.lru_next = _free;
+				_free = &page;
+			}
+		}
+
+		~Cache_file_system()
+		{
+			_flush_all();
+
+			_alloc.free(_buffer, _read_ahead_pages*PAGE_SIZE);
+			_alloc.free(_buckets, sizeof(Page *)*(_bucket_mask + 1));
+			_alloc.free(_pages, sizeof(Page)*_num_pages);
+
+			while (Genode::Avl_string_base *file = _files.first()) {
+				_files.remove(file);
+				destroy(_alloc, static_cast<File *>(file));
+			}
+		}
+
+		static char const *name()   { return "cache"; }
+		char const *type() override { return "cache"; }
+
+
+		/*********************************
+		 ** Directory-service interface **
+		 *********************************/
+
+		Dataspace_capability dataspace(char const *path) override
+		{
+			if (File *file = _lookup_file(path))
+				_flush(*file);
+
+			return _vfs.dataspace(path);
+		}
+
+		void release(char const *path, Dataspace_capability ds_cap) override {
+			_vfs.release(path, ds_cap); }
+
+		Stat_result stat(char const *path, Stat &out) override
+		{
+			Stat_result const result = _vfs.stat(path, out);
+
+			/* account for the pages not written back */
+			if (result == STAT_OK)
+				if (File *file = _lookup_file(path))
+					if (file->dirty)
+						out.size = Genode::max(out.size, file->size);
+
+			return result;
+		}
+
+		Dirent_result dirent(char const *path, file_offset index, Dirent &out) override {
+			return _vfs.dirent(path, index, out); }
+
+		Unlink_result unlink(char const *path) override
+		{
+			Unlink_result const result = _vfs.unlink(path);
+			if (result == UNLINK_OK)
+				_remove_file(path);
+
+			return result;
+		}
+
+		Readlink_result readlink(char const *path, char *buf, file_size buf_size,
+		                         file_size &out_len) override {
+			return _vfs.readlink(path, buf, buf_size, out_len); }
+
+		Rename_result rename(char const *from, char const *to) override
+		{
+			if (File *file = _lookup_file(from))
+				if (!_flush(*file))
+					return RENAME_ERR_NO_PERM;
+
+			Rename_result const result = _vfs.rename(from, to);
+			if (result == RENAME_OK) {
+				_remove_file(from);
+				_remove_file(to);
+			}
+			return result;
+		}
+
+		Mkdir_result mkdir(char const *path, unsigned mode) override {
+			return _vfs.mkdir(path, mode); }
+
+		Symlink_result symlink(char const *from, char const *to) override {
+			return _vfs.symlink(from, to); }
+
+		file_size num_dirent(char const *path) override {
+			return _vfs.num_dirent(path); }
+
+		bool directory(char const *path) override {
+			return _vfs.directory(path); }
+
+		char const *leaf_path(char const *path) override {
+			return _vfs.leaf_path(path); }
+
+		Open_result open(char const *path, unsigned mode,
+		                 Vfs_handle **out_handle,
+		                 Genode::Allocator &alloc) override
+		{
+			Vfs_handle *sub = nullptr;
+
+			Open_result const result = _vfs.open(path, mode, &sub, alloc);
+			if (result != OPEN_OK)
+				return result;
+
+			/* pass through handles of files other than regular files */
+			Stat st;
+			if (_vfs.stat(path, st) != STAT_OK
+			 || (st.mode & STAT_MODE_FILE) != STAT_MODE_FILE) {
+				*out_handle = sub;
+				return OPEN_OK;
+			}
+
+			File *file = _lookup_file(path);
+
+			/* drop cached content of a file changed behind our back */
+			if (file && !file->writers.first()
+			 && (file->inode != st.inode || file->size != st.size)) {
+				_drop(*file);
+				file->inode = st.inode;
+				file->size  = st.size;
+			}
+
+			try {
+				if (!file) {
+					file = new (_alloc) File(path, st.inode, st.size);
+					_files.insert(file);
+				}
+
+				*out_handle = new (alloc)
+					Cache_handle(*this, alloc, mode, *sub, *file);
+			}
+			catch (Genode::Allocator::Out_of_memory) {
+				sub->ds().close(sub);
+				if (file) _release_if_unused(*file);
+				return OPEN_ERR_NO_SPACE;
+			}
+
+			file->handles++;
+			return OPEN_OK;
+		}
+
+		void close(Vfs_handle *vfs_handle) override
+		{
+			Cache_handle &handle = *static_cast<Cache_handle *>(vfs_handle);
+			File         &file   = handle.file;
+
+			if (handle.writer) {
+
+				/*
+				 * The last writer writes back the dirty pages. Pages that
+				 * cannot be written back are lost without a writer.
+				 */
+				if (file.writers.first() == &handle && !handle.next()) {
+					if (!_flush(file) || file.write_error) {
+						Genode::error("write back to ", file.name(), " failed "
+						              "before close, modifications are lost");
+						_drop(file);
+						file.write_error = false;
+					}
+				}
+
+				file.writers.remove(&handle);
+			}
+
+			handle.sub.ds().close(&handle.sub);
+
+			destroy(handle.alloc(), &handle);
+
+			file.handles--;
+			_release_if_unused(file);
+		}
+
+
+		/***************************
+		 ** File_system interface **
+		 ***************************/
+
+		void sync(char const *path) override
+		{
+			_flush_all();
+			_vfs.sync(path);
+		}
+
+		void apply_config(Genode::Xml_node const &node) override {
+			_vfs.apply_config(node); }
+
+
+		/********************************
+		 ** File I/O service interface **
+		 ********************************/
+
+		Write_result write(Vfs_handle *vfs_handle, char const *buf,
+		                   file_size count, file_size &out_count) override
+		{
+			Cache_handle &handle = *static_cast<Cache_handle *>(vfs_handle);
+			File         &file   = handle.file;
+
+			out_count = 0;
+
+			if ((handle.status_flags() & OPEN_MODE_ACCMODE) == OPEN_MODE_RDONLY)
+				return WRITE_ERR_INVALID;
+
+			if (!handle.writer) {
+				file.writers.insert(&handle);
+				handle.writer = true;
+			}
+
+			/* report the failed write back of earlier modifications */
+			if (file.write_error) {
+				file.write_error = false;
+				return WRITE_ERR_IO;
+			}
+
+			file_size pos = handle.seek();
+
+			/*
+			 * A write beyond the end of the file leaves a hole that is not
+			 * cached. Hence, write it through.
+			 */
+			if (pos > file.size)
+				return _write_through(handle, buf, count, pos, out_count);
+
+			while (count) {
+
+				file_size const index  = pos / PAGE_SIZE;
+				size_t    const offset = pos % PAGE_SIZE;
+				size_t    const n      = Genode::min((file_size)PAGE_SIZE - offset, count);
+
+				/* bytes of the page present in the file before the write */
+				size_t const valid = Genode::min((file_size)PAGE_SIZE,
+				                                 file.size - index*PAGE_SIZE);
+
+				Page *page = _lookup(file, index);
+
+				/*
+				 * A partially written page is completed by the file content.
+				 * If the content cannot be read completely, the remaining
+				 * data is written through.
+				 */
+				if (!page && (offset || offset + n < valid)) {
+
+					page = _fill(handle, index, 1);
+
+					if (!page || page->length < valid) {
+						if (page)
+							_free_page(*page);
+
+						file_size written = 0;
+						Write_result const result =
+							_write_through(handle, buf, count, pos, written);
+
+						out_count += written;
+						return out_count ? WRITE_OK : result;
+					}
+				}
+
+				if (!page)
+					page = &_alloc_page(file, index);
+
+				Genode::memcpy(page->data + offset, buf, n);
+
+				page->length = Genode::max(page->length, offset + n);
+
+				if (!page->dirty) {
+					page->dirty = true;
+					file.dirty++;
+				}
+				_touch(*page);
+
+				pos       += n;
+				buf       += n;
+				count     -= n;
+				out_count += n;
+
+				file.size = Genode::max(file.size, pos);
+			}
+
+			return WRITE_OK;
+		}
+
+		Read_result read(Vfs_handle *vfs_handle, char *dst, file_size count,
+		                 file_size &out_count) override
+		{
+			Cache_handle &handle = *static_cast<Cache_handle *>(vfs_handle);
+			File         &file   = handle.file;
+
+			out_count = 0;
+
+			file_size pos = handle.seek();
+
+			while (count && pos < file.size) {
+
+				file_size const index  = pos / PAGE_SIZE;
+				size_t    const offset = pos % PAGE_SIZE;
+
+				Page *page = _lookup(file, index);
+				if (!page) {
+					unsigned const pages = pos == handle.next_read
+					                     ? _read_ahead_pages : 1;
+
+					page = _fill(handle, index, pages);
+					if (!page)
+						return out_count ? READ_OK : READ_ERR_IO;
+				}
+				_touch(*page);
+
+				/* end of file */
+				if (offset >= page->length)
+					break;
+
+				size_t const n = Genode::min((file_size)page->length - offset, count);
+
+				Genode::memcpy(dst, page->data + offset, n);
+
+				pos       += n;
+				dst       += n;
+				count     -= n;
+				out_count += n;
+			}
+
+			handle.next_read = pos;
+			return READ_OK;
+		}
+
+		Ftruncate_result ftruncate(Vfs_handle *vfs_handle, file_size len) override
+		{
+			Cache_handle &handle = *static_cast<Cache_handle *>(vfs_handle);
+			File         &file   = handle.file;
+
+			if (!_flush(file))
+				return FTRUNCATE_ERR_NO_SPACE;
+
+			_drop(file);
+
+			Ftruncate_result const result = handle.sub.fs().ftruncate(&handle.sub, len);
+			if (result == FTRUNCATE_OK)
+				file.size = len;
+
+			return result;
+		}
+
+		bool read_ready(Vfs_handle *) override { return true; }
+};
+
+#endif /* _INCLUDE__VFS__CACHE_FILE_SYSTEM_H_ */
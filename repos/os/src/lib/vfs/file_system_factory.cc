@@ -18,6 +18,7 @@
 
 /* supported builtin file systems */
 #include <block_file_system.h>
+#include <cache_file_system.h>
 #include <fs_file_system.h>
 #include <inline_file_system.h>
 #include <log_file_system.h>
@@ -37,6 +38,7 @@ namespace Vfs {
 
 	template <typename> struct Builtin_entry;
 	struct External_entry;
+	struct Cache_entry;
 }
 
 
@@ -89,6 +91,29 @@ struct Vfs::External_entry : Vfs::Global_file_system_factory::Entry_base
 };
 
 
+/**
+ * Entry for the cache file system, which creates its sub file systems
+ * via the global factory
+ */
+struct Vfs::Cache_entry : Vfs::Global_file_system_factory::Entry_base
+{
+	File_system_factory &_fs_factory;
+
+	Cache_entry(Vfs::File_system_factory &fs_factory)
+	:
+		Entry_base(Cache_file_system::name()), _fs_factory(fs_factory) { }
+
+	Vfs::File_system *create(Genode::Env       &env,
+	                         Genode::Allocator &alloc,
+	                         Genode::Xml_node   node,
+	                         Vfs::Io_response_handler &io_handler) override
+	{
+		return new (alloc) Cache_file_system(env, alloc, node, io_handler,
+		                                     _fs_factory);
+	}
+};
+
+
 /**
  * Add builtin File_system type
  */
@@ -253,4 +278,6 @@ Vfs::Global_file_system_factory::Global_file_system_factory(Genode::Allocator &a
 	_add_builtin_fs<Vfs::Rtc_file_system>();
 	_add_builtin_fs<Vfs::Ram_file_system>();
 	_add_builtin_fs<Vfs::Symlink_file_system>();
+
+	_list.insert(new (&_md_alloc) Cache_entry(*this));
 }
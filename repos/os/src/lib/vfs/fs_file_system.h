@@ -64,6 +64,8 @@ class Vfs::Fs_file_system : public File_system
 
 		Handle_space _handle_space;
 
+		enum { MAX_READ_AHEAD = 8 };
+
 		struct Handle_state
 		{
 			enum class Read_ready_state { IDLE, PENDING, READY };
@@ -75,6 +77,73 @@ class Vfs::Fs_file_system : public File_system
 
 			::File_system::Packet_descriptor queued_read_packet;
 			::File_system::Packet_descriptor queued_write_packet;
+
+			/*
+			 * Reads issued by 'queue_read', including the reads ahead of
+			 * the current seek position
+			 */
+			struct Read
+			{
+				/* 'DISCARD' marks a packet in flight whose data is not needed */
+				enum class State { FREE, QUEUED, ACK, DISCARD };
+
+				State                            state     = State::FREE;
+				file_size                        position  = 0;
+				file_size                        requested = 0;
+				::File_system::Packet_descriptor packet;
+
+				bool active() const {
+					return state == State::QUEUED || state == State::ACK; }
+			};
+
+			Read      reads[1 + MAX_READ_AHEAD];
+			file_size read_size      = 0;  /* size of the reads ahead         */
+			file_size read_ahead_end = 0;  /* position after the last read    */
+			file_size next_read      = 0;  /* position after the last result  */
+			bool      read_eof       = false;
+
+			/* write-behind state */
+			bool      write_behind   = false;
+			bool      write_error    = false;
+			unsigned  pending_writes = 0;
+			file_size write_end      = 0;  /* position after the last write   */
+
+			/**
+			 * Return read that covers the given position
+			 */
+			Read *read_at(file_size position)
+			{
+				for (Read &read : reads)
+					if (read.active() && read.position <= position
+					 && position < read.position + read.requested)
+						return &read;
+				return nullptr;
+			}
+
+			Read *free_read()
+			{
+				for (Read &read : reads)
+					if (read.state == Read::State::FREE)
+						return &read;
+				return nullptr;
+			}
+
+			unsigned active_reads() const
+			{
+				unsigned n = 0;
+				for (Read const &read : reads)
+					if (read.active()) n++;
+				return n;
+			}
+
+			bool reads_in_flight() const
+			{
+				for (Read const &read : reads)
+					if (read.state == Read::State::QUEUED
+					 || read.state == Read::State::DISCARD)
+						return true;
+				return false;
+			}
 		};
 
 		struct Fs_vfs_handle : Vfs_handle, Handle_space::Element, Handle_state
@@ -116,7 +185,16 @@ class Vfs::Fs_file_system : public File_system
 		{
 			Genode::Entrypoint  &_ep;
 			Io_response_handler &_io_handler;
-			Vfs_handle::Context *_context = nullptr;
+			/*
+			 * Contexts armed while handling one signal. If more contexts
+			 * are armed, the remaining ones are reported by a response
+			 * without context.
+			 */
+			enum { MAX_CONTEXTS = 8 };
+
+			Vfs_handle::Context *_contexts[MAX_CONTEXTS];
+			unsigned             _num_contexts = 0;
+			bool                 _overflow     = false;
 
 			Post_signal_hook(Genode::Entrypoint &ep,
 			                 Io_response_handler &io_handler)
@@ -124,26 +202,272 @@ class Vfs::Fs_file_system : public File_system
 
 			void arm(Vfs_handle::Context *context)
 			{
-				_context = context;
+				bool armed = false;
+				for (unsigned i = 0; i < _num_contexts; i++)
+					if (_contexts[i] == context)
+						armed = true;
+
+				if (!armed) {
+					if (_num_contexts < MAX_CONTEXTS)
+						_contexts[_num_contexts++] = context;
+					else
+						_overflow = true;
+				}
+
 				_ep.schedule_post_signal_hook(this);
 			}
 
 			void function() override
 			{
 				/*
-				 * XXX The current implementation executes the post signal hook
-				 *     for the last armed context only. When changing this,
-				 *     beware that the called handle_io_response() may change
-				 *     this object in a signal handler.
+				 * The called handle_io_response() may arm the hook again.
+				 * Hence, the armed contexts are taken over before.
 				 */
+				Vfs_handle::Context *contexts[MAX_CONTEXTS];
 
-				_io_handler.handle_io_response(_context);
-				_context = nullptr;
+				unsigned const num_contexts = _num_contexts;
+				bool     const overflow     = _overflow;
+
+				for (unsigned i = 0; i < num_contexts; i++)
+					contexts[i] = _contexts[i];
+
+				_num_contexts = 0;
+				_overflow     = false;
+
+				for (unsigned i = 0; i < num_contexts; i++)
+					_io_handler.handle_io_response(contexts[i]);
+
+				if (overflow)
+					_io_handler.handle_io_response(nullptr);
 			}
 		};
 
 		Post_signal_hook _post_signal_hook { _env.ep(), _io_handler };
 
+		/**
+		 * Directory entries obtained by the most recent directory read
+		 *
+		 * Directories are listed entry by entry via 'dirent'. Instead of
+		 * issuing one packet per entry, a single read fetches a batch of
+		 * consecutive entries, which serves the following 'dirent' calls.
+		 * A read of the first entry of the batch always refetches the batch
+		 * so that a new listing observes modifications by other clients.
+		 */
+		struct Dirent_cache
+		{
+			enum { MAX_ENTRIES = 16 };
+
+			Absolute_path                   path;
+			file_offset                     first = 0;
+			unsigned                        count = 0;
+			::File_system::Directory_entry  entries[MAX_ENTRIES];
+
+			::File_system::Directory_entry const *lookup(char const *p,
+			                                             file_offset index) const
+			{
+				if (!count || index <= first || index >= first + count
+				 || !(path == p))
+					return nullptr;
+
+				return &entries[index - first];
+			}
+
+			void invalidate() { count = 0; }
+		};
+
+		Dirent_cache _dirent_cache;
+
+		static Dirent_result _dirent(::File_system::Directory_entry const &entry,
+		                             Dirent &out)
+		{
+			using ::File_system::Directory_entry;
+
+			/*
+			 * The default value has no meaning because the switch below
+			 * assigns a value in each possible branch. But it is needed to
+			 * keep the compiler happy.
+			 */
+			Dirent_type type = DIRENT_TYPE_END;
+
+			/* copy-out payload into destination buffer */
+			switch (entry.type) {
+			case Directory_entry::TYPE_DIRECTORY: type = DIRENT_TYPE_DIRECTORY; break;
+			case Directory_entry::TYPE_FILE:      type = DIRENT_TYPE_FILE;      break;
+			case Directory_entry::TYPE_SYMLINK:   type = DIRENT_TYPE_SYMLINK;   break;
+			}
+
+			out.fileno = entry.inode;
+			out.type   = type;
+			strncpy(out.name, entry.name, sizeof(out.name));
+
+			return DIRENT_OK;
+		}
+
+		/*
+		 * Number of packets read ahead of the current position of a handle
+		 * ('read_ahead' config attribute) and write-behind mode
+		 * ('write_behind'). In write-behind mode, a write returns as soon as
+		 * the data is submitted. The writes are awaited by 'sync', 'stat',
+		 * 'close', and by reads of the same handle.
+		 */
+		unsigned const _read_ahead;
+		bool     const _write_behind;
+
+		/* write-behind packets in flight of all handles */
+		unsigned _pending_writes = 0;
+
+		typedef Handle_state::Read Read;
+
+		/**
+		 * Wait until the write-behind packets of 'handle' are acknowledged
+		 */
+		void _drain_writes(Fs_vfs_handle &handle)
+		{
+			while (handle.pending_writes)
+				_env.ep().wait_and_dispatch_one_signal();
+		}
+
+		void _drain_all_writes()
+		{
+			while (_pending_writes)
+				_env.ep().wait_and_dispatch_one_signal();
+		}
+
+		/**
+		 * Drop data read ahead, packets in flight are released on arrival
+		 */
+		void _discard_reads(Fs_vfs_handle &handle)
+		{
+			for (Read &read : handle.reads) {
+				switch (read.state) {
+				case Read::State::QUEUED:
+					read.state = Read::State::DISCARD;
+					break;
+				case Read::State::ACK:
+					_fs.tx()->release_packet(read.packet);
+					read.state = Read::State::FREE;
+					break;
+				case Read::State::FREE:
+				case Read::State::DISCARD:
+					break;
+				}
+			}
+			handle.read_eof = false;
+		}
+
+		/**
+		 * Drop data read ahead by any handle
+		 *
+		 * The handles of the session do not tell which of them refer to the
+		 * same file. So a write conservatively outdates the reads ahead of
+		 * all handles.
+		 */
+		void _discard_all_reads()
+		{
+			_handle_space.for_each<Fs_vfs_handle>([&] (Fs_vfs_handle &handle) {
+				_discard_reads(handle); });
+		}
+
+		bool _submit_read(Fs_vfs_handle &handle, Read &read,
+		                  file_size position, file_size count)
+		{
+			::File_system::Session::Tx::Source &source = *_fs.tx();
+
+			if (!source.ready_to_submit())
+				return false;
+
+			::File_system::Packet_descriptor p;
+			try {
+				p = source.alloc_packet(count);
+			} catch (::File_system::Session::Tx::Source::Packet_alloc_failed) {
+				return false;
+			}
+
+			read.packet    = ::File_system::Packet_descriptor(p,
+			                     handle.file_handle(),
+			                     ::File_system::Packet_descriptor::READ,
+			                     count, position);
+			read.position  = position;
+			read.requested = count;
+			read.state     = Read::State::QUEUED;
+
+			source.submit_packet(read.packet);
+			return true;
+		}
+
+		/**
+		 * Keep up to '_read_ahead' reads in flight beyond the current read
+		 */
+		void _read_ahead_of(Fs_vfs_handle &handle)
+		{
+			while (!handle.read_eof && handle.active_reads() < 1 + _read_ahead) {
+
+				Read *read = handle.free_read();
+				if (!read || !_submit_read(handle, *read, handle.read_ahead_end,
+				                           handle.read_size))
+					return;
+
+				handle.read_ahead_end += handle.read_size;
+			}
+		}
+
+		/**
+		 * Submit write without waiting for its acknowledgement
+		 *
+		 * A failed write-behind packet is reported by the next write of the
+		 * handle.
+		 */
+		Write_result _queue_write(Fs_vfs_handle &handle, char const *buf,
+		                          file_size count, file_size seek_offset,
+		                          file_size &out_count)
+		{
+			if (handle.write_error) {
+				handle.write_error = false;
+				return WRITE_ERR_IO;
+			}
+
+			/* only a contiguous write may overtake the pending writes */
+			if (handle.pending_writes && seek_offset != handle.write_end)
+				_drain_writes(handle);
+
+			::File_system::Session::Tx::Source &source = *_fs.tx();
+			using ::File_system::Packet_descriptor;
+
+			count = min(count, (file_size)source.bulk_buffer_size() / 4);
+
+			Packet_descriptor p;
+			for (;;) {
+				if (source.ready_to_submit()) {
+					try {
+						p = source.alloc_packet(count);
+						break;
+					}
+					catch (::File_system::Session::Tx::Source::Packet_alloc_failed) { }
+				}
+
+				/* wait for the bulk buffer to be freed by pending writes */
+				if (!_pending_writes)
+					return WRITE_ERR_AGAIN;
+
+				_env.ep().wait_and_dispatch_one_signal();
+			}
+
+			Packet_descriptor const packet(p, handle.file_handle(),
+			                               Packet_descriptor::WRITE,
+			                               count, seek_offset);
+
+			memcpy(source.packet_content(packet), buf, count);
+
+			handle.pending_writes++;
+			handle.write_end = seek_offset + count;
+			_pending_writes++;
+
+			source.submit_packet(packet);
+
+			out_count = count;
+			return WRITE_OK;
+		}
+
 		file_size _read(Fs_vfs_handle &handle, void *buf,
 		                file_size const count, file_size const seek_offset)
 		{
@@ -237,6 +561,58 @@ class Vfs::Fs_file_system : public File_system
 			return write_num_bytes;
 		}
 
+		/**
+		 * Match acknowledged packet with the reads issued by 'queue_read'
+		 *
+		 * \return true if the acknowledgement needs no further handling
+		 */
+		bool _handle_read_ack(Fs_vfs_handle &handle,
+		                      ::File_system::Packet_descriptor const &packet)
+		{
+			for (Read &read : handle.reads) {
+
+				if (read.state != Read::State::QUEUED
+				 && read.state != Read::State::DISCARD)
+					continue;
+
+				if (read.packet.offset() != packet.offset())
+					continue;
+
+				if (read.state == Read::State::DISCARD) {
+					_fs.tx()->release_packet(packet);
+					read.state = Read::State::FREE;
+					return true;
+				}
+
+				/* a short read marks the end of the file */
+				if (packet.length() < read.requested)
+					handle.read_eof = true;
+
+				read.packet = packet;
+				read.state  = Read::State::ACK;
+
+				/* only the read at the seek position is of interest */
+				if (handle.read_at(handle.seek()) != &read)
+					return true;
+
+				_post_signal_hook.arm(handle.context);
+				return true;
+			}
+			return false;
+		}
+
+		void _handle_write_behind_ack(Fs_vfs_handle &handle,
+		                              ::File_system::Packet_descriptor const &packet)
+		{
+			if (!packet.succeeded() || packet.length() < packet.size())
+				handle.write_error = true;
+
+			_fs.tx()->release_packet(packet);
+
+			handle.pending_writes--;
+			_pending_writes--;
+		}
+
 		void _handle_ack()
 		{
 			::File_system::Session::Tx::Source &source = *_fs.tx();
@@ -257,11 +633,19 @@ class Vfs::Fs_file_system : public File_system
 							break;
 
 						case Packet_descriptor::READ:
+							if (_handle_read_ack(handle, packet))
+								return;
+
 							handle.queued_read_packet = packet;
 							handle.queued_read_state  = Handle_state::Queued_state::ACK;
 							break;
 
 						case Packet_descriptor::WRITE:
+							if (handle.write_behind) {
+								_handle_write_behind_ack(handle, packet);
+								return;
+							}
+
 							handle.queued_write_packet = packet;
 							handle.queued_write_state  = Handle_state::Queued_state::ACK;
 							break;
@@ -292,7 +676,10 @@ class Vfs::Fs_file_system : public File_system
 			_fs(env, _fs_packet_alloc,
 			    _label.string(), _root.string(),
 			    config.attribute_value("writeable", true),
-			    ::File_system::DEFAULT_TX_BUF_SIZE)
+			    ::File_system::DEFAULT_TX_BUF_SIZE),
+			_read_ahead(min(config.attribute_value("read_ahead", 0U),
+			                (unsigned)MAX_READ_AHEAD)),
+			_write_behind(config.attribute_value("write_behind", false))
 		{
 			_fs.sigh_ack_avail(_ack_handler);
 		}
@@ -305,6 +692,8 @@ class Vfs::Fs_file_system : public File_system
 		{
 			Lock::Guard guard(_lock);
 
+			_drain_all_writes();
+
 			Absolute_path dir_path(path);
 			dir_path.strip_last_element();
 
@@ -363,6 +752,9 @@ class Vfs::Fs_file_system : public File_system
 		{
 			::File_system::Status status;
 
+			/* the file size must account for the pending writes */
+			_drain_all_writes();
+
 			try {
 				::File_system::Node_handle node = _fs.node(path);
 				Fs_handle_guard node_guard(*this, _fs, node, _handle_space);
@@ -398,6 +790,9 @@ class Vfs::Fs_file_system : public File_system
 			if (strcmp(path, "") == 0)
 				path = "/";
 
+			if (Directory_entry const *entry = _dirent_cache.lookup(path, index))
+				return _dirent(*entry, out);
+
 			::File_system::Dir_handle dir_handle;
 			try { dir_handle = _fs.dir(path, false); }
 			catch (::File_system::Lookup_failed) { return DIRENT_ERR_INVALID_PATH; }
@@ -405,35 +800,32 @@ class Vfs::Fs_file_system : public File_system
 			catch (...) { return DIRENT_ERR_NO_PERM; }
 
 			Fs_handle_guard dir_guard(*this, _fs, dir_handle, _handle_space);
-			Directory_entry entry;
 
 			enum { DIRENT_SIZE = sizeof(Directory_entry) };
 
-			_read(dir_guard, &entry, DIRENT_SIZE, index*DIRENT_SIZE);
+			/* fetch batch of entries starting at 'index' */
+			_dirent_cache.invalidate();
+			file_size const num_bytes =
+				_read(dir_guard, _dirent_cache.entries,
+				      sizeof(_dirent_cache.entries), index*DIRENT_SIZE);
 
-			/*
-			 * The default value has no meaning because the switch below
-			 * assigns a value in each possible branch. But it is needed to
-			 * keep the compiler happy.
-			 */
-			Dirent_type type = DIRENT_TYPE_END;
-
-			/* copy-out payload into destination buffer */
-			switch (entry.type) {
-			case Directory_entry::TYPE_DIRECTORY: type = DIRENT_TYPE_DIRECTORY; break;
-			case Directory_entry::TYPE_FILE:      type = DIRENT_TYPE_FILE;      break;
-			case Directory_entry::TYPE_SYMLINK:   type = DIRENT_TYPE_SYMLINK;   break;
+			if (num_bytes < DIRENT_SIZE) {
+				out = Dirent();
+				out.type = DIRENT_TYPE_END;
+				return DIRENT_OK;
 			}
 
-			out.fileno = entry.inode;
-			out.type   = type;
-			strncpy(out.name, entry.name, sizeof(out.name));
+			_dirent_cache.path  = path;
+			_dirent_cache.first = index;
+			_dirent_cache.count = num_bytes / DIRENT_SIZE;
 
-			return DIRENT_OK;
+			return _dirent(_dirent_cache.entries[0], out);
 		}
 
 		Unlink_result unlink(char const *path) override
 		{
+			_dirent_cache.invalidate();
+
 			Absolute_path dir_path(path);
 			dir_path.strip_last_element();
 
@@ -501,6 +893,8 @@ class Vfs::Fs_file_system : public File_system
 			Absolute_path to_file_name(to_path);
 			to_file_name.keep_only_last_element();
 
+			_dirent_cache.invalidate();
+
 			try {
 				::File_system::Dir_handle from_dir = _fs.dir(from_dir_path.base(), false);
 				Fs_handle_guard from_dir_guard(*this, _fs, from_dir, _handle_space);
@@ -523,6 +917,8 @@ class Vfs::Fs_file_system : public File_system
 			 */
 			Absolute_path abs_path(path);
 
+			_dirent_cache.invalidate();
+
 			try {
 				_fs.close(_fs.dir(abs_path.base(), true));
 			}
@@ -553,6 +949,8 @@ class Vfs::Fs_file_system : public File_system
 			Absolute_path symlink_name(to);
 			symlink_name.keep_only_last_element();
 
+			_dirent_cache.invalidate();
+
 			try {
 				::File_system::Dir_handle dir_handle = _fs.dir(abs_path.base(), false);
 				Fs_handle_guard from_dir_guard(*this, _fs, dir_handle, _handle_space);
@@ -634,6 +1032,9 @@ class Vfs::Fs_file_system : public File_system
 
 			bool const create = vfs_mode & OPEN_MODE_CREATE;
 
+			if (create)
+				_dirent_cache.invalidate();
+
 			try {
 				::File_system::Dir_handle dir = _fs.dir(dir_path.base(), false);
 				Fs_handle_guard dir_guard(*this, _fs, dir, _handle_space);
@@ -642,8 +1043,13 @@ class Vfs::Fs_file_system : public File_system
 				                                           mode, create);
 
 				Handle_space::Id id { file };
-				*out_handle = new (alloc)
+				Fs_vfs_handle *handle = new (alloc)
 					Fs_vfs_handle(*this, alloc, vfs_mode, _handle_space, id);
+
+				handle->write_behind = _write_behind
+				                    && mode != ::File_system::READ_ONLY
+				                    && mode != ::File_system::STAT_ONLY;
+				*out_handle = handle;
 			}
 			catch (::File_system::Lookup_failed)       { return OPEN_ERR_UNACCESSIBLE;  }
 			catch (::File_system::Permission_denied)   { return OPEN_ERR_NO_PERM;       }
@@ -666,6 +1072,16 @@ class Vfs::Fs_file_system : public File_system
 			Fs_vfs_handle *fs_handle = static_cast<Fs_vfs_handle *>(vfs_handle);
 
 			if (fs_handle) {
+
+				/* acknowledgements for unknown handles would be lost */
+				_drain_writes(*fs_handle);
+				_discard_reads(*fs_handle);
+				while (fs_handle->reads_in_flight())
+					_env.ep().wait_and_dispatch_one_signal();
+
+				if (fs_handle->write_error)
+					Genode::error("write-behind to file failed before close");
+
 				_fs.close(fs_handle->file_handle());
 				destroy(fs_handle->alloc(), fs_handle);
 			}
@@ -681,6 +1097,8 @@ class Vfs::Fs_file_system : public File_system
 
 		void sync(char const *path) override
 		{
+			_drain_all_writes();
+
 			try {
 				::File_system::Node_handle node = _fs.node(path);
 				_fs.sync(node);
@@ -700,6 +1118,12 @@ class Vfs::Fs_file_system : public File_system
 
 			Fs_vfs_handle &handle = static_cast<Fs_vfs_handle &>(*vfs_handle);
 
+			/* data read ahead may be outdated by the write */
+			_discard_all_reads();
+
+			if (handle.write_behind)
+				return _queue_write(handle, buf, buf_size, handle.seek(), out_count);
+
 			out_count = _write(handle, buf, buf_size, handle.seek());
 
 			return WRITE_OK;
@@ -715,6 +1139,9 @@ class Vfs::Fs_file_system : public File_system
 			/* reset the ready_ready state */
 			handle.read_ready_state = Handle_state::Read_ready_state::IDLE;
 
+			_drain_writes(handle);
+			_discard_reads(handle);
+
 			out_count = _read(handle, dst, count, handle.seek());
 
 			return READ_OK;
@@ -725,39 +1152,44 @@ class Vfs::Fs_file_system : public File_system
 		{
 			Lock::Guard guard(_lock);
 
-			Fs_vfs_handle *handle = static_cast<Fs_vfs_handle *>(vfs_handle);
+			Fs_vfs_handle &handle = *static_cast<Fs_vfs_handle *>(vfs_handle);
 
-			if (handle->queued_read_state != Handle_state::Queued_state::IDLE)
-				return false;
+			file_size const seek = handle.seek();
 
-			::File_system::Session::Tx::Source &source = *_fs.tx();
+			/* reads observe the preceding writes of the handle */
+			_drain_writes(handle);
 
-			/* if not ready to submit suggest retry */
-			if (!source.ready_to_submit()) return false;
+			/* data may already be in flight or present due to a read ahead */
+			if (!handle.read_at(seek)) {
 
-			file_size const max_packet_size = source.bulk_buffer_size() / 2;
-			file_size const clipped_count = min(max_packet_size, count);
+				_discard_reads(handle);
 
-			::File_system::Packet_descriptor p;
-			try {
-				p = source.alloc_packet(clipped_count);
-			} catch (::File_system::Session::Tx::Source::Packet_alloc_failed) {
-				return false;
-			}
+				Read *read = handle.free_read();
 
-			::File_system::Packet_descriptor const
-				packet(p, handle->file_handle(),
-				       ::File_system::Packet_descriptor::READ,
-				       clipped_count, handle->seek());
+				/* if not ready to submit suggest retry */
+				if (!read)
+					return false;
 
-			handle->read_ready_state  = Handle_state::Read_ready_state::IDLE;
-			handle->queued_read_state = Handle_state::Queued_state::QUEUED;
+				::File_system::Session::Tx::Source &source = *_fs.tx();
 
-			out_result = READ_QUEUED;
+				file_size const max_packet_size =
+					source.bulk_buffer_size() / (2*(1 + _read_ahead));
+				file_size const clipped_count = min(max_packet_size, count);
 
-			/* pass packet to server side */
-			source.submit_packet(packet);
+				if (!_submit_read(handle, *read, seek, clipped_count))
+					return false;
+
+				handle.read_size      = clipped_count;
+				handle.read_ahead_end = seek + clipped_count;
+			}
+
+			/* read ahead on sequential access only */
+			if (_read_ahead && seek == handle.next_read)
+				_read_ahead_of(handle);
 
+			handle.read_ready_state = Handle_state::Read_ready_state::IDLE;
+
+			out_result = READ_QUEUED;
 			return true;
 		}
 
@@ -766,27 +1198,35 @@ class Vfs::Fs_file_system : public File_system
 		{
 			Lock::Guard guard(_lock);
 
-			Fs_vfs_handle *handle = static_cast<Fs_vfs_handle *>(vfs_handle);
+			Fs_vfs_handle &handle = *static_cast<Fs_vfs_handle *>(vfs_handle);
 
-			if (handle->queued_read_state != Handle_state::Queued_state::ACK)
-				return READ_QUEUED;
+			file_size const seek = handle.seek();
 
-			/* obtain result packet descriptor with updated status info */
-			::File_system::Packet_descriptor const
-				packet = handle->queued_read_packet;
+			Read *read = handle.read_at(seek);
+			if (!read)
+				return READ_ERR_INVALID;
 
-			file_size const read_num_bytes = min(packet.length(), count);
+			if (read->state != Read::State::ACK)
+				return READ_QUEUED;
 
 			::File_system::Session::Tx::Source &source = *_fs.tx();
 
-			memcpy(dst, source.packet_content(packet), read_num_bytes);
+			/* the read may cover data preceding the seek position */
+			file_size const length = read->packet.length();
+			file_size const offset = seek - read->position;
+			file_size const read_num_bytes =
+				offset < length ? min(length - offset, count) : 0;
 
-			handle->queued_read_state  = Handle_state::Queued_state::IDLE;
-			handle->queued_read_packet = ::File_system::Packet_descriptor();
+			memcpy(dst, source.packet_content(read->packet) + offset, read_num_bytes);
 
-			out_count  = read_num_bytes;
+			out_count        = read_num_bytes;
+			handle.next_read = seek + read_num_bytes;
 
-			source.release_packet(packet);
+			/* release packet once its data is consumed */
+			if (offset + read_num_bytes >= length) {
+				source.release_packet(read->packet);
+				read->state = Read::State::FREE;
+			}
 
 			return READ_OK;
 		}
@@ -829,7 +1269,10 @@ class Vfs::Fs_file_system : public File_system
 
 		Ftruncate_result ftruncate(Vfs_handle *vfs_handle, file_size len) override
 		{
-			Fs_vfs_handle const *handle = static_cast<Fs_vfs_handle *>(vfs_handle);
+			Fs_vfs_handle *handle = static_cast<Fs_vfs_handle *>(vfs_handle);
+
+			_drain_writes(*handle);
+			_discard_reads(*handle);
 
 			try {
 				_fs.truncate(handle->file_handle(), len);
@@ -15,9 +15,9 @@
 #define _INCLUDE__VFS__RAM_FILE_SYSTEM_H_
 
 #include <ram_fs/chunk.h>
+#include <ram_fs/directory_index.h>
 #include <vfs/file_system.h>
 #include <dataspace/client.h>
-#include <util/avl_tree.h>
 
 namespace Vfs_ram {
 
@@ -52,7 +52,7 @@ namespace Vfs_ram {
 namespace Vfs { class Ram_file_system; }
 
 
-class Vfs_ram::Node : public Genode::Avl_node<Node>, public Genode::Lock
+class Vfs_ram::Node : public Genode::Lock
 {
 	private:
 
@@ -81,45 +81,6 @@ class Vfs_ram::Node : public Genode::Avl_node<Node>, public Genode::Lock
 
 		virtual Vfs::file_size length() = 0;
 
-		/************************
-		 ** Avl node interface **
-		 ************************/
-
-		bool higher(Node *c) { return (strcmp(c->_name, _name) > 0); }
-
-		/**
-		 * Find index N by walking down the tree N times,
-		 * not the most efficient way to do this.
-		 */
-		Node *index(file_offset &i)
-		{
-			if (i-- == 0)
-				return this;
-
-			Node *n;
-
-			n = child(LEFT);
-			if (n)
-				n = n->index(i);
-
-			if (n) return n;
-
-			n = child(RIGHT);
-			if (n)
-				n = n->index(i);
-
-			return n;
-		}
-
-		Node *sibling(const char *name)
-		{
-			if (strcmp(name, _name) == 0) return this;
-
-			Node *c =
-				Avl_node<Node>::child(strcmp(name, _name) > 0);
-			return c ? c->sibling(name) : 0;
-		}
-
 		struct Guard
 		{
 			Node *node;
@@ -263,18 +224,17 @@ class Vfs_ram::Directory : public Vfs_ram::Node
 {
 	private:
 
-		Avl_tree<Node>  _entries;
-		file_size       _count = 0;
+		::File_system::Directory_index<Node> _entries;
 
 	public:
 
-		Directory(char const *name)
-		: Node(name) { }
+		Directory(Allocator &alloc, char const *name)
+		: Node(name), _entries(alloc) { }
 
 		void empty(Allocator &alloc)
 		{
-			while (Node *node = _entries.first()) {
-				_entries.remove(node);
+			while (Node *node = _entries.at(_entries.count() - 1)) {
+				_entries.remove(*node);
 				if (File *file = dynamic_cast<File*>(node)) {
 					if (file->close_but_keep())
 						continue;
@@ -285,30 +245,27 @@ class Vfs_ram::Directory : public Vfs_ram::Node
 			}
 		}
 
-		void adopt(Node *node)
-		{
-			_entries.insert(node);
-			++_count;
-		}
+		/**
+		 * Add node to directory
+		 *
+		 * \throw Out_of_memory
+		 */
+		void adopt(Node *node) { _entries.insert(*node); }
 
-		Node *child(char const *name)
-		{
-			Node *node = _entries.first();
-			return node ? node->sibling(name) : 0;
-		}
+		/**
+		 * Make room for adopting one more node without allocation
+		 */
+		void reserve() { _entries.reserve(); }
 
-		void release(Node *node)
-		{
-			_entries.remove(node);
-			--_count;
-		}
+		Node *child(char const *name) { return _entries.lookup(name); }
 
-		file_size length() override { return _count; }
+		void release(Node *node) { _entries.remove(*node); }
+
+		file_size length() override { return _entries.count(); }
 
 		void dirent(file_offset index, Directory_service::Dirent &dirent)
 		{
-			Node *node = _entries.first();
-			if (node) node = node->index(index);
+			Node *node = _entries.at(index);
 			if (!node) {
 				dirent.type = Directory_service::DIRENT_TYPE_END;
 				return;
@@ -358,7 +315,7 @@ class Vfs::Ram_file_system : public Vfs::File_system
 
 		Genode::Env        &_env;
 		Genode::Allocator  &_alloc;
-		Vfs_ram::Directory  _root = { "" };
+		Vfs_ram::Directory  _root = { _alloc, "" };
 
 		Vfs_ram::Node *lookup(char const *path, bool return_parent = false)
 		{
@@ -472,8 +429,14 @@ class Vfs::Ram_file_system : public Vfs::File_system
 
 			if (parent->child(name)) return MKDIR_ERR_EXISTS;
 
-			try { parent->adopt(new (_alloc) Directory(name)); }
-			catch (Out_of_memory) { return MKDIR_ERR_NO_SPACE; }
+			Directory *dir = nullptr;
+			try {
+				dir = new (_alloc) Directory(_alloc, name);
+				parent->adopt(dir);
+			} catch (Out_of_memory) {
+				if (dir) destroy(_alloc, dir);
+				return MKDIR_ERR_NO_SPACE;
+			}
 
 			return MKDIR_OK;
 		}
@@ -499,7 +462,12 @@ class Vfs::Ram_file_system : public Vfs::File_system
 
 				try { file = new (_alloc) File(name, _alloc); }
 				catch (Out_of_memory) { return OPEN_ERR_NO_SPACE; }
-				parent->adopt(file);
+
+				try { parent->adopt(file); }
+				catch (Out_of_memory) {
+					destroy(_alloc, file);
+					return OPEN_ERR_NO_SPACE;
+				}
 			} else {
 				Node *node = lookup(path);
 				if (!node) return OPEN_ERR_UNACCESSIBLE;
@@ -599,8 +567,12 @@ class Vfs::Ram_file_system : public Vfs::File_system
 				try { link = new (_alloc) Symlink(name); }
 				catch (Out_of_memory) { return SYMLINK_ERR_NO_SPACE; }
 
+				try { parent->adopt(link); }
+				catch (Out_of_memory) {
+					destroy(_alloc, link);
+					return SYMLINK_ERR_NO_SPACE;
+				}
 				link->lock();
-				parent->adopt(link);
 			}
 
 			if (*target)
@@ -661,9 +633,20 @@ class Vfs::Ram_file_system : public Vfs::File_system
 				to_node->lock();
 
 				if (Directory *dir = dynamic_cast<Directory*>(to_node))
-					if (dir->length() || (!dynamic_cast<Directory*>(from_node)))
+					if (dir->length() || (!dynamic_cast<Directory*>(from_node))) {
+						to_node->unlock();
 						return RENAME_ERR_NO_PERM;
+					}
+			}
 
+			/* the node must not get lost if the target index cannot grow */
+			try { to_dir->reserve(); }
+			catch (Out_of_memory) {
+				if (to_node) to_node->unlock();
+				return RENAME_ERR_NO_PERM;
+			}
+
+			if (to_node) {
 				to_dir->release(to_node);
 				remove(to_node);
 			}
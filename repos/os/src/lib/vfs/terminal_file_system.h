@@ -44,7 +44,16 @@ class Vfs::Terminal_file_system : public Single_file_system
 		{
 			Genode::Entrypoint  &_ep;
 			Io_response_handler &_io_handler;
-			Vfs_handle::Context *_context = nullptr;
+			/*
+			 * Contexts armed while handling one signal. If more contexts
+			 * are armed, the remaining ones are reported by a response
+			 * without context.
+			 */
+			enum { MAX_CONTEXTS = 8 };
+
+			Vfs_handle::Context *_contexts[MAX_CONTEXTS];
+			unsigned             _num_contexts = 0;
+			bool                 _overflow     = false;
 
 			Post_signal_hook(Genode::Entrypoint &ep,
 			                 Io_response_handler &io_handler)
@@ -52,21 +61,43 @@ class Vfs::Terminal_file_system : public Single_file_system
 
 			void arm(Vfs_handle::Context *context)
 			{
-				_context = context;
+				bool armed = false;
+				for (unsigned i = 0; i < _num_contexts; i++)
+					if (_contexts[i] == context)
+						armed = true;
+
+				if (!armed) {
+					if (_num_contexts < MAX_CONTEXTS)
+						_contexts[_num_contexts++] = context;
+					else
+						_overflow = true;
+				}
+
 				_ep.schedule_post_signal_hook(this);
 			}
 
 			void function() override
 			{
 				/*
-				 * XXX The current implementation executes the post signal hook
-				 *     for the last armed context only. When changing this,
-				 *     beware that the called handle_io_response() may change
-				 *     this object in a signal handler.
+				 * The called handle_io_response() may arm the hook again.
+				 * Hence, the armed contexts are taken over before.
 				 */
+				Vfs_handle::Context *contexts[MAX_CONTEXTS];
+
+				unsigned const num_contexts = _num_contexts;
+				bool     const overflow     = _overflow;
+
+				for (unsigned i = 0; i < num_contexts; i++)
+					contexts[i] = _contexts[i];
+
+				_num_contexts = 0;
+				_overflow     = false;
+
+				for (unsigned i = 0; i < num_contexts; i++)
+					_io_handler.handle_io_response(contexts[i]);
 
-				_io_handler.handle_io_response(_context);
-				_context = nullptr;
+				if (overflow)
+					_io_handler.handle_io_response(nullptr);
 			}
 		};
 
@@ -108,7 +108,8 @@ namespace Cache {
 		private:
 
 			char        _data[CHUNK_SIZE];
-			unsigned    _writes;
+			bool        _valid;  /* chunk holds the device content */
+			bool        _dirty;  /* content differs from the device */
 
 		public:
 
@@ -126,12 +127,12 @@ namespace Cache {
 			 * of 'Chunk_index'.
 			 */
 			Chunk(Genode::Allocator &, offset_t base_offset, Chunk_base *p)
-			: Chunk_base(base_offset, p), _writes(0) { }
+			: Chunk_base(base_offset, p), _valid(false), _dirty(false) { }
 
 			/**
 			 * Construct zero chunk
 			 */
-			Chunk() : _writes(0) { }
+			Chunk() : _valid(false), _dirty(false) { }
 
 			/**
 			 * Return number of used entries
@@ -142,6 +143,21 @@ namespace Cache {
 			 */
 			size_t used_size() const { return _num_entries; }
 
+			/**
+			 * Return true if the chunk must be written back to the device
+			 */
+			bool dirty() const { return _dirty; }
+
+			/**
+			 * Mark chunk as written back
+			 */
+			void clean() { _dirty = false; }
+
+			/**
+			 * Return content of the chunk
+			 */
+			char const *data() const { return _data; }
+
 			void write(char const *src, size_t len, offset_t seek_offset)
 			{
 				assert_valid_range(seek_offset, len, SIZE);
@@ -155,7 +171,31 @@ namespace Cache {
 
 				_num_entries = Genode::max(_num_entries, local_offset + len);
 
-				_writes++;
+				_valid = true;
+				_dirty = true;
+			}
+
+			/**
+			 * Fill chunk with content read from the device
+			 *
+			 * A chunk that became valid in the meantime, e.g., by a write of
+			 * the client, keeps its content.
+			 */
+			void fill(char const *src, size_t len, offset_t seek_offset)
+			{
+				assert_valid_range(seek_offset, len, SIZE);
+
+				if (_valid) return;
+
+				POLICY::write(this);
+
+				offset_t const local_offset = seek_offset - base_offset();
+
+				Genode::memcpy(&_data[local_offset], src, len);
+
+				_num_entries = Genode::max(_num_entries, local_offset + len);
+
+				_valid = true;
 			}
 
 			void read(char *dst, size_t len, offset_t seek_offset) const
@@ -171,20 +211,27 @@ namespace Cache {
 			{
 				assert_valid_range(seek_offset, len, SIZE);
 
-				if (_writes == 0)
+				if (!_valid)
 					throw Range_incomplete(base_offset(), SIZE);
 			}
 
 			void sync(size_t len, offset_t seek_offset)
 			{
-				if (_writes > 1) {
+				if (_dirty) {
 					POLICY::sync(this, (char*)_data);
-					_writes = 1;
+					_dirty = false;
 				}
 			}
 
 			void alloc(size_t len, offset_t seek_offset) { }
 
+			template <typename FN>
+			void for_each_chunk(offset_t from, FN const &fn)
+			{
+				if (base_offset() + SIZE > from)
+					fn(*this);
+			}
+
 			void truncate(size_t size)
 			{
 				assert_valid_range(size, 0, SIZE);
@@ -205,7 +252,7 @@ namespace Cache {
 
 			void free(size_t, offset_t)
 			{
-				if (_writes > 1) throw Dirty_chunk(_base_offset, SIZE);
+				if (_dirty) throw Dirty_chunk(_base_offset, SIZE);
 
 				_num_entries = 0;
 				if (_parent) _parent->free(SIZE, _base_offset);
@@ -393,6 +440,20 @@ namespace Cache {
 				}
 			};
 
+			struct Fill_func
+			{
+				typedef ENTRY_TYPE Entry;
+
+				static Entry &lookup(Chunk_index &chunk, unsigned i) {
+					return chunk._entry(i); }
+
+				void operator () (Entry &entry, char const *src, size_t len,
+				                  offset_t seek_offset) const
+				{
+					entry.fill(src, len, seek_offset);
+				}
+			};
+
 			struct Read_func
 			{
 				typedef ENTRY_TYPE const Entry;
@@ -499,6 +560,12 @@ namespace Cache {
 			void write(char const *src, size_t len, offset_t seek_offset) {
 				_range_op(*this, src, len, seek_offset, Write_func()); }
 
+			/**
+			 * Fill chunk with data read from the device
+			 */
+			void fill(char const *src, size_t len, offset_t seek_offset) {
+				_range_op(*this, src, len, seek_offset, Fill_func()); }
+
 			/**
 			 * Allocate needed chunks
 			 */
@@ -524,6 +591,22 @@ namespace Cache {
 				if (zero()) return;
 				_range_op(*this, (char*)0, len, seek_offset, Sync_func()); }
 
+			/**
+			 * Apply functor to all allocated leaf chunks in ascending order
+			 *
+			 * \param from  skip chunks that end before this offset
+			 */
+			template <typename FN>
+			void for_each_chunk(offset_t from, FN const &fn)
+			{
+				offset_t const first = from > base_offset()
+				                     ? (from - base_offset()) / ENTRY_SIZE : 0;
+
+				for (offset_t i = first; i < _num_entries; i++)
+					if (_entries[i])
+						_entries[i]->for_each_chunk(from, fn);
+			}
+
 			/**
 			 * Free chunks
 			 */
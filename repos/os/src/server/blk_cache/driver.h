@@ -15,7 +15,12 @@
 #include <block_session/connection.h>
 #include <block/component.h>
 #include <os/packet_allocator.h>
+#include <os/reporter.h>
 #include <os/server.h>
+#include <os/timer.h>
+#include <timer_session/connection.h>
+#include <util/reconstructible.h>
+#include <util/xml_node.h>
 
 #include "chunk.h"
 
@@ -38,11 +43,18 @@ class Driver : public Block::Driver
 			Block::Packet_descriptor srv;
 			Block::Packet_descriptor cli;
 			char * const             buffer;
+			bool const               read_ahead;
 
 			Request(Block::Packet_descriptor &s,
 			        Block::Packet_descriptor &c,
 			        char * const              b)
-				: srv(s), cli(c), buffer(b) {}
+				: srv(s), cli(c), buffer(b), read_ahead(false) {}
+
+			/**
+			 * Construct read-ahead request not triggered by a client packet
+			 */
+			Request(Block::Packet_descriptor &s)
+				: srv(s), cli(), buffer(nullptr), read_ahead(true) {}
 
 			/*
 			 * \return true when the given response packet matches
@@ -50,7 +62,8 @@ class Driver : public Block::Driver
 			 */
 			bool match(const Block::Packet_descriptor& reply) const
 			{
-				return reply.operation()    == srv.operation()  &&
+				return reply.offset()       == srv.offset()     &&
+				       reply.operation()    == srv.operation()  &&
 				       reply.block_number() == srv.block_number() &&
 				       reply.block_count()  == srv.block_count();
 			}
@@ -100,7 +113,19 @@ class Driver : public Block::Driver
 
 		enum {
 			SLAB_SZ = Block::Session::TX_QUEUE_SIZE*sizeof(Request),
-			CACHE_BLK_SIZE = 4096
+			CACHE_BLK_SIZE = 4096,
+
+			/* maximum number of chunks combined in one write-back packet */
+			WRITE_BACK_CHUNKS = 32,
+
+			/* maximum number of chunks fetched by one read-ahead packet */
+			READ_AHEAD_CHUNKS = 32,
+
+			/* number of sequential streams tracked for read-ahead */
+			READ_AHEAD_STREAMS = 4,
+
+			/* initial read-ahead window in chunks */
+			READ_AHEAD_MIN_CHUNKS = 4
 		};
 
 		/**
@@ -115,6 +140,38 @@ class Driver : public Block::Driver
 
 	private:
 
+		/**
+		 * Run of adjacent dirty chunks written back by one packet
+		 */
+		struct Write_back_run
+		{
+			Chunk_level_4 *chunks[WRITE_BACK_CHUNKS];
+			unsigned       count = 0;
+
+			bool extends(Chunk_level_4 const &chunk) const
+			{
+				return count < WRITE_BACK_CHUNKS &&
+				       chunks[count - 1]->base_offset() + CACHE_BLK_SIZE
+				       == chunk.base_offset();
+			}
+		};
+
+		/**
+		 * Sequential read stream detected by the read-ahead
+		 *
+		 * All values are in blocks of the backend device. A window of 0
+		 * marks an unused stream.
+		 */
+		struct Stream
+		{
+			Block::sector_t  next;    /* block expected to be read next */
+			Block::sector_t  ahead;   /* end of the fetched range       */
+			Genode::size_t   window;  /* current read-ahead window      */
+			Genode::uint64_t used;    /* time stamp of last access      */
+		};
+
+		typedef Genode::Periodic_timeout<Driver> Driver_timeout;
+
 		Genode::Env                      &_env;
 		Genode::Tslab<Request, SLAB_SZ>   _r_slab;    /* slab for requests  */
 		Genode::List<Request>             _r_list;    /* list of requests   */
@@ -127,6 +184,32 @@ class Driver : public Block::Driver
 		Genode::Signal_handler<Driver>    _source_ack;
 		Genode::Signal_handler<Driver>    _source_submit;
 		Genode::Signal_handler<Driver>    _yield;
+		Timer::Connection                 _timer_connection;
+		Genode::Timer                     _timer;
+
+		/* background write-back of dirty chunks */
+		Genode::Constructible<Genode::One_shot_timeout<Driver> > _write_back_timeout;
+		Genode::Timer::Microseconds           _write_back_delay { 0 };
+		bool                                  _write_back_armed = false;
+		bool                                  _written  = false;
+		bool                                  _pending  = false;
+		Cache::offset_t                       _resume   = 0;
+
+		/* statistics */
+		Genode::Constructible<Genode::Reporter> _reporter;
+		Genode::Constructible<Driver_timeout>   _report_timeout;
+		bool             _replay             = false;
+		Genode::uint64_t _hits               = 0;
+		Genode::uint64_t _misses             = 0;
+		Genode::uint64_t _write_back_packets = 0;
+		Genode::uint64_t _write_back_chunks  = 0;
+		Genode::uint64_t _read_ahead_chunks  = 0;
+
+		/* read-ahead */
+		Stream           _streams[READ_AHEAD_STREAMS] { };
+		Genode::uint64_t _stream_time      = 0;
+		Genode::size_t   _read_ahead_max    = 0;  /* maximum window in blocks */
+		Genode::size_t   _read_ahead_budget = 0;  /* unread blocks fetched    */
 
 		Driver(Driver const&);            /* singleton pattern */
 		Driver& operator=(Driver const&); /* singleton pattern */
@@ -158,6 +241,14 @@ class Driver : public Block::Driver
 		 */
 		inline void _handle_reply(Block::Packet_descriptor &srv, Request *r)
 		{
+			/* requests without payload are passed through to the device */
+			if (srv.operation() == Block::Packet_descriptor::SYNC ||
+			    srv.operation() == Block::Packet_descriptor::TRIM) {
+				ack_packet(r->cli, srv.succeeded());
+				return;
+			}
+
+			_replay = true;
 			try {
 			if (r->cli.operation() == Block::Packet_descriptor::READ)
 				read(r->cli.block_number(), r->cli.block_count(),
@@ -171,6 +262,7 @@ class Driver : public Block::Driver
 				                "srv (", r->srv.block_number(), " ",
 				                         r->srv.block_count(), ")");
 			}
+			_replay = false;
 		}
 
 		/*
@@ -181,9 +273,9 @@ class Driver : public Block::Driver
 			while (_blk.tx()->ack_avail()) {
 				Block::Packet_descriptor p = _blk.tx()->get_acked_packet();
 
-				/* when reading, write result into cache */
+				/* when reading, fill cache with the result */
 				if (p.operation() == Block::Packet_descriptor::READ)
-					_cache.write(_blk.tx()->packet_content(p),
+					_cache.fill(_blk.tx()->packet_content(p),
 					             p.block_count() * _blk_sz,
 					             p.block_number() * _blk_sz);
 
@@ -192,7 +284,8 @@ class Driver : public Block::Driver
 				     r_to_handle = r) {
 					r = r->next();
 					if (r_to_handle->match(p)) {
-						_handle_reply(p, r_to_handle);
+						if (!r_to_handle->read_ahead)
+							_handle_reply(p, r_to_handle);
 						_r_list.remove(r_to_handle);
 						Genode::destroy(&_r_slab, r_to_handle);
 					}
@@ -205,7 +298,11 @@ class Driver : public Block::Driver
 		/*
 		 * Handle that the backend device is ready to receive again
 		 */
-		void _ready_to_submit() { }
+		void _ready_to_submit()
+		{
+			/* continue an interrupted background write-back */
+			if (_pending) _write_back_in_background();
+		}
 
 		/*
 		 * Setup a request to the backend device
@@ -261,28 +358,303 @@ class Driver : public Block::Driver
 			}
 		}
 
+		/*
+		 * Pass a request without payload through to the backend device
+		 *
+		 * The client packet is acknowledged when the backend device
+		 * acknowledges the request.
+		 */
+		void _pass_through(Block::Packet_descriptor::Opcode  op,
+		                   Block::sector_t                   block_number,
+		                   Genode::size_t                    block_count,
+		                   Block::Packet_descriptor         &packet)
+		{
+			if (!_blk.tx()->ready_to_submit())
+				throw Request_congestion();
+
+			try {
+				Block::Packet_descriptor p_to_dev(_blk.dma_alloc_packet(_blk_sz),
+				                                  op, block_number, block_count);
+				_r_list.insert(new (&_r_slab) Request(p_to_dev, packet, nullptr));
+				_blk.tx()->submit_packet(p_to_dev);
+			} catch(Block::Session::Tx::Source::Packet_alloc_failed) {
+				throw Request_congestion();
+			}
+		}
+
+		/*
+		 * Write back a run of adjacent dirty chunks with one packet
+		 */
+		void _submit(Write_back_run &run)
+		{
+			Cache::offset_t const off  = run.chunks[0]->base_offset();
+			Genode::size_t  const size = run.count * CACHE_BLK_SIZE;
+
+			if (!_blk.tx()->ready_to_submit())
+				throw Write_failed(off);
+
+			Block::Packet_descriptor p;
+			try {
+				p = Block::Packet_descriptor(_blk.dma_alloc_packet(size),
+				                             Block::Packet_descriptor::WRITE,
+				                             off / _blk_sz, size / _blk_sz);
+			} catch(Block::Session::Tx::Source::Packet_alloc_failed) {
+				throw Write_failed(off);
+			}
+
+			char *dst = _blk.tx()->packet_content(p);
+			for (unsigned i = 0; i < run.count; i++) {
+				Genode::memcpy(dst + i*CACHE_BLK_SIZE, run.chunks[i]->data(),
+				               CACHE_BLK_SIZE);
+				run.chunks[i]->clean();
+			}
+			_blk.tx()->submit_packet(p);
+
+			_write_back_packets++;
+			_write_back_chunks += run.count;
+			run.count = 0;
+		}
+
+		/*
+		 * Write back all dirty chunks starting at the given offset
+		 *
+		 * Adjacent dirty chunks are combined into large sequential write
+		 * requests. If the backend device is not ready to proceed, the
+		 * 'Write_failed' exception names the offset to resume at.
+		 */
+		void _write_back(Cache::offset_t from)
+		{
+			Write_back_run run;
+
+			_cache.for_each_chunk(from, [&] (Chunk_level_4 &chunk) {
+				if (!chunk.dirty())
+					return;
+
+				if (run.count && !run.extends(chunk))
+					_submit(run);
+
+				run.chunks[run.count++] = &chunk;
+			});
+
+			if (run.count)
+				_submit(run);
+		}
+
+		/*
+		 * Write back dirty chunks without blocking the client
+		 */
+		void _write_back_in_background()
+		{
+			if (!_pending) {
+				if (!_written) return;
+				_written = false;
+				_resume  = 0;
+			}
+
+			try {
+				_write_back(_resume);
+				_pending = false;
+			} catch (Write_failed &e) {
+				/* continue as soon as the backend is ready again */
+				_resume  = e.off;
+				_pending = true;
+			}
+		}
+
+		void _handle_write_back_timeout(Genode::Timer::Microseconds)
+		{
+			_write_back_armed = false;
+			_write_back_in_background();
+		}
+
+		/*
+		 * Schedule the write-back after chunks became dirty
+		 *
+		 * The timeout is armed only while dirty chunks exist, so an idle
+		 * cache does not cause any wakeups.
+		 */
+		void _schedule_write_back()
+		{
+			_written = true;
+
+			if (!_write_back_timeout.constructed() || _write_back_armed)
+				return;
+
+			_write_back_timeout->start(_write_back_delay);
+			_write_back_armed = true;
+		}
+
 		/*
 		 * Synchronize dirty chunks with backend device
 		 */
 		void _sync()
 		{
 			Cache::offset_t off = 0;
-			Cache::size_t len   = _blk_sz * _blk_cnt;
 
-			while (len > 0) {
+			for (;;) {
 				try {
-					_cache.sync(len, off);
-					len = 0;
+					_write_back(off);
+					break;
 				} catch(Write_failed &e) {
 					/**
 					 * Write to backend failed when backend device isn't ready
 					 * to proceed, so handle signals, until it's ready again
 					 */
 					off = e.off;
-					len = _blk_sz * _blk_cnt - off;
 					_env.ep().wait_and_dispatch_one_signal();
 				}
 			}
+			_pending = false;
+		}
+
+		void _handle_report_timeout(Genode::Timer::Microseconds)
+		{
+			Genode::Reporter::Xml_generator xml(*_reporter, [&] () {
+				xml.attribute("hits",               (unsigned long long)_hits);
+				xml.attribute("misses",             (unsigned long long)_misses);
+				xml.attribute("write_back_packets", (unsigned long long)_write_back_packets);
+				xml.attribute("write_back_chunks",  (unsigned long long)_write_back_chunks);
+				xml.attribute("read_ahead_chunks",  (unsigned long long)_read_ahead_chunks);
+				xml.node("policy", [&] () {
+					xml.attribute("name", POLICY::name());
+					POLICY::report(xml);
+				});
+			});
+		}
+
+		/*
+		 * Return true if a read of the given blocks is pending at the backend
+		 */
+		bool _read_pending(Block::sector_t nr, Genode::size_t cnt) const
+		{
+			for (Request const *r = _r_list.first(); r; r = r->next())
+				if (r->match(false, nr, cnt))
+					return true;
+			return false;
+		}
+
+		/*
+		 * Fetch the chunks of a block range that are neither cached nor
+		 * requested yet
+		 *
+		 * \return end of the range that was fetched, which is smaller than
+		 *         'end' if the backend is congested
+		 */
+		Block::sector_t _fetch(Block::sector_t nr, Block::sector_t end)
+		{
+			Genode::size_t const chunk_blks = _cache_blk_mod();
+
+			nr  = _cache_blk_round_off(nr);
+			end = Genode::min(_cache_blk_round_up(end), _blk_cnt);
+
+			while (nr < end) {
+
+				/* skip chunks that are cached or on their way */
+				try {
+					_cache.stat(CACHE_BLK_SIZE, nr * _blk_sz);
+					nr += chunk_blks;
+					continue;
+				} catch (Cache::Chunk_base::Range_incomplete) { }
+
+				if (_read_pending(nr, chunk_blks)) {
+					nr += chunk_blks;
+					continue;
+				}
+
+				/* collect run of missing chunks */
+				Genode::size_t cnt = chunk_blks;
+				for (; cnt < READ_AHEAD_CHUNKS*chunk_blks && nr + cnt < end;
+				     cnt += chunk_blks) {
+					try {
+						_cache.stat(CACHE_BLK_SIZE, (nr + cnt) * _blk_sz);
+						break;
+					} catch (Cache::Chunk_base::Range_incomplete) { }
+
+					if (_read_pending(nr + cnt, chunk_blks))
+						break;
+				}
+
+				if (!_blk.tx()->ready_to_submit())
+					return nr;
+
+				/* the last chunk may exceed the end of the device */
+				cnt = Genode::min(cnt, (Genode::size_t)(_blk_cnt - nr));
+
+				/* read-ahead is best effort, so give up on any shortage */
+				Block::Packet_descriptor p;
+				try {
+					_cache.alloc(cnt * _blk_sz, nr * _blk_sz);
+					p = Block::Packet_descriptor(_blk.dma_alloc_packet(cnt*_blk_sz),
+					                             Block::Packet_descriptor::READ,
+					                             nr, cnt);
+				}
+				catch (Request_congestion)                              { return nr; }
+				catch (Write_failed)                                    { return nr; }
+				catch (Genode::Allocator::Out_of_memory)                { return nr; }
+				catch (Block::Session::Tx::Source::Packet_alloc_failed) { return nr; }
+				_r_list.insert(new (&_r_slab) Request(p));
+				_blk.tx()->submit_packet(p);
+
+				_read_ahead_chunks += (cnt + chunk_blks - 1) / chunk_blks;
+				nr += cnt;
+			}
+			return end;
+		}
+
+		/*
+		 * Detect sequential reads and fetch the blocks expected next
+		 *
+		 * A read that continues a tracked stream doubles the stream's
+		 * window up to the configured maximum. As soon as less than half
+		 * of the window is fetched ahead of the reader, the remainder of
+		 * the window is requested from the backend asynchronously. Any
+		 * other read replaces the least recently used stream.
+		 */
+		void _read_ahead(Block::sector_t nr, Genode::size_t cnt)
+		{
+			if (!_read_ahead_max)
+				return;
+
+			_stream_time++;
+
+			Stream *s = nullptr;
+			Stream *lru = &_streams[0];
+			for (Stream &stream : _streams) {
+				if (stream.window && stream.next == nr)
+					s = &stream;
+				if (stream.used < lru->used)
+					lru = &stream;
+			}
+
+			if (!s) {
+				*lru = Stream { nr + cnt, nr + cnt, 1, _stream_time };
+				return;
+			}
+
+			Genode::size_t const min = READ_AHEAD_MIN_CHUNKS * _cache_blk_mod();
+
+			s->next   = nr + cnt;
+			s->ahead  = Genode::max(s->ahead, s->next);
+			s->window = Genode::min(Genode::max(s->window * 2, min),
+			                        _read_ahead_max);
+			s->used   = _stream_time;
+
+			if (s->ahead - s->next >= s->window / 2)
+				return;
+
+			/* limit the fetched but not yet read blocks of all streams */
+			Genode::size_t unread = 0;
+			for (Stream const &stream : _streams)
+				unread += stream.ahead - Genode::min(stream.next, stream.ahead);
+
+			if (unread >= _read_ahead_budget)
+				return;
+
+			Block::sector_t const end =
+				Genode::min(s->next + s->window,
+				            s->ahead + (_read_ahead_budget - unread));
+
+			s->ahead = _fetch(s->ahead, end);
 		}
 
 		/*
@@ -331,9 +703,11 @@ class Driver : public Block::Driver
 		/*
 		 * Constructor
 		 *
-		 * \param ep  server entrypoint
+		 * \param env     component environment
+		 * \param heap    backing store of the cache
+		 * \param config  configuration of the component
 		 */
-		Driver(Genode::Env &env, Genode::Heap &heap)
+		Driver(Genode::Env &env, Genode::Heap &heap, Genode::Xml_node config)
 		: Block::Driver(env.ram()),
 		  _env(env),
 		  _r_slab(&heap),
@@ -344,7 +718,9 @@ class Driver : public Block::Driver
 		  _cache(heap, 0),
 		  _source_ack(env.ep(), *this, &Driver::_ack_avail),
 		  _source_submit(env.ep(), *this, &Driver::_ready_to_submit),
-		  _yield(env.ep(), *this, &Driver::_parent_yield)
+		  _yield(env.ep(), *this, &Driver::_parent_yield),
+		  _timer_connection(env),
+		  _timer(_timer_connection, env.ep())
 		{
 			using namespace Genode;
 
@@ -361,6 +737,31 @@ class Driver : public Block::Driver
 
 			/* truncate chunk structure to real size of the device */
 			_cache.truncate(_blk_sz*_blk_cnt);
+
+			using Genode::Number_of_bytes;
+
+			_read_ahead_max = config.attribute_value("read_ahead_max",
+			                  Number_of_bytes(256*1024)) / _blk_sz;
+			_read_ahead_budget = config.attribute_value("read_ahead_budget",
+			                     Number_of_bytes(1024*1024)) / _blk_sz;
+
+			unsigned long const write_back_ms =
+				config.attribute_value("write_back_ms", 1000UL);
+			if (write_back_ms) {
+				_write_back_delay = Genode::Timer::Microseconds(write_back_ms * 1000);
+				_write_back_timeout.construct(_timer, *this,
+					&Driver::_handle_write_back_timeout);
+			}
+
+			if (config.has_sub_node("report")) {
+				unsigned long const sec = config.sub_node("report")
+					.attribute_value("interval_sec", 5UL);
+				_reporter.construct(env, "statistics");
+				_reporter->enabled(true);
+				_report_timeout.construct(_timer, *this,
+					&Driver::_handle_report_timeout,
+					Genode::Timer::Microseconds((sec ? sec : 1) * 1000 * 1000));
+			}
 		}
 
 		~Driver()
@@ -390,7 +791,16 @@ class Driver : public Block::Driver
 			if (!_ops.supported(Block::Packet_descriptor::READ))
 				throw Io_error();
 
-			if (!_stat(block_number, block_count, buffer, packet))
+			bool const cached = _stat(block_number, block_count, buffer, packet);
+
+			if (!_replay) {
+				if (cached) _hits++;
+				else        _misses++;
+
+				_read_ahead(block_number, block_count);
+			}
+
+			if (!cached)
 				return;
 
 			_cache.read(buffer, block_count*_blk_sz, block_number*_blk_sz);
@@ -418,8 +828,44 @@ class Driver : public Block::Driver
 
 			_cache.write(buffer, block_count * _blk_sz,
 			             block_number * _blk_sz);
+			_schedule_write_back();
 			ack_packet(packet);
 		}
 
+		void trim(Block::sector_t           block_number,
+		          Genode::size_t            block_count,
+		          Block::Packet_descriptor &packet)
+		{
+			if (!_ops.supported(Block::Packet_descriptor::TRIM))
+				throw Io_error();
+
+			/*
+			 * Cached chunks of the range stay valid. Their content is as
+			 * good as any other after discarding the blocks.
+			 */
+			_pass_through(Block::Packet_descriptor::TRIM,
+			              block_number, block_count, packet);
+		}
+
 		void sync() { _sync(); }
+
+		void synchronize(Block::Packet_descriptor &packet)
+		{
+			_sync();
+
+			if (!_ops.supported(Block::Packet_descriptor::SYNC)) {
+				_blk.sync();
+				ack_packet(packet);
+				return;
+			}
+
+			/*
+			 * The backend executes the request not before the write-back
+			 * of the dirty chunks is completed
+			 */
+			while (!_blk.tx()->ready_to_submit())
+				_env.ep().wait_and_dispatch_one_signal();
+
+			_pass_through(Block::Packet_descriptor::SYNC, 0, 0, packet);
+		}
 };
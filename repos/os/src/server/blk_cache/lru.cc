@@ -16,18 +16,15 @@
 
 typedef Driver<Lru_policy>::Chunk_level_4 Chunk;
 
-static const Lru_policy::Element        *lru = 0;
-static Genode::List<Lru_policy::Element> lru_list;
+/* head of the queue is the least recently used chunk */
+static Cache::Queue<Lru_policy::Element> lru_queue;
+static Genode::uint64_t                  evictions;
 
 
 static void lru_access(const Lru_policy::Element *e)
 {
-	if (e == lru) return;
-
-	if (e->next()) lru_list.remove(e);
-
-	lru_list.insert(e, lru);
-	lru = e;
+	lru_queue.remove(*e);
+	lru_queue.enqueue(*e);
 }
 
 
@@ -42,21 +39,26 @@ void Lru_policy::write(const Lru_policy::Element *e) {
 void Lru_policy::flush(Cache::size_t size)
 {
 	Cache::size_t s = 0;
-	for (Lru_policy::Element *e = lru_list.first();
+	for (Lru_policy::Element *e = lru_queue.head();
 		 e && ((size == 0) || (s < size));
-		 e = lru_list.first(), s += sizeof(Chunk)) {
+		 e = lru_queue.head(), s += sizeof(Chunk)) {
 		Chunk *cb = static_cast<Chunk*>(e);
-		e = e->next();
-		try {
-			cb->free(Driver<Lru_policy>::CACHE_BLK_SIZE,
-			         cb->base_offset());
-			lru_list.remove(cb);
-		} catch(Chunk::Dirty_chunk &e) {
-			cb->sync(e.size, e.off);
-		}
-	}
 
-	if (!lru_list.first()) lru = 0;
+		/* write back dirty chunk before freeing it */
+		if (cb->dirty())
+			cb->sync(Driver<Lru_policy>::CACHE_BLK_SIZE, cb->base_offset());
+
+		lru_queue.remove(*e);
+		cb->free(Driver<Lru_policy>::CACHE_BLK_SIZE, cb->base_offset());
+		evictions++;
+	}
 
 	if (s < size) throw Block::Driver::Request_congestion();
 }
+
+
+void Lru_policy::report(Genode::Xml_generator &xml)
+{
+	xml.attribute("resident",  (unsigned long)lru_queue.count());
+	xml.attribute("evictions", (unsigned long long)evictions);
+}
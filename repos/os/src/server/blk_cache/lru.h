@@ -11,15 +11,24 @@
  * under the terms of the GNU Affero General Public License version 3.
  */
 
-#include <util/list.h>
+#ifndef _LRU_H_
+#define _LRU_H_
+
+#include <util/xml_generator.h>
 
 #include "chunk.h"
+#include "queue.h"
 
 struct Lru_policy
 {
-	class Element : public Genode::List<Element>::Element {};
+	class Element : public Cache::Queue<Element>::Element {};
+
+	static char const *name() { return "lru"; }
 
 	static void read(const Element  *e);
 	static void write(const Element *e);
 	static void flush(Cache::size_t size = 0);
+	static void report(Genode::Xml_generator &xml);
 };
+
+#endif /* _LRU_H_ */
@@ -12,12 +12,13 @@
  */
 
 #include <base/component.h>
+#include <base/attached_rom_dataspace.h>
 
 #include "lru.h"
+#include "two_q.h"
 #include "driver.h"
 
-using Policy = Lru_policy;
-static Driver<Policy> * driver = nullptr;
+static Block::Driver * driver = nullptr;
 
 
 /**
@@ -29,7 +30,10 @@ void Driver<POLICY>::Policy::sync(const typename POLICY::Element *e, char *dst)
 	Cache::offset_t off =
 		static_cast<const Driver<POLICY>::Chunk_level_4*>(e)->base_offset();
 
-	if (!driver) throw Write_failed(off);
+	if (!::driver) throw Write_failed(off);
+
+	/* the driver was created for the policy of the chunk */
+	Driver<POLICY> * const driver = static_cast<Driver<POLICY>*>(::driver);
 
 	if (!driver->blk()->tx()->ready_to_submit())
 		throw Write_failed(off);
@@ -47,30 +51,66 @@ void Driver<POLICY>::Policy::sync(const typename POLICY::Element *e, char *dst)
 
 struct Main
 {
-	template <typename T>
 	struct Factory : Block::Driver_factory
 	{
-		Genode::Env  &env;
-		Genode::Heap &heap;
+		typedef Genode::String<8> Policy_name;
+
+		Genode::Env                    &env;
+		Genode::Heap                   &heap;
+		Genode::Attached_rom_dataspace &config;
+		Policy_name                     created { };
+
+		Factory(Genode::Env &env, Genode::Heap &heap,
+		        Genode::Attached_rom_dataspace &config)
+		: env(env), heap(heap), config(config) {}
+
+		template <typename T>
+		static bool selected(Policy_name const &name) {
+			return name == T::name(); }
+
+		Policy_name policy() const
+		{
+			Policy_name const name =
+				config.xml().attribute_value("policy",
+				                             Policy_name(Lru_policy::name()));
 
-		Factory(Genode::Env &env, Genode::Heap &heap) : env(env), heap(heap) {}
+			if (selected<Lru_policy>(name) || selected<Two_q_policy>(name))
+				return name;
+
+			Genode::warning("unknown policy '", name, "', using '",
+			                Lru_policy::name(), "'");
+			return Lru_policy::name();
+		}
 
 		Block::Driver *create()
 		{
-			driver = new (&heap) ::Driver<T>(env, heap);
+			Genode::Xml_node const node = config.xml();
+
+			created = policy();
+			if (selected<Two_q_policy>(created))
+				driver = new (&heap) ::Driver<Two_q_policy>(env, heap, node);
+			else
+				driver = new (&heap) ::Driver<Lru_policy>(env, heap, node);
 			return driver;
 		}
 
-		void destroy(Block::Driver *driver) {
-			Genode::destroy(&heap, static_cast<::Driver<T>*>(driver)); }
+		void destroy(Block::Driver *driver)
+		{
+			if (selected<Two_q_policy>(created))
+				Genode::destroy(&heap, static_cast<::Driver<Two_q_policy>*>(driver));
+			else
+				Genode::destroy(&heap, static_cast<::Driver<Lru_policy>*>(driver));
+			::driver = nullptr;
+		}
 	};
 
 	void resource_handler() { }
 
-	Genode::Env                 &env;
-	Genode::Heap                 heap    { env.ram(), env.rm()     };
-	Factory<Lru_policy>          factory { env, heap               };
-	Block::Root                  root    { env.ep(), heap, env.rm(), factory };
+	Genode::Env                   &env;
+	Genode::Heap                   heap    { env.ram(), env.rm()     };
+	Genode::Attached_rom_dataspace config  { env, "config"           };
+	Factory                        factory { env, heap, config       };
+	Block::Root                    root    { env.ep(), heap, env.rm(), factory };
 	Genode::Signal_handler<Main> resource_dispatcher {
 		env.ep(), *this, &Main::resource_handler };
 
@@ -0,0 +1,112 @@
+/*
+ * \brief  Doubly-linked queue of cache chunks
+ * \author Genode Labs
+ * \date   2017-03-29
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _QUEUE_H_
+#define _QUEUE_H_
+
+/* Genode includes */
+#include <base/stdint.h>
+
+namespace Cache { template <typename T> class Queue; }
+
+
+/**
+ * Queue used by the replacement policies to order the cached chunks
+ *
+ * In contrast to 'Genode::List', an element can be removed from the middle
+ * of the queue in constant time, which the policies do on each access.
+ * 'T' must inherit from 'Queue<T>::Element'.
+ */
+template <typename T>
+class Cache::Queue
+{
+	public:
+
+		class Element
+		{
+			private:
+
+				friend class Queue;
+
+				Queue   *_queue = nullptr;
+				Element *_prev  = nullptr;
+				Element *_next  = nullptr;
+
+			public:
+
+				/**
+				 * Return true if element is part of queue 'q'
+				 */
+				bool queued(Queue const &q) const { return _queue == &q; }
+
+				/**
+				 * Return true if element is part of any queue
+				 */
+				bool queued() const { return _queue != nullptr; }
+		};
+
+	private:
+
+		Element        *_head  = nullptr;
+		Element        *_tail  = nullptr;
+		Genode::size_t  _count = 0;
+
+	public:
+
+		/**
+		 * Append element at the tail of the queue
+		 */
+		void enqueue(T const &t)
+		{
+			Element &e = const_cast<T &>(t);
+
+			e._queue = this;
+			e._prev  = _tail;
+			e._next  = nullptr;
+
+			if (_tail) _tail->_next = &e;
+			else       _head        = &e;
+
+			_tail = &e;
+			_count++;
+		}
+
+		/**
+		 * Remove element from the queue
+		 */
+		void remove(T const &t)
+		{
+			Element &e = const_cast<T &>(t);
+
+			if (e._queue != this) return;
+
+			if (e._prev) e._prev->_next = e._next;
+			else         _head          = e._next;
+
+			if (e._next) e._next->_prev = e._prev;
+			else         _tail          = e._prev;
+
+			e._queue = nullptr;
+			e._prev  = e._next = nullptr;
+			_count--;
+		}
+
+		/**
+		 * Return element at the head of the queue or 'nullptr'
+		 */
+		T *head() const { return static_cast<T *>(_head); }
+
+		Genode::size_t count() const { return _count; }
+};
+
+#endif /* _QUEUE_H_ */
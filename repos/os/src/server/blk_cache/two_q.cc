@@ -0,0 +1,68 @@
+/*
+ * \brief  Scan-resistant 2Q cache replacement strategy
+ * \author Genode Labs
+ * \date   2017-03-29
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include "two_q.h"
+#include "driver.h"
+
+typedef Driver<Two_q_policy>::Chunk_level_4 Chunk;
+
+enum { CHUNK_SIZE = Driver<Two_q_policy>::CACHE_BLK_SIZE };
+
+static Cache::Two_q_queues<Two_q_policy::Element, CHUNK_SIZE> queues;
+static Genode::uint64_t                                        evictions;
+
+
+static void two_q_access(const Two_q_policy::Element *e) {
+	queues.access(*e, static_cast<Chunk const *>(e)->base_offset()); }
+
+
+void Two_q_policy::read(const Two_q_policy::Element  *e) {
+	two_q_access(e); }
+
+
+void Two_q_policy::write(const Two_q_policy::Element *e) {
+	two_q_access(e); }
+
+
+void Two_q_policy::flush(Cache::size_t size)
+{
+	Cache::size_t s = 0;
+	while ((size == 0) || (s < size)) {
+
+		Element *e = queues.victim();
+		if (!e) break;
+
+		Chunk * const cb = static_cast<Chunk*>(e);
+		Cache::offset_t const off = cb->base_offset();
+
+		/* write back dirty chunk before freeing it */
+		if (cb->dirty())
+			cb->sync(CHUNK_SIZE, off);
+
+		queues.evict(*e, off);
+		cb->free(CHUNK_SIZE, off);
+		s += sizeof(Chunk);
+		evictions++;
+	}
+
+	if (s < size) throw Block::Driver::Request_congestion();
+}
+
+
+void Two_q_policy::report(Genode::Xml_generator &xml)
+{
+	xml.attribute("a1in",      (unsigned long)queues.a1in_count());
+	xml.attribute("am",        (unsigned long)queues.am_count());
+	xml.attribute("a1out",     (unsigned long)queues.a1out_count());
+	xml.attribute("evictions", (unsigned long long)evictions);
+}
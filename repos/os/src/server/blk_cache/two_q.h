@@ -0,0 +1,36 @@
+/*
+ * \brief  Scan-resistant 2Q cache replacement strategy
+ * \author Genode Labs
+ * \date   2017-03-29
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _TWO_Q_H_
+#define _TWO_Q_H_
+
+#include <util/xml_generator.h>
+
+#include "two_q_queues.h"
+
+/**
+ * Scan-resistant replacement policy, see 'Cache::Two_q_queues'
+ */
+struct Two_q_policy
+{
+	class Element : public Cache::Queue<Element>::Element {};
+
+	static char const *name() { return "2q"; }
+
+	static void read(const Element  *e);
+	static void write(const Element *e);
+	static void flush(Cache::size_t size = 0);
+	static void report(Genode::Xml_generator &xml);
+};
+
+#endif /* _TWO_Q_H_ */
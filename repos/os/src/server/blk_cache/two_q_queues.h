@@ -0,0 +1,238 @@
+/*
+ * \brief  Queues of the 2Q cache replacement strategy
+ * \author Genode Labs
+ * \date   2017-03-29
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _TWO_Q_QUEUES_H_
+#define _TWO_Q_QUEUES_H_
+
+/* Genode includes */
+#include <util/misc_math.h>
+
+/* local includes */
+#include "chunk.h"
+#include "queue.h"
+
+namespace Cache { template <typename, Genode::size_t> class Two_q_queues; }
+
+
+/**
+ * Full version of the 2Q algorithm by Johnson and Shasha
+ *
+ * Chunks enter the FIFO queue 'A1in' on their first access. Chunks evicted
+ * from 'A1in' are remembered by offset in the ghost queue 'A1out'. Only a
+ * chunk that is accessed again while being remembered enters the LRU queue
+ * 'Am' of hot chunks. Hence, a sequential scan over the device passes
+ * through 'A1in' without displacing the working set kept in 'Am'.
+ *
+ * 'T' must inherit from 'Queue<T>::Element', 'CHUNK_SIZE' is the size of
+ * the chunks, whose offsets are remembered by the ghost queue.
+ */
+template <typename T, Genode::size_t CHUNK_SIZE>
+class Cache::Two_q_queues
+{
+	public:
+
+		/**
+		 * Ghost queue of the offsets of recently evicted chunks
+		 *
+		 * The offsets are kept in a ring in eviction order and are indexed
+		 * by a hash table with linear probing. Each slot of the table
+		 * records the position of its offset within the ring, so an
+		 * outdated ring entry never drops an offset that was remembered
+		 * again later on.
+		 */
+		class Ghost_queue
+		{
+			public:
+
+				enum { CAPACITY = 2048 };
+
+			private:
+
+				enum { SLOTS_LOG2 = 12, SLOTS = 1 << SLOTS_LOG2 };
+
+				static constexpr offset_t EMPTY = ~(offset_t)0;
+
+				struct Slot
+				{
+					offset_t         off;
+					Genode::uint64_t seq;
+				};
+
+				offset_t         _ring[CAPACITY];
+				Slot             _slots[SLOTS];
+				Genode::uint64_t _head = 0;   /* sequence number of oldest entry */
+				Genode::uint64_t _tail = 0;   /* sequence number of next entry   */
+
+				static unsigned _hash(offset_t off)
+				{
+					/* Fibonacci hashing of the chunk number */
+					return ((off / CHUNK_SIZE) * 0x9e3779b97f4a7c15ULL)
+					       >> (64 - SLOTS_LOG2);
+				}
+
+				unsigned _find(offset_t off) const
+				{
+					for (unsigned i = _hash(off); _slots[i].off != EMPTY;
+					     i = (i + 1) % SLOTS)
+						if (_slots[i].off == off)
+							return i;
+
+					return SLOTS;
+				}
+
+				void _remove_at(unsigned hole)
+				{
+					_slots[hole].off = EMPTY;
+
+					/* move back followers that may not stay behind the hole */
+					for (unsigned i = (hole + 1) % SLOTS; _slots[i].off != EMPTY;
+					     i = (i + 1) % SLOTS) {
+
+						unsigned const probe = (i - _hash(_slots[i].off)) % SLOTS;
+						if (probe < (i - hole) % SLOTS)
+							continue;
+
+						_slots[hole]  = _slots[i];
+						_slots[i].off = EMPTY;
+						hole          = i;
+					}
+				}
+
+			public:
+
+				Ghost_queue()
+				{
+					for (unsigned i = 0; i < SLOTS; i++)
+						_slots[i].off = EMPTY;
+				}
+
+				Genode::size_t count() const { return _tail - _head; }
+
+				void drop_oldest()
+				{
+					if (!count()) return;
+
+					unsigned const i = _find(_ring[_head % CAPACITY]);
+					if (i != SLOTS && _slots[i].seq == _head)
+						_remove_at(i);
+
+					_head++;
+				}
+
+				void insert(offset_t off)
+				{
+					if (count() == CAPACITY)
+						drop_oldest();
+
+					unsigned i = _hash(off);
+					for (; _slots[i].off != EMPTY && _slots[i].off != off;
+					     i = (i + 1) % SLOTS);
+
+					_slots[i] = Slot { off, _tail };
+					_ring[_tail % CAPACITY] = off;
+					_tail++;
+				}
+
+				/**
+				 * Return true if the offset is remembered
+				 */
+				bool contains(offset_t off) const { return _find(off) != SLOTS; }
+
+				/**
+				 * Forget offset
+				 *
+				 * \return true if the offset was remembered
+				 */
+				bool remove(offset_t off)
+				{
+					unsigned const i = _find(off);
+					if (i == SLOTS)
+						return false;
+
+					_remove_at(i);
+					return true;
+				}
+		};
+
+	private:
+
+		Queue<T>    _a1in;   /* FIFO of new chunks  */
+		Queue<T>    _am;     /* LRU of hot chunks   */
+		Ghost_queue _a1out;  /* evicted from 'a1in' */
+
+	public:
+
+		/**
+		 * Account access to the chunk at offset 'off'
+		 */
+		void access(T const &e, offset_t off)
+		{
+			/* a chunk in 'a1in' keeps its position on further accesses */
+			if (e.queued(_a1in))
+				return;
+
+			if (e.queued(_am)) {
+				_am.remove(e);
+				_am.enqueue(e);
+				return;
+			}
+
+			/* first access after the chunk got loaded */
+			if (_a1out.remove(off))
+				_am.enqueue(e);
+			else
+				_a1in.enqueue(e);
+		}
+
+		/**
+		 * Return chunk to evict next or 'nullptr' if no chunk is resident
+		 */
+		T *victim() const
+		{
+			/* 'a1in' may hold a quarter of the resident chunks */
+			Genode::size_t const resident = _a1in.count() + _am.count();
+			bool const from_a1in = _a1in.count() > resident / 4 || !_am.count();
+
+			return from_a1in ? _a1in.head() : _am.head();
+		}
+
+		/**
+		 * Remove chunk at offset 'off' from the queues before it gets freed
+		 */
+		void evict(T const &e, offset_t off)
+		{
+			Genode::size_t const resident = _a1in.count() + _am.count();
+
+			if (!e.queued(_a1in)) {
+				_am.remove(e);
+				return;
+			}
+
+			_a1in.remove(e);
+
+			/* 'a1out' remembers as many chunks as half of the resident ones */
+			_a1out.insert(off);
+			while (_a1out.count() > Genode::max(resident / 2, (Genode::size_t)1))
+				_a1out.drop_oldest();
+		}
+
+		bool in_a1in(T const &e)     const { return e.queued(_a1in); }
+		bool in_am(T const &e)       const { return e.queued(_am); }
+		bool in_a1out(offset_t off)  const { return _a1out.contains(off); }
+
+		Genode::size_t a1in_count()  const { return _a1in.count(); }
+		Genode::size_t am_count()    const { return _am.count(); }
+		Genode::size_t a1out_count() const { return _a1out.count(); }
+};
+
+#endif /* _TWO_Q_QUEUES_H_ */
@@ -31,10 +31,114 @@ class File_system::Directory : public Node
 
 		typedef Genode::Path<MAX_PATH_LEN> Path;
 
+		/**
+		 * Number of entries of a recently counted directory
+		 *
+		 * Clients tend to request the status of a directory repeatedly,
+		 * e.g., each time before listing it, and each request opens a new
+		 * node. Hence, the counts are shared by all nodes and are valid as
+		 * long as the modification time of the directory is unchanged.
+		 */
+		struct Count
+		{
+			dev_t           dev;
+			ino_t           ino;
+			struct timespec mtime;
+			size_t          num;
+		};
+
+		enum { NUM_COUNTS = 16 };
+
+		static Count *_counts()
+		{
+			static Count counts[NUM_COUNTS];
+			return counts;
+		}
+
+		static bool _equal(struct timespec const &a, struct timespec const &b) {
+			return a.tv_sec == b.tv_sec && a.tv_nsec == b.tv_nsec; }
+
 		DIR       *_fd;
 		Path       _path;
 		Allocator &_alloc;
 
+		/*
+		 * Index of the entry returned by the next 'readdir' of '_fd' and
+		 * modification time of the directory when the stream was rewound
+		 */
+		seek_off_t      _cursor = 0;
+		struct timespec _cursor_mtime { 0, 0 };
+
+		bool _stat(struct stat &s)
+		{
+			return fstat(dirfd(_fd), &s) == 0;
+		}
+
+		/**
+		 * Rewind the stream if the directory got modified since the last
+		 * rewind
+		 *
+		 * This check is done once per 'read', not per entry.
+		 */
+		void _revalidate_cursor()
+		{
+			struct stat s { };
+			if (_stat(s) && _equal(s.st_mtim, _cursor_mtime))
+				return;
+
+			rewinddir(_fd);
+			_cursor       = 0;
+			_cursor_mtime = s.st_mtim;
+		}
+
+		/**
+		 * Return directory entry at index or 0 if the index is out of range
+		 *
+		 * Reading a directory sequentially continues at the current stream
+		 * position. The stream is rewound only when reading backwards.
+		 */
+		struct dirent *_entry(seek_off_t index)
+		{
+			if (index < _cursor) {
+				rewinddir(_fd);
+				_cursor = 0;
+			}
+
+			struct dirent *dent = 0;
+			while (_cursor <= index) {
+				dent = readdir(_fd);
+				if (!dent)
+					return 0;
+				_cursor++;
+			}
+			return dent;
+		}
+
+		/**
+		 * Determine type of directory entry
+		 *
+		 * \return false if the entry is of an unsupported type
+		 */
+		bool _type(struct dirent const &dent, Directory_entry::Type &type)
+		{
+			unsigned char d_type = dent.d_type;
+
+			/* not all file systems fill in the type of the entry */
+			if (d_type == DT_UNKNOWN) {
+				struct stat s;
+				if (fstatat(dirfd(_fd), dent.d_name, &s, AT_SYMLINK_NOFOLLOW) == -1)
+					return false;
+				d_type = IFTODT(s.st_mode);
+			}
+
+			switch (d_type) {
+			case DT_REG: type = Directory_entry::TYPE_FILE;      return true;
+			case DT_DIR: type = Directory_entry::TYPE_DIRECTORY; return true;
+			case DT_LNK: type = Directory_entry::TYPE_SYMLINK;   return true;
+			default:     return false;
+			}
+		}
+
 		unsigned long _inode(char const *path, bool create)
 		{
 			int ret;
@@ -144,29 +248,27 @@ class File_system::Directory : public Node
 
 			seek_off_t index = seek_offset / sizeof(Directory_entry);
 
-			/* seek to index and read entry */
-			struct dirent *dent;
-			rewinddir(_fd);
-			for (unsigned i = 0; i <= index; ++i) {
-				dent = readdir(_fd);
-			}
+			_revalidate_cursor();
 
-			if (!dent)
-				return 0;
+			/* fill buffer with as many consecutive entries as fit */
+			size_t res = 0;
+			for (; res + sizeof(Directory_entry) <= len;
+			     res += sizeof(Directory_entry), index++) {
 
-			Directory_entry *e = (Directory_entry *)(dst);
+				struct dirent *dent = _entry(index);
+				if (!dent)
+					break;
 
-			switch (dent->d_type) {
-			case DT_REG: e->type = Directory_entry::TYPE_FILE;      break;
-			case DT_DIR: e->type = Directory_entry::TYPE_DIRECTORY; break;
-			case DT_LNK: e->type = Directory_entry::TYPE_SYMLINK;   break;
-			default:
-				return 0;
-			}
+				Directory_entry *e = (Directory_entry *)(dst + res);
+
+				if (!_type(*dent, e->type))
+					return res;
 
-			strncpy(e->name, dent->d_name, sizeof(e->name));
+				e->inode = dent->d_ino;
+				strncpy(e->name, dent->d_name, sizeof(e->name));
+			}
 
-			return sizeof(Directory_entry);
+			return res;
 		}
 
 		size_t write(char const *src, size_t len, seek_off_t seek_offset)
@@ -175,13 +277,41 @@ class File_system::Directory : public Node
 			return 0;
 		}
 
-		size_t num_entries() const
+		size_t num_entries()
 		{
-			unsigned num = 0;
+			struct stat s { };
+			bool const valid = _stat(s);
+
+			Count *counts = _counts();
+			if (valid)
+				for (unsigned i = 0; i < NUM_COUNTS; i++)
+					if (counts[i].dev == s.st_dev && counts[i].ino == s.st_ino
+					 && _equal(counts[i].mtime, s.st_mtim))
+						return counts[i].num;
+
+			struct timespec now;
+			clock_gettime(CLOCK_REALTIME, &now);
+
+			size_t num = 0;
 
 			rewinddir(_fd);
 			while (readdir(_fd)) ++num;
 
+			/* the stream is exhausted now */
+			_cursor       = num;
+			_cursor_mtime = s.st_mtim;
+
+			/*
+			 * Do not remember the count of a directory modified within the
+			 * granularity of the file-system time stamps because a further
+			 * modification may leave the modification time unchanged.
+			 */
+			if (valid && s.st_mtim.tv_sec + 1 < now.tv_sec) {
+				static unsigned next;
+				counts[next] = Count { s.st_dev, s.st_ino, s.st_mtim, num };
+				next = (next + 1) % NUM_COUNTS;
+			}
+
 			return num;
 		}
 };
@@ -95,6 +95,11 @@ class File_system::File : public Node
 			Node::name(basename(path));
 		}
 
+		/**
+		 * Return host file descriptor, used for asynchronous I/O
+		 */
+		int fd() const { return _fd; }
+
 		size_t read(char *dst, size_t len, seek_off_t seek_offset)
 		{
 			int ret = pread(_fd, dst, len, seek_offset);
@@ -0,0 +1,344 @@
+/*
+ * \brief  Asynchronous execution of file I/O requests
+ * \author Genode Labs
+ * \date   2017-04-03
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _IO_ENGINE_H_
+#define _IO_ENGINE_H_
+
+/* Genode includes */
+#include <base/thread.h>
+#include <base/semaphore.h>
+#include <base/signal.h>
+#include <util/fifo.h>
+#include <file_system_session/file_system_session.h>
+
+/* local includes */
+#include <lx_util.h>
+
+/* Linux includes */
+#include <sys/uio.h>
+
+
+namespace File_system { class Io_engine; }
+
+
+/**
+ * Pool of worker threads that perform reads and writes on host files
+ *
+ * The entrypoint of a session collects the pending READ and WRITE packets
+ * into jobs and hands them over to the workers. Packets that refer to
+ * adjacent ranges of the same file are merged into one job, which is
+ * executed as a single 'preadv' or 'pwritev' call. Once a job is done, the
+ * worker signals the session, whose entrypoint acknowledges the packets of
+ * the job. Hence, a slow host request stalls only the worker that executes
+ * it, and packets are acknowledged in the order of completion.
+ *
+ * All jobs that refer to the same file are executed by the same worker in
+ * the order of submission, so that dependent requests, e.g., a read of a
+ * just written range, observe each other. Each job operates on a duplicate
+ * of the file descriptor, which stays valid even if the client closes the
+ * file while the job is in flight.
+ */
+class File_system::Io_engine
+{
+	public:
+
+		enum { MAX_QUEUE_DEPTH = 64, MAX_WORKERS = 16, MAX_MERGE = 16 };
+
+		enum { WORKER_STACK_SIZE = 16*1024 };
+
+		class Job : public Genode::Fifo<Job>::Element
+		{
+			private:
+
+				friend class Io_engine;
+
+				Packet_descriptor::Opcode _op     = Packet_descriptor::READ;
+				int                       _file   = -1;  /* fd of the node */
+				int                       _fd     = -1;  /* duplicate      */
+				bool                      _append = false;
+				seek_off_t                _offset = 0;
+				size_t                    _length = 0;
+				unsigned                  _count  = 0;
+				unsigned                  _acked  = 0;
+
+				Packet_descriptor _packets[MAX_MERGE];
+				struct iovec      _iov[MAX_MERGE];
+
+				void _execute()
+				{
+					/* appending writes depend on the current file size */
+					if (_append) {
+						::off_t const off = lseek(_fd, 0, SEEK_END);
+						if (off != -1)
+							_offset = off;
+					}
+
+					ssize_t const res = _op == Packet_descriptor::READ
+					                  ? preadv (_fd, _iov, _count, _offset)
+					                  : pwritev(_fd, _iov, _count, _offset);
+
+					/* distribute the transferred bytes over the packets */
+					size_t left = res < 0 ? 0 : res;
+					for (unsigned i = 0; i < _count; i++) {
+						size_t const n = Genode::min(left, _iov[i].iov_len);
+						_packets[i].length(n);
+						_packets[i].succeeded(n > 0);
+						left -= n;
+					}
+				}
+
+			public:
+
+				bool empty() const { return _count == 0; }
+
+				/**
+				 * Add packet to job
+				 *
+				 * \param fd       host file descriptor of the file node
+				 * \param content  packet content within the bulk buffer
+				 *
+				 * \return false if the packet cannot be merged with the
+				 *         packets already present
+				 */
+				bool add(Packet_descriptor const &packet, int fd, void *content)
+				{
+					bool const append = packet.operation() == Packet_descriptor::WRITE
+					                 && packet.position() == ~0ULL;
+					if (_count) {
+						if (_count == MAX_MERGE || _file != fd || _append || append
+						 || _op != packet.operation()
+						 || _offset + _length != packet.position())
+							return false;
+					} else {
+						_fd = dup(fd);
+						if (_fd < 0)
+							return false;
+
+						_op     = packet.operation();
+						_file   = fd;
+						_append = append;
+						_offset = packet.position();
+					}
+
+					_iov[_count].iov_base = content;
+					_iov[_count].iov_len  = packet.length();
+					_packets[_count]      = packet;
+					_length += packet.length();
+					_count++;
+					return true;
+				}
+		};
+
+	private:
+
+		struct Worker : Genode::Thread
+		{
+			Io_engine &engine;
+
+			Genode::Semaphore pending_sem;
+			Genode::Fifo<Job> pending;  /* submitted, not yet executed */
+
+			Worker(Genode::Env &env, Io_engine &engine)
+			:
+				Genode::Thread(env, "io_worker", WORKER_STACK_SIZE),
+				engine(engine)
+			{ }
+
+			void entry() override
+			{
+				while (Job *job = engine._next_job(*this)) {
+					job->_execute();
+					engine._complete(*job);
+				}
+			}
+		};
+
+		Genode::Allocator &_alloc;
+
+		Genode::Signal_context_capability const _done_sigh;
+
+		Genode::Lock      _lock;
+		Genode::Fifo<Job> _completed;  /* executed, not yet picked up   */
+		bool              _shutdown = false;
+
+		/* accessed by the entrypoint only */
+		Genode::Fifo<Job> _free;
+		Genode::Fifo<Job> _acking;     /* completed, not fully acked    */
+
+		unsigned const _num_workers;
+		Worker        *_workers[MAX_WORKERS];
+
+		Job *_next_job(Worker &worker)
+		{
+			worker.pending_sem.down();
+
+			Genode::Lock::Guard guard(_lock);
+			return _shutdown ? nullptr : worker.pending.dequeue();
+		}
+
+		void _destroy(Job &job)
+		{
+			if (job._fd >= 0)
+				close(job._fd);
+
+			destroy(_alloc, &job);
+		}
+
+		void _complete(Job &job)
+		{
+			{
+				Genode::Lock::Guard guard(_lock);
+				_completed.enqueue(&job);
+			}
+			Genode::Signal_transmitter(_done_sigh).submit();
+		}
+
+		/*
+		 * Noncopyable
+		 */
+		Io_engine(Io_engine const &);
+		Io_engine &operator = (Io_engine const &);
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param queue_depth  maximum number of jobs in flight
+		 * \param workers      number of worker threads, 0 disables the
+		 *                     asynchronous execution
+		 * \param done_sigh    signal handler informed about completed jobs
+		 */
+		Io_engine(Genode::Env &env, Genode::Allocator &alloc,
+		          unsigned queue_depth, unsigned workers,
+		          Genode::Signal_context_capability done_sigh)
+		:
+			_alloc(alloc), _done_sigh(done_sigh),
+			_num_workers(Genode::min(workers, (unsigned)MAX_WORKERS))
+		{
+			if (!_num_workers)
+				return;
+
+			queue_depth = Genode::max(1U, Genode::min(queue_depth,
+			                                          (unsigned)MAX_QUEUE_DEPTH));
+			for (unsigned i = 0; i < queue_depth; i++)
+				_free.enqueue(new (_alloc) Job);
+
+			for (unsigned i = 0; i < _num_workers; i++) {
+				_workers[i] = new (_alloc) Worker(env, *this);
+				_workers[i]->start();
+			}
+		}
+
+		~Io_engine()
+		{
+			{
+				Genode::Lock::Guard guard(_lock);
+				_shutdown = true;
+			}
+
+			auto destroy_all = [&] (Genode::Fifo<Job> &fifo) {
+				while (Job *job = fifo.dequeue())
+					_destroy(*job); };
+
+			/* workers finish their current job before they exit */
+			for (unsigned i = 0; i < _num_workers; i++)
+				_workers[i]->pending_sem.up();
+
+			for (unsigned i = 0; i < _num_workers; i++) {
+				_workers[i]->join();
+				destroy_all(_workers[i]->pending);
+				destroy(_alloc, _workers[i]);
+			}
+
+			destroy_all(_free);
+			destroy_all(_acking);
+			destroy_all(_completed);
+		}
+
+		bool enabled() const { return _num_workers > 0; }
+
+		/**
+		 * Size of the metadata allocated per job
+		 */
+		static size_t job_size() { return sizeof(Job); }
+
+		/**
+		 * RAM consumed per worker thread
+		 *
+		 * Besides the stack and the worker object, the estimate covers the
+		 * UTCB and the thread meta data.
+		 */
+		static size_t worker_size()
+		{
+			return sizeof(Worker) + WORKER_STACK_SIZE + 8*1024;
+		}
+
+		/**
+		 * Obtain empty job
+		 *
+		 * \return nullptr if the maximum number of jobs is in flight
+		 */
+		Job *alloc_job() { return enabled() ? _free.dequeue() : nullptr; }
+
+		void free_job(Job &job)
+		{
+			if (job._fd >= 0)
+				close(job._fd);
+
+			job = Job();
+			_free.enqueue(&job);
+		}
+
+		/**
+		 * Hand job over to the worker responsible for its file
+		 */
+		void submit(Job &job)
+		{
+			Worker &worker = *_workers[(unsigned)job._file % _num_workers];
+			{
+				Genode::Lock::Guard guard(_lock);
+				worker.pending.enqueue(&job);
+			}
+			worker.pending_sem.up();
+		}
+
+		/**
+		 * Acknowledge the packets of completed jobs
+		 *
+		 * The functor 'fn' is called with each packet and returns false if
+		 * it cannot acknowledge the packet right now. The remaining
+		 * packets are kept for the next call.
+		 */
+		template <typename FN>
+		void ack_completed(FN const &fn)
+		{
+			{
+				Genode::Lock::Guard guard(_lock);
+				while (Job *job = _completed.dequeue())
+					_acking.enqueue(job);
+			}
+
+			while (Job *job = _acking.head()) {
+
+				for (; job->_acked < job->_count; job->_acked++)
+					if (!fn(job->_packets[job->_acked]))
+						return;
+
+				_acking.remove(job);
+				free_job(*job);
+			}
+		}
+};
+
+#endif /* _IO_ENGINE_H_ */
@@ -20,9 +20,11 @@
 #include <file_system_session/rpc_object.h>
 #include <os/session_policy.h>
 #include <util/xml_node.h>
+#include <util/reconstructible.h>
 
 /* local includes */
 #include <directory.h>
+#include <io_engine.h>
 
 
 namespace File_system {
@@ -44,6 +46,9 @@ class File_system::Session_component : public Session_rpc_object
 
 		Signal_handler<Session_component> _process_packet_dispatcher;
 
+		/* destructed before the packet-stream buffer is freed */
+		Genode::Constructible<Io_engine> _io;
+
 
 		/******************************
 		 ** Packet-stream processing **
@@ -87,10 +92,8 @@ class File_system::Session_component : public Session_rpc_object
 			packet.succeeded(res_length > 0);
 		}
 
-		void _process_packet()
+		void _process_packet(Packet_descriptor packet)
 		{
-			Packet_descriptor packet = tx_sink()->get_packet();
-
 			/* assume failure by default */
 			packet.succeeded(false);
 
@@ -109,12 +112,66 @@ class File_system::Session_component : public Session_rpc_object
 			tx_sink()->acknowledge_packet(packet);
 		}
 
+		/**
+		 * Add file read or write to job executed by the I/O engine
+		 *
+		 * If the packet cannot be merged with the packets of 'job', the job
+		 * is submitted and a new one is started.
+		 *
+		 * \return false if the packet must be processed synchronously
+		 */
+		bool _queue_packet(Packet_descriptor const &packet, Io_engine::Job *&job)
+		{
+			void * const content = tx_sink()->packet_content(packet);
+
+			if (!content || (packet.length() > packet.size())
+			 || (packet.operation() != Packet_descriptor::READ
+			  && packet.operation() != Packet_descriptor::WRITE))
+				return false;
+
+			File *file = nullptr;
+			try {
+				Node *node = _handle_registry.lookup_and_lock(packet.handle());
+				Node_lock_guard guard(node);
+
+				file = dynamic_cast<File *>(node);
+			}
+			catch (Invalid_handle) { return false; }
+
+			if (!file)
+				return false;
+
+			if (job->add(packet, file->fd(), content))
+				return true;
+
+			/* the file descriptor could not be duplicated */
+			if (job->empty())
+				return false;
+
+			_io->submit(*job);
+
+			job = _io->alloc_job();
+			return job && job->add(packet, file->fd(), content);
+		}
+
 		/**
 		 * Called by signal dispatcher, executed in the context of the main
 		 * thread (not serialized with the RPC functions)
 		 */
 		void _process_packets()
 		{
+			/* acknowledge the requests completed by the I/O engine */
+			_io->ack_completed([&] (Packet_descriptor const &packet) {
+				if (!tx_sink()->ready_to_ack())
+					return false;
+
+				tx_sink()->acknowledge_packet(packet);
+				return true;
+			});
+
+			/* job that collects the requests to adjacent file ranges */
+			Io_engine::Job *job = nullptr;
+
 			while (tx_sink()->packet_avail()) {
 
 				/*
@@ -130,10 +187,31 @@ class File_system::Session_component : public Session_rpc_object
 				 * for receiving any subsequent 'ready-to-ack' signals.
 				 */
 				if (!tx_sink()->ready_to_ack())
-					return;
+					break;
+
+				/*
+				 * Leave further requests in the submit queue while the
+				 * maximum number of jobs is in flight. Processing is
+				 * resumed once a job is completed.
+				 */
+				if (_io->enabled() && !job && !(job = _io->alloc_job()))
+					break;
+
+				Packet_descriptor const packet = tx_sink()->get_packet();
 
-				_process_packet();
+				if (job && _queue_packet(packet, job))
+					continue;
+
+				_process_packet(packet);
 			}
+
+			if (!job)
+				return;
+
+			if (job->empty())
+				_io->free_job(*job);
+			else
+				_io->submit(*job);
 		}
 
 		/**
@@ -156,7 +234,9 @@ class File_system::Session_component : public Session_rpc_object
 		                  Genode::Env &env,
 		                  char const  *root_dir,
 		                  bool         writable,
-		                  Allocator   &md_alloc)
+		                  Allocator   &md_alloc,
+		                  unsigned     io_queue_depth,
+		                  unsigned     io_workers)
 		:
 			Session_rpc_object(env.ram().alloc(tx_buf_size), env.rm(), env.ep().rpc_ep()),
 			_env(env),
@@ -165,6 +245,9 @@ class File_system::Session_component : public Session_rpc_object
 			_writable(writable),
 			_process_packet_dispatcher(env.ep(), *this, &Session_component::_process_packets)
 		{
+			_io.construct(env, md_alloc, io_queue_depth, io_workers,
+			              _process_packet_dispatcher);
+
 			/*
 			 * Register '_process_packets' dispatch function as signal
 			 * handler for packet-avail and ready-to-ack signals.
@@ -178,6 +261,8 @@ class File_system::Session_component : public Session_rpc_object
 		 */
 		~Session_component()
 		{
+			_io.destruct();
+
 			Dataspace_capability ds = tx_sink()->dataspace();
 			_env.ram().free(static_cap_cast<Ram_dataspace>(ds));
 			destroy(&_md_alloc, &_root);
@@ -398,16 +483,39 @@ class File_system::Root : public Root_component<Session_component>
 			 * Check if donated ram quota suffices for session data,
 			 * and communication buffer.
 			 */
-			size_t session_size = sizeof(Session_component) + tx_buf_size;
-			if (max((size_t)4096, session_size) > ram_quota) {
+			size_t session_size = max((size_t)4096,
+			                          sizeof(Session_component) + tx_buf_size);
+			if (session_size > ram_quota) {
 				Genode::error("insufficient 'ram_quota', "
 				              "got ", ram_quota, ", need ", session_size);
 				throw Root::Quota_exceeded();
 			}
 
+			/*
+			 * The jobs and worker threads of the asynchronous I/O are paid
+			 * from the remaining quota. The session starts as many of the
+			 * configured workers as the quota covers and processes its
+			 * packets synchronously if it cannot afford a single worker.
+			 */
+			unsigned const io_queue_depth =
+				max(1U, min(_config.xml().attribute_value("io_queue_depth", 16U),
+				            (unsigned)Io_engine::MAX_QUEUE_DEPTH));
+
+			size_t const io_quota = ram_quota - session_size;
+			size_t const jobs_size = io_queue_depth*Io_engine::job_size();
+
+			size_t const affordable_workers = io_quota > jobs_size
+				? (io_quota - jobs_size) / Io_engine::worker_size() : 0;
+
+			unsigned const io_workers =
+				min((size_t)min(_config.xml().attribute_value("io_workers", 4U),
+				                (unsigned)Io_engine::MAX_WORKERS),
+				    affordable_workers);
+
 			try {
 				return new (md_alloc())
-				       Session_component(tx_buf_size, _env, root_dir, writeable, *md_alloc());
+				       Session_component(tx_buf_size, _env, root_dir, writeable,
+				                         *md_alloc(), io_queue_depth, io_workers);
 			} catch (Lookup_failed) {
 				Genode::error("session root directory \"", Genode::Cstring(root), "\" "
 				              "does not exist");
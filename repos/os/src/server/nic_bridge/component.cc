@@ -38,6 +38,8 @@ bool Session_component::handle_arp(Ethernet_frame *eth, Genode::size_t size)
 		 if (arp->src_ip() == arp->dst_ip())
 			return false;
 
+		Vlan::Read_guard guard(vlan().lock);
+
 		Ipv4_address_node *node = vlan().ip_tree.first();
 		if (node)
 			node = node->find_by_address(arp->dst_ip());
@@ -74,6 +76,8 @@ bool Session_component::handle_ip(Ethernet_frame *eth, Genode::size_t size)
 void Session_component::finalize_packet(Ethernet_frame *eth,
                                                     Genode::size_t size)
 {
+	Vlan::Read_guard guard(vlan().lock);
+
 	Mac_address_node *node = vlan().mac_tree.first();
 	if (node)
 		node = node->find_by_address(eth->dst());
@@ -107,26 +111,26 @@ void Session_component::set_ipv4_address(Ipv4_address ip_addr)
 }
 
 
-Session_component::Session_component(Genode::Ram_session        &ram,
-                                     Genode::Region_map         &rm,
-                                     Genode::Entrypoint         &ep,
+Session_component::Session_component(Genode::Env                &env,
                                      Genode::size_t              amount,
                                      Genode::size_t              tx_buf_size,
                                      Genode::size_t              rx_buf_size,
+                                     unsigned                    queues,
                                      Mac_address                 vmac,
                                      Net::Nic                   &nic,
                                      char                       *ip_addr)
-: Stream_allocator(ram, rm, amount),
-  Stream_dataspaces(ram, tx_buf_size, rx_buf_size),
-  Session_rpc_object(rm,
-                     Stream_dataspaces::tx_ds,
-                     Stream_dataspaces::rx_ds,
-                     Stream_allocator::range_allocator(), ep.rpc_ep()),
-  Packet_handler(ep, nic.vlan()),
+: Stream_allocator(env.ram(), env.rm(), amount),
+  Multi_queue_session_component(tx_buf_size, rx_buf_size, queues, _heap, env),
+  Packet_handler(nic.vlan()),
   _mac_node(*this, vmac),
   _ipv4_node(*this),
   _nic(nic)
 {
+	for (unsigned i = 0; i < Multi_queue_session_component::queues(); i++)
+		_add_queue(_queue_sink(i), _queue_source(i));
+
+	Vlan::Write_guard guard(vlan().lock);
+
 	vlan().mac_tree.insert(&_mac_node);
 	vlan().mac_list.insert(&_mac_node);
 
@@ -141,16 +145,19 @@ Session_component::Session_component(Genode::Ram_session        &ram,
 			Genode::log("vmac = ", vmac, " ip = ", ip);
 		}
 	}
-
-	_tx.sigh_ready_to_ack(_sink_ack);
-	_tx.sigh_packet_avail(_sink_submit);
-	_rx.sigh_ack_avail(_source_ack);
-	_rx.sigh_ready_to_submit(_source_submit);
 }
 
 
-Session_component::~Session_component() {
-	vlan().mac_tree.remove(&_mac_node);
-	vlan().mac_list.remove(&_mac_node);
-	_unset_ipv4_node();
+Session_component::~Session_component()
+{
+	{
+		Vlan::Write_guard guard(vlan().lock);
+
+		vlan().mac_tree.remove(&_mac_node);
+		vlan().mac_list.remove(&_mac_node);
+		_unset_ipv4_node();
+	}
+
+	/* no other thread can reach the session anymore, stop its own threads */
+	_destruct_queues();
 }
@@ -17,9 +17,8 @@
 /* Genode */
 #include <base/log.h>
 #include <base/heap.h>
+#include <nic/component.h>
 #include <nic/packet_allocator.h>
-#include <nic_session/rpc_object.h>
-#include <nic_session/connection.h>
 #include <nic_bridge/mac_allocator.h>
 #include <os/ram_session_guard.h>
 #include <os/session_policy.h>
@@ -32,8 +31,6 @@
 
 namespace Net {
 	class Stream_allocator;
-	class Stream_dataspace;
-	class Stream_dataspaces;
 	class Session_component;
 	class Root;
 }
@@ -49,7 +46,6 @@ class Net::Stream_allocator
 
 		Genode::Ram_session_guard _ram;
 		Genode::Heap              _heap;
-		::Nic::Packet_allocator   _range_alloc;
 
 	public:
 
@@ -57,32 +53,7 @@ class Net::Stream_allocator
 		                 Genode::Region_map  &rm,
 		                 Genode::size_t     amount)
 		: _ram(ram, Genode::Ram_session_capability(), amount),
-		  _heap(ram, rm),
-		  _range_alloc(&_heap) {}
-
-		Genode::Range_allocator *range_allocator() {
-			return static_cast<Genode::Range_allocator *>(&_range_alloc); }
-};
-
-
-struct Net::Stream_dataspace : Genode::Ram_dataspace_capability
-{
-	Genode::Ram_session &ram;
-
-	Stream_dataspace(Genode::Ram_session &ram, Genode::size_t size)
-	: Genode::Ram_dataspace_capability(ram.alloc(size)), ram(ram) { }
-
-	~Stream_dataspace() { ram.free(*this); }
-};
-
-
-struct Net::Stream_dataspaces
-{
-	Stream_dataspace tx_ds, rx_ds;
-
-	Stream_dataspaces(Genode::Ram_session &ram, Genode::size_t tx_size,
-	                  Genode::size_t rx_size)
-	: tx_ds(ram, tx_size), rx_ds(ram, rx_size) { }
+		  _heap(ram, rm) {}
 };
 
 
@@ -91,11 +62,12 @@ struct Net::Stream_dataspaces
  *
  * We must inherit here from Stream_allocator, although aggregation
  * would be more convinient, because the allocator needs to be initialized
- * before base-class Session_rpc_object.
+ * before base-class Multi_queue_session_component.
+ *
+ * Each queue pair of the session is served by a thread of its own.
  */
 class Net::Session_component : public  Net::Stream_allocator,
-                               private Net::Stream_dataspaces,
-                               public  ::Nic::Session_rpc_object,
+                               public  ::Nic::Multi_queue_session_component,
                                public  Net::Packet_handler
 {
 	private:
@@ -103,36 +75,41 @@ class Net::Session_component : public  Net::Stream_allocator,
 		Mac_address_node                  _mac_node;
 		Ipv4_address_node                 _ipv4_node;
 		Net::Nic                         &_nic;
-		Genode::Signal_context_capability _link_state_sigh;
 
 		void _unset_ipv4_node();
 
+		/****************************************
+		 ** Nic::Multi_queue_session_component **
+		 ****************************************/
+
+		void _handle_queue(unsigned queue, Session::Tx::Sink &,
+		                   Session::Rx::Source &) override {
+			_process_queue(queue); }
+
 	public:
 
 		/**
 		 * Constructor
 		 *
-		 * \param ram          ram session
-		 * \param rm           region map of this component
-		 * \param ep           entry point this session component is handled by
+		 * \param env          environment of the component
 		 * \param amount       amount of memory managed by guarded allocator
 		 * \param tx_buf_size  buffer size for tx channel
 		 * \param rx_buf_size  buffer size for rx channel
+		 * \param queues       number of queue pairs
 		 * \param vmac         virtual mac address
 		 */
-		Session_component(Genode::Ram_session &ram,
-		                  Genode::Region_map  &rm,
-		                  Genode::Entrypoint  &ep,
+		Session_component(Genode::Env         &env,
 		                  Genode::size_t       amount,
 		                  Genode::size_t       tx_buf_size,
 		                  Genode::size_t       rx_buf_size,
+		                  unsigned             queues,
 		                  Mac_address          vmac,
 		                  Net::Nic            &nic,
 		                  char                *ip_addr = 0);
 
 		~Session_component();
 
-		::Nic::Mac_address mac_address()
+		::Nic::Mac_address mac_address() override
 		{
 			::Nic::Mac_address m;
 			Mac_address_node::Address mac = _mac_node.addr();
@@ -140,12 +117,13 @@ class Net::Session_component : public  Net::Stream_allocator,
 			return m;
 		}
 
-		void link_state_changed()
-		{
-			if (_link_state_sigh.valid())
-				Genode::Signal_transmitter(_link_state_sigh).submit();
-		}
+		void link_state_changed() { _link_state_changed(); }
 
+		/**
+		 * Set IP address of the client
+		 *
+		 * The caller must hold the lock of the VLAN for writing.
+		 */
 		void set_ipv4_address(Ipv4_address ip_addr);
 
 
@@ -153,22 +131,13 @@ class Net::Session_component : public  Net::Stream_allocator,
 		 ** Nic::Driver notification interface **
 		 ****************************************/
 
-		bool link_state();
-
-		void link_state_sigh(Genode::Signal_context_capability sigh) {
-			_link_state_sigh = sigh; }
+		bool link_state() override;
 
 
 		/******************************
 		 ** Packet_handler interface **
 		 ******************************/
 
-		Packet_stream_sink< ::Nic::Session::Policy>   * sink()   {
-			return _tx.sink(); }
-
-		Packet_stream_source< ::Nic::Session::Policy> * source() {
-			return _rx.source(); }
-
 		bool handle_arp(Ethernet_frame *eth,      Genode::size_t size);
 		bool handle_ip(Ethernet_frame *eth,       Genode::size_t size);
 		void finalize_packet(Ethernet_frame *eth, Genode::size_t size);
@@ -187,6 +156,8 @@ class Net::Root : public Genode::Root_component<Net::Session_component>
 		Net::Nic         &_nic;
 		Genode::Xml_node  _config;
 
+		unsigned const _max_queues = _env.cpu().affinity_space().total();
+
 	protected:
 
 		Session_component *_create_session(const char *args)
@@ -211,11 +182,29 @@ class Net::Root : public Genode::Root_component<Net::Session_component>
 				Arg_string::find_arg(args, "tx_buf_size").ulong_value(0);
 			size_t rx_buf_size =
 				Arg_string::find_arg(args, "rx_buf_size").ulong_value(0);
+			unsigned queues =
+				Arg_string::find_arg(args, "queues"     ).ulong_value(1);
+
+			/* more queues than CPUs bring no additional parallelism */
+			queues = max(1U, min(queues, min(_max_queues,
+			                                 (unsigned)::Nic::Session::MAX_QUEUES)));
+
+			/*
+			 * Deplete ram quota by the memory needed for the threads
+			 * serving the queues
+			 */
+			size_t const queues_quota =
+				Session_component::queues_quota(queues);
+
+			if (ram_quota < queues_quota) {
+				Genode::warning("insufficient 'ram_quota'");
+				throw Root::Quota_exceeded();
+			}
 
 			try {
 				return new (md_alloc())
-					Session_component(_env.ram(), _env.rm(), _env.ep(),
-					                  ram_quota, tx_buf_size, rx_buf_size,
+					Session_component(_env, ram_quota - queues_quota,
+					                  tx_buf_size, rx_buf_size, queues,
 					                  _mac_alloc.alloc(), _nic, ip_addr);
 			} catch(Mac_allocator::Alloc_failed) {
 				Genode::warning("Mac address allocation failed!");
@@ -32,9 +32,21 @@ struct Main
 	Genode::Heap                    heap   { env.ram(), env.rm() };
 	Genode::Attached_rom_dataspace  config { env, "config" };
 	Net::Vlan                       vlan;
-	Net::Nic                        nic    { env, heap, vlan };
+	Net::Nic                        nic    { env, heap, vlan, uplink_queues() };
 	Net::Root                       root   { env, nic, heap, config.xml() };
 
+	/**
+	 * Number of queue pairs requested from the uplink, at most one per CPU
+	 */
+	unsigned uplink_queues()
+	{
+		unsigned const queues =
+			config.xml().attribute_value("uplink_queues", 1U);
+
+		return Genode::max(1U, Genode::min(queues,
+		                   (unsigned)env.cpu().affinity_space().total()));
+	}
+
 	void handle_config()
 	{
 		/* read MAC address prefix from config file */
@@ -31,6 +31,8 @@ bool Net::Nic::handle_arp(Ethernet_frame *eth, Genode::size_t size) {
 	if (!arp->ethernet_ipv4())
 		return true;
 
+	Vlan::Read_guard guard(vlan().lock);
+
 	/* look whether the IP address is one of our client's */
 	Ipv4_address_node *node = vlan().ip_tree.first();
 	if (node)
@@ -90,6 +92,8 @@ bool Net::Nic::handle_ip(Ethernet_frame *eth, Genode::size_t size) {
 					 */
 					Genode::uint8_t *msg_type =	(Genode::uint8_t*) ext->value();
 					if (*msg_type == Dhcp_packet::DHCP_ACK) {
+						Vlan::Write_guard guard(vlan().lock);
+
 						Mac_address_node *node =
 							vlan().mac_tree.first();
 						if (node)
@@ -104,6 +108,8 @@ bool Net::Nic::handle_ip(Ethernet_frame *eth, Genode::size_t size) {
 
 	/* is it an unicast message to one of our clients ? */
 	if (eth->dst() == mac()) {
+		Vlan::Read_guard guard(vlan().lock);
+
 		Ipv4_address_node *node = vlan().ip_tree.first();
 		if (node) {
 			node = node->find_by_address(ip->dst());
@@ -121,15 +127,30 @@ bool Net::Nic::handle_ip(Ethernet_frame *eth, Genode::size_t size) {
 }
 
 
-Net::Nic::Nic(Genode::Env &env, Genode::Heap &heap, Net::Vlan &vlan)
-: Packet_handler(env.ep(), vlan),
+Net::Nic::Nic(Genode::Env &env, Genode::Heap &heap, Net::Vlan &vlan,
+              unsigned queues)
+: Packet_handler(vlan),
   _tx_block_alloc(&heap),
-  _nic(env, &_tx_block_alloc, BUF_SIZE, BUF_SIZE),
-  _mac(_nic.mac_address().addr)
+  _nic(env, _tx_block_alloc, heap, BUF_SIZE, BUF_SIZE, queues),
+  _mac(_nic.mac_address().addr),
+  _link_state_handler(env.ep(), *this, &Nic::_link_state)
 {
-	_nic.rx_channel()->sigh_ready_to_ack(_sink_ack);
-	_nic.rx_channel()->sigh_packet_avail(_sink_submit);
-	_nic.tx_channel()->sigh_ack_avail(_source_ack);
-	_nic.tx_channel()->sigh_ready_to_submit(_source_submit);
-	_nic.link_state_sigh(_client_link_state);
+	Genode::Affinity::Space const space = env.cpu().affinity_space();
+
+	for (unsigned i = 0; i < _nic.queues(); i++) {
+		_add_queue(*_nic.rx(i), *_nic.tx(i));
+
+		_queue_handlers[i].construct(env, *this, i, space.location_of_index(i));
+
+		/*
+		 * A full acknowledgement queue and a full submit queue are not
+		 * waited for, so the corresponding signals are not needed.
+		 */
+		Genode::Signal_context_capability const sigh =
+			*_queue_handlers[i]->handler;
+
+		_nic.rx_channel(i)->sigh_packet_avail(sigh);
+		_nic.tx_channel(i)->sigh_ack_avail(sigh);
+	}
+	_nic.link_state_sigh(_link_state_handler);
 }
@@ -14,7 +14,9 @@
 #ifndef _SRC__SERVER__NIC_BRIDGE__NIC_H_
 #define _SRC__SERVER__NIC_BRIDGE__NIC_H_
 
-#include <nic_session/connection.h>
+#include <base/entrypoint.h>
+#include <base/heap.h>
+#include <nic_session/multi_queue_connection.h>
 #include <nic/packet_allocator.h>
 
 #include <packet_handler.h>
@@ -29,17 +31,56 @@ class Net::Nic : public Net::Packet_handler
 		enum {
 			PACKET_SIZE = ::Nic::Packet_allocator::DEFAULT_PACKET_SIZE,
 			BUF_SIZE    = ::Nic::Session::QUEUE_SIZE * PACKET_SIZE,
+			STACK_SIZE  = 8*1024*sizeof(long),
 		};
 
-		::Nic::Packet_allocator     _tx_block_alloc;
-		::Nic::Connection           _nic;
-		Mac_address _mac;
+		/**
+		 * Thread that serves a queue pair of the uplink session
+		 *
+		 * The first queue pair is served by the entrypoint of the
+		 * component, each further pair by an entrypoint of its own.
+		 */
+		struct Queue_handler
+		{
+			Nic           &nic;
+			unsigned const index;
+
+			Genode::Constructible<Genode::Entrypoint> ep;
+
+			Genode::Constructible<Genode::Signal_handler<Queue_handler> > handler;
+
+			void handle() { nic._process_queue(index); }
+
+			Queue_handler(Genode::Env &env, Nic &nic, unsigned index,
+			              Genode::Affinity::Location location)
+			: nic(nic), index(index)
+			{
+				if (index)
+					ep.construct(env, STACK_SIZE, "nic_queue", location);
+
+				handler.construct(index ? *ep : env.ep(), *this,
+				                  &Queue_handler::handle);
+			}
+		};
+
+		::Nic::Packet_allocator      _tx_block_alloc;
+		::Nic::Multi_queue_connection _nic;
+		Mac_address                  _mac;
+
+		Genode::Constructible<Queue_handler> _queue_handlers[::Nic::Session::MAX_QUEUES];
+
+		Genode::Signal_handler<Nic> _link_state_handler;
 
 	public:
 
-		Nic(Genode::Env&, Genode::Heap&, Vlan&);
+		/**
+		 * Constructor
+		 *
+		 * \param queues  number of queue pairs requested from the uplink
+		 */
+		Nic(Genode::Env&, Genode::Heap&, Vlan&, unsigned queues);
 
-		::Nic::Connection          *nic() { return &_nic; }
+		::Nic::Multi_queue_connection *nic() { return &_nic; }
 		Mac_address mac() { return _mac; }
 
 		bool link_state() { return _nic.link_state(); }
@@ -48,12 +89,6 @@ class Net::Nic : public Net::Packet_handler
 		 ** Packet_handler interface **
 		 ******************************/
 
-		Packet_stream_sink< ::Nic::Session::Policy> * sink() {
-			return _nic.rx(); }
-
-		Packet_stream_source< ::Nic::Session::Policy> * source() {
-			return _nic.tx(); }
-
 		bool handle_arp(Ethernet_frame *eth,      Genode::size_t size);
 		bool handle_ip(Ethernet_frame *eth,       Genode::size_t size);
 		void finalize_packet(Ethernet_frame *eth, Genode::size_t size) {}
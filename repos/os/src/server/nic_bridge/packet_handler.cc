@@ -12,6 +12,7 @@
  */
 
 #include <base/log.h>
+#include <nic/flow_hash.h>
 #include <net/arp.h>
 #include <net/dhcp.h>
 #include <net/ethernet.h>
@@ -23,34 +24,53 @@
 
 using namespace Net;
 
-void Packet_handler::_ready_to_submit()
+void Packet_handler::_ready_to_submit(Queue &queue)
 {
+	Sink &sink = queue.sink;
+
 	/* as long as packets are available, and we can ack them */
-	while (sink()->packet_avail()) {
-		_packet = sink()->get_packet();
-		if (!_packet.size()) continue;
-		handle_ethernet(sink()->packet_content(_packet), _packet.size());
+	while (sink.packet_avail()) {
+		Packet_descriptor const packet = sink.get_packet();
+		if (!packet.size()) continue;
+		handle_ethernet(sink.packet_content(packet), packet.size());
 
-		if (!sink()->ready_to_ack()) {
+		if (!sink.ready_to_ack()) {
 			Genode::warning("ack state FULL");
 			return;
 		}
 
-		sink()->acknowledge_packet(_packet);
+		sink.acknowledge_packet(packet);
 	}
 }
 
 
-void Packet_handler::_ready_to_ack()
+void Packet_handler::_ready_to_ack(Queue &queue)
 {
+	Genode::Lock::Guard guard(queue.source_lock);
+
 	/* check for acknowledgements */
-	while (source()->ack_avail())
-		source()->release_packet(source()->get_acked_packet());
+	while (queue.source.ack_avail())
+		queue.source.release_packet(queue.source.get_acked_packet());
+}
+
+
+void Packet_handler::_add_queue(Sink &sink, Source &source)
+{
+	_packet_queues[_packet_queue_cnt++].construct(sink, source);
+}
+
+
+void Packet_handler::_process_queue(unsigned queue)
+{
+	_ready_to_ack(*_packet_queues[queue]);
+	_ready_to_submit(*_packet_queues[queue]);
 }
 
 
 void Packet_handler::_link_state()
 {
+	Vlan::Read_guard guard(_vlan.lock);
+
 	Mac_address_node *node = _vlan.mac_list.first();
 	while (node) {
 		node->component().link_state_changed();
@@ -63,6 +83,8 @@ void Packet_handler::broadcast_to_clients(Ethernet_frame *eth, Genode::size_t si
 {
 	/* check whether it's really a broadcast packet */
 	if (eth->dst() == Ethernet_frame::BROADCAST) {
+		Vlan::Read_guard guard(_vlan.lock);
+
 		/* iterate through the list of clients */
 		Mac_address_node *node =
 			_vlan.mac_list.first();
@@ -109,23 +131,21 @@ void Packet_handler::handle_ethernet(void* src, Genode::size_t size)
 
 void Packet_handler::send(Ethernet_frame *eth, Genode::size_t size)
 {
+	Queue &queue =
+		*_packet_queues[::Nic::flow_queue(eth, size, _packet_queue_cnt)];
+
+	Genode::Lock::Guard guard(queue.source_lock);
+
 	try {
 		/* copy and submit packet */
-		Packet_descriptor packet  = source()->alloc_packet(size);
-		char             *content = source()->packet_content(packet);
+		Packet_descriptor packet  = queue.source.alloc_packet(size);
+		char             *content = queue.source.packet_content(packet);
 		Genode::memcpy((void*)content, (void*)eth, size);
-		source()->submit_packet(packet);
-	} catch(Packet_stream_source< ::Nic::Session::Policy>::Packet_alloc_failed) {
+		queue.source.submit_packet(packet);
+	} catch(Source::Packet_alloc_failed) {
 		Genode::warning("Packet dropped");
 	}
 }
 
 
-Packet_handler::Packet_handler(Genode::Entrypoint &ep, Vlan &vlan)
-: _vlan(vlan),
-  _sink_ack(ep, *this, &Packet_handler::_ack_avail),
-  _sink_submit(ep, *this, &Packet_handler::_ready_to_submit),
-  _source_ack(ep, *this, &Packet_handler::_ready_to_ack),
-  _source_submit(ep, *this, &Packet_handler::_packet_avail),
-  _client_link_state(ep, *this, &Packet_handler::_link_state)
-{ }
+Packet_handler::Packet_handler(Vlan &vlan) : _vlan(vlan) { }
@@ -15,10 +15,9 @@
 #define _PACKET_HANDLER_H_
 
 /* Genode */
-#include <base/semaphore.h>
-#include <base/thread.h>
+#include <base/lock.h>
 #include <nic_session/connection.h>
-#include <os/server.h>
+#include <util/reconstructible.h>
 #include <net/ethernet.h>
 #include <net/ipv4.h>
 
@@ -35,59 +34,71 @@ namespace Net {
 
 /**
  * Generic packet handler used as base for NIC and client packet handlers.
+ *
+ * The handler serves one or more queue pairs, each by a thread of its own.
+ * A queue pair consists of a sink, which is drained only by the thread of
+ * the queue, and a source, to which the threads of all queues of the NIC
+ * and the clients send packets.
  */
 class Net::Packet_handler
 {
+	public:
+
+		using Sink   = Packet_stream_sink< ::Nic::Session::Policy>;
+		using Source = Packet_stream_source< ::Nic::Session::Policy>;
+
 	private:
 
-		Packet_descriptor _packet;
-		Net::Vlan        &_vlan;
+		struct Queue
+		{
+			Sink   &sink;
+			Source &source;
+
+			/* serializes the senders, and the release of acked packets */
+			Genode::Lock source_lock;
+
+			Queue(Sink &sink, Source &source) : sink(sink), source(source) { }
+		};
+
+		Net::Vlan &_vlan;
+
+		Genode::Constructible<Queue> _packet_queues[::Nic::Session::MAX_QUEUES];
+		unsigned                     _packet_queue_cnt = 0;
 
 		/**
 		 * submit queue not empty anymore
 		 */
-		void _ready_to_submit();
+		void _ready_to_submit(Queue &queue);
 
 		/**
-		 * acknoledgement queue not full anymore
-		 *
-		 * TODO: by now, we assume ACK and SUBMIT queue to be equally
-		 *       dimensioned. That's why we ignore this signal by now.
+		 * acknoledgement queue not empty anymore
 		 */
-		void _ack_avail() { }
+		void _ready_to_ack(Queue &queue);
+
+	protected:
 
 		/**
-		 * acknoledgement queue not empty anymore
+		 * Add queue pair, called by the constructors of sub-classes
 		 */
-		void _ready_to_ack();
+		void _add_queue(Sink &sink, Source &source);
 
 		/**
-		 * submit queue not full anymore
+		 * Handle packet-stream signals of the queue pair with index 'queue'
 		 *
-		 * TODO: by now, we just drop packets that cannot be transferred
-		 *       to the other side, that's why we ignore this signal.
+		 * Full acknowledgement queues and full submit queues of the peer are
+		 * not waited for. Packets that cannot be transferred to the other
+		 * side are dropped.
 		 */
-		void _packet_avail() { }
+		void _process_queue(unsigned queue);
 
 		/**
 		 * the link-state of changed
 		 */
 		void _link_state();
 
-	protected:
-
-		Genode::Signal_handler<Packet_handler> _sink_ack;
-		Genode::Signal_handler<Packet_handler> _sink_submit;
-		Genode::Signal_handler<Packet_handler> _source_ack;
-		Genode::Signal_handler<Packet_handler> _source_submit;
-		Genode::Signal_handler<Packet_handler> _client_link_state;
-
 	public:
 
-		Packet_handler(Genode::Entrypoint&, Vlan&);
-
-		virtual Packet_stream_sink< ::Nic::Session::Policy>   * sink()   = 0;
-		virtual Packet_stream_source< ::Nic::Session::Policy> * source() = 0;
+		Packet_handler(Vlan&);
 
 		Net::Vlan & vlan() { return _vlan; }
 
@@ -106,6 +117,8 @@ class Net::Packet_handler
 		 *
 		 * \param eth   ethernet frame to send.
 		 * \param size  ethernet frame's size.
+		 *
+		 * The frame is sent via the queue that serves its flow.
 		 */
 		void send(Ethernet_frame *eth, Genode::size_t size);
 
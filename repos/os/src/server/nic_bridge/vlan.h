@@ -18,6 +18,7 @@
 
 #include <util/avl_tree.h>
 #include <util/list.h>
+#include <base/reader_writer_lock.h>
 #include <address_node.h>
 
 namespace Net {
@@ -25,12 +26,20 @@ namespace Net {
 	/*
 	 * The Vlan is a database containing all clients
 	 * sorted by IP and MAC addresses.
+	 *
+	 * The queues of all sessions look up the database concurrently. The
+	 * lock must be held for reading while a client found in the database
+	 * is used, which keeps the client from being destroyed meanwhile.
 	 */
 	struct Vlan
 	{
 		using Mac_address_tree  = Genode::Avl_tree<Mac_address_node>;
 		using Ipv4_address_tree = Genode::Avl_tree<Ipv4_address_node>;
 		using Mac_address_list  = Genode::List<Mac_address_node>;
+		using Read_guard        = Genode::Reader_writer_lock::Read_guard;
+		using Write_guard       = Genode::Reader_writer_lock::Write_guard;
+
+		Genode::Reader_writer_lock lock;
 
 		Mac_address_tree  mac_tree;
 		Mac_address_list  mac_list;
@@ -4,6 +4,8 @@
  * \date   2009-11-13
  *
  * This program showcases the server-side use of the 'Nic_session' interface.
+ * Each queue pair of a multi-queue session is served by its own thread and
+ * echoes packets on the queue they arrived at.
  */
 
 /*
@@ -30,7 +32,7 @@ namespace Nic_loopback {
 }
 
 
-class Nic_loopback::Session_component : public Nic::Session_component
+class Nic_loopback::Session_component : public Nic::Multi_queue_session_component
 {
 	public:
 
@@ -39,19 +41,21 @@ class Nic_loopback::Session_component : public Nic::Session_component
 		 *
 		 * \param tx_buf_size        buffer size for tx channel
 		 * \param rx_buf_size        buffer size for rx channel
+		 * \param queues             number of queue pairs
 		 * \param rx_block_md_alloc  backing store of the meta data of the
 		 *                           rx block allocator
 		 * \param ram_session        RAM session to allocate tx and rx buffers
 		 * \param ep                 entry point used for packet stream
 		 *                           channels
 		 */
-		Session_component(size_t const tx_buf_size,
-		                  size_t const rx_buf_size,
-		                  Allocator   &rx_block_md_alloc,
-		                  Env         &env)
+		Session_component(size_t   const tx_buf_size,
+		                  size_t   const rx_buf_size,
+		                  unsigned const queues,
+		                  Allocator     &rx_block_md_alloc,
+		                  Env           &env)
 		:
-			Nic::Session_component(tx_buf_size, rx_buf_size, rx_block_md_alloc,
-			                       env)
+			Nic::Multi_queue_session_component(tx_buf_size, rx_buf_size, queues,
+			                                   rx_block_md_alloc, env)
 		{ }
 
 		Nic::Mac_address mac_address() override
@@ -67,11 +71,14 @@ class Nic_loopback::Session_component : public Nic::Session_component
 			return true;
 		}
 
-		void _handle_packet_stream() override;
+		void _handle_queue(unsigned, Session::Tx::Sink &,
+		                   Session::Rx::Source &) override;
 };
 
 
-void Nic_loopback::Session_component::_handle_packet_stream()
+void Nic_loopback::Session_component::_handle_queue(unsigned,
+                                                    Session::Tx::Sink   &tx_sink,
+                                                    Session::Rx::Source &rx_source)
 {
 	size_t const alloc_size = Nic::Packet_allocator::DEFAULT_PACKET_SIZE;
 
@@ -79,20 +86,20 @@ void Nic_loopback::Session_component::_handle_packet_stream()
 	for (;;) {
 
 		/* flush acknowledgements for the echoes packets */
-		while (_rx.source()->ack_avail())
-			_rx.source()->release_packet(_rx.source()->get_acked_packet());
+		while (rx_source.ack_avail())
+			rx_source.release_packet(rx_source.get_acked_packet());
 
 		/*
 		 * If the client cannot accept new acknowledgements for a sent packets,
 		 * we won't consume the sent packet.
 		 */
-		if (!_tx.sink()->ready_to_ack())
+		if (!tx_sink.ready_to_ack())
 			return;
 
 		/*
 		 * Nothing to be done if the client has not sent any packets.
 		 */
-		if (!_tx.sink()->packet_avail())
+		if (!tx_sink.packet_avail())
 			return;
 
 		/*
@@ -104,7 +111,7 @@ void Nic_loopback::Session_component::_handle_packet_stream()
 		 * The client fails to pick up the packets from the rx channel. So we
 		 * won't try to submit new packets.
 		 */
-		if (!_rx.source()->ready_to_submit())
+		if (!rx_source.ready_to_submit())
 			return;
 
 		/*
@@ -114,27 +121,27 @@ void Nic_loopback::Session_component::_handle_packet_stream()
 
 		Packet_descriptor packet_to_client;
 		try {
-			packet_to_client = _rx.source()->alloc_packet(alloc_size); }
+			packet_to_client = rx_source.alloc_packet(alloc_size); }
 		catch (Session::Rx::Source::Packet_alloc_failed) {
 			continue; }
 
 		/* obtain packet */
-		Packet_descriptor const packet_from_client = _tx.sink()->get_packet();
+		Packet_descriptor const packet_from_client = tx_sink.get_packet();
 		if (!packet_from_client.size()) {
 			warning("received zero-size packet");
-			_rx.source()->release_packet(packet_to_client);
+			rx_source.release_packet(packet_to_client);
 			continue;
 		}
 
-		memcpy(_rx.source()->packet_content(packet_to_client),
-		       _tx.sink()->packet_content(packet_from_client),
+		memcpy(rx_source.packet_content(packet_to_client),
+		       tx_sink.packet_content(packet_from_client),
 		       packet_from_client.size());
 
 		packet_to_client = Packet_descriptor(packet_to_client.offset(),
 		                                     packet_from_client.size());
-		_rx.source()->submit_packet(packet_to_client);
+		rx_source.submit_packet(packet_to_client);
 
-		_tx.sink()->acknowledge_packet(packet_from_client);
+		tx_sink.acknowledge_packet(packet_from_client);
 	}
 }
 
@@ -145,6 +152,8 @@ class Nic_loopback::Root : public Root_component<Session_component>
 
 		Env  &_env;
 
+		unsigned const _max_queues = _env.cpu().affinity_space().total();
+
 	protected:
 
 		Session_component *_create_session(char const *args)
@@ -152,25 +161,40 @@ class Nic_loopback::Root : public Root_component<Session_component>
 			size_t ram_quota   = Arg_string::find_arg(args, "ram_quota"  ).ulong_value(0);
 			size_t tx_buf_size = Arg_string::find_arg(args, "tx_buf_size").ulong_value(0);
 			size_t rx_buf_size = Arg_string::find_arg(args, "rx_buf_size").ulong_value(0);
+			unsigned queues    = Arg_string::find_arg(args, "queues"     ).ulong_value(1);
+
+			/*
+			 * Each further queue is echoed by a thread of its own, so more
+			 * queues than CPUs bring no additional parallelism.
+			 */
+			queues = max(1U, min(queues, min(_max_queues,
+			                                 (unsigned)Nic::Session::MAX_QUEUES)));
+
+			/*
+			 * Deplete ram quota by the memory needed for the session
+			 * structure and the threads serving the queues
+			 */
+			size_t const session_size =
+				max(4096UL, (size_t)sizeof(Session_component))
+				+ Session_component::queues_quota(queues);
 
-			/* deplete ram quota by the memory needed for the session structure */
-			size_t session_size = max(4096UL, (size_t)sizeof(Session_component));
 			if (ram_quota < session_size)
 				throw Root::Quota_exceeded();
 
 			/*
-			 * Check if donated ram quota suffices for both communication
-			 * buffers and check for overflow
+			 * Check if donated ram quota suffices for the communication
+			 * buffers of all queues and check for overflow
 			 */
-			if (tx_buf_size + rx_buf_size < tx_buf_size ||
-			    tx_buf_size + rx_buf_size > ram_quota - session_size) {
+			size_t const buf_size = tx_buf_size + rx_buf_size;
+			if (buf_size < tx_buf_size ||
+			    buf_size > (ram_quota - session_size) / queues) {
 				error("insufficient 'ram_quota', got ", ram_quota, ", "
-				      "need ", tx_buf_size + rx_buf_size + session_size);
+				      "need ", queues*buf_size + session_size);
 				throw Root::Quota_exceeded();
 			}
 
 			return new (md_alloc()) Session_component(tx_buf_size, rx_buf_size,
-			                                          *md_alloc(), _env);
+			                                          queues, *md_alloc(), _env);
 		}
 
 	public:
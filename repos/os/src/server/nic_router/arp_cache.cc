@@ -29,23 +29,11 @@ Arp_cache_entry::Arp_cache_entry(Ipv4_address const &ip,
 { }
 
 
-bool Arp_cache_entry::_higher(Ipv4_address const &ip) const
+uint32_t Arp_cache_entry::hash(Ipv4_address const &ip)
 {
-	return memcmp(ip.addr, _ip.addr, sizeof(_ip.addr)) > 0;
-}
-
-
-Arp_cache_entry const &
-Arp_cache_entry::find_by_ip(Ipv4_address const &ip) const
-{
-	if (ip == _ip) {
-		return *this; }
-
-	Arp_cache_entry const *const entry = child(_higher(ip));
-	if (!entry) {
-		throw Arp_cache::No_match(); }
-
-	return entry->find_by_ip(ip);
+	uint8_t const *const addr = ip.addr;
+	return hash_mix(addr[0] << 24 | addr[1] << 16 | addr[2] << 8 | addr[3],
+	                0, 0);
 }
 
 
@@ -55,9 +43,9 @@ Arp_cache_entry::find_by_ip(Ipv4_address const &ip) const
 
 void Arp_cache::new_entry(Ipv4_address const &ip, Mac_address const &mac)
 {
-	if (_entries[_curr].constructed()) { remove(&(*_entries[_curr])); }
+	if (_entries[_curr].constructed()) { _table.remove(*_entries[_curr]); }
 	_entries[_curr].construct(ip, mac);
-	insert(&(*_entries[_curr]));
+	_table.insert(*_entries[_curr]);
 	if (_curr < NR_OF_ENTRIES - 1) {
 		_curr++;
 	} else {
@@ -68,8 +56,9 @@ void Arp_cache::new_entry(Ipv4_address const &ip, Mac_address const &mac)
 
 Arp_cache_entry const &Arp_cache::find_by_ip(Ipv4_address const &ip) const
 {
-	if (!first()) {
+	Arp_cache_entry const *const entry = _table.find(ip);
+	if (!entry) {
 		throw No_match(); }
 
-	return first()->find_by_ip(ip);
+	return *entry;
 }
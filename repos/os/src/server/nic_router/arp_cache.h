@@ -17,9 +17,11 @@
 /* Genode includes */
 #include <net/ipv4.h>
 #include <net/ethernet.h>
-#include <util/avl_tree.h>
 #include <util/reconstructible.h>
 
+/* local includes */
+#include <hash_table.h>
+
 namespace Net {
 
 	class Arp_cache;
@@ -28,27 +30,25 @@ namespace Net {
 }
 
 
-class Net::Arp_cache_entry : public Genode::Avl_node<Arp_cache_entry>
+class Net::Arp_cache_entry
 {
 	private:
 
 		Ipv4_address const _ip;
 		Mac_address  const _mac;
 
-		bool _higher(Ipv4_address const &ip) const;
-
 	public:
 
 		Arp_cache_entry(Ipv4_address const &ip, Mac_address const &mac);
 
-		Arp_cache_entry const &find_by_ip(Ipv4_address const &ip) const;
 
+		/****************
+		 ** Hash_table **
+		 ****************/
 
-		/**************
-		 ** Avl_node **
-		 **************/
+		Ipv4_address const &key() const { return _ip; }
 
-		bool higher(Arp_cache_entry *entry) { return _higher(entry->_ip); }
+		static Genode::uint32_t hash(Ipv4_address const &ip);
 
 
 		/***************
@@ -59,7 +59,7 @@ class Net::Arp_cache_entry : public Genode::Avl_node<Arp_cache_entry>
 };
 
 
-class Net::Arp_cache : public Genode::Avl_tree<Arp_cache_entry>
+class Net::Arp_cache
 {
 	private:
 
@@ -68,17 +68,22 @@ class Net::Arp_cache : public Genode::Avl_tree<Arp_cache_entry>
 			NR_OF_ENTRIES = ENTRIES_SIZE / sizeof(Arp_cache_entry),
 		};
 
-		Arp_cache_entry_slot _entries[NR_OF_ENTRIES];
-		bool                 _init = true;
-		unsigned             _curr = 0;
+		Arp_cache_entry_slot                        _entries[NR_OF_ENTRIES];
+		unsigned                                    _curr = 0;
+		Hash_table<Arp_cache_entry, Ipv4_address>   _table;
 
 	public:
 
 		struct No_match : Genode::Exception { };
 
+		Arp_cache(Genode::Allocator &alloc)
+		: _table(alloc, NR_OF_ENTRIES * 2) { }
+
 		void new_entry(Ipv4_address const &ip, Mac_address const &mac);
 
 		Arp_cache_entry const &find_by_ip(Ipv4_address const &ip) const;
+
+		void report(Genode::Xml_generator &xml) const { _table.report(xml); }
 };
 
 #endif /* _ARP_CACHE_H_ */
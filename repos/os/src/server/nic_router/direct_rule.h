@@ -15,6 +15,7 @@
 #define _DIRECT_RULE_H_
 
 /* Genode includes */
+#include <base/allocator.h>
 #include <net/ipv4.h>
 #include <util/list.h>
 #include <util/xml_node.h>
@@ -66,35 +67,230 @@ struct Net::Direct_rule : Direct_rule_base,
 };
 
 
+/**
+ * List of direct rules with a compiled longest-prefix-match lookup table
+ *
+ * The list is kept sorted by descending prefix size, so the first matching
+ * rule is the longest-prefix match. As walking the list costs O(n) per
+ * packet, 'compile' translates the list into a sorted array of disjoint
+ * address intervals, each referring to the rule that the list walk would
+ * yield for all addresses of the interval. A lookup then boils down to a
+ * binary search in O(log n). The table must be re-compiled after the list
+ * was modified, until then, lookups fall back to the list walk.
+ */
 template <typename T>
-struct Net::Direct_rule_list : Genode::List<T>
+class Net::Direct_rule_list : public Genode::List<T>
 {
-	using List = Genode::List<T>;
+	private:
+
+		using List     = Genode::List<T>;
+		using uint32_t = Genode::uint32_t;
+		using uint64_t = Genode::uint64_t;
+
+		struct Interval
+		{
+			uint32_t  first;  /* first address of the interval */
+			T const  *rule;   /* matching rule or nullptr      */
+		};
+
+		/* prefix converted to an address range during compilation */
+		struct Range
+		{
+			uint64_t first;
+			uint64_t last;
+			unsigned prefix;
+			T const *rule;
+		};
+
+		/* temporary array of ranges, freed even if compilation fails */
+		struct Range_array
+		{
+			Genode::Allocator    &alloc;
+			Genode::size_t const  size;
+			Range         *const  ranges;
+
+			Range_array(Genode::Allocator &alloc, unsigned cnt)
+			:
+				alloc(alloc), size(cnt * sizeof(Range)),
+				ranges((Range *)alloc.alloc(size))
+			{ }
+
+			~Range_array() { alloc.free(ranges, size); }
+		};
+
+		enum { MAX_NESTING = 33 };
+
+		Genode::Allocator *_table_alloc = nullptr;
+		Interval          *_table       = nullptr;
+		unsigned           _table_cnt   = 0;
+		Genode::size_t     _table_size  = 0;
+
+		static uint32_t _to_uint32(Ipv4_address const &ip)
+		{
+			return ((uint32_t)ip.addr[0] << 24) | ((uint32_t)ip.addr[1] << 16) |
+			       ((uint32_t)ip.addr[2] <<  8) |  (uint32_t)ip.addr[3];
+		}
+
+		static Range _range(T const &rule)
+		{
+			unsigned const prefix = rule.dst().prefix < 32 ? rule.dst().prefix : 32;
+			uint64_t const size   = 1ULL << (32 - prefix);
+			uint64_t const first  = _to_uint32(rule.dst().address) & ~(size - 1);
+			return Range { first, first + size - 1, prefix, &rule };
+		}
+
+		void _free_table()
+		{
+			if (_table)
+				_table_alloc->free(_table, _table_size);
+
+			_table     = nullptr;
+			_table_cnt = 0;
+		}
+
+		/**
+		 * Append interval starting at 'first', merging equal neighbours
+		 */
+		void _append(uint64_t first, T const *rule)
+		{
+			if (_table_cnt && _table[_table_cnt - 1].rule == rule)
+				return;
+
+			if (_table_cnt && _table[_table_cnt - 1].first == first) {
+				_table[_table_cnt - 1].rule = rule;
+				return;
+			}
+			_table[_table_cnt++] = Interval { (uint32_t)first, rule };
+		}
+
+		T const &_linear_match(Ipv4_address const &ip) const
+		{
+			/* first match is sufficient as the list is prefix-size-sorted */
+			for (T const *curr = List::first(); curr; curr = curr->next()) {
+				if (curr->dst().prefix_matches(ip)) {
+					return *curr; }
+			}
+			throw No_match();
+		}
 
-	struct No_match : Genode::Exception { };
+	public:
+
+		struct No_match : Genode::Exception { };
+
+		~Direct_rule_list() { _free_table(); }
 
-	T const &longest_prefix_match(Ipv4_address const &ip) const
-	{
-		/* first match is sufficient as the list is prefix-size-sorted */
-		for (T const *curr = List::first(); curr; curr = curr->next()) {
-			if (curr->dst().prefix_matches(ip)) {
-				return *curr; }
+		T const &longest_prefix_match(Ipv4_address const &ip) const
+		{
+			if (!_table) {
+				return _linear_match(ip); }
+
+			/* find last interval that starts at or below the address */
+			uint32_t const addr = _to_uint32(ip);
+			unsigned lo = 0, hi = _table_cnt;
+			while (hi - lo > 1) {
+				unsigned const mid = (lo + hi) / 2;
+				if (_table[mid].first <= addr) { lo = mid; }
+				else                           { hi = mid; }
+			}
+			if (_table[lo].rule) {
+				return *_table[lo].rule; }
+
+			throw No_match();
 		}
-		throw No_match();
-	}
-
-	void insert(T &rule)
-	{
-		/* ensure that the list stays prefix-size-sorted (descending) */
-		T *behind = nullptr;
-		for (T *curr = List::first(); curr; curr = curr->next()) {
-			if (rule.dst().prefix >= curr->dst().prefix) {
-				break; }
-
-			behind = curr;
+
+		void insert(T &rule)
+		{
+			/* the compiled table becomes stale */
+			_free_table();
+
+			/* ensure that the list stays prefix-size-sorted (descending) */
+			T *behind = nullptr;
+			for (T *curr = List::first(); curr; curr = curr->next()) {
+				if (rule.dst().prefix >= curr->dst().prefix) {
+					break; }
+
+				behind = curr;
+			}
+			List::insert(&rule, behind);
+		}
+
+		/**
+		 * Translate the list into the interval table used for lookups
+		 */
+		void compile(Genode::Allocator &alloc)
+		{
+			_free_table();
+
+			unsigned cnt = 0;
+			for (T const *curr = List::first(); curr; curr = curr->next()) {
+				cnt++; }
+
+			if (!cnt) {
+				return; }
+
+			/*
+			 * Sort ranges by first address and, for equal first addresses,
+			 * by ascending prefix size, so enclosing ranges precede the
+			 * ranges they contain. Insertion sort is stable, which keeps
+			 * identical prefixes in list order.
+			 */
+			Range_array const range_array(alloc, cnt);
+			Range *ranges = range_array.ranges;
+			unsigned n = 0;
+			for (T const *curr = List::first(); curr; curr = curr->next()) {
+				Range const range = _range(*curr);
+				unsigned i = n++;
+				for (; i && (ranges[i - 1].first > range.first ||
+				            (ranges[i - 1].first == range.first &&
+				             ranges[i - 1].prefix > range.prefix)); i--) {
+					ranges[i] = ranges[i - 1]; }
+
+				ranges[i] = range;
+			}
+
+			/* each range adds at most two interval boundaries */
+			_table_alloc = &alloc;
+			_table_size  = (2 * cnt + 1) * sizeof(Interval);
+			_table       = (Interval *)alloc.alloc(_table_size);
+
+			/*
+			 * Sweep over the sorted ranges while maintaining the stack of
+			 * ranges that enclose the current address. As prefixes are
+			 * either nested or disjoint, the innermost range on the stack
+			 * is the longest-prefix match.
+			 */
+			Range const *stack[MAX_NESTING];
+			unsigned     depth = 0;
+			uint64_t     curr  = 0;
+
+			auto top_rule = [&] () -> T const * {
+				return depth ? stack[depth - 1]->rule : nullptr; };
+
+			auto close_ranges_below = [&] (uint64_t addr) {
+				while (depth && stack[depth - 1]->last < addr) {
+					curr = stack[--depth]->last + 1;
+					if (curr <= ~(uint32_t)0) {
+						_append(curr, top_rule()); }
+				}
+			};
+
+			_append(0, nullptr);
+			for (unsigned i = 0; i < cnt; i++) {
+
+				Range const &range = ranges[i];
+				close_ranges_below(range.first);
+
+				/* the first rule in the list wins for identical prefixes */
+				if (depth && stack[depth - 1]->first  == range.first
+				          && stack[depth - 1]->prefix == range.prefix) {
+					continue; }
+
+				stack[depth++] = &range;
+				curr = range.first;
+				_append(curr, range.rule);
+			}
+			close_ranges_below(~0ULL);
 		}
-		List::insert(&rule, behind);
-	}
 };
 
-#endif /* _RULE_H_ */
+#endif /* _DIRECT_RULE_H_ */
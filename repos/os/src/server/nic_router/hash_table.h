@@ -0,0 +1,228 @@
+/*
+ * \brief  Open-addressing hash table for connection tracking
+ * \author Genode Labs
+ * \date   2017-03-27
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _HASH_TABLE_H_
+#define _HASH_TABLE_H_
+
+/* Genode includes */
+#include <base/allocator.h>
+#include <util/xml_generator.h>
+
+namespace Net {
+
+	template <typename T, typename KEY> class Hash_table;
+
+	inline Genode::uint32_t hash_mix(Genode::uint32_t a,
+	                                 Genode::uint32_t b,
+	                                 Genode::uint32_t c);
+}
+
+
+/**
+ * Final mix of Bob Jenkins' lookup3 hash
+ *
+ * Every input bit affects every output bit of 'c', which makes the low
+ * bits of the result suitable as table index.
+ */
+Genode::uint32_t Net::hash_mix(Genode::uint32_t a,
+                               Genode::uint32_t b,
+                               Genode::uint32_t c)
+{
+	auto rot = [] (Genode::uint32_t x, unsigned k) {
+		return (x << k) | (x >> (32 - k)); };
+
+	c ^= b; c -= rot(b, 14);
+	a ^= c; a -= rot(c, 11);
+	b ^= a; b -= rot(a, 25);
+	c ^= b; c -= rot(b, 16);
+	a ^= c; a -= rot(c,  4);
+	b ^= a; b -= rot(a, 14);
+	c ^= b; c -= rot(b, 24);
+	return c;
+}
+
+
+/**
+ * Hash table of object pointers with linear probing
+ *
+ * Each slot caches the hash value of its object, so a probe dereferences
+ * an object only if the hash values match. Removal shifts the following
+ * slots of the probe sequence back instead of leaving tombstones, which
+ * keeps the probe sequences short even under heavy link churn. The table
+ * doubles its capacity whenever it becomes three-quarters full.
+ *
+ * 'T' must provide a method 'KEY const &key() const' and a static method
+ * 'Genode::uint32_t hash(KEY const &)'. 'KEY' must provide 'operator =='.
+ */
+template <typename T, typename KEY>
+class Net::Hash_table
+{
+	private:
+
+		struct Slot
+		{
+			Genode::uint32_t  hash;
+			T                *object;
+		};
+
+		enum { MIN_CAPACITY = 16 };
+
+		Genode::Allocator &_alloc;
+		Slot              *_slots      = nullptr;
+		Genode::size_t     _capacity   = 0;
+		Genode::size_t     _used       = 0;
+		Genode::size_t     _scan       = 0;
+		unsigned           _max_probe  = 0;
+
+		/* statistics of lookups, updated by const lookups too */
+		Genode::uint64_t mutable _lookups = 0;
+		Genode::uint64_t mutable _probes  = 0;
+
+		Genode::size_t _mask() const { return _capacity - 1; }
+
+		Genode::size_t _probe_length(Genode::size_t idx) const {
+			return (idx - _slots[idx].hash) & _mask(); }
+
+		void _place(Slot const &slot)
+		{
+			Genode::size_t idx = slot.hash & _mask();
+			for (; _slots[idx].object; idx = (idx + 1) & _mask()) { }
+
+			_slots[idx] = slot;
+			unsigned const probe = _probe_length(idx);
+			if (probe > _max_probe) {
+				_max_probe = probe; }
+		}
+
+		void _resize(Genode::size_t capacity)
+		{
+			Slot *const slots = (Slot *)_alloc.alloc(capacity * sizeof(Slot));
+			Slot          *const old_slots    = _slots;
+			Genode::size_t const old_capacity = _capacity;
+
+			for (Genode::size_t i = 0; i < capacity; i++) {
+				slots[i].object = nullptr; }
+
+			_slots     = slots;
+			_capacity  = capacity;
+			_max_probe = 0;
+			_scan      = 0;
+			for (Genode::size_t i = 0; i < old_capacity; i++) {
+				if (old_slots[i].object) {
+					_place(old_slots[i]); }
+			}
+			if (old_slots) {
+				_alloc.free(old_slots, old_capacity * sizeof(Slot)); }
+		}
+
+		void _remove_at(Genode::size_t hole)
+		{
+			_slots[hole].object = nullptr;
+			_used--;
+
+			/* move back followers that may not stay behind the hole */
+			for (Genode::size_t idx = (hole + 1) & _mask();
+			     _slots[idx].object; idx = (idx + 1) & _mask())
+			{
+				if (_probe_length(idx) < ((idx - hole) & _mask())) {
+					continue; }
+
+				_slots[hole] = _slots[idx];
+				_slots[idx].object = nullptr;
+				hole = idx;
+			}
+		}
+
+	public:
+
+		Hash_table(Genode::Allocator &alloc,
+		           Genode::size_t     capacity = MIN_CAPACITY)
+		:
+			_alloc(alloc)
+		{
+			Genode::size_t pow2 = MIN_CAPACITY;
+			for (; pow2 < capacity; pow2 <<= 1) { }
+			_resize(pow2);
+		}
+
+		~Hash_table() { _alloc.free(_slots, _capacity * sizeof(Slot)); }
+
+		void insert(T &object)
+		{
+			if ((_used + 1) * 4 > _capacity * 3) {
+				_resize(_capacity * 2); }
+
+			_place(Slot { T::hash(object.key()), &object });
+			_used++;
+		}
+
+		void remove(T &object)
+		{
+			Genode::size_t idx = T::hash(object.key()) & _mask();
+			for (; _slots[idx].object; idx = (idx + 1) & _mask()) {
+				if (_slots[idx].object == &object) {
+					_remove_at(idx);
+					return;
+				}
+			}
+		}
+
+		/**
+		 * Return object with matching key or 'nullptr'
+		 */
+		T *find(KEY const &key) const
+		{
+			Genode::uint32_t const hash = T::hash(key);
+
+			_lookups++;
+			for (Genode::size_t idx = hash & _mask();
+			     _slots[idx].object; idx = (idx + 1) & _mask())
+			{
+				_probes++;
+				Slot const &slot = _slots[idx];
+				if (slot.hash == hash && slot.object->key() == key) {
+					return slot.object; }
+			}
+			return nullptr;
+		}
+
+		/**
+		 * Return any object of the table or 'nullptr' if it is empty
+		 *
+		 * The scan continues where the previous call stopped, so removing
+		 * all objects one by one via this method does not rescan the
+		 * already emptied part of the table.
+		 */
+		T *first()
+		{
+			for (Genode::size_t i = 0; i < _capacity; i++) {
+				Genode::size_t const idx = (_scan + i) & _mask();
+				if (_slots[idx].object) {
+					_scan = idx;
+					return _slots[idx].object;
+				}
+			}
+			return nullptr;
+		}
+
+		void report(Genode::Xml_generator &xml) const
+		{
+			xml.attribute("used",      (unsigned long)_used);
+			xml.attribute("capacity",  (unsigned long)_capacity);
+			xml.attribute("max_probe", _max_probe);
+			xml.attribute("lookups",   (unsigned long long)_lookups);
+			xml.attribute("probes",    (unsigned long long)_probes);
+		}
+};
+
+#endif /* _HASH_TABLE_H_ */
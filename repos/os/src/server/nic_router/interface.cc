@@ -29,31 +29,6 @@ using namespace Genode;
  ** Utilities **
  ***************/
 
-template <typename LINK_TYPE>
-static void _destroy_closed_links(Link_list   &closed_links,
-                                  Deallocator &dealloc)
-{
-	while (Link *link = closed_links.first()) {
-		closed_links.remove(link);
-		destroy(dealloc, static_cast<LINK_TYPE *>(link));
-	}
-}
-
-
-template <typename LINK_TYPE>
-static void _destroy_links(Link_side_tree &links,
-                           Link_list      &closed_links,
-                           Deallocator    &dealloc)
-{
-	_destroy_closed_links<LINK_TYPE>(closed_links, dealloc);
-	while (Link_side *link_side = links.first()) {
-		Link &link = link_side->link();
-		link.dissolve();
-		destroy(dealloc, static_cast<LINK_TYPE *>(&link));
-	}
-}
-
-
 static void _link_packet(uint8_t  const  prot,
                          void    *const  prot_base,
                          Link           &link,
@@ -75,23 +50,6 @@ static void _link_packet(uint8_t  const  prot,
 }
 
 
-static void _update_checksum(uint8_t       const prot,
-                             void         *const prot_base,
-                             size_t        const prot_size,
-                             Ipv4_address  const src,
-                             Ipv4_address  const dst)
-{
-	switch (prot) {
-	case Tcp_packet::IP_ID:
-		((Tcp_packet *)prot_base)->update_checksum(src, dst, prot_size);
-		return;
-	case Udp_packet::IP_ID:
-		((Udp_packet *)prot_base)->update_checksum(src, dst);
-		return;
-	default: throw Interface::Bad_transport_protocol(); }
-}
-
-
 static Port _dst_port(uint8_t const prot, void *const prot_base)
 {
 	switch (prot) {
@@ -132,6 +90,50 @@ static void _src_port(uint8_t  const prot,
 }
 
 
+/**
+ * Adapt checksums incrementally to the rewrite of addresses and ports
+ *
+ * \param old_id  addresses and ports of the packet before the rewrite
+ */
+template <typename PROT_PACKET>
+static void _adapt_checksums(Ipv4_packet        &ip,
+                             PROT_PACKET        &prot,
+                             Link_side_id const &old_id)
+{
+	Ipv4_address const src_ip = ip.src();
+	Ipv4_address const dst_ip = ip.dst();
+	if (src_ip != old_id.src_ip) {
+		ip.adapt_checksum(old_id.src_ip, src_ip);
+		prot.adapt_checksum(old_id.src_ip, src_ip);
+	}
+	if (dst_ip != old_id.dst_ip) {
+		ip.adapt_checksum(old_id.dst_ip, dst_ip);
+		prot.adapt_checksum(old_id.dst_ip, dst_ip);
+	}
+	if (!(prot.src_port() == old_id.src_port)) {
+		prot.adapt_checksum(old_id.src_port, prot.src_port()); }
+
+	if (!(prot.dst_port() == old_id.dst_port)) {
+		prot.adapt_checksum(old_id.dst_port, prot.dst_port()); }
+}
+
+
+static void _adapt_checksums(Ipv4_packet        &ip,
+                             uint8_t      const  prot,
+                             void        *const  prot_base,
+                             Link_side_id const &old_id)
+{
+	switch (prot) {
+	case Tcp_packet::IP_ID:
+		_adapt_checksums(ip, *(Tcp_packet *)prot_base, old_id);
+		return;
+	case Udp_packet::IP_ID:
+		_adapt_checksums(ip, *(Udp_packet *)prot_base, old_id);
+		return;
+	default: throw Interface::Bad_transport_protocol(); }
+}
+
+
 static void *_prot_base(uint8_t const  prot,
                         size_t  const  prot_size,
                         Ipv4_packet   &ip)
@@ -147,15 +149,14 @@ static void *_prot_base(uint8_t const  prot,
  ** Interface **
  ***************/
 
-void Interface::_pass_ip(Ethernet_frame &eth,
-                         size_t   const  eth_size,
-                         Ipv4_packet    &ip,
-                         uint8_t  const  prot,
-                         void    *const  prot_base,
-                         size_t   const  prot_size)
+void Interface::_pass_ip(Ethernet_frame     &eth,
+                         size_t       const  eth_size,
+                         Ipv4_packet        &ip,
+                         uint8_t      const  prot,
+                         void        *const  prot_base,
+                         Link_side_id const &old_id)
 {
-	_update_checksum(prot, prot_base, prot_size, ip.src(), ip.dst());
-	ip.checksum(Ipv4_packet::calculate_checksum(ip));
+	_adapt_checksums(ip, prot, prot_base, old_id);
 	_send(eth, eth_size);
 }
 
@@ -188,11 +189,11 @@ Interface::_new_link(uint8_t                       const  protocol,
 	switch (protocol) {
 	case Tcp_packet::IP_ID:
 		{
-			Tcp_link &link = *new (_alloc)
+			Tcp_link &link = *new (_tcp_link_slab)
 				Tcp_link(*this, local, remote_port_alloc, remote_interface,
-				         remote, _timer, _config(), protocol);
-			_tcp_links.insert(&link.client());
-			remote_interface._tcp_links.insert(&link.server());
+				         remote, _link_wheel, _config(), protocol);
+			_tcp_links.insert(link.client());
+			remote_interface._tcp_links.insert(link.server());
 			if (_config().verbose()) {
 				log("New TCP client link: ", link.client(), " at ", *this);
 				log("New TCP server link: ", link.server(),
@@ -202,11 +203,11 @@ Interface::_new_link(uint8_t                       const  protocol,
 		}
 	case Udp_packet::IP_ID:
 		{
-			Udp_link &link = *new (_alloc)
+			Udp_link &link = *new (_udp_link_slab)
 				Udp_link(*this, local, remote_port_alloc, remote_interface,
-				         remote, _timer, _config(), protocol);
-			_udp_links.insert(&link.client());
-			remote_interface._udp_links.insert(&link.server());
+				         remote, _link_wheel, _config(), protocol);
+			_udp_links.insert(link.client());
+			remote_interface._udp_links.insert(link.server());
 			if (_config().verbose()) {
 				log("New UDP client link: ", link.client(), " at ", *this);
 				log("New UDP server link: ", link.server(),
@@ -218,7 +219,7 @@ Interface::_new_link(uint8_t                       const  protocol,
 }
 
 
-Link_side_tree &Interface::_links(uint8_t const protocol)
+Link_side_table &Interface::_links(uint8_t const protocol)
 {
 	switch (protocol) {
 	case Tcp_packet::IP_ID: return _tcp_links;
@@ -235,7 +236,43 @@ void Interface::link_closed(Link &link, uint8_t const prot)
 
 void Interface::dissolve_link(Link_side &link_side, uint8_t const prot)
 {
-	_links(prot).remove(&link_side);
+	_links(prot).remove(link_side);
+}
+
+
+void Interface::_destroy_link(Link &link)
+{
+	/* a link is allocated from the slabs of its client interface */
+	Interface &interface = link.client().interface();
+	switch (link.protocol()) {
+	case Tcp_packet::IP_ID:
+		destroy(interface._tcp_link_slab, static_cast<Tcp_link *>(&link));
+		return;
+	case Udp_packet::IP_ID:
+		destroy(interface._udp_link_slab, static_cast<Udp_link *>(&link));
+		return;
+	default: throw Bad_transport_protocol(); }
+}
+
+
+void Interface::_destroy_closed_links(Link_list &closed_links)
+{
+	while (Link *link = closed_links.first()) {
+		closed_links.remove(link);
+		_destroy_link(*link);
+	}
+}
+
+
+void Interface::_destroy_links(Link_side_table &links,
+                               Link_list       &closed_links)
+{
+	_destroy_closed_links(closed_links);
+	while (Link_side *link_side = links.first()) {
+		Link &link = link_side->link();
+		link.dissolve();
+		_destroy_link(link);
+	}
 }
 
 
@@ -270,7 +307,6 @@ void Interface::_nat_link_and_pass(Ethernet_frame      &eth,
                                    Ipv4_packet         &ip,
                                    uint8_t       const  prot,
                                    void         *const  prot_base,
-                                   size_t        const  prot_size,
                                    Link_side_id  const &local,
                                    Interface           &interface)
 {
@@ -288,7 +324,7 @@ void Interface::_nat_link_and_pass(Ethernet_frame      &eth,
 	Link_side_id const remote = { ip.dst(), _dst_port(prot, prot_base),
 	                              ip.src(), _src_port(prot, prot_base) };
 	_new_link(prot, local, remote_port_alloc, interface, remote);
-	interface._pass_ip(eth, eth_size, ip, prot, prot_base, prot_size);
+	interface._pass_ip(eth, eth_size, ip, prot, prot_base, local);
 }
 
 
@@ -296,8 +332,8 @@ void Interface::_handle_ip(Ethernet_frame          &eth,
                            Genode::size_t    const  eth_size,
                            Packet_descriptor const &pkt)
 {
-	_destroy_closed_links<Udp_link>(_closed_udp_links, _alloc);
-	_destroy_closed_links<Tcp_link>(_closed_tcp_links, _alloc);
+	_destroy_closed_links(_closed_udp_links);
+	_destroy_closed_links(_closed_tcp_links);
 
 	/* read packet information */
 	Ipv4_packet &ip = *new (eth.data<void>())
@@ -325,11 +361,11 @@ void Interface::_handle_ip(Ethernet_frame          &eth,
 		_src_port(prot, prot_base, remote_side.dst_port());
 		_dst_port(prot, prot_base, remote_side.src_port());
 
-		interface._pass_ip(eth, eth_size, ip, prot, prot_base, prot_size);
+		interface._pass_ip(eth, eth_size, ip, prot, prot_base, local);
 		_link_packet(prot, prot_base, link, client);
 		return;
 	}
-	catch (Link_side_tree::No_match) { }
+	catch (Link_side_table::No_match) { }
 
 	/* try to route via forward rules */
 	if (local.dst_ip == _router_ip()) {
@@ -343,8 +379,8 @@ void Interface::_handle_ip(Ethernet_frame          &eth,
 
 			_adapt_eth(eth, eth_size, rule.to(), pkt, interface);
 			ip.dst(rule.to());
-			_nat_link_and_pass(eth, eth_size, ip, prot, prot_base, prot_size,
-			                   local, interface);
+			_nat_link_and_pass(eth, eth_size, ip, prot, prot_base, local,
+			                   interface);
 			return;
 		}
 		catch (Forward_rule_tree::No_match) { }
@@ -363,8 +399,8 @@ void Interface::_handle_ip(Ethernet_frame          &eth,
 			    " ", permit_rule); }
 
 		_adapt_eth(eth, eth_size, local.dst_ip, pkt, interface);
-		_nat_link_and_pass(eth, eth_size, ip, prot, prot_base, prot_size,
-		                   local, interface);
+		_nat_link_and_pass(eth, eth_size, ip, prot, prot_base, local,
+		                   interface);
 		return;
 	}
 	catch (Transport_rule_list::No_match) { }
@@ -380,7 +416,7 @@ void Interface::_handle_ip(Ethernet_frame          &eth,
 			log("Using IP rule: ", rule); }
 
 		_adapt_eth(eth, eth_size, local.dst_ip, pkt, interface);
-		interface._pass_ip(eth, eth_size, ip, prot, prot_base, prot_size);
+		interface._pass_ip(eth, eth_size, ip, prot, prot_base, local);
 		return;
 	}
 	catch (Ip_rule_list::No_match) { }
@@ -580,8 +616,9 @@ Interface::Interface(Entrypoint        &ep,
 	_sink_submit(ep, *this, &Interface::_ready_to_submit),
 	_source_ack(ep, *this, &Interface::_ready_to_ack),
 	_source_submit(ep, *this, &Interface::_packet_avail),
-	_router_mac(router_mac), _mac(mac), _timer(timer), _alloc(alloc),
-	_domain(domain)
+	_router_mac(router_mac), _mac(mac), _alloc(alloc), _domain(domain),
+	_arp_cache(alloc), _tcp_links(alloc), _udp_links(alloc),
+	_link_wheel(timer), _tcp_link_slab(&alloc), _udp_link_slab(&alloc)
 {
 	if (_config().verbose()) {
 		log("Interface connected ", *this);
@@ -626,14 +663,22 @@ Interface::~Interface()
 		waiter.src()._cancel_arp_waiting(waiter); }
 
 	/* destroy links */
-	_destroy_links<Tcp_link>(_tcp_links, _closed_tcp_links, _alloc);
-	_destroy_links<Udp_link>(_udp_links, _closed_udp_links, _alloc);
+	_destroy_links(_tcp_links, _closed_tcp_links);
+	_destroy_links(_udp_links, _closed_udp_links);
 }
 
 
 Configuration &Interface::_config() const { return _domain.config(); }
 
 
+void Interface::report(Xml_generator &xml) const
+{
+	xml.node("tcp_links", [&] () { _tcp_links.report(xml); });
+	xml.node("udp_links", [&] () { _udp_links.report(xml); });
+	xml.node("arp_cache", [&] () { _arp_cache.report(xml); });
+}
+
+
 void Interface::print(Output &output) const
 {
 	Genode::print(output, "\"", _domain.name(), "\"");
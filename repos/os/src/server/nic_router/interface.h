@@ -21,6 +21,7 @@
 
 /* Genode includes */
 #include <nic_session/nic_session.h>
+#include <base/tslab.h>
 
 namespace Net {
 
@@ -52,16 +53,23 @@ class Net::Interface
 
 	private:
 
-		Genode::Timer      &_timer;
+		enum { LINK_SLAB_BLOCK_SIZE = 4096 };
+
+		template <typename LINK>
+		using Link_slab = Genode::Tslab<LINK, LINK_SLAB_BLOCK_SIZE>;
+
 		Genode::Allocator  &_alloc;
 		Domain             &_domain;
 		Arp_cache           _arp_cache;
 		Arp_waiter_list     _own_arp_waiters;
 		Arp_waiter_list     _foreign_arp_waiters;
-		Link_side_tree      _tcp_links;
-		Link_side_tree      _udp_links;
+		Link_side_table     _tcp_links;
+		Link_side_table     _udp_links;
 		Link_list           _closed_tcp_links;
 		Link_list           _closed_udp_links;
+		Link_timer_wheel    _link_wheel;
+		Link_slab<Tcp_link> _tcp_link_slab;
+		Link_slab<Udp_link> _udp_link_slab;
 
 		void _new_link(Genode::uint8_t               const  protocol,
 		               Link_side_id                  const &local_id,
@@ -96,7 +104,6 @@ class Net::Interface
 		                        Ipv4_packet            &ip,
 		                        Genode::uint8_t  const  prot,
 		                        void            *const  prot_base,
-		                        Genode::size_t   const  prot_size,
 		                        Link_side_id     const &local_id,
 		                        Interface              &interface);
 
@@ -109,13 +116,19 @@ class Net::Interface
 		              Ipv4_packet            &ip,
 		              Genode::uint8_t  const  prot,
 		              void            *const  prot_base,
-		              Genode::size_t   const  prot_size);
+		              Link_side_id     const &old_id);
 
 		void _continue_handle_eth(Packet_descriptor const &pkt);
 
 		Link_list &_closed_links(Genode::uint8_t const protocol);
 
-		Link_side_tree &_links(Genode::uint8_t const protocol);
+		Link_side_table &_links(Genode::uint8_t const protocol);
+
+		void _destroy_link(Link &link);
+
+		void _destroy_closed_links(Link_list &closed_links);
+
+		void _destroy_links(Link_side_table &links, Link_list &closed_links);
 
 		Configuration &_config() const;
 
@@ -163,6 +176,12 @@ class Net::Interface
 		void dissolve_link(Link_side &link_side, Genode::uint8_t const prot);
 
 
+		/**
+		 * Report statistics of the link tables and the ARP cache
+		 */
+		void report(Genode::Xml_generator &xml) const;
+
+
 		/*********
 		 ** log **
 		 *********/
@@ -41,9 +41,13 @@ bool Link_side_id::operator == (Link_side_id const &id) const
 }
 
 
-bool Link_side_id::operator > (Link_side_id const &id) const
+uint32_t Link_side_id::hash() const
 {
-	return memcmp(id.data, data, data_size()) > 0;
+	struct Words { uint32_t value[3]; } __attribute__((packed));
+	static_assert(sizeof(Words) == data_size(), "unexpected ID size");
+
+	Words const &words = *(Words const *)data;
+	return hash_mix(words.value[0], words.value[1], words.value[2]);
 }
 
 
@@ -59,20 +63,6 @@ Link_side::Link_side(Interface          &interface,
 { }
 
 
-Link_side const &Link_side::find_by_id(Link_side_id const &id) const
-{
-	if (id == _id) {
-		return *this; }
-
-	bool const side = id > _id;
-	Link_side *const link_side = Avl_node<Link_side>::child(side);
-	if (!link_side) {
-		throw Link_side_tree::No_match(); }
-
-	return link_side->find_by_id(id);
-}
-
-
 void Link_side::print(Output &output) const
 {
 	Genode::print(output, "src ", src_ip(), ":", src_port(),
@@ -86,17 +76,108 @@ bool Link_side::is_client() const
 }
 
 
-/********************
- ** Link_side_tree **
- ********************/
+/*********************
+ ** Link_side_table **
+ *********************/
 
-Link_side const &Link_side_tree::find_by_id(Link_side_id const &id) const
+Link_side const &Link_side_table::find_by_id(Link_side_id const &id) const
 {
-	Link_side *const link_side = first();
+	Link_side const *const link_side = find(id);
 	if (!link_side) {
 		throw No_match(); }
 
-	return link_side->find_by_id(id);
+	return *link_side;
+}
+
+
+/**********************
+ ** Link_timer_wheel **
+ **********************/
+
+Link_timer_wheel::Link_timer_wheel(Genode::Timer &timer)
+:
+	_tick_timeout(timer, *this, &Link_timer_wheel::_handle_tick)
+{ }
+
+
+void Link_timer_wheel::_insert(Link &link, unsigned slot)
+{
+	Link *&head = _slots[slot];
+
+	link._wheel_slot = slot;
+	link._wheel_prev = nullptr;
+	link._wheel_next = head;
+	link._scheduled  = true;
+
+	if (head) {
+		head->_wheel_prev = &link; }
+
+	head = &link;
+	_link_cnt++;
+}
+
+
+void Link_timer_wheel::_arm_tick()
+{
+	if (_ticking || !_link_cnt) {
+		return; }
+
+	_ticking = true;
+	_tick_timeout.start(Genode::Timer::Microseconds(TICK_MS * 1000));
+}
+
+
+void Link_timer_wheel::schedule(Link &link)
+{
+	unsigned long const tick = link._deadline > _now ? link._deadline
+	                                                 : _now + 1;
+	_insert(link, tick % NR_OF_SLOTS);
+	_arm_tick();
+}
+
+
+void Link_timer_wheel::cancel(Link &link)
+{
+	if (link._wheel_prev) {
+		link._wheel_prev->_wheel_next = link._wheel_next; }
+	else {
+		_slots[link._wheel_slot] = link._wheel_next; }
+
+	if (link._wheel_next) {
+		link._wheel_next->_wheel_prev = link._wheel_prev; }
+
+	link._wheel_prev = nullptr;
+	link._wheel_next = nullptr;
+	link._scheduled  = false;
+	_link_cnt--;
+}
+
+
+void Link_timer_wheel::_handle_tick(Genode::Timer::Microseconds)
+{
+	_ticking = false;
+	_now++;
+
+	/*
+	 * Move the slot to the due slot first as links may get re-inserted
+	 * into the slot. Links that are cancelled meanwhile leave the due
+	 * slot like any other slot.
+	 */
+	Link *&slot = _slots[_now % NR_OF_SLOTS];
+	for (Link *link = slot; link; link = link->_wheel_next) {
+		link->_wheel_slot = DUE_SLOT; }
+
+	_slots[DUE_SLOT] = slot;
+	slot             = nullptr;
+
+	while (Link *link = _slots[DUE_SLOT]) {
+		cancel(*link);
+		if (link->_deadline > _now) {
+			schedule(*link);
+		} else {
+			link->_close_timeout(); }
+	}
+	_arm_tick();
 }
 
 
@@ -115,7 +196,7 @@ Link::Link(Interface                           &cln_interface,
            Pointer<Port_allocator_guard> const  srv_port_alloc,
            Interface                           &srv_interface,
            Link_side_id                  const &srv_id,
-           Genode::Timer                       &timer,
+           Link_timer_wheel                    &wheel,
            Configuration                       &config,
            uint8_t                       const  protocol)
 :
@@ -123,15 +204,24 @@ Link::Link(Interface                           &cln_interface,
 	_client(cln_interface, cln_id, *this),
 	_server_port_alloc(srv_port_alloc),
 	_server(srv_interface, srv_id, *this),
-	_close_timeout(timer, *this, &Link::_handle_close_timeout),
-	_close_timeout_us(_config.rtt_sec() * 2 * 1000 * 1000),
+	_wheel(wheel),
+	_close_timeout_ticks(
+		Link_timer_wheel::ticks(_config.rtt_sec() * 2 * 1000 * 1000)),
+	_deadline(_wheel.now() + _close_timeout_ticks),
 	_protocol(protocol)
 {
-	_close_timeout.start(_close_timeout_us);
+	_wheel.schedule(*this);
+}
+
+
+Link::~Link()
+{
+	if (_scheduled) {
+		_wheel.cancel(*this); }
 }
 
 
-void Link::_handle_close_timeout(Genode::Timer::Microseconds)
+void Link::_close_timeout()
 {
 	dissolve();
 	_client._interface.link_closed(*this, _protocol);
@@ -167,11 +257,11 @@ Tcp_link::Tcp_link(Interface                           &cln_interface,
                    Pointer<Port_allocator_guard> const  srv_port_alloc,
                    Interface                           &srv_interface,
                    Link_side_id                  const &srv_id,
-                   Genode::Timer                       &timer,
+                   Link_timer_wheel                    &wheel,
                    Configuration                       &config,
                    uint8_t                       const  protocol)
 :
-	Link(cln_interface, cln_id, srv_port_alloc, srv_interface, srv_id, timer,
+	Link(cln_interface, cln_id, srv_port_alloc, srv_interface, srv_id, wheel,
 	     config, protocol)
 { }
 
@@ -179,7 +269,7 @@ Tcp_link::Tcp_link(Interface                           &cln_interface,
 void Tcp_link::_fin_acked()
 {
 	if (_server_fin_acked && _client_fin_acked) {
-		_close_timeout.start(_close_timeout_us);
+		_restart_close_timeout();
 		_closed = true;
 	}
 }
@@ -228,10 +318,10 @@ Udp_link::Udp_link(Interface                           &cln_interface,
                    Pointer<Port_allocator_guard> const  srv_port_alloc,
                    Interface                           &srv_interface,
                    Link_side_id                  const &srv_id,
-                   Genode::Timer                       &timer,
+                   Link_timer_wheel                    &wheel,
                    Configuration                       &config,
                    uint8_t                       const  protocol)
 :
-	Link(cln_interface, cln_id, srv_port_alloc, srv_interface, srv_id, timer,
+	Link(cln_interface, cln_id, srv_port_alloc, srv_interface, srv_id, wheel,
 	     config, protocol)
 { }
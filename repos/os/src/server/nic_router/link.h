@@ -16,13 +16,13 @@
 
 /* Genode includes */
 #include <os/timer.h>
-#include <util/avl_tree.h>
 #include <util/list.h>
 #include <net/ipv4.h>
 #include <net/port.h>
 
 /* local includes */
 #include <pointer.h>
+#include <hash_table.h>
 
 namespace Net {
 
@@ -32,9 +32,10 @@ namespace Net {
 	class  Interface;
 	class  Link_side_id;
 	class  Link_side;
-	class  Link_side_tree;
+	class  Link_side_table;
 	class  Link;
 	struct Link_list : Genode::List<Link> { };
+	class  Link_timer_wheel;
 	class  Tcp_link;
 	class  Udp_link;
 }
@@ -50,19 +51,19 @@ struct Net::Link_side_id
 
 	static constexpr Genode::size_t data_size();
 
+	Genode::uint32_t hash() const;
+
 
 	/************************
 	 ** Standard operators **
 	 ************************/
 
 	bool operator == (Link_side_id const &id) const;
-
-	bool operator > (Link_side_id const &id) const;
 }
 __attribute__((__packed__));
 
 
-class Net::Link_side : public Genode::Avl_node<Link_side>
+class Net::Link_side
 {
 	friend class Link;
 
@@ -78,16 +79,17 @@ class Net::Link_side : public Genode::Avl_node<Link_side>
 		          Link_side_id const &id,
 		          Link               &link);
 
-		Link_side const &find_by_id(Link_side_id const &id) const;
-
 		bool is_client() const;
 
 
-		/**************
-		 ** Avl_node **
-		 **************/
+		/****************
+		 ** Hash_table **
+		 ****************/
+
+		Link_side_id const &key() const { return _id; }
 
-		bool higher(Link_side *side) { return side->_id > _id; }
+		static Genode::uint32_t hash(Link_side_id const &id) {
+			return id.hash(); }
 
 
 		/*********
@@ -110,16 +112,69 @@ class Net::Link_side : public Genode::Avl_node<Link_side>
 };
 
 
-struct Net::Link_side_tree : Genode::Avl_tree<Link_side>
+struct Net::Link_side_table : Hash_table<Link_side, Link_side_id>
 {
 	struct No_match : Genode::Exception { };
 
+	Link_side_table(Genode::Allocator &alloc) : Hash_table(alloc) { }
+
 	Link_side const &find_by_id(Link_side_id const &id) const;
 };
 
 
+/**
+ * Coarse-grained timeouts for all links of an interface
+ *
+ * Instead of one timeout per link, links are kept in the slots of a wheel
+ * that advances by one slot per tick. A packet merely moves the deadline
+ * of its link forward. Only when the wheel reaches the slot of a link, the
+ * link is either expired or re-inserted at the slot of its new deadline.
+ * Each slot is a doubly linked list, so cancelling a link is O(1). The
+ * wheel ticks only while it holds links.
+ */
+class Net::Link_timer_wheel
+{
+	private:
+
+		enum { NR_OF_SLOTS = 256, TICK_MS = 250 };
+
+		/* the extra slot holds the links that are due at the current tick */
+		enum { DUE_SLOT = NR_OF_SLOTS };
+
+		Genode::One_shot_timeout<Link_timer_wheel> _tick_timeout;
+		Link                                      *_slots[NR_OF_SLOTS + 1] { };
+		unsigned long                              _link_cnt = 0;
+		unsigned long                              _now      = 0;
+		bool                                       _ticking  = false;
+
+		void _insert(Link &link, unsigned slot);
+
+		void _arm_tick();
+
+		void _handle_tick(Genode::Timer::Microseconds);
+
+	public:
+
+		Link_timer_wheel(Genode::Timer &timer);
+
+		void schedule(Link &link);
+
+		void cancel(Link &link);
+
+		/**
+		 * Return number of ticks that covers a duration in microseconds
+		 */
+		static unsigned long ticks(unsigned long us) {
+			return (us + TICK_MS * 1000 - 1) / (TICK_MS * 1000); }
+
+		unsigned long now() const { return _now; }
+};
+
+
 class Net::Link : public Link_list::Element
 {
+	friend class Link_timer_wheel;
+
 	protected:
 
 		using Signal_handler = Genode::Signal_handler<Link>;
@@ -128,13 +183,21 @@ class Net::Link : public Link_list::Element
 		Link_side                            _client;
 		Pointer<Port_allocator_guard> const  _server_port_alloc;
 		Link_side                            _server;
-		Genode::One_shot_timeout<Link>       _close_timeout;
-		Genode::Timer::Microseconds   const  _close_timeout_us;
+		Link_timer_wheel                    &_wheel;
+		unsigned long                 const  _close_timeout_ticks;
+		unsigned long                        _deadline;
+		unsigned                             _wheel_slot = 0;
+		Link                                *_wheel_prev = nullptr;
+		Link                                *_wheel_next = nullptr;
+		bool                                 _scheduled  = false;
 		Genode::uint8_t               const  _protocol;
 
-		void _handle_close_timeout(Genode::Timer::Microseconds);
+		void _close_timeout();
+
+		void _restart_close_timeout() {
+			_deadline = _wheel.now() + _close_timeout_ticks; }
 
-		void _packet() { _close_timeout.start(_close_timeout_us); }
+		void _packet() { _restart_close_timeout(); }
 
 	public:
 
@@ -145,10 +208,12 @@ class Net::Link : public Link_list::Element
 		     Pointer<Port_allocator_guard> const  srv_port_alloc,
 		     Interface                           &srv_interface,
 		     Link_side_id                  const &srv_id,
-		     Genode::Timer                       &timer,
+		     Link_timer_wheel                    &wheel,
 		     Configuration                       &config,
 		     Genode::uint8_t               const  protocol);
 
+		~Link();
+
 		void dissolve();
 
 
@@ -163,8 +228,9 @@ class Net::Link : public Link_list::Element
 		 ** Accessors **
 		 ***************/
 
-		Link_side &client() { return _client; }
-		Link_side &server() { return _server; }
+		Link_side       &client()         { return _client; }
+		Link_side       &server()         { return _server; }
+		Genode::uint8_t  protocol() const { return _protocol; }
 };
 
 
@@ -187,7 +253,7 @@ class Net::Tcp_link : public Link
 		         Pointer<Port_allocator_guard> const  srv_port_alloc,
 		         Interface                           &srv_interface,
 		         Link_side_id                  const &srv_id,
-		         Genode::Timer                       &timer,
+		         Link_timer_wheel                    &wheel,
 		         Configuration                       &config,
 		         Genode::uint8_t               const  protocol);
 
@@ -204,7 +270,7 @@ struct Net::Udp_link : Link
 	         Pointer<Port_allocator_guard> const  srv_port_alloc,
 	         Interface                           &srv_interface,
 	         Link_side_id                  const &srv_id,
-	         Genode::Timer                       &timer,
+	         Link_timer_wheel                    &wheel,
 	         Configuration                       &config,
 	         Genode::uint8_t               const  protocol);
 
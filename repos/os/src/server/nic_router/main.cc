@@ -23,6 +23,7 @@
 #include <component.h>
 #include <uplink.h>
 #include <configuration.h>
+#include <statistics_report.h>
 
 using namespace Net;
 using namespace Genode;
@@ -39,6 +40,8 @@ class Main
 		Uplink            _uplink;
 		Net::Root         _root;
 
+		Genode::Constructible<Statistics_report> _report;
+
 	public:
 
 		Main(Env &env);
@@ -53,6 +56,12 @@ Main::Main(Env &env)
 	_root(env.ep(), _timer, _heap, _uplink.router_mac(), _config, env.ram(),
 	      env.rm())
 {
+	try {
+		_report.construct(env, _timer, _config,
+		                  _config.node().sub_node("report"));
+	}
+	catch (Xml_node::Nonexistent_sub_node) { }
+
 	env.parent().announce(env.ep().manage(_root));
 }
 
@@ -0,0 +1,61 @@
+/*
+ * \brief  Periodic report of the link-tracking statistics
+ * \author Genode Labs
+ * \date   2017-03-27
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* local includes */
+#include <statistics_report.h>
+#include <interface.h>
+#include <configuration.h>
+
+using namespace Net;
+using namespace Genode;
+
+
+static Genode::Timer::Microseconds read_interval(Xml_node const node)
+{
+	unsigned long const sec = node.attribute_value("interval_sec", 5UL);
+	return Genode::Timer::Microseconds((sec ? sec : 1) * 1000 * 1000);
+}
+
+
+Statistics_report::Statistics_report(Env           &env,
+                                     Genode::Timer &timer,
+                                     Configuration &config,
+                                     Xml_node const node)
+:
+	_config(config),
+	_reporter(env, "statistics", nullptr, 16 * 1024),
+	_timeout(timer, *this, &Statistics_report::_handle_timeout, read_interval(node))
+{
+	_reporter.enabled(true);
+}
+
+
+void Statistics_report::_handle_timeout(Genode::Timer::Microseconds)
+{
+	try {
+		Reporter::Xml_generator xml(_reporter, [&] () {
+			_config.domains().for_each([&] (Domain &domain) {
+				try {
+					Interface const &interface = domain.interface().deref();
+					xml.node("domain", [&] () {
+						xml.attribute("name", domain.name());
+						interface.report(xml);
+					});
+				}
+				catch (Pointer<Interface>::Invalid) { }
+			});
+		});
+	}
+	catch (Xml_generator::Buffer_exceeded) {
+		warning("statistics report exceeds buffer"); }
+}
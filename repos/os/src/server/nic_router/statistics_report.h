@@ -0,0 +1,47 @@
+/*
+ * \brief  Periodic report of the link-tracking statistics
+ * \author Genode Labs
+ * \date   2017-03-27
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _STATISTICS_REPORT_H_
+#define _STATISTICS_REPORT_H_
+
+/* Genode includes */
+#include <os/reporter.h>
+#include <os/timer.h>
+#include <util/xml_node.h>
+
+namespace Net {
+
+	class Configuration;
+	class Statistics_report;
+}
+
+
+class Net::Statistics_report
+{
+	private:
+
+		Configuration                               &_config;
+		Genode::Reporter                             _reporter;
+		Genode::Periodic_timeout<Statistics_report>  _timeout;
+
+		void _handle_timeout(Genode::Timer::Microseconds);
+
+	public:
+
+		Statistics_report(Genode::Env            &env,
+		                  Genode::Timer          &timer,
+		                  Configuration          &config,
+		                  Genode::Xml_node const  node);
+};
+
+#endif /* _STATISTICS_REPORT_H_ */
@@ -80,7 +80,25 @@ class Canvas : public Canvas_base, public Genode::Surface_base::Flusher
 
 		void draw_box(Rect rect, Color color)
 		{
-			Box_painter::paint(_surface, rect, color);
+			Rect const clipped = Rect::intersect(_surface.clip(), rect);
+
+			/* fill opaque boxes using the SIMD fill of the blit library */
+			if (!color.opaque() || !clipped.valid()
+			 || (sizeof(PT) != 2 && sizeof(PT) != 4)) {
+				Box_painter::paint(_surface, rect, color);
+				return;
+			}
+
+			PT const pixel(color.r, color.g, color.b);
+			PT *dst = _surface.addr() + clipped.y1()*size().w() + clipped.x1();
+			unsigned const line = size().w()*sizeof(PT);
+
+			if (sizeof(PT) == 4)
+				blit_fill_32(dst, line, pixel.pixel, clipped.w(), clipped.h());
+			else
+				blit_fill_16(dst, line, pixel.pixel, clipped.w(), clipped.h());
+
+			_surface.flush_pixels(clipped);
 		}
 
 		void draw_texture(Point pos, Texture_base const &texture_base,
@@ -64,7 +64,8 @@ class Block::Session_component : public Block::Session_rpc_object,
 		 * Range check packet request
 		 */
 		inline bool _range_check(Packet_descriptor &p) {
-			return p.block_number() + p.block_count() <= _partition->sectors; }
+			return p.operation() == Packet_descriptor::SYNC
+			    || p.block_number() + p.block_count() <= _partition->sectors; }
 
 		/**
 		 * Handle a single request
@@ -74,18 +75,21 @@ class Block::Session_component : public Block::Session_rpc_object,
 			_p_to_handle = packet;
 			_p_to_handle.succeeded(false);
 
-			/* ignore invalid packets */
-			if (!packet.size() || !_range_check(_p_to_handle)) {
+			/* ignore invalid and unsupported packets */
+			Packet_descriptor::Opcode op = _p_to_handle.operation();
+			if (!packet.size() || !_range_check(_p_to_handle) ||
+			    !_driver.ops().supported(op)) {
 				_ack_packet(_p_to_handle);
 				return;
 			}
 
-			bool write   = _p_to_handle.operation() == Packet_descriptor::WRITE;
-			sector_t off = _p_to_handle.block_number() + _partition->lba;
+			/* 'SYNC' has no block range and affects the whole device */
+			sector_t off = op == Packet_descriptor::SYNC ? 0
+			             : _p_to_handle.block_number() + _partition->lba;
 			size_t cnt   = _p_to_handle.block_count();
 			void* addr   = tx_sink()->packet_content(_p_to_handle);
 			try {
-				_driver.io(write, off, cnt, addr, *this, _p_to_handle);
+				_driver.io(op, off, cnt, addr, *this, _p_to_handle);
 			} catch (Block::Session::Tx::Source::Packet_alloc_failed) {
 				if (!_req_queue_full) {
 					_req_queue_full = true;
@@ -39,7 +39,12 @@ class Block::Block_dispatcher
 bool operator== (const Block::Packet_descriptor& p1,
                  const Block::Packet_descriptor& p2)
 {
-	return p1.operation()    == p2.operation()    &&
+	/*
+	 * The offset distinguishes requests without block range, e.g., 'SYNC'
+	 * requests of different sessions.
+	 */
+	return p1.offset()       == p2.offset()       &&
+	       p1.operation()    == p2.operation()    &&
 	       p1.block_number() == p2.block_number() &&
 	       p1.block_count()  == p2.block_count();
 }
@@ -134,22 +139,27 @@ class Block::Driver
 
 		static Driver& driver();
 
-		void io(bool write, sector_t nr, Genode::size_t cnt, void* addr,
-		        Block_dispatcher &dispatcher, Packet_descriptor& cli)
+		void io(Packet_descriptor::Opcode op, sector_t nr, Genode::size_t cnt,
+		        void* addr, Block_dispatcher &dispatcher, Packet_descriptor& cli)
 		{
 			if (!_session.tx()->ready_to_submit())
 				throw Block::Session::Tx::Source::Packet_alloc_failed();
 
-			Block::Packet_descriptor::Opcode op = write
-			    ? Block::Packet_descriptor::WRITE
-			    : Block::Packet_descriptor::READ;
-			Genode::size_t size = _blk_size * cnt;
+			/* requests without payload occupy a single block of the buffer */
+			bool const payload = op == Packet_descriptor::READ ||
+			                     op == Packet_descriptor::WRITE;
+			Genode::size_t size = _blk_size * (payload ? cnt : 1);
+
+			/*
+			 * The barrier flag is passed on because the backend orders the
+			 * requests of all partitions.
+			 */
 			Packet_descriptor p(_session.dma_alloc_packet(size),
-			                    op,  nr, cnt);
+			                    op, nr, cnt, cli.barrier());
 			Request *r = new (&_r_slab) Request(dispatcher, cli, p);
 			_r_list.insert(r);
 
-			if (write)
+			if (op == Packet_descriptor::WRITE)
 				Genode::memcpy(_session.tx()->packet_content(p),
 				               addr, size);
 
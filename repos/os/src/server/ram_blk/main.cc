@@ -113,6 +113,7 @@ class Ram_blk : public Block::Driver
 			Block::Session::Operations o;
 			o.set_operation(Block::Packet_descriptor::READ);
 			o.set_operation(Block::Packet_descriptor::WRITE);
+			o.set_operation(Block::Packet_descriptor::TRIM);
 			return o;
 		}
 
@@ -131,6 +132,16 @@ class Ram_blk : public Block::Driver
 		{
 			_io(block_number, block_count, const_cast<char *>(buffer), packet, false);
 		}
+
+		void trim(Block::sector_t           block_number,
+		          size_t                    block_count,
+		          Block::Packet_descriptor &packet)
+		{
+			/* discarded blocks read as zeroes */
+			memset((void *)(_ram_addr + block_number * _block_size), 0,
+			       block_count * _block_size);
+			ack_packet(packet);
+		}
 };
 
 
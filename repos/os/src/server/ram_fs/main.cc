@@ -213,7 +213,8 @@ class File_system::Session_component : public Session_rpc_object
 					File * const file = new (_alloc)
 					                    File(_alloc, name.string());
 
-					dir->adopt_unsynchronized(file);
+					try { dir->adopt_unsynchronized(file); }
+					catch (...) { destroy(_alloc, file); throw; }
 				}
 				catch (Allocator::Out_of_memory) { throw No_space(); }
 			}
@@ -243,7 +244,8 @@ class File_system::Session_component : public Session_rpc_object
 					Symlink * const symlink = new (_alloc)
 					                    Symlink(name.string());
 
-					dir->adopt_unsynchronized(symlink);
+					try { dir->adopt_unsynchronized(symlink); }
+					catch (...) { destroy(_alloc, symlink); throw; }
 				}
 				catch (Allocator::Out_of_memory) { throw No_space(); }
 			}
@@ -280,7 +282,10 @@ class File_system::Session_component : public Session_rpc_object
 					throw Node_already_exists();
 
 				try {
-					parent->adopt_unsynchronized(new (_alloc) Directory(name));
+					Directory * const dir = new (_alloc) Directory(_alloc, name);
+
+					try { parent->adopt_unsynchronized(dir); }
+					catch (...) { destroy(_alloc, dir); throw; }
 				} catch (Allocator::Out_of_memory) {
 					throw No_space();
 				}
@@ -388,13 +393,29 @@ class File_system::Session_component : public Session_rpc_object
 
 			Node *node = from_dir->lookup_and_lock(from_name.string());
 			Node_lock_guard node_guard(node);
-			node->name(to_name.string());
 
-			if (!_handle_registry.refer_to_same_node(from_dir_handle, to_dir_handle)) {
+			/*
+			 * The directory index refers to the node by name. Adopting the
+			 * renamed node must not fail after it was discarded, so make
+			 * room in the target index up front. The session interface
+			 * provides no dedicated error for exhausted metadata.
+			 */
+			if (_handle_registry.refer_to_same_node(from_dir_handle, to_dir_handle)) {
+				try { from_dir->reserve_unsynchronized(); }
+				catch (Allocator::Out_of_memory) { throw Permission_denied(); }
+
+				from_dir->discard_unsynchronized(node);
+				node->name(to_name.string());
+				from_dir->adopt_unsynchronized(node);
+			} else {
 				Directory *to_dir = _handle_registry.lookup_and_lock(to_dir_handle);
 				Node_lock_guard to_dir_guard(to_dir);
 
+				try { to_dir->reserve_unsynchronized(); }
+				catch (Allocator::Out_of_memory) { throw Permission_denied(); }
+
 				from_dir->discard_unsynchronized(node);
+				node->name(to_name.string());
 				to_dir->adopt_unsynchronized(node);
 
 				/*
@@ -599,7 +620,7 @@ static void preload_content(Genode::Env            &env,
 		 */
 		if (sub_node.has_type("dir")) {
 
-			Directory *sub_dir = new (&alloc) Directory(name);
+			Directory *sub_dir = new (&alloc) Directory(alloc, name);
 
 			/* traverse into the new directory */
 			preload_content(env, alloc, sub_node, *sub_dir);
@@ -648,8 +669,6 @@ struct File_system::Main
 {
 	Genode::Env &_env;
 
-	Directory _root_dir { "" };
-
 	Genode::Attached_rom_dataspace _config { _env, "config" };
 
 	/*
@@ -659,6 +678,8 @@ struct File_system::Main
 
 	Genode::Heap _heap { _env.ram(), _env.rm() };
 
+	Directory _root_dir { _heap, "" };
+
 	Root _fs_root { _env.ep(), _env.ram(), _env.rm(), _config.xml(),
 	                _sliced_heap, _heap, _root_dir };
 
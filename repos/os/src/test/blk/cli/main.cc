@@ -374,6 +374,101 @@ struct Violation_test : Test
 };
 
 
+/*
+ * Check that barrier and 'SYNC' requests are ordered against all other
+ * requests of the session
+ */
+struct Ordering_test : Test
+{
+	enum { BEFORE = 8, AFTER = 8, TOTAL = BEFORE + AFTER + 3 };
+
+	struct Order_violated : Exception
+	{
+		char const *what;
+		unsigned    position;
+
+		Order_violated(char const *what, unsigned position)
+		: what(what), position(position) { }
+
+		void print_error() {
+			Genode::error(what, " request acknowledged as ", position, ". one"); }
+	};
+
+	static Genode::size_t packet_size() {
+		return Genode::max(blk_sz,
+		                   (Genode::size_t)1 << Block::Packet_descriptor::PACKET_ALIGNMENT); }
+
+	unsigned p_in_fly = 0;
+	unsigned acked    = 0;
+
+	Ordering_test(Genode::Env &env, Genode::Heap &heap, unsigned timeo)
+	: Test(env, heap, TOTAL*packet_size(), timeo) {}
+
+	void req(Block::Packet_descriptor::Opcode op, Block::sector_t nr,
+	         bool barrier = false)
+	{
+		Block::Packet_descriptor p(_session.dma_alloc_packet(blk_sz),
+		                           op, nr, 1, barrier);
+		_session.tx()->submit_packet(p);
+		p_in_fly++;
+	}
+
+	void perform()
+	{
+		using Block::Packet_descriptor;
+
+		if (!blk_ops.supported(Packet_descriptor::WRITE) ||
+		    !blk_ops.supported(Packet_descriptor::SYNC))
+			return;
+
+		Genode::log("barrier and sync ordering of ", (int)TOTAL, " requests");
+
+		for (unsigned i = 0; i < BEFORE; i++)
+			req(Packet_descriptor::WRITE, i);
+
+		req(Packet_descriptor::WRITE, BEFORE, true);
+
+		for (unsigned i = 0; i < AFTER; i++)
+			req(Packet_descriptor::WRITE, BEFORE + 1 + i);
+
+		req(Packet_descriptor::SYNC, 0);
+
+		if (blk_ops.supported(Packet_descriptor::TRIM))
+			req(Packet_descriptor::TRIM, 0);
+		else
+			req(Packet_descriptor::READ, 0);
+
+		while (p_in_fly > 0)
+			_handle_signal();
+	}
+
+	void ack_avail()
+	{
+		using Block::Packet_descriptor;
+
+		 _handle = false;
+
+		while (_session.tx()->ack_avail()) {
+			Packet_descriptor p = _session.tx()->get_acked_packet();
+			if (!p.succeeded())
+				throw Block_exception(p.block_number(), p.block_count(),
+				                      p.operation() != Packet_descriptor::READ);
+
+			unsigned const position = acked++;
+			if (p.barrier() && position != BEFORE)
+				throw Order_violated("barrier", position);
+
+			if (p.operation() == Packet_descriptor::SYNC &&
+			    position != BEFORE + AFTER + 1)
+				throw Order_violated("sync", position);
+
+			_session.tx()->release_packet(p);
+			p_in_fly--;
+		}
+	}
+};
+
+
 template <typename TEST>
 void perform(Genode::Env &env, Genode::Heap &heap, unsigned timeo_ms = 0)
 {
@@ -421,6 +516,7 @@ void Component::construct(Genode::Env &env)
 		perform<Read_test<Block::Session::TX_QUEUE_SIZE, 1> >(env, heap);
 		perform<Write_test<Block::Session::TX_QUEUE_SIZE, 8, 16> >(env, heap);
 		perform<Violation_test>(env, heap, 1000);
+		perform<Ordering_test>(env, heap, 1000);
 
 		log("Tests finished successfully!");
 	} catch(Genode::Parent::Service_denied) {
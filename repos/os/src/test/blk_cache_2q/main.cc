@@ -0,0 +1,198 @@
+/*
+ * \brief  Unit test for the 2Q replacement policy of the block cache
+ * \author Genode Labs
+ * \date   2017-03-29
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/log.h>
+
+/* blk_cache includes */
+#include <two_q_queues.h>
+
+using namespace Genode;
+
+enum { CHUNK_SIZE = 4096, CHUNKS = 16 };
+
+struct Element : Cache::Queue<Element>::Element
+{
+	unsigned index = 0;
+	bool     resident = false;
+};
+
+
+struct Cache_model
+{
+	Cache::Two_q_queues<Element, CHUNK_SIZE> queues;
+
+	Element chunks[CHUNKS];
+
+	Cache_model()
+	{
+		for (unsigned i = 0; i < CHUNKS; i++)
+			chunks[i].index = i;
+	}
+
+	static Cache::offset_t off(unsigned i) { return i*CHUNK_SIZE; }
+
+	void access(unsigned i)
+	{
+		chunks[i].resident = true;
+		queues.access(chunks[i], off(i));
+	}
+
+	/**
+	 * Evict one chunk and return its index
+	 */
+	unsigned evict()
+	{
+		Element *e = queues.victim();
+		if (!e) {
+			error("no victim");
+			throw -1;
+		}
+
+		queues.evict(*e, off(e->index));
+		e->resident = false;
+		return e->index;
+	}
+};
+
+
+static void expect(bool condition, char const *what)
+{
+	if (condition) {
+		log(what, ": ok");
+		return;
+	}
+
+	error(what, ": failed");
+	throw -2;
+}
+
+
+/*
+ * Chunks accessed once are evicted in FIFO order, and are remembered by
+ * the ghost queue
+ */
+static void test_fifo_of_new_chunks()
+{
+	static Cache_model cache;
+
+	for (unsigned i = 0; i < 4; i++)
+		cache.access(i);
+
+	/* repeated access does not change the position within 'A1in' */
+	cache.access(0);
+
+	expect(cache.queues.a1in_count() == 4, "new chunks enter A1in");
+	expect(cache.evict() == 0, "oldest chunk of A1in is evicted first");
+	expect(cache.queues.in_a1out(Cache_model::off(0)),
+	       "evicted chunk is remembered in A1out");
+	expect(cache.evict() == 1, "A1in is evicted in FIFO order");
+}
+
+
+/*
+ * Make chunks 0..'hot'-1 hot
+ *
+ * Eight chunks are loaded, the first 'hot' of them are evicted to 'A1out',
+ * and accessed again.
+ */
+static void promote(Cache_model &cache, unsigned hot)
+{
+	for (unsigned i = 0; i < 8; i++)
+		cache.access(i);
+	for (unsigned i = 0; i < hot; i++)
+		cache.evict();
+	for (unsigned i = 0; i < hot; i++)
+		cache.access(i);
+}
+
+
+/*
+ * A remembered chunk that is accessed again becomes hot, and a subsequent
+ * scan only displaces chunks of 'A1in'
+ */
+static void test_scan_resistance()
+{
+	static Cache_model cache;
+
+	promote(cache, 2);
+
+	expect(cache.queues.am_count() == 2, "re-accessed chunks are promoted to Am");
+	expect(!cache.queues.in_a1out(Cache_model::off(0)),
+	       "promoted chunk is no longer remembered");
+
+	/* sequential scan over chunks 8..15 */
+	for (unsigned i = 8; i < 16; i++)
+		cache.access(i);
+
+	bool scan_only = true;
+	for (unsigned i = 0; i < 8; i++)
+		if (cache.evict() < 2)
+			scan_only = false;
+
+	expect(scan_only, "scan does not displace hot chunks");
+
+	bool hot_resident = true;
+	for (unsigned i = 0; i < 2; i++)
+		if (!cache.chunks[i].resident || !cache.queues.in_am(cache.chunks[i]))
+			hot_resident = false;
+
+	expect(hot_resident, "hot chunks stay in Am");
+}
+
+
+/*
+ * Chunks of 'Am' are evicted in LRU order
+ */
+static void test_lru_of_hot_chunks()
+{
+	static Cache_model cache;
+
+	promote(cache, 3);
+
+	/* touch chunk 0, making chunk 1 the least-recently used one */
+	cache.access(0);
+
+	/* evict all resident chunks, recording the order of the hot ones */
+	unsigned order[3] = { };
+	unsigned hot = 0;
+	for (unsigned i = 0; i < 8; i++) {
+		unsigned const index = cache.evict();
+		if (index < 3 && hot < 3)
+			order[hot++] = index;
+	}
+
+	expect(hot == 3 && order[0] == 1 && order[1] == 2 && order[2] == 0,
+	       "Am is evicted in LRU order");
+	expect(!cache.queues.in_a1out(Cache_model::off(1)),
+	       "chunks evicted from Am are not remembered");
+	expect(!cache.queues.victim(), "all chunks are evicted");
+}
+
+
+void Component::construct(Genode::Env &)
+{
+	log("--- block-cache 2Q test started ---");
+
+	try {
+		test_fifo_of_new_chunks();
+		test_scan_resistance();
+		test_lru_of_hot_chunks();
+	} catch (int) {
+		error("--- block-cache 2Q test failed ---");
+		return;
+	}
+
+	log("--- block-cache 2Q test finished ---");
+}
@@ -0,0 +1,4 @@
+TARGET   = test-blk_cache_2q
+SRC_CC   = main.cc
+INC_DIR += $(REP_DIR)/src/server/blk_cache
+LIBS     = base
@@ -18,6 +18,7 @@
 #include <base/attached_dataspace.h>
 #include <blit/blit.h>
 #include <framebuffer_session/connection.h>
+#include <os/pixel_rgb888.h>
 #include <timer_session/connection.h>
 
 using namespace Genode;
@@ -120,12 +121,172 @@ struct Unaligned_blit_test : Test
 	}
 };
 
+struct Pixel_test : Test
+{
+	enum { BACKGROUND = 0x404040 };
+
+	unsigned const w = fb_mode.width();
+	unsigned const h = fb_mode.height();
+
+	uint32_t      *rgb888[2];
+	uint16_t      *rgb565;
+	unsigned char *alpha;
+
+	void *_alloc(size_t size)
+	{
+		void *ptr = nullptr;
+		if (!heap.alloc(size, &ptr)) {
+			env.parent().exit(-1); }
+		return ptr;
+	}
+
+	Pixel_test(Env &env, int id, char const *brief) : Test(env, id, brief)
+	{
+		rgb888[0] = (uint32_t      *)_alloc(w*h*sizeof(uint32_t));
+		rgb888[1] = (uint32_t      *)_alloc(w*h*sizeof(uint32_t));
+		rgb565    = (uint16_t      *)_alloc(w*h*sizeof(uint16_t));
+		alpha     = (unsigned char *)_alloc(w*h);
+
+		/* pattern with fully transparent, opaque, and masked pixels */
+		for (unsigned i = 0; i < w*h; i++) {
+			rgb888[0][i] = BACKGROUND;
+			rgb888[1][i] = (i % 5) ? i*0x010203 : 0;
+			rgb565[i]    = (i % 5) ? i : 0;
+			alpha[i]     = (i % 7) ? i : 0;
+		}
+	}
+
+	template <typename FN>
+	void measure(FN const &fn)
+	{
+		uint64_t       pixels   = 0;
+		unsigned const start_ms = timer.elapsed_ms();
+		for (; timer.elapsed_ms() - start_ms < DURATION_MS;) {
+			fn();
+			pixels += w*h;
+		}
+		unsigned const ms = timer.elapsed_ms() - start_ms;
+		log("throughput: ", pixels / 1000 / ms, " MPixel/sec (", blit_backend(), ")");
+	}
+};
+
+struct Fill_test : Pixel_test
+{
+	static constexpr char const *brief = "fill FB via blit library";
+
+	Fill_test(Env &env, int id) : Pixel_test(env, id, brief)
+	{
+		unsigned const bpp  = fb_mode.bytes_per_pixel();
+		unsigned const line = w*bpp;
+		measure([&] () {
+			if (bpp == 4)
+				blit_fill_32(fb_ds.local_addr<char>(), line, 0x204080, w, h);
+			else
+				blit_fill_16(fb_ds.local_addr<char>(), line, 0x1234, w, h);
+		});
+	}
+};
+
+struct Blend_test : Pixel_test
+{
+	static constexpr char const *brief = "RGB888 alpha blending via blit library in RAM";
+
+	/**
+	 * Compare the result of the blit library with 'Pixel_rgb888::mix'
+	 *
+	 * The blended width is not a multiple of the vector size, so the
+	 * pixels handled by the scalar tail are compared as well.
+	 */
+	bool verify()
+	{
+		unsigned const blend_w = w - 3;
+
+		blit_blend_rgb888(rgb888[1], w*4, alpha, w, rgb888[0], w*4, blend_w, h);
+
+		bool ok = true;
+		for (unsigned i = 0; i < w*h; i++) {
+
+			Pixel_rgb888 dst, src;
+			dst.pixel = BACKGROUND;
+			src.pixel = rgb888[1][i];
+
+			bool     const blended  = (i % w) < blend_w && alpha[i];
+			uint32_t const expected = blended
+			                        ? Pixel_rgb888::mix(dst, src, alpha[i]).pixel
+			                        : (uint32_t)BACKGROUND;
+
+			if (rgb888[0][i] == expected)
+				continue;
+
+			error("blending mismatch at pixel ", i % w, ",", i / w, ": ",
+			      Hex(rgb888[0][i]), " instead of ", Hex(expected));
+			ok = false;
+			break;
+		}
+
+		for (unsigned i = 0; i < w*h; i++)
+			rgb888[0][i] = BACKGROUND;
+
+		return ok;
+	}
+
+	Blend_test(Env &env, int id) : Pixel_test(env, id, brief)
+	{
+		if (!verify()) {
+			env.parent().exit(-1);
+			return;
+		}
+		log("result matches Pixel_rgb888::mix (", blit_backend(), ")");
+
+		measure([&] () {
+			blit_blend_rgb888(rgb888[1], w*4, alpha, w, rgb888[0], w*4, w, h); });
+	}
+};
+
+struct Masked_test : Pixel_test
+{
+	static constexpr char const *brief = "masked RGB888 copy via blit library in RAM";
+
+	Masked_test(Env &env, int id) : Pixel_test(env, id, brief)
+	{
+		measure([&] () {
+			blit_masked_32(rgb888[1], w*4, rgb888[0], w*4, w, h); });
+	}
+};
+
+struct Rgb565_to_rgb888_test : Pixel_test
+{
+	static constexpr char const *brief = "RGB565 to RGB888 conversion via blit library in RAM";
+
+	Rgb565_to_rgb888_test(Env &env, int id) : Pixel_test(env, id, brief)
+	{
+		measure([&] () {
+			blit_rgb565_to_rgb888(rgb565, w*2, rgb888[0], w*4, w, h); });
+	}
+};
+
+struct Rgb888_to_rgb565_test : Pixel_test
+{
+	static constexpr char const *brief = "RGB888 to RGB565 conversion via blit library in RAM";
+
+	Rgb888_to_rgb565_test(Env &env, int id) : Pixel_test(env, id, brief)
+	{
+		measure([&] () {
+			blit_rgb888_to_rgb565(rgb888[1], w*4, rgb565, w*2, w, h); });
+	}
+};
+
 struct Main
 {
-	Constructible<Bytewise_ram_test>   test_1;
-	Constructible<Bytewise_fb_test>    test_2;
-	Constructible<Blit_test>           test_3;
-	Constructible<Unaligned_blit_test> test_4;
+	Constructible<Bytewise_ram_test>     test_1;
+	Constructible<Bytewise_fb_test>      test_2;
+	Constructible<Blit_test>             test_3;
+	Constructible<Unaligned_blit_test>   test_4;
+	Constructible<Fill_test>             test_5;
+	Constructible<Blend_test>            test_6;
+	Constructible<Masked_test>           test_7;
+	Constructible<Rgb565_to_rgb888_test> test_8;
+	Constructible<Rgb888_to_rgb565_test> test_9;
 
 	Main(Env &env)
 	{
@@ -134,6 +295,11 @@ struct Main
 		test_2.construct(env, 2); test_2.destruct();
 		test_3.construct(env, 3); test_3.destruct();
 		test_4.construct(env, 4); test_4.destruct();
+		test_5.construct(env, 5); test_5.destruct();
+		test_6.construct(env, 6); test_6.destruct();
+		test_7.construct(env, 7); test_7.destruct();
+		test_8.construct(env, 8); test_8.destruct();
+		test_9.construct(env, 9); test_9.destruct();
 		log("--- Framebuffer benchmark finished ---");
 	}
 };
@@ -0,0 +1,190 @@
+/*
+ * \brief  Throughput of streamed file-system reads and writes
+ * \author Genode Labs
+ * \date   2017-04-04
+ *
+ * For each '<fs label="..."/>' node of the config, the benchmark opens a
+ * file-system session and transfers files of 4 KiB to 16 MiB, once with a
+ * single packet in flight and once with the configured window of packets.
+ * The read data is checked against the written pattern.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/allocator_avl.h>
+#include <base/attached_rom_dataspace.h>
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <file_system/util.h>
+#include <file_system_session/connection.h>
+#include <timer_session/connection.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Failed : Exception { };
+
+	struct Fs_connection;
+	struct Main;
+}
+
+
+/**
+ * File-system connection with additional quota for the server
+ *
+ * Servers like lx_fs pay their I/O worker threads from the session quota.
+ * The stock connection donates merely enough for the session meta data and
+ * the transmission buffer.
+ */
+struct Test::Fs_connection : Connection<File_system::Session>,
+                             File_system::Session_client
+{
+	Fs_connection(Env &env, Range_allocator &tx_alloc, char const *label,
+	              size_t tx_buf_size, size_t extra_quota)
+	:
+		Connection<File_system::Session>(env,
+			session(env.parent(),
+			        "ram_quota=%ld, tx_buf_size=%ld, label=\"%s\", "
+			        "root=\"/\", writeable=1",
+			        8*1024*sizeof(long) + tx_buf_size + extra_quota,
+			        tx_buf_size, label)),
+		File_system::Session_client(cap(), tx_alloc, env.rm())
+	{ }
+};
+
+
+struct Test::Main
+{
+	enum { MIN_SIZE = 4*1024, MAX_SIZE = 16*1024*1024 };
+
+	typedef String<64> Label;
+
+	Env                    &_env;
+	Heap                    _heap    { _env.ram(), _env.rm() };
+	Attached_rom_dataspace  _config  { _env, "config" };
+	Timer::Connection       _timer   { _env };
+
+	unsigned const _window =
+		_config.xml().attribute_value("window",
+		                              (unsigned)File_system::Packet_window::FILE_WINDOW);
+
+	size_t const _tx_buf_size =
+		_config.xml().attribute_value("tx_buf_size", Number_of_bytes(1024*1024));
+
+	size_t const _extra_quota =
+		_config.xml().attribute_value("extra_quota", Number_of_bytes(512*1024));
+
+	static char _pattern(size_t offset) { return (char)(offset*7 + (offset >> 12)); }
+
+	/**
+	 * Log throughput of transferring 'size' bytes 'rounds' times
+	 */
+	void _log(Label const &label, char const *what, unsigned window,
+	          size_t size, unsigned rounds, unsigned long ms)
+	{
+		unsigned long long const kib = ((unsigned long long)size*rounds) / 1024;
+
+		log(label, ": ", what, " ", Number_of_bytes(size), " window ", window,
+		    ": ", ms ? kib*1000/1024/ms : 0, " MiB/s");
+	}
+
+	void _bench(File_system::Session &fs, Label const &label,
+	            File_system::File_handle file, size_t size, unsigned window)
+	{
+		/* transfer at least 'MAX_SIZE' bytes per measurement */
+		unsigned const rounds = max(1UL, (unsigned long)(MAX_SIZE / size));
+
+		unsigned long start_ms = _timer.elapsed_ms();
+
+		for (unsigned i = 0; i < rounds; i++) {
+			size_t offset = 0;
+			size_t const written =
+				File_system::write_streamed(fs, file, size, 0,
+					[&] (void *dst, size_t len) {
+						char *p = (char *)dst;
+						for (size_t j = 0; j < len; j++)
+							p[j] = _pattern(offset + j);
+						offset += len;
+					}, window);
+
+			if (written != size) {
+				error(label, ": wrote ", written, " of ", size, " bytes");
+				throw Failed();
+			}
+		}
+
+		_log(label, "write", window, size, rounds, _timer.elapsed_ms() - start_ms);
+
+		start_ms = _timer.elapsed_ms();
+
+		for (unsigned i = 0; i < rounds; i++) {
+			size_t offset = 0;
+			bool   valid  = true;
+			size_t const read =
+				File_system::read_streamed(fs, file, size, 0,
+					[&] (void const *src, size_t len) {
+						char const *p = (char const *)src;
+
+						/* check every byte, a lost part shifts the content */
+						for (size_t j = 0; j < len; j++)
+							valid &= p[j] == _pattern(offset + j);
+						offset += len;
+					}, window);
+
+			if (read != size || !valid) {
+				error(label, ": read ", read, " of ", size, " bytes",
+				      valid ? "" : ", data mismatch");
+				throw Failed();
+			}
+		}
+
+		_log(label, "read ", window, size, rounds, _timer.elapsed_ms() - start_ms);
+	}
+
+	void _bench(Label const &label)
+	{
+		Allocator_avl             tx_alloc { &_heap };
+		Fs_connection             fs { _env, tx_alloc, label.string(),
+		                               _tx_buf_size, _extra_quota };
+
+		File_system::Dir_handle dir = fs.dir("/", false);
+		File_system::Handle_guard dir_guard(fs, dir);
+
+		File_system::File_handle file =
+			fs.file(dir, "fs_stream_bench", File_system::READ_WRITE, true);
+		File_system::Handle_guard file_guard(fs, file);
+
+		for (size_t size = MIN_SIZE; size <= MAX_SIZE; size *= 4) {
+			fs.truncate(file, 0);
+			_bench(fs, label, file, size, 1);
+			_bench(fs, label, file, size, _window);
+		}
+
+		fs.unlink(dir, "fs_stream_bench");
+	}
+
+	Main(Env &env) : _env(env)
+	{
+		try {
+			_config.xml().for_each_sub_node("fs", [&] (Xml_node fs) {
+				_bench(fs.attribute_value("label", Label())); });
+		} catch (Failed) {
+			_env.parent().exit(-1);
+			return;
+		}
+
+		log("--- benchmark finished ---");
+		_env.parent().exit(0);
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
@@ -16,12 +16,14 @@
 #include <base/heap.h>
 #include <base/allocator_avl.h>
 #include <nic_session/connection.h>
+#include <nic_session/multi_queue_connection.h>
 #include <nic/packet_allocator.h>
 
 namespace Test {
 	struct Base;
 	struct Roundtrip;
 	struct Batch;
+	struct Multi_queue;
 	struct Main;
 
 	using namespace Genode;
@@ -332,12 +334,188 @@ struct Test::Batch : Base
 };
 
 
+/*
+ * Send UDP frames of many flows, each on the queue selected by the flow
+ * hash, and expect every frame to be echoed on the queue it was sent on
+ */
+struct Test::Multi_queue
+{
+	enum { QUEUES = 4, NUM_FLOWS = 64, PACKETS_PER_FLOW = 16, PACKET_SIZE = 64 };
+	enum { MAX_QUEUES = Nic::Session::MAX_QUEUES };
+	enum { BUF_SIZE = Nic::Packet_allocator::DEFAULT_PACKET_SIZE * 32 };
+
+	Env &_env;
+
+	Signal_context_capability _succeeded_sigh;
+
+	Heap _heap { _env.ram(), _env.rm() };
+
+	Allocator_avl _tx_block_alloc { &_heap };
+
+	Nic::Multi_queue_connection _nic { _env, _tx_block_alloc, _heap,
+	                                   BUF_SIZE, BUF_SIZE, QUEUES };
+
+	unsigned _tx_cnt = 0, _acked_cnt = 0, _rx_cnt = 0;
+
+	unsigned _rx_per_queue[MAX_QUEUES] { };
+
+	bool _done = false;
+
+	/**
+	 * Write UDP/IPv4 frame of a flow in forward or reverse direction
+	 */
+	static void _write_frame(uint8_t *frame, unsigned flow, bool reverse)
+	{
+		memset(frame, 0, PACKET_SIZE);
+
+		uint8_t *ip  = frame + 14;
+		uint8_t *udp = ip + 20;
+
+		uint8_t const addr_a[] = { 10, 0, 0, 1 };
+		uint8_t const addr_b[] = { 10, 0, 0, (uint8_t)(2 + flow % 8) };
+		uint16_t const port_a  = 1024 + flow;
+		uint16_t const port_b  = 80;
+
+		frame[12] = 0x08;
+		ip[0]     = 0x45;
+		ip[9]     = 17;
+		memcpy(ip + 12, reverse ? addr_b : addr_a, 4);
+		memcpy(ip + 16, reverse ? addr_a : addr_b, 4);
+
+		uint16_t const src_port = reverse ? port_b : port_a;
+		uint16_t const dst_port = reverse ? port_a : port_b;
+		udp[0] = src_port >> 8; udp[1] = src_port & 0xff;
+		udp[2] = dst_port >> 8; udp[3] = dst_port & 0xff;
+	}
+
+	/**
+	 * Check that both directions of a flow are steered to the same queue
+	 */
+	void _check_flow_hash()
+	{
+		uint8_t forward[PACKET_SIZE], reverse[PACKET_SIZE];
+		bool used[MAX_QUEUES] { };
+
+		for (unsigned flow = 0; flow < NUM_FLOWS; flow++) {
+			_write_frame(forward, flow, false);
+			_write_frame(reverse, flow, true);
+
+			unsigned const queue = _nic.flow_queue(forward, PACKET_SIZE);
+			if (queue != _nic.flow_queue(reverse, PACKET_SIZE))
+				Base::abort("directions of flow ", flow, " use different queues");
+
+			if (queue >= _nic.queues())
+				Base::abort("flow ", flow, " steered to invalid queue ", queue);
+
+			used[queue] = true;
+		}
+
+		for (unsigned i = 0; i < _nic.queues(); i++)
+			if (!used[i])
+				Base::abort("no flow steered to queue ", i);
+	}
+
+	void _send_packets()
+	{
+		unsigned const num_packets = NUM_FLOWS * PACKETS_PER_FLOW;
+
+		for (; _tx_cnt < num_packets; _tx_cnt++) {
+
+			uint8_t frame[PACKET_SIZE];
+			_write_frame(frame, _tx_cnt % NUM_FLOWS, _tx_cnt % 2);
+
+			unsigned const queue = _nic.flow_queue(frame, PACKET_SIZE);
+			Nic::Session::Tx::Source &tx = *_nic.tx(queue);
+
+			/* keep the order of packets by not skipping a busy queue */
+			if (!tx.ready_to_submit())
+				return;
+
+			Packet_descriptor packet;
+			try { packet = tx.alloc_packet(PACKET_SIZE); }
+			catch (Nic::Session::Tx::Source::Packet_alloc_failed) { return; }
+
+			memcpy(tx.packet_content(packet), frame, PACKET_SIZE);
+			tx.submit_packet(packet);
+		}
+	}
+
+	void _handle_nic()
+	{
+		if (_done)
+			return;
+
+		for (unsigned queue = 0; queue < _nic.queues(); queue++) {
+
+			Nic::Session::Tx::Source &tx = *_nic.tx(queue);
+			Nic::Session::Rx::Sink   &rx = *_nic.rx(queue);
+
+			while (tx.ack_avail()) {
+				tx.release_packet(tx.get_acked_packet());
+				_acked_cnt++;
+			}
+
+			while (rx.packet_avail() && rx.ready_to_ack()) {
+				Packet_descriptor const packet = rx.get_packet();
+				if (packet.size() != PACKET_SIZE)
+					Base::abort("echoed packet has unexpected size");
+
+				unsigned const flow_queue =
+					_nic.flow_queue(rx.packet_content(packet), packet.size());
+				if (flow_queue != queue)
+					Base::abort("packet of queue ", flow_queue,
+					            " echoed on queue ", queue);
+
+				rx.acknowledge_packet(packet);
+				_rx_per_queue[queue]++;
+				_rx_cnt++;
+			}
+		}
+
+		_send_packets();
+
+		unsigned const n = NUM_FLOWS * PACKETS_PER_FLOW;
+		if (_tx_cnt < n || _acked_cnt < n || _rx_cnt < n)
+			return;
+
+		for (unsigned i = 0; i < _nic.queues(); i++)
+			log("queue ", i, " echoed ", _rx_per_queue[i], " packets");
+
+		_done = true;
+		log("-- multi-queue test succeeded --");
+		Signal_transmitter(_succeeded_sigh).submit();
+	}
+
+	Signal_handler<Multi_queue> _nic_handler {
+		_env.ep(), *this, &Multi_queue::_handle_nic };
+
+	Multi_queue(Env &env, Signal_context_capability succeeded_sigh)
+	:
+		_env(env), _succeeded_sigh(succeeded_sigh)
+	{
+		log("-- starting multi-queue test --");
+		log("server provides ", _nic.queues(), " of ", (int)QUEUES, " queues");
+
+		for (unsigned i = 0; i < _nic.queues(); i++) {
+			_nic.tx_channel(i)->sigh_ready_to_submit(_nic_handler);
+			_nic.tx_channel(i)->sigh_ack_avail      (_nic_handler);
+			_nic.rx_channel(i)->sigh_ready_to_ack   (_nic_handler);
+			_nic.rx_channel(i)->sigh_packet_avail   (_nic_handler);
+		}
+
+		_check_flow_hash();
+		_handle_nic();
+	}
+};
+
+
 struct Test::Main
 {
 	Env &_env;
 
-	Constructible<Roundtrip> _roundtrip;
-	Constructible<Batch>     _batch;
+	Constructible<Roundtrip>   _roundtrip;
+	Constructible<Batch>       _batch;
+	Constructible<Multi_queue> _multi_queue;
 
 	Signal_handler<Main> _test_completed_handler {
 		_env.ep(), *this, &Main::_handle_test_completed };
@@ -354,6 +532,12 @@ struct Test::Main
 
 		if (_batch.constructed()) {
 			_batch.destruct();
+			_multi_queue.construct(_env, _test_completed_handler);
+			return;
+		}
+
+		if (_multi_queue.constructed()) {
+			_multi_queue.destruct();
 			log("--- finished NIC loop-back test ---");
 			_env.parent().exit(0);
 		}
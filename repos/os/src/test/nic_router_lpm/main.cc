@@ -0,0 +1,160 @@
+/*
+ * \brief  Benchmark of the longest-prefix match of the NIC router
+ * \author Genode Labs
+ * \date   2017-03-23
+ *
+ * The test routes synthetic destination addresses through rule lists of
+ * 10, 100, and 1000 rules, once using the list walk and once using the
+ * compiled lookup table. It checks that both yield the same rules and
+ * reports the number of lookups per second.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/snprintf.h>
+#include <timer_session/connection.h>
+
+/* NIC router includes */
+#include <direct_rule.h>
+
+using namespace Net;
+using namespace Genode;
+
+
+struct Test_rule : Direct_rule<Test_rule>
+{
+	Test_rule(Xml_node const node) : Direct_rule<Test_rule>(node) { }
+};
+
+using Test_rule_list = Direct_rule_list<Test_rule>;
+
+
+struct Random
+{
+	uint32_t _state = 0x2545f491;
+
+	uint32_t next()
+	{
+		_state ^= _state << 13;
+		_state ^= _state >> 17;
+		_state ^= _state << 5;
+		return _state;
+	}
+};
+
+
+struct Main
+{
+	enum { DURATION_MS = 1000, NUM_ADDRESSES = 1024 };
+
+	Env               &env;
+	Heap               heap  { env.ram(), env.rm() };
+	Timer::Connection  timer { env };
+
+	Ipv4_address addresses[NUM_ADDRESSES];
+
+	static Ipv4_address address(uint32_t value)
+	{
+		Ipv4_address ip;
+		ip.addr[0] = value >> 24; ip.addr[1] = value >> 16;
+		ip.addr[2] = value >>  8; ip.addr[3] = value;
+		return ip;
+	}
+
+	/**
+	 * Create rule with a random destination prefix within 10.0.0.0/8
+	 */
+	Test_rule &random_rule(Random &random)
+	{
+		static unsigned const prefixes[] = { 8, 12, 16, 20, 24, 24, 28, 32 };
+
+		uint32_t const value  = (10U << 24) | (random.next() & 0xffffff);
+		unsigned const prefix = prefixes[random.next() % 8];
+
+		char buf[64];
+		snprintf(buf, sizeof(buf), "<ip dst=\"%u.%u.%u.%u/%u\"/>",
+		         (value >> 24) & 0xff, (value >> 16) & 0xff,
+		         (value >>  8) & 0xff, value & 0xff, prefix);
+
+		return *new (heap) Test_rule(Xml_node(buf));
+	}
+
+	unsigned long lookups_per_sec(Test_rule_list const &rules)
+	{
+		unsigned long       lookups  = 0;
+		unsigned long const start_ms = timer.elapsed_ms();
+		unsigned long       end_ms   = start_ms;
+
+		for (; end_ms - start_ms < DURATION_MS; end_ms = timer.elapsed_ms()) {
+			for (unsigned i = 0; i < NUM_ADDRESSES; i++) {
+				try { rules.longest_prefix_match(addresses[i]); }
+				catch (Test_rule_list::No_match) { }
+			}
+			lookups += NUM_ADDRESSES;
+		}
+		return lookups * 1000 / (end_ms - start_ms);
+	}
+
+	void measure(unsigned num_rules)
+	{
+		Random random;
+		Test_rule_list linear, compiled;
+
+		for (unsigned i = 0; i < num_rules; i++) {
+			Random state = random;
+			linear.insert(random_rule(random));
+			compiled.insert(random_rule(state));
+		}
+		compiled.compile(heap);
+
+		/* destinations within and outside the configured prefixes */
+		for (unsigned i = 0; i < NUM_ADDRESSES; i++) {
+			uint32_t const value = random.next();
+			addresses[i] = address(i % 4 ? (10U << 24) | (value & 0xffffff)
+			                             : value);
+		}
+
+		for (unsigned i = 0; i < NUM_ADDRESSES; i++) {
+			Test_rule const *expected = nullptr, *result = nullptr;
+			try { expected = &linear.longest_prefix_match(addresses[i]); }
+			catch (Test_rule_list::No_match) { }
+			try { result = &compiled.longest_prefix_match(addresses[i]); }
+			catch (Test_rule_list::No_match) { }
+
+			bool const equal = (!expected && !result) ||
+			                   (expected && result &&
+			                    expected->dst().address == result->dst().address &&
+			                    expected->dst().prefix  == result->dst().prefix);
+			if (!equal) {
+				error("lookup mismatch for ", addresses[i]);
+				throw -1;
+			}
+		}
+
+		log(num_rules, " rules: list walk ", lookups_per_sec(linear),
+		    " lookups/s, compiled table ", lookups_per_sec(compiled),
+		    " lookups/s");
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- NIC-router longest-prefix-match benchmark ---");
+
+		measure(10);
+		measure(100);
+		measure(1000);
+
+		log("--- NIC-router longest-prefix-match benchmark finished ---");
+	}
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }
@@ -0,0 +1,6 @@
+TARGET   = test-nic_router_lpm
+SRC_CC   = main.cc direct_rule.cc
+LIBS     = base net
+INC_DIR += $(REP_DIR)/src/server/nic_router
+
+vpath direct_rule.cc $(REP_DIR)/src/server/nic_router
@@ -0,0 +1,3 @@
+TARGET = test-packet_allocator_bench
+SRC_CC = main.cc
+LIBS   = base
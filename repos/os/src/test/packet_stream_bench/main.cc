@@ -0,0 +1,155 @@
+/*
+ * \brief  Packet-stream throughput benchmark
+ * \author Genode Labs
+ * \date   2017-03-20
+ *
+ * The benchmark streams packet descriptors from a source in the main thread
+ * to a sink in a separate thread and reports the number of descriptors
+ * processed per second, once using the single-packet interface and once
+ * using the batch interface with different batch sizes.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/allocator_avl.h>
+#include <base/attached_ram_dataspace.h>
+#include <base/thread.h>
+#include <os/packet_stream.h>
+#include <timer_session/connection.h>
+
+using namespace Genode;
+
+enum { QUEUE_SIZE = 1024, MAX_BATCH = 64 };
+
+typedef Packet_stream_policy<Packet_descriptor, QUEUE_SIZE, QUEUE_SIZE, char> Policy;
+typedef Packet_stream_source<Policy> Source;
+typedef Packet_stream_sink<Policy>   Sink;
+
+static unsigned long const NUM_PACKETS = 4*1000*1000;
+
+
+struct Sink_thread : Thread
+{
+	Sink              &sink;
+	unsigned long const num_packets;
+	unsigned      const batch;
+
+	Sink_thread(Env &env, Sink &sink, unsigned long num_packets, unsigned batch)
+	:
+		Thread(env, "sink", 0x2000),
+		sink(sink), num_packets(num_packets), batch(batch)
+	{ }
+
+	void entry()
+	{
+		Packet_descriptor packets[MAX_BATCH];
+
+		for (unsigned long i = 0; i < num_packets; ) {
+
+			if (batch == 1) {
+				sink.acknowledge_packet(sink.get_packet());
+				i++;
+				continue;
+			}
+
+			unsigned const n = sink.get_packets(packets, batch);
+			sink.acknowledge_packets(packets, n);
+			i += n;
+		}
+	}
+};
+
+
+struct Main
+{
+	Env                    &env;
+	Timer::Connection       timer        { env };
+	Heap                    heap         { env.ram(), env.rm() };
+	Allocator_avl           packet_alloc { &heap };
+	Attached_ram_dataspace  ds           { env.ram(), env.rm(), 64*1024 };
+	Source                  source       { ds.cap(), env.rm(), packet_alloc };
+	Sink                    sink         { ds.cap(), env.rm() };
+
+	void measure(unsigned batch)
+	{
+		Sink_thread sink_thread(env, sink, NUM_PACKETS, batch);
+
+		Packet_descriptor packets[MAX_BATCH];
+		for (unsigned i = 0; i < MAX_BATCH; i++)
+			packets[i] = Packet_descriptor(i, 0);
+
+		unsigned long const start_ms = timer.elapsed_ms();
+
+		sink_thread.start();
+
+		/*
+		 * The number of packets in flight is limited to the capacity of the
+		 * ack queue, which holds 'QUEUE_SIZE - 1' descriptors, so that the
+		 * sink never blocks on acknowledging.
+		 */
+		unsigned long submitted = 0, acked = 0;
+		while (acked < NUM_PACKETS) {
+
+			unsigned long const left      = NUM_PACKETS - submitted;
+			unsigned long const in_flight = submitted - acked;
+			unsigned      const n         = left < batch ? left : batch;
+
+			bool const submit = n && in_flight + n < QUEUE_SIZE;
+
+			if (submit) {
+				if (batch == 1)
+					source.submit_packet(packets[0]);
+				else
+					source.submit_packets(packets, n);
+				submitted += n;
+			}
+
+			if (!source.ack_avail() && submit)
+				continue;
+
+			if (batch == 1) {
+				source.get_acked_packet();
+				acked++;
+			} else {
+				acked += source.get_acked_packets(packets, MAX_BATCH);
+			}
+		}
+
+		sink_thread.join();
+
+		unsigned long const duration_ms = timer.elapsed_ms() - start_ms;
+
+		log("batch size ", batch, ": ", NUM_PACKETS, " descriptors in ",
+		    duration_ms, " ms -> ",
+		    duration_ms ? (NUM_PACKETS / duration_ms) * 1000 : 0,
+		    " descriptors/s");
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- packet-stream benchmark ---");
+
+		source.register_sigh_packet_avail(sink.sigh_packet_avail());
+		source.register_sigh_ready_to_ack(sink.sigh_ready_to_ack());
+		sink.register_sigh_ready_to_submit(source.sigh_ready_to_submit());
+		sink.register_sigh_ack_avail(source.sigh_ack_avail());
+
+		measure(1);
+		measure(8);
+		measure(32);
+		measure(MAX_BATCH);
+
+		log("--- packet-stream benchmark finished ---");
+	}
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }
@@ -0,0 +1,90 @@
+/*
+ * \brief  Benchmark of the first access to attached memory
+ * \author Genode Labs
+ * \date   2017-04-13
+ *
+ * The benchmark measures the bandwidth of writing to a freshly attached RAM
+ * dataspace, once with the mappings established lazily via page faults and
+ * once with the region populated via 'Region_map::populate' beforehand. The
+ * time of the 'populate' call is included in the measurement.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/log.h>
+#include <timer_session/connection.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Main;
+}
+
+
+struct Test::Main
+{
+	enum { SIZE = 16*1024*1024, ROUNDS = 4 };
+
+	Env &env;
+
+	Timer::Connection timer { env };
+
+	Ram_dataspace_capability ds = env.ram().alloc(SIZE);
+
+	/**
+	 * Attach dataspace, write one word per page, and return the duration
+	 */
+	unsigned long first_touch(bool populate)
+	{
+		unsigned long const start = timer.elapsed_ms();
+
+		char volatile *base = env.rm().attach(ds);
+
+		if (populate)
+			env.rm().populate((void *)base, SIZE);
+
+		for (size_t offset = 0; offset < SIZE; offset += 4096)
+			base[offset] = 1;
+
+		unsigned long const elapsed = timer.elapsed_ms() - start;
+
+		env.rm().detach((void *)base);
+
+		return max(elapsed, 1UL);
+	}
+
+	void measure(char const *name, bool populate)
+	{
+		unsigned long elapsed = 0;
+		for (unsigned i = 0; i < ROUNDS; i++)
+			elapsed += first_touch(populate);
+
+		unsigned long const mib = SIZE/(1024*1024);
+
+		log(name, ": ", elapsed/ROUNDS, " ms per ", mib, " MiB, ",
+		    mib*ROUNDS*1000/elapsed, " MiB/s");
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- populate benchmark started ---");
+
+		measure("page faults", false);
+		measure("populated",   true);
+
+		log("--- populate benchmark finished ---");
+	}
+
+	~Main() { env.ram().free(ds); }
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
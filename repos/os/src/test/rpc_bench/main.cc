@@ -0,0 +1,199 @@
+/*
+ * \brief  RPC round-trip benchmark
+ * \author Genode Labs
+ * \date   2017-04-11
+ *
+ * The benchmark measures the rate of RPCs between two threads of the same
+ * component, for RPCs without arguments, RPCs with a payload, and RPCs that
+ * transfer a capability. Furthermore, it measures the aggregated rate of
+ * 1 to 8 client threads calling a single entrypoint and an entrypoint pool.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/log.h>
+#include <base/rpc_server.h>
+#include <base/rpc_client.h>
+#include <base/rpc_entrypoint_pool.h>
+#include <timer_session/connection.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Payload { char data[1024]; };
+
+	struct Session;
+	struct Client;
+	struct Component;
+	struct Client_thread;
+	struct Main;
+}
+
+
+struct Test::Session : Genode::Session
+{
+	static const char *service_name() { return "RPC_BENCH"; }
+
+	GENODE_RPC(Rpc_null, void, null);
+	GENODE_RPC(Rpc_payload, unsigned, payload, Payload const &);
+	GENODE_RPC(Rpc_cap, Native_capability, cap, Native_capability);
+	GENODE_RPC_INTERFACE(Rpc_null, Rpc_payload, Rpc_cap);
+};
+
+
+struct Test::Client : Genode::Rpc_client<Session>
+{
+	Client(Capability<Session> cap) : Rpc_client<Session>(cap) { }
+
+	void null() { call<Rpc_null>(); }
+
+	unsigned payload(Payload const &payload) { return call<Rpc_payload>(payload); }
+
+	Native_capability cap(Native_capability cap) { return call<Rpc_cap>(cap); }
+};
+
+
+struct Test::Component : Genode::Rpc_object<Session, Component>
+{
+	void null() { }
+
+	unsigned payload(Payload const &payload) { return payload.data[0]; }
+
+	Native_capability cap(Native_capability cap) { return cap; }
+};
+
+
+/**
+ * Thread that performs null RPCs until stopped
+ */
+struct Test::Client_thread : Genode::Thread
+{
+	Client client;
+
+	unsigned long    calls = 0;
+	bool    volatile stop  = false;
+
+	void entry() override
+	{
+		while (!stop) {
+			client.null();
+			calls++;
+		}
+	}
+
+	Client_thread(Env &env, Capability<Session> cap, Affinity::Location location)
+	:
+		Thread(env, "client", 2*1024*sizeof(long), location,
+		       Weight(), env.cpu()),
+		client(cap)
+	{
+		start();
+	}
+};
+
+
+struct Test::Main
+{
+	enum { STACK_SIZE = 2*1024*sizeof(long), DURATION_MS = 2000 };
+
+	Env &env;
+
+	Timer::Connection timer { env };
+
+	Rpc_entrypoint ep { &env.pd(), STACK_SIZE, "rpc_bench_ep" };
+
+	Component component;
+
+	Client client { ep.manage(&component) };
+
+	Payload payload { };
+
+	/**
+	 * Perform RPCs for 'DURATION_MS' and print the achieved rate
+	 */
+	template <typename FN>
+	void measure(char const *name, FN const &fn)
+	{
+		unsigned long const start = timer.elapsed_ms();
+		unsigned long calls = 0, elapsed = 0;
+
+		for (; elapsed < DURATION_MS; elapsed = timer.elapsed_ms() - start)
+			for (unsigned i = 0; i < 1000; i++, calls++)
+				fn();
+
+		log(name, ": ", calls/elapsed, " calls/ms, ",
+		    (elapsed*1000*1000)/calls, " ns/call");
+	}
+
+	/**
+	 * Measure aggregated rate of 'num_clients' concurrent clients
+	 *
+	 * Each client uses a dedicated RPC object. The objects are served by
+	 * 'num_threads' entrypoint threads.
+	 */
+	void measure_scaling(unsigned num_clients, unsigned num_threads)
+	{
+		enum { MAX_CLIENTS = 8 };
+
+		Affinity::Space space = env.cpu().affinity_space();
+
+		Rpc_entrypoint_pool pool(env.pd(), STACK_SIZE, "rpc_bench_pool",
+		                         num_threads, space);
+
+		Component                    components[MAX_CLIENTS];
+		Constructible<Client_thread> threads[MAX_CLIENTS];
+
+		/* place clients after the entrypoint threads */
+		for (unsigned i = 0; i < num_clients; i++)
+			threads[i].construct(env, pool.manage(&components[i]),
+			                     space.location_of_index(num_threads + i));
+
+		timer.msleep(DURATION_MS);
+
+		unsigned long calls = 0;
+		for (unsigned i = 0; i < num_clients; i++) {
+			threads[i]->stop = true;
+			threads[i]->join();
+			calls += threads[i]->calls;
+		}
+
+		for (unsigned i = 0; i < num_clients; i++) {
+			threads[i].destruct();
+			pool.dissolve(&components[i]);
+		}
+
+		log(num_clients, " clients, ", num_threads, " entrypoint threads: ",
+		    calls/DURATION_MS, " calls/ms");
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- RPC benchmark started ---");
+
+		measure("null RPC",    [&] () { client.null(); });
+		measure("1 KiB RPC",   [&] () { client.payload(payload); });
+		measure("cap RPC",     [&] () { client.cap(client); });
+
+		log("CPUs: ", env.cpu().affinity_space().total());
+
+		for (unsigned n = 1; n <= 8; n *= 2) {
+			measure_scaling(n, 1);
+			measure_scaling(n, n);
+		}
+
+		log("--- RPC benchmark finished ---");
+	}
+
+	~Main() { ep.dissolve(&component); }
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
@@ -0,0 +1,223 @@
+/*
+ * \brief  Test of the VFS page cache
+ * \author Genode Labs
+ * \date   2017-04-07
+ *
+ * The test accesses a file via a '<cache>' node, which is smaller than the
+ * file, and via an uncached node of the same file system. It checks that
+ * partial writes, reads after writes, and evictions preserve the file
+ * content and that the modifications are written back to the underlying
+ * file system.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/attached_ram_dataspace.h>
+#include <base/attached_rom_dataspace.h>
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <vfs/dir_file_system.h>
+#include <vfs/file_system_factory.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Failed : Exception { };
+
+	struct Main;
+}
+
+
+struct Test::Main
+{
+	struct Io_response_handler : Vfs::Io_response_handler
+	{
+		void handle_io_response(Vfs::Vfs_handle::Context *) override { }
+	};
+
+	typedef Vfs::Directory_service Ds;
+	typedef Vfs::File_io_service   Fs;
+
+	enum { FILE_SIZE = 256*1024, CHUNK_SIZE = 3000 };
+
+	char const * const CACHED = "/cached/file";
+	char const * const DIRECT = "/direct/file";
+
+	Env                            &_env;
+	Heap                            _heap    { _env.ram(), _env.rm() };
+	Attached_rom_dataspace          _config  { _env, "config" };
+	Io_response_handler             _io_response_handler;
+	Vfs::Global_file_system_factory _factory { _heap };
+	Vfs::Dir_file_system            _vfs     { _env, _heap,
+	                                           _config.xml().sub_node("vfs"),
+	                                           _io_response_handler,
+	                                           _factory };
+
+	/* expected file content and buffer for reading the file */
+	Attached_ram_dataspace _model_ds { _env.ram(), _env.rm(), FILE_SIZE };
+	Attached_ram_dataspace _buf_ds   { _env.ram(), _env.rm(), FILE_SIZE };
+
+	char * const _model = _model_ds.local_addr<char>();
+	char * const _buf   = _buf_ds.local_addr<char>();
+
+	Vfs::Vfs_handle &_open(char const *path, unsigned mode)
+	{
+		Vfs::Vfs_handle *handle = nullptr;
+		if (_vfs.open(path, mode, &handle, _heap) != Ds::OPEN_OK) {
+			error("could not open ", path);
+			throw Failed();
+		}
+		return *handle;
+	}
+
+	/**
+	 * Write 'len' bytes of the model at 'offset' after filling them with 'seed'
+	 */
+	void _write(Vfs::Vfs_handle &handle, size_t offset, size_t len,
+	            unsigned seed)
+	{
+		for (size_t i = 0; i < len; i++)
+			_model[offset + i] = (char)((offset + i)*13 + (offset + i)/4096 + seed);
+
+		handle.seek(offset);
+
+		for (size_t done = 0; done < len; ) {
+
+			Vfs::file_size n = 0;
+			if (_vfs.write(&handle, _model + offset + done, len - done, n)
+			    != Fs::WRITE_OK || n == 0) {
+				error("write failed at offset ", handle.seek());
+				throw Failed();
+			}
+			handle.advance_seek(n);
+			done += n;
+		}
+	}
+
+	/**
+	 * Read the whole file in chunks and compare it with the model
+	 */
+	void _check(char const *what, Vfs::Vfs_handle &handle)
+	{
+		handle.seek(0);
+
+		for (size_t done = 0; done < FILE_SIZE; ) {
+
+			Vfs::file_size const len = min((size_t)CHUNK_SIZE, FILE_SIZE - done);
+			Vfs::file_size       n   = 0;
+
+			if (_vfs.read(&handle, _buf + done, len, n) != Fs::READ_OK || n == 0) {
+				error(what, ": read failed at offset ", done);
+				throw Failed();
+			}
+			handle.advance_seek(n);
+			done += n;
+		}
+
+		for (size_t i = 0; i < FILE_SIZE; i++) {
+			if (_buf[i] == _model[i])
+				continue;
+
+			error(what, ": unexpected content at offset ", i);
+			throw Failed();
+		}
+		log(what, ": ok");
+	}
+
+	void _check_direct(char const *what)
+	{
+		Vfs::Vfs_handle &handle = _open(DIRECT, Ds::OPEN_MODE_RDONLY);
+		Vfs::Vfs_handle::Guard guard(&handle);
+
+		_check(what, handle);
+	}
+
+	void _test()
+	{
+		{
+			Vfs::Vfs_handle &handle =
+				_open(CACHED, Ds::OPEN_MODE_RDWR | Ds::OPEN_MODE_CREATE);
+			Vfs::Vfs_handle::Guard guard(&handle);
+
+			/* unaligned writes of a file larger than the cache */
+			for (size_t offset = 0; offset < FILE_SIZE; offset += CHUNK_SIZE)
+				_write(handle, offset, min((size_t)CHUNK_SIZE, FILE_SIZE - offset), 0);
+
+			_check("read after write with eviction", handle);
+
+			/* partial writes within a page, across pages, and of many pages */
+			_write(handle, 100,        10,   1);
+			_write(handle, 4090,       20,   1);
+			_write(handle, 70000,      9000, 1);
+			_write(handle, FILE_SIZE - 1, 1, 1);
+
+			_check("read after partial writes", handle);
+
+			_vfs.sync(CACHED);
+			_check_direct("write back on sync");
+
+			_write(handle, 12345, 6789, 2);
+		}
+
+		_check_direct("write back on close");
+
+		/* partial writes via a write-only handle cannot read the page */
+		{
+			Vfs::Vfs_handle &handle = _open(CACHED, Ds::OPEN_MODE_WRONLY);
+			Vfs::Vfs_handle::Guard guard(&handle);
+
+			_write(handle, 200000 + 17, 100, 3);
+			_write(handle, 8192 + 5,    4096, 3);
+		}
+
+		{
+			Vfs::Vfs_handle &handle = _open(CACHED, Ds::OPEN_MODE_RDONLY);
+			Vfs::Vfs_handle::Guard guard(&handle);
+
+			_check("partial writes via write-only handle", handle);
+
+			/* writes via a read-only handle are rejected */
+			Vfs::file_size n = 0;
+			if (_vfs.write(&handle, _buf, 1, n) == Fs::WRITE_OK) {
+				error("write via read-only handle succeeded");
+				throw Failed();
+			}
+		}
+
+		_check_direct("content of the underlying file");
+
+		Ds::Stat st;
+		if (_vfs.stat(CACHED, st) != Ds::STAT_OK || st.size != FILE_SIZE) {
+			error("unexpected file size ", st.size);
+			throw Failed();
+		}
+
+		if (_vfs.unlink(CACHED) != Ds::UNLINK_OK) {
+			error("could not unlink ", CACHED);
+			throw Failed();
+		}
+	}
+
+	Main(Env &env) : _env(env)
+	{
+		try { _test(); }
+		catch (Failed) {
+			_env.parent().exit(-1);
+			return;
+		}
+
+		log("--- test finished ---");
+		_env.parent().exit(0);
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
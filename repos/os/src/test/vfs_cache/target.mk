@@ -0,0 +1,3 @@
+TARGET = test-vfs_cache
+SRC_CC = main.cc
+LIBS   = base vfs
@@ -0,0 +1,154 @@
+/*
+ * \brief  Benchmark of large directories
+ * \author Genode Labs
+ * \date   2017-03-30
+ *
+ * For each directory of the VFS root, the benchmark creates a sub directory
+ * with a configurable number of files, stats each file, lists the sub
+ * directory, and unlinks all files.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/attached_rom_dataspace.h>
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <timer_session/connection.h>
+#include <vfs/dir_file_system.h>
+#include <vfs/file_system_factory.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	typedef String<Vfs::MAX_PATH_LEN> Path;
+
+	struct Failed : Exception { };
+
+	struct Main;
+}
+
+
+struct Test::Main
+{
+	struct Io_response_handler : Vfs::Io_response_handler
+	{
+		void handle_io_response(Vfs::Vfs_handle::Context *) override { }
+	};
+
+	Env                            &_env;
+	Heap                            _heap    { _env.ram(), _env.rm() };
+	Attached_rom_dataspace          _config  { _env, "config" };
+	Timer::Connection               _timer   { _env };
+	Io_response_handler             _io_response_handler;
+	Vfs::Global_file_system_factory _factory { _heap };
+	Vfs::Dir_file_system            _vfs     { _env, _heap,
+	                                           _config.xml().sub_node("vfs"),
+	                                           _io_response_handler,
+	                                           _factory };
+
+	unsigned const _entries = _config.xml().attribute_value("entries", 100000U);
+
+	static Path _file_path(Path const &dir, unsigned i) {
+		return Path(dir, "/", i); }
+
+	/**
+	 * Measure duration of 'fn' applied to each entry
+	 */
+	template <typename FN>
+	void _measure(char const *what, Path const &dir, FN const &fn)
+	{
+		unsigned long const start_ms = _timer.elapsed_ms();
+
+		for (unsigned i = 0; i < _entries; i++)
+			fn(i);
+
+		unsigned long const ms = _timer.elapsed_ms() - start_ms;
+
+		log(dir, ": ", what, " ", _entries, " entries in ", ms, " ms (",
+		    (ms*1000) / _entries, " us/entry)");
+	}
+
+	void _bench(Path const &dir)
+	{
+		using namespace Vfs;
+
+		if (_vfs.mkdir(dir.string(), 0) != Directory_service::MKDIR_OK) {
+			error("could not create directory ", dir);
+			throw Failed();
+		}
+
+		_measure("created", dir, [&] (unsigned i) {
+			Vfs_handle *handle = nullptr;
+			if (_vfs.open(_file_path(dir, i).string(),
+			              Directory_service::OPEN_MODE_CREATE,
+			              &handle, _heap) != Directory_service::OPEN_OK) {
+				error("could not create ", _file_path(dir, i));
+				throw Failed();
+			}
+			Vfs_handle::Guard guard(handle);
+		});
+
+		_measure("stat'ed", dir, [&] (unsigned i) {
+			Directory_service::Stat st;
+			if (_vfs.stat(_file_path(dir, i).string(), st)
+			    != Directory_service::STAT_OK) {
+				error("could not stat ", _file_path(dir, i));
+				throw Failed();
+			}
+		});
+
+		if (_vfs.num_dirent(dir.string()) != _entries) {
+			error(dir, " has ", _vfs.num_dirent(dir.string()),
+			      " entries instead of ", _entries);
+			throw Failed();
+		}
+
+		_measure("listed", dir, [&] (unsigned i) {
+			Directory_service::Dirent dirent;
+			if (_vfs.dirent(dir.string(), i, dirent) != Directory_service::DIRENT_OK
+			 || dirent.type != Directory_service::DIRENT_TYPE_FILE) {
+				error("could not read entry ", i, " of ", dir);
+				throw Failed();
+			}
+		});
+
+		_measure("unlinked", dir, [&] (unsigned i) {
+			if (_vfs.unlink(_file_path(dir, i).string())
+			    != Directory_service::UNLINK_OK) {
+				error("could not unlink ", _file_path(dir, i));
+				throw Failed();
+			}
+		});
+
+		_vfs.unlink(dir.string());
+	}
+
+	Main(Env &env) : _env(env)
+	{
+		try {
+			_config.xml().sub_node("vfs").for_each_sub_node("dir",
+				[&] (Xml_node dir) {
+					typedef String<64> Name;
+					Name const name = dir.attribute_value("name", Name());
+					_bench(Path("/", name, "/bench"));
+			});
+		} catch (Failed) {
+			_env.parent().exit(-1);
+			return;
+		}
+
+		log("--- benchmark finished ---");
+		_env.parent().exit(0);
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
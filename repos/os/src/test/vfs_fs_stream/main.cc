@@ -0,0 +1,311 @@
+/*
+ * \brief  Test of read-ahead and write-behind of the VFS fs plugin
+ * \author Genode Labs
+ * \date   2017-04-06
+ *
+ * For each directory of the VFS root, the test streams a file through the
+ * VFS, checks that written data is visible to subsequent reads, and logs
+ * the throughput of sequential writes and reads. The directories are
+ * expected to host <fs> nodes with different 'read_ahead' and
+ * 'write_behind' settings.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/attached_ram_dataspace.h>
+#include <base/attached_rom_dataspace.h>
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <timer_session/connection.h>
+#include <vfs/dir_file_system.h>
+#include <vfs/file_system_factory.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	typedef String<Vfs::MAX_PATH_LEN> Path;
+
+	struct Failed : Exception { };
+
+	struct Main;
+}
+
+
+struct Test::Main
+{
+	struct Io_response_handler : Vfs::Io_response_handler
+	{
+		void handle_io_response(Vfs::Vfs_handle::Context *) override { }
+	};
+
+	typedef Vfs::Directory_service   Ds;
+	typedef Vfs::File_io_service     Fs;
+
+	Env                            &_env;
+	Heap                            _heap    { _env.ram(), _env.rm() };
+	Attached_rom_dataspace          _config  { _env, "config" };
+	Timer::Connection               _timer   { _env };
+	Io_response_handler             _io_response_handler;
+	Vfs::Global_file_system_factory _factory { _heap };
+	Vfs::Dir_file_system            _vfs     { _env, _heap,
+	                                           _config.xml().sub_node("vfs"),
+	                                           _io_response_handler,
+	                                           _factory };
+
+	size_t const _file_size =
+		_config.xml().attribute_value("file_size", Number_of_bytes(8*1024*1024));
+
+	size_t const _chunk_size =
+		_config.xml().attribute_value("chunk_size", Number_of_bytes(16*1024));
+
+	Attached_ram_dataspace _buf_ds { _env.ram(), _env.rm(), _chunk_size };
+
+	char * const _buf = _buf_ds.local_addr<char>();
+
+	/**
+	 * Content expected at 'offset' after writing with 'seed'
+	 */
+	static char _pattern(size_t offset, unsigned seed) {
+		return (char)(offset*7 + (offset >> 12) + seed); }
+
+	void _fill(size_t offset, size_t len, unsigned seed)
+	{
+		for (size_t i = 0; i < len; i++)
+			_buf[i] = _pattern(offset + i, seed);
+	}
+
+	void _check(Path const &path, size_t offset, size_t len, unsigned seed)
+	{
+		for (size_t i = 0; i < len; i++) {
+			if (_buf[i] == _pattern(offset + i, seed))
+				continue;
+
+			error(path, ": unexpected content at offset ", offset + i);
+			throw Failed();
+		}
+	}
+
+	Vfs::Vfs_handle &_open(Path const &path, unsigned mode)
+	{
+		Vfs::Vfs_handle *handle = nullptr;
+		if (_vfs.open(path.string(), mode, &handle, _heap) != Ds::OPEN_OK) {
+			error("could not open ", path);
+			throw Failed();
+		}
+		return *handle;
+	}
+
+	void _write(Path const &path, Vfs::Vfs_handle &handle, size_t len)
+	{
+		for (size_t done = 0; done < len; ) {
+
+			Vfs::file_size n = 0;
+			if (_vfs.write(&handle, _buf + done, len - done, n) != Fs::WRITE_OK
+			 || n == 0) {
+				error(path, ": write failed at offset ", handle.seek());
+				throw Failed();
+			}
+			handle.advance_seek(n);
+			done += n;
+		}
+	}
+
+	void _read(Path const &path, Vfs::Vfs_handle &handle, size_t len)
+	{
+		for (size_t done = 0; done < len; ) {
+
+			Fs::Read_result result = Fs::READ_OK;
+			Vfs::file_size  n      = 0;
+
+			while (!_vfs.queue_read(&handle, _buf + done, len - done, result, n))
+				_env.ep().wait_and_dispatch_one_signal();
+
+			while (result == Fs::READ_QUEUED) {
+				result = _vfs.complete_read(&handle, _buf + done, len - done, n);
+				if (result == Fs::READ_QUEUED)
+					_env.ep().wait_and_dispatch_one_signal();
+			}
+
+			if (result != Fs::READ_OK || n == 0) {
+				error(path, ": read failed at offset ", handle.seek());
+				throw Failed();
+			}
+			handle.advance_seek(n);
+			done += n;
+		}
+	}
+
+	void _log(Path const &dir, char const *what, unsigned long ms)
+	{
+		log(dir, ": ", what, " ", _file_size/1024, " KiB in ", ms, " ms (",
+		    ms ? (_file_size/1024*1000)/ms : 0, " KiB/s)");
+	}
+
+	/**
+	 * Stream file sequentially in chunks
+	 */
+	void _stream(Path const &dir, Path const &path)
+	{
+		/* write */
+		{
+			unsigned const mode = Ds::OPEN_MODE_WRONLY | Ds::OPEN_MODE_CREATE;
+
+			Vfs::Vfs_handle &handle = _open(path, mode);
+			Vfs::Vfs_handle::Guard guard(&handle);
+
+			unsigned long const start_ms = _timer.elapsed_ms();
+
+			for (size_t offset = 0; offset < _file_size; offset += _chunk_size) {
+				_fill(offset, _chunk_size, 0);
+				_write(path, handle, _chunk_size);
+			}
+			_vfs.sync(path.string());
+
+			_log(dir, "wrote", _timer.elapsed_ms() - start_ms);
+		}
+
+		/* the size must account for all written-behind data */
+		Ds::Stat st;
+		if (_vfs.stat(path.string(), st) != Ds::STAT_OK || st.size != _file_size) {
+			error(path, ": unexpected file size ", st.size);
+			throw Failed();
+		}
+
+		/* read */
+		{
+			Vfs::Vfs_handle &handle = _open(path, Ds::OPEN_MODE_RDONLY);
+			Vfs::Vfs_handle::Guard guard(&handle);
+
+			unsigned long const start_ms = _timer.elapsed_ms();
+
+			for (size_t offset = 0; offset < _file_size; offset += _chunk_size) {
+				_read(path, handle, _chunk_size);
+				_check(path, offset, _chunk_size, 0);
+			}
+
+			_log(dir, "read", _timer.elapsed_ms() - start_ms);
+		}
+	}
+
+	/**
+	 * Check that reads observe preceding writes
+	 */
+	void _read_after_write(Path const &path)
+	{
+		Vfs::Vfs_handle &handle = _open(path, Ds::OPEN_MODE_RDWR);
+		Vfs::Vfs_handle::Guard guard(&handle);
+
+		Vfs::Vfs_handle &reader = _open(path, Ds::OPEN_MODE_RDONLY);
+		Vfs::Vfs_handle::Guard reader_guard(&reader);
+
+		/* start a sequential read, so reads ahead are in flight */
+		reader.seek(0);
+		_read(path, reader, _chunk_size);
+		_check(path, 0, _chunk_size, 0);
+
+		/*
+		 * Overwrite chunks with a new seed and read each chunk back via the
+		 * same handle while the write may still be pending
+		 */
+		for (size_t offset = 0; offset < 4*_chunk_size; offset += _chunk_size) {
+
+			handle.seek(offset);
+			_fill(offset, _chunk_size, 1);
+			_write(path, handle, _chunk_size);
+
+			handle.seek(offset);
+			_read(path, handle, _chunk_size);
+			_check(path, offset, _chunk_size, 1);
+		}
+
+		/* a partial overwrite in the middle of a chunk */
+		size_t const offset = 5*_chunk_size + _chunk_size/3;
+		handle.seek(offset);
+		_fill(offset, _chunk_size/2, 2);
+		_write(path, handle, _chunk_size/2);
+
+		handle.seek(offset - _chunk_size/3);
+		_read(path, handle, _chunk_size);
+		for (size_t i = 0; i < _chunk_size; i++) {
+			size_t   const pos  = offset - _chunk_size/3 + i;
+			unsigned const seed = (pos >= offset && pos < offset + _chunk_size/2)
+			                    ? 2 : 0;
+			if (_buf[i] != _pattern(pos, seed)) {
+				error(path, ": partial overwrite not visible at offset ", pos);
+				throw Failed();
+			}
+		}
+
+		/* after sync, the writes are visible to other handles */
+		_vfs.sync(path.string());
+
+		reader.seek(_chunk_size);
+		_read(path, reader, _chunk_size);
+		_check(path, _chunk_size, _chunk_size, 1);
+
+		/* a seek of the reader discards its reads ahead */
+		reader.seek(0);
+		_read(path, reader, _chunk_size);
+		_check(path, 0, _chunk_size, 1);
+
+		/* extending write followed by the file size */
+		handle.seek(_file_size);
+		_fill(_file_size, _chunk_size, 3);
+		_write(path, handle, _chunk_size);
+
+		Ds::Stat st;
+		if (_vfs.stat(path.string(), st) != Ds::STAT_OK
+		 || st.size != _file_size + _chunk_size) {
+			error(path, ": size ", st.size, " does not reflect extending write");
+			throw Failed();
+		}
+
+		/* reading beyond the end of the file yields the written data */
+		handle.seek(_file_size);
+		_read(path, handle, _chunk_size);
+		_check(path, _file_size, _chunk_size, 3);
+	}
+
+	void _test(Path const &dir)
+	{
+		Path const path(dir, "/stream");
+
+		_stream(dir, path);
+		_read_after_write(path);
+
+		if (_vfs.unlink(path.string()) != Ds::UNLINK_OK) {
+			error("could not unlink ", path);
+			throw Failed();
+		}
+		log(dir, ": read-after-write consistent");
+	}
+
+	Main(Env &env) : _env(env)
+	{
+		try {
+			_config.xml().sub_node("vfs").for_each_sub_node("dir",
+				[&] (Xml_node dir) {
+					typedef String<64> Name;
+					Name const name = dir.attribute_value("name", Name());
+					_test(Path("/", name));
+			});
+		} catch (Failed) {
+			_env.parent().exit(-1);
+			return;
+		}
+
+		log("--- test finished ---");
+		_env.parent().exit(0);
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
@@ -0,0 +1,3 @@
+TARGET = test-vfs_fs_stream
+SRC_CC = main.cc
+LIBS   = base vfs
@@ -428,7 +428,7 @@ struct Noux::Sysio
 		                        { Select_fds fds; });
 
 		SYSIO_DECL(fork,        { addr_t ip; addr_t sp;
-		                          addr_t parent_cap_addr; },
+		                          addr_t parent_cap_addr; bool vfork; },
 		                        { int pid; });
 
 		SYSIO_DECL(getpid,      { }, { int pid; });
@@ -566,6 +566,7 @@ extern "C" void fork_trampoline()
 
 
 static pid_t fork_result;
+static bool  fork_vfork;
 
 
 /**
@@ -600,6 +601,7 @@ static void suspended_callback()
 		sysio()->fork_in.ip = (Genode::addr_t)(&fork_trampoline);
 		sysio()->fork_in.sp = Abi::stack_align((Genode::addr_t)&stack[STACK_SIZE]);
 		sysio()->fork_in.parent_cap_addr = (Genode::addr_t)(&new_parent);
+		sysio()->fork_in.vfork           = fork_vfork;
 
 		if (!noux_syscall(Noux::Session::SYSCALL_FORK)) {
 			error("fork error ", (int)sysio()->error.general);
@@ -621,13 +623,27 @@ namespace Libc { void schedule_suspend(void (*suspended) ()); }
 
 extern "C" pid_t fork(void)
 {
+	fork_vfork = false;
+
 	Libc::schedule_suspend(suspended_callback);
 
 	return fork_result;
 }
 
 
-extern "C" pid_t vfork(void) { return fork(); }
+/*
+ * The new process does not share the address space with the caller. But
+ * noux suspends the caller until the new process executes another binary or
+ * exits, which saves the caller from copying the pages it writes meanwhile.
+ */
+extern "C" pid_t vfork(void)
+{
+	fork_vfork = true;
+
+	Libc::schedule_suspend(suspended_callback);
+
+	return fork_result;
+}
 
 
 extern "C" pid_t getpid(void)
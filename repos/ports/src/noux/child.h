@@ -158,11 +158,34 @@ class Noux::Child : public Rpc_object<Session>,
 		Pd_service::Single_session_factory _pd_factory { _pd };
 		Pd_service                         _pd_service { _pd_factory };
 
+		/**
+		 * Managed dataspaces used for the copy-on-write RAM dataspaces
+		 */
+		Rm_connection _cow_rm { _env };
+
+		/*
+		 * A write fault that cannot be resolved leaves the faulting thread
+		 * blocked forever, so we terminate the process instead.
+		 */
+		void _handle_unresolvable_fault()
+		{
+			if (exited())
+				return;
+
+			error("terminating ", _name, " after unresolvable copy-on-write fault");
+			_child_policy.exit(-1);
+		}
+
+		Signal_handler<Child> _unresolvable_fault_handler {
+			_env.ep(), *this, &Child::_handle_unresolvable_fault };
+
+		Cow_env _cow_env { _env, _cow_rm, _unresolvable_fault_handler };
+
 		/**
 		 * Locally-provided RAM service
 		 */
 		typedef Local_service<Ram_session_component> Ram_service;
-		Ram_session_component _ram { _ref_ram, _heap, _ep, _ds_registry };
+		Ram_session_component _ram { _ref_ram, _heap, _ep, _ds_registry, &_cow_env };
 		Ram_service::Single_session_factory _ram_factory { _ram };
 		Ram_service                         _ram_service { _ram_factory };
 
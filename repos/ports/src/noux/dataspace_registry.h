@@ -22,6 +22,7 @@ namespace Noux {
 	class Dataspace_user;
 	class Dataspace_info;
 	class Dataspace_registry;
+	class Ram_session_component;
 
 	struct Static_dataspace_info;
 
@@ -89,7 +90,8 @@ class Noux::Dataspace_info : public Object_pool<Dataspace_info>::Entry
 		/**
 		 * Create shadow copy of dataspace
 		 *
-		 * \param ram          backing store used for copied dataspaces
+		 * \param ram          RAM session of the new process, used for
+		 *                     copied dataspaces
 		 * \param local_rm     region map used for temporarily attaching
 		 *                     dataspaces to the local address space
 		 * \param alloc        allocator used for creatng new 'Dataspace_info'
@@ -100,13 +102,17 @@ class Noux::Dataspace_info : public Object_pool<Dataspace_info>::Entry
 		 *                     interface of the new dataspace
 		 *                     (used if the dataspace is a sub
 		 *                     RM session)
+		 * \param vfork        true if the forking process is suspended
+		 *                     until the new process executes another
+		 *                     binary or exits
 		 * \return             capability for the new dataspace
 		 */
-		virtual Dataspace_capability fork(Ram_session        &ram,
-		                                  Region_map         &local_rm,
-		                                  Allocator          &alloc,
-		                                  Dataspace_registry &ds_registry,
-		                                  Rpc_entrypoint     &ep) = 0;
+		virtual Dataspace_capability fork(Ram_session_component &ram,
+		                                  Region_map            &local_rm,
+		                                  Allocator             &alloc,
+		                                  Dataspace_registry    &ds_registry,
+		                                  Rpc_entrypoint        &ep,
+		                                  bool                   vfork) = 0;
 
 		/**
 		 * Write raw byte sequence into dataspace
@@ -186,11 +192,12 @@ struct Noux::Static_dataspace_info : Dataspace_info
 		_ds_registry.apply(ds_cap(), lambda);
 	}
 
-	Dataspace_capability fork(Ram_session        &,
-	                          Region_map         &,
-	                          Allocator          &,
-	                          Dataspace_registry &,
-	                          Rpc_entrypoint     &) override
+	Dataspace_capability fork(Ram_session_component &,
+	                          Region_map            &,
+	                          Allocator             &,
+	                          Dataspace_registry    &,
+	                          Rpc_entrypoint        &,
+	                          bool) override
 	{
 		return ds_cap();
 	}
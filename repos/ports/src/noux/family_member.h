@@ -37,6 +37,52 @@ class Noux::Family_member : public List<Family_member>::Element,
 		bool                _has_exited;
 		int                 _exit_status;
 
+		/*
+		 * Parent that is suspended until we execute another binary or
+		 * exit, and the child the parent waits for, used for vfork
+		 */
+		Family_member *_vfork_parent = nullptr;
+		Family_member *_vfork_child  = nullptr;
+		Lock           _vfork_blocker { Lock::LOCKED };
+
+		/**
+		 * Lock protecting the vfork relationship of all processes
+		 *
+		 * The relationship is changed by both the parent and the child.
+		 */
+		static Lock &_vfork_lock()
+		{
+			static Lock lock;
+			return lock;
+		}
+
+		void _resume_vfork_parent()
+		{
+			Lock::Guard guard(_vfork_lock());
+
+			if (!_vfork_parent)
+				return;
+
+			_vfork_parent->_vfork_child = nullptr;
+			_vfork_parent->_vfork_blocker.unlock();
+			_vfork_parent = nullptr;
+		}
+
+		/**
+		 * Detach the vfork child, which must not resume us anymore
+		 */
+		void _forget_vfork_child()
+		{
+			Lock::Guard guard(_vfork_lock());
+
+			if (!_vfork_child)
+				return;
+
+			_vfork_child->_vfork_parent = nullptr;
+			_vfork_child = nullptr;
+			_vfork_blocker.unlock();
+		}
+
 	protected:
 
 		/**
@@ -51,12 +97,22 @@ class Noux::Family_member : public List<Family_member>::Element,
 		: _pid(pid), _has_exited(false), _exit_status(0)
 		{ }
 
-		virtual ~Family_member() { }
+		/*
+		 * The destructor is executed after the resources of the process
+		 * got released, e.g., after executing another binary.
+		 */
+		virtual ~Family_member()
+		{
+			_resume_vfork_parent();
+			_forget_vfork_child();
+		}
 
 		int pid() const { return _pid; }
 
 		int exit_status() const { return _exit_status; }
 
+		bool exited() const { return _has_exited; }
+
 		/**
 		 * Called by the parent at creation time of the process
 		 */
@@ -139,8 +195,29 @@ class Noux::Family_member : public List<Family_member>::Element,
 		{
 			_exit_status = exit_status;
 			_has_exited  = true;
+
+			_resume_vfork_parent();
+		}
+
+		/**
+		 * Suspend parent until we execute another binary or exit
+		 *
+		 * Called by the parent before starting a process created via
+		 * vfork. The parent blocks in 'wait_for_vfork_child'.
+		 */
+		void suspend_parent(Family_member &parent)
+		{
+			Lock::Guard guard(_vfork_lock());
+
+			_vfork_parent = &parent;
+			parent._vfork_child = this;
 		}
 
+		/**
+		 * Block until the vfork child executed another binary or exited
+		 */
+		void wait_for_vfork_child() { _vfork_blocker.lock(); }
+
 		Family_member *poll4()
 		{
 			Lock::Guard guard(_lock);
@@ -75,17 +75,18 @@ class Noux::Pd_session_component : public Rpc_object<Pd_session>
 		Region_map &linker_area_region_map()   { return _linker_area;   }
 		Region_map &stack_area_region_map()    { return _stack_area;    }
 
-		void replay(Ram_session          &dst_ram,
-		            Pd_session_component &dst_pd,
-		            Region_map           &local_rm,
-		            Allocator            &alloc,
-		            Dataspace_registry   &ds_registry,
-		            Rpc_entrypoint       &ep)
+		void replay(Ram_session_component &dst_ram,
+		            Pd_session_component  &dst_pd,
+		            Region_map            &local_rm,
+		            Allocator             &alloc,
+		            Dataspace_registry    &ds_registry,
+		            Rpc_entrypoint        &ep,
+		            bool                   vfork)
 		{
 			/* replay region map into new protection domain */
-			_stack_area   .replay(dst_ram, dst_pd.stack_area_region_map(),    local_rm, alloc, ds_registry, ep);
-			_linker_area  .replay(dst_ram, dst_pd.linker_area_region_map(),   local_rm, alloc, ds_registry, ep);
-			_address_space.replay(dst_ram, dst_pd.address_space_region_map(), local_rm, alloc, ds_registry, ep);
+			_stack_area   .replay(dst_ram, dst_pd.stack_area_region_map(),    local_rm, alloc, ds_registry, ep, vfork);
+			_linker_area  .replay(dst_ram, dst_pd.linker_area_region_map(),   local_rm, alloc, ds_registry, ep, vfork);
+			_address_space.replay(dst_ram, dst_pd.address_space_region_map(), local_rm, alloc, ds_registry, ep, vfork);
 
 			Region_map &dst_address_space = dst_pd.address_space_region_map();
 			Region_map &dst_stack_area    = dst_pd.stack_area_region_map();
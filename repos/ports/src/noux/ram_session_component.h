@@ -11,6 +11,11 @@
  * dataspaces allocated by each Noux process. When forking a process, the
  * acquired information (in the form of 'Ram_dataspace_info' objects) is used
  * to create a shadow copy of the forking address space.
+ *
+ * The RAM dataspaces of Noux processes are managed dataspaces with
+ * copy-on-write semantics ('Cow_dataspace_info'). Hence, the shadow copy
+ * shares the memory with the forking process until one of both processes
+ * writes to it.
  */
 
 /*
@@ -25,14 +30,24 @@
 
 /* Genode includes */
 #include <ram_session/client.h>
+#include <rm_session/connection.h>
+#include <region_map/client.h>
+#include <base/attached_dataspace.h>
 #include <base/rpc_server.h>
+#include <base/signal.h>
+#include <base/thread.h>
+#include <util/avl_tree.h>
+#include <util/retry.h>
 
 /* Noux includes */
 #include <dataspace_registry.h>
 
 namespace Noux {
 	struct Ram_dataspace_info;
-	struct Ram_session_component;
+	class  Cow_env;
+	class  Cow_backing;
+	class  Cow_dataspace_info;
+	class  Ram_session_component;
 	using namespace Genode;
 }
 
@@ -43,34 +58,27 @@ struct Noux::Ram_dataspace_info : Dataspace_info,
 	Ram_dataspace_info(Ram_dataspace_capability ds_cap)
 	: Dataspace_info(ds_cap) { }
 
-	Dataspace_capability fork(Ram_session        &ram,
-	                          Region_map         &local_rm,
-	                          Allocator          &alloc,
-	                          Dataspace_registry &ds_registry,
-	                          Rpc_entrypoint     &) override
+	/**
+	 * Release backing store of the dataspace
+	 *
+	 * \param ram  RAM session the dataspace was allocated from
+	 */
+	virtual void free(Ram_session &ram)
 	{
-		size_t const size = Dataspace_client(ds_cap()).size();
-		Ram_dataspace_capability dst_ds_cap;
-
-		try {
-			dst_ds_cap = ram.alloc(size);
-
-			Attached_dataspace src_ds(local_rm, ds_cap());
-			Attached_dataspace dst_ds(local_rm, dst_ds_cap);
-			memcpy(dst_ds.local_addr<char>(), src_ds.local_addr<char>(), size);
-
-			ds_registry.insert(new (alloc) Ram_dataspace_info(dst_ds_cap));
-			return dst_ds_cap;
+		ram.free(static_cap_cast<Ram_dataspace>(ds_cap()));
+	}
 
-		} catch (...) {
-			error("fork of RAM dataspace failed");
+	/**
+	 * Write-protect memory shared with other dataspaces
+	 */
+	virtual void protect_shared() { }
 
-			if (dst_ds_cap.valid())
-				ram.free(dst_ds_cap);
-
-			return Dataspace_capability();
-		}
-	}
+	inline Dataspace_capability fork(Ram_session_component &ram,
+	                                 Region_map            &local_rm,
+	                                 Allocator             &alloc,
+	                                 Dataspace_registry    &ds_registry,
+	                                 Rpc_entrypoint        &,
+	                                 bool                   vfork) override;
 
 	void poke(Region_map &rm, addr_t dst_offset, char const *src, size_t len) override
 	{
@@ -89,6 +97,701 @@ struct Noux::Ram_dataspace_info : Dataspace_info,
 };
 
 
+/**
+ * Facilities used by the copy-on-write dataspaces of a Noux process
+ */
+class Noux::Cow_env : Noncopyable
+{
+	private:
+
+		enum { RM_UPGRADE = 8*1024, STACK_SIZE = 4*1024*sizeof(long) };
+
+		/**
+		 * Thread that resolves the write faults of the process
+		 *
+		 * The faults are not handled by the entrypoint of Noux because
+		 * copying pages would stall all other processes meanwhile.
+		 */
+		struct Fault_thread : Thread
+		{
+			Signal_receiver &receiver;
+
+			Fault_thread(Genode::Env &env, Signal_receiver &receiver)
+			:
+				Thread(env, "cow_faults", STACK_SIZE), receiver(receiver)
+			{
+				start();
+			}
+
+			void entry() override
+			{
+				for (;;) {
+					Signal signal = receiver.wait_for_signal();
+
+					static_cast<Signal_dispatcher_base *>(signal.context())
+						->dispatch(signal.num());
+				}
+			}
+		};
+
+		Lock   _lock;
+		size_t _used = 0;
+
+	public:
+
+		Region_map    &local_rm;  /* used for copying pages */
+		Rm_connection &rm;        /* provides the managed dataspaces */
+
+		/* terminates the process if a fault cannot be resolved */
+		Signal_context_capability const unresolvable_fault;
+
+		Signal_receiver faults;
+
+	private:
+
+		Fault_thread _fault_thread;
+
+	public:
+
+		Cow_env(Genode::Env &env, Rm_connection &rm,
+		        Signal_context_capability unresolvable_fault)
+		:
+			local_rm(env.rm()), rm(rm), unresolvable_fault(unresolvable_fault),
+			_fault_thread(env, faults)
+		{ }
+
+		/**
+		 * Account memory allocated on behalf of the process
+		 */
+		void charge(size_t size)
+		{
+			Lock::Guard guard(_lock);
+			_used += size;
+		}
+
+		void uncharge(size_t size)
+		{
+			Lock::Guard guard(_lock);
+			_used -= size;
+		}
+
+		/**
+		 * Return memory allocated on behalf of the process in addition to
+		 * the sizes of its RAM dataspaces
+		 */
+		size_t used()
+		{
+			Lock::Guard guard(_lock);
+			return _used;
+		}
+
+		/**
+		 * Upgrade the RM session on behalf of the process
+		 */
+		void upgrade_rm()
+		{
+			rm.upgrade_ram(RM_UPGRADE);
+			charge(RM_UPGRADE);
+		}
+
+		Capability<Region_map> create_region_map(size_t size)
+		{
+			return retry<Rm_session::Out_of_metadata>(
+				[&] () { return rm.create(size); },
+				[&] () { upgrade_rm(); });
+		}
+};
+
+
+/**
+ * RAM dataspace referenced by copy-on-write dataspaces
+ */
+class Noux::Cow_backing : Noncopyable
+{
+	private:
+
+		Ram_session             &_ram;
+		Ram_dataspace_capability _ds;
+		size_t             const _size;
+
+		Lock     _lock;
+		unsigned _users = 0;
+
+	public:
+
+		Cow_backing(Ram_session &ram, size_t size, Cache_attribute cached)
+		: _ram(ram), _ds(ram.alloc(size, cached)), _size(size) { }
+
+		~Cow_backing() { _ram.free(_ds); }
+
+		Ram_dataspace_capability ds() const { return _ds; }
+
+		size_t size() const { return _size; }
+
+		void acquire()
+		{
+			Lock::Guard guard(_lock);
+			_users++;
+		}
+
+		/**
+		 * Drop reference
+		 *
+		 * \return true if the backing store is not used anymore
+		 */
+		bool release()
+		{
+			Lock::Guard guard(_lock);
+			return --_users == 0;
+		}
+
+		/**
+		 * Return true if only one dataspace uses the backing store
+		 */
+		bool exclusive()
+		{
+			Lock::Guard guard(_lock);
+			return _users == 1;
+		}
+};
+
+
+/**
+ * RAM dataspace with copy-on-write semantics
+ *
+ * The dataspace is a managed dataspace composed of extents of backing
+ * stores. A forked dataspace shares the backing stores of its origin, and
+ * the shared extents of both dataspaces are attached read-only. The first
+ * write access to a page of such an extent is reflected as region-map fault,
+ * which is resolved by copying the page to a backing store private to the
+ * dataspace. If no other dataspace uses the backing store of the extent
+ * anymore, the extent is attached writeable without copying.
+ *
+ * Private copies of adjacent pages are merged into one extent if their
+ * copies are adjacent in the backing store, which is the case for pages
+ * written in ascending or descending order. This keeps the number of
+ * extents and region-map attachments low.
+ */
+class Noux::Cow_dataspace_info : public Ram_dataspace_info
+{
+	public:
+
+		enum { PAGE_SIZE_LOG2 = 12, PAGE_SIZE = 1 << PAGE_SIZE_LOG2 };
+
+	private:
+
+		/* number of pages allocated at once for private copies */
+		enum { SPARE_PAGES = 16 };
+
+		/* maximum number of extents replaced at once */
+		enum { MAX_REPLACED = 3 };
+
+		struct Extent : Avl_node<Extent>
+		{
+			addr_t const offset;
+			size_t const size;
+			Cow_backing &backing;
+			addr_t const backing_offset;
+			bool         writeable;
+
+			Extent(addr_t offset, size_t size, Cow_backing &backing,
+			       addr_t backing_offset, bool writeable)
+			:
+				offset(offset), size(size), backing(backing),
+				backing_offset(backing_offset), writeable(writeable)
+			{ }
+
+			addr_t end() const { return offset + size; }
+
+			bool contains(addr_t addr) const {
+				return addr >= offset && addr - offset < size; }
+
+			/**
+			 * Avl_node interface
+			 */
+			bool higher(Extent *e) { return e->offset > offset; }
+
+			Extent *find_by_offset(addr_t addr)
+			{
+				if (contains(addr)) return this;
+
+				Extent *e = child(addr > offset);
+				return e ? e->find_by_offset(addr) : nullptr;
+			}
+		};
+
+		/**
+		 * Backing store used by the dataspace
+		 */
+		struct Backing_ref : List<Backing_ref>::Element
+		{
+			Cow_backing &backing;
+			unsigned     uses    = 0;  /* extents, and the role as spare */
+			size_t       charged = 0;  /* accounted to the process */
+
+			Backing_ref(Cow_backing &backing) : backing(backing) { }
+		};
+
+		/**
+		 * Page of a backing store attached to the local address space
+		 */
+		struct Attached_page
+		{
+			Region_map &rm;
+			char * const ptr;
+
+			Attached_page(Region_map &rm, Dataspace_capability ds, addr_t offset)
+			: rm(rm), ptr(rm.attach(ds, PAGE_SIZE, offset)) { }
+
+			~Attached_page() { rm.detach(ptr); }
+		};
+
+		Cow_env                     &_env;
+		Allocator                   &_alloc;
+		Ram_session                 &_ram;
+		Cache_attribute        const _cached;
+		Capability<Region_map> const _rm_cap;
+		Region_map_client            _rm { _rm_cap };
+
+		Lock              _lock;
+		Avl_tree<Extent>  _extents;
+		List<Backing_ref> _backings;
+
+		/* backing store for private copies, of which 'spare_used' bytes are taken */
+		Cow_backing *_spare      = nullptr;
+		size_t       _spare_used = 0;
+
+		Signal_dispatcher<Cow_dataspace_info> _fault_dispatcher {
+			_env.faults, *this, &Cow_dataspace_info::_handle_fault };
+
+		/**
+		 * Reference backing store
+		 *
+		 * \param charge  memory accounted to the process while the
+		 *                dataspace references the backing store, applies
+		 *                only to backing stores not referenced yet
+		 */
+		void _use(Cow_backing &backing, size_t charge = 0)
+		{
+			for (Backing_ref *r = _backings.first(); r; r = r->next())
+				if (&r->backing == &backing) {
+					r->uses++;
+					return;
+				}
+
+			Backing_ref *r = new (_alloc) Backing_ref(backing);
+			r->uses    = 1;
+			r->charged = charge;
+			backing.acquire();
+			_backings.insert(r);
+			_env.charge(charge);
+		}
+
+		void _unuse(Cow_backing &backing)
+		{
+			for (Backing_ref *r = _backings.first(); r; r = r->next()) {
+				if (&r->backing != &backing)
+					continue;
+
+				if (--r->uses)
+					return;
+
+				_backings.remove(r);
+				_env.uncharge(r->charged);
+				destroy(_alloc, r);
+
+				if (backing.release())
+					destroy(_alloc, &backing);
+				return;
+			}
+		}
+
+		void _attach(Extent const &e)
+		{
+			retry<Region_map::Out_of_metadata>(
+				[&] () {
+					_rm.attach(e.backing.ds(), e.size, e.backing_offset,
+					           true, e.offset, false, e.writeable); },
+				[&] () { _env.upgrade_rm(); });
+		}
+
+		void _add(addr_t offset, size_t size, Cow_backing &backing,
+		          addr_t backing_offset, bool writeable)
+		{
+			_use(backing);
+
+			Extent *e = nullptr;
+			try {
+				e = new (_alloc) Extent(offset, size, backing, backing_offset,
+				                        writeable);
+				_attach(*e);
+			} catch (...) {
+				if (e) destroy(_alloc, e);
+				_unuse(backing);
+				throw;
+			}
+			_extents.insert(e);
+		}
+
+		/**
+		 * Change the access rights of an extent
+		 *
+		 * If the extent cannot be attached with the new rights, the old
+		 * rights are restored and the exception is propagated.
+		 */
+		void _reattach(Extent &e, bool writeable)
+		{
+			bool const old_writeable = e.writeable;
+
+			_rm.detach(e.offset);
+			e.writeable = writeable;
+
+			try { _attach(e); }
+			catch (...) {
+				e.writeable = old_writeable;
+				_attach(e);
+				throw;
+			}
+		}
+
+		template <typename FN>
+		static void _for_each(Extent * const (&extents)[MAX_REPLACED], FN const &fn)
+		{
+			for (unsigned i = 0; i < MAX_REPLACED && extents[i]; i++)
+				fn(*extents[i]);
+		}
+
+		/**
+		 * Replace extents by new extents that cover the same range
+		 *
+		 * The arrays are terminated by a nullptr if not full. The new
+		 * extents are owned by the method. If they cannot be attached, the
+		 * old extents are restored and the exception is propagated.
+		 */
+		void _replace(Extent * const (&old_extents)[MAX_REPLACED],
+		              Extent * const (&new_extents)[MAX_REPLACED])
+		{
+			/* the backing stores are already referenced by the dataspace */
+			_for_each(new_extents, [&] (Extent &e) { _use(e.backing); });
+
+			_for_each(old_extents, [&] (Extent &e) { _rm.detach(e.offset); });
+
+			unsigned attached = 0;
+			try {
+				_for_each(new_extents, [&] (Extent &e) {
+					_attach(e);
+					attached++; });
+			}
+			catch (...) {
+				for (unsigned i = 0; i < attached; i++)
+					_rm.detach(new_extents[i]->offset);
+
+				_for_each(old_extents, [&] (Extent &e) {
+					try { _attach(e); }
+					catch (...) {
+						error("could not restore copy-on-write extent at offset ",
+						      Hex(e.offset)); }
+				});
+
+				_for_each(new_extents, [&] (Extent &e) {
+					Cow_backing &backing = e.backing;
+					destroy(_alloc, &e);
+					_unuse(backing); });
+				throw;
+			}
+
+			_for_each(old_extents, [&] (Extent &e) {
+				Cow_backing &backing = e.backing;
+				_extents.remove(&e);
+				destroy(_alloc, &e);
+				_unuse(backing); });
+
+			_for_each(new_extents, [&] (Extent &e) { _extents.insert(&e); });
+		}
+
+		Extent *_lookup(addr_t offset)
+		{
+			return _extents.first() ? _extents.first()->find_by_offset(offset)
+			                        : nullptr;
+		}
+
+		/**
+		 * Allocate page of backing store for a private copy
+		 *
+		 * \param backing_offset  offset of the page within the returned
+		 *                        backing store
+		 */
+		Cow_backing &_alloc_page(addr_t &backing_offset)
+		{
+			if (!_spare || _spare_used == _spare->size()) {
+
+				size_t const spare_size = min(size(), (size_t)SPARE_PAGES*PAGE_SIZE);
+
+				Cow_backing *spare = new (_alloc) Cow_backing(_ram, spare_size, _cached);
+
+				try { _use(*spare, spare_size); }
+				catch (...) {
+					destroy(_alloc, spare);
+					throw;
+				}
+
+				if (_spare)
+					_unuse(*_spare);
+
+				_spare      = spare;
+				_spare_used = 0;
+			}
+
+			backing_offset = _spare_used;
+			_spare_used   += PAGE_SIZE;
+			return *_spare;
+		}
+
+		/**
+		 * Revert '_alloc_page'
+		 */
+		void _free_page(Cow_backing &backing, addr_t backing_offset)
+		{
+			if (&backing == _spare && backing_offset + PAGE_SIZE == _spare_used)
+				_spare_used = backing_offset;
+		}
+
+		/**
+		 * Replace page of extent 'e' by its private copy
+		 *
+		 * \return extent that covers the page
+		 */
+		Extent &_replace_page(Extent &e, addr_t page, Cow_backing &backing,
+		                      addr_t backing_offset)
+		{
+			/* private neighbours continued by the copy in the backing store */
+			Extent *left = (page == e.offset && page) ? _lookup(page - 1) : nullptr;
+			if (left && !(left->writeable && &left->backing == &backing
+			           && left->backing_offset + left->size == backing_offset))
+				left = nullptr;
+
+			addr_t const page_end = page + PAGE_SIZE;
+
+			Extent *right = (page_end == e.end()) ? _lookup(page_end) : nullptr;
+			if (right && !(right->writeable && &right->backing == &backing
+			            && backing_offset + PAGE_SIZE == right->backing_offset))
+				right = nullptr;
+
+			addr_t const private_offset = left  ? left->offset         : page;
+			addr_t const private_end    = right ? right->end()         : page_end;
+			addr_t const private_boff   = left  ? left->backing_offset : backing_offset;
+
+			Extent *new_extents[MAX_REPLACED] { };
+			unsigned n = 0;
+			try {
+				new_extents[n++] = new (_alloc)
+					Extent(private_offset, private_end - private_offset,
+					       backing, private_boff, true);
+
+				/* read-only remainders of the split extent */
+				if (page > e.offset)
+					new_extents[n++] = new (_alloc)
+						Extent(e.offset, page - e.offset, e.backing,
+						       e.backing_offset, false);
+
+				if (page_end < e.end())
+					new_extents[n++] = new (_alloc)
+						Extent(page_end, e.end() - page_end, e.backing,
+						       e.backing_offset + page_end - e.offset, false);
+			} catch (...) {
+				while (n--)
+					destroy(_alloc, new_extents[n]);
+				throw;
+			}
+
+			Extent * const old_extents[MAX_REPLACED] {
+				&e, left ? left : right, left ? right : nullptr };
+
+			Extent &result = *new_extents[0];
+			_replace(old_extents, new_extents);
+			return result;
+		}
+
+		/**
+		 * Make page at 'offset' private to the dataspace and writeable
+		 *
+		 * If the page cannot be made private, the extents of the dataspace
+		 * stay unchanged and the exception is propagated.
+		 *
+		 * \return extent that covers the page
+		 */
+		Extent &_make_private(addr_t offset)
+		{
+			Extent &e = *_lookup(offset);
+
+			if (e.writeable)
+				return e;
+
+			/* the backing store is not shared anymore, take it over */
+			if (e.backing.exclusive()) {
+				_reattach(e, true);
+				return e;
+			}
+
+			addr_t const page = offset & ~((addr_t)PAGE_SIZE - 1);
+
+			addr_t page_backing_offset = 0;
+			Cow_backing &page_backing = _alloc_page(page_backing_offset);
+
+			try {
+				{
+					Attached_page dst(_env.local_rm, page_backing.ds(), page_backing_offset);
+					Attached_page src(_env.local_rm, e.backing.ds(),
+					                  e.backing_offset + page - e.offset);
+					memcpy(dst.ptr, src.ptr, PAGE_SIZE);
+				}
+				return _replace_page(e, page, page_backing, page_backing_offset);
+			} catch (...) {
+				_free_page(page_backing, page_backing_offset);
+				throw;
+			}
+		}
+
+		void _handle_fault(unsigned)
+		{
+			Lock::Guard guard(_lock);
+
+			/* dataspace got freed meanwhile */
+			if (!_extents.first())
+				return;
+
+			for (;;) {
+				Region_map::State const state = _rm.state();
+
+				if (state.type == Region_map::State::READY)
+					return;
+
+				Extent const *e = _lookup(state.addr);
+				if (!e || e->writeable || state.type != Region_map::State::WRITE_FAULT) {
+					error("unresolvable fault in copy-on-write dataspace at offset ",
+					      Hex(state.addr));
+					Signal_transmitter(_env.unresolvable_fault).submit();
+					return;
+				}
+
+				try { _make_private(state.addr); }
+				catch (...) {
+					error("copy-on-write of page at offset ", Hex(state.addr),
+					      " failed");
+					Signal_transmitter(_env.unresolvable_fault).submit();
+					return;
+				}
+			}
+		}
+
+		void _release_all()
+		{
+			while (Extent *e = _extents.first()) {
+				_extents.remove(e);
+				destroy(_alloc, e);
+			}
+
+			while (Backing_ref *r = _backings.first()) {
+				_backings.remove(r);
+				_env.uncharge(r->charged);
+
+				if (r->backing.release())
+					destroy(_alloc, &r->backing);
+
+				destroy(_alloc, r);
+			}
+
+			_spare = nullptr;
+		}
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param ram     RAM session used for allocating backing stores
+		 * \param rm      region map that represents the dataspace
+		 * \param origin  dataspace to share the content with, or nullptr
+		 *                for a new dataspace, must be locked by the caller
+		 */
+		Cow_dataspace_info(Cow_env &env, Allocator &alloc, Ram_session &ram,
+		                   Capability<Region_map> rm, Cache_attribute cached,
+		                   Cow_dataspace_info *origin)
+		:
+			Ram_dataspace_info(static_cap_cast<Ram_dataspace>(Region_map_client(rm).dataspace())),
+			_env(env), _alloc(alloc), _ram(ram), _cached(cached), _rm_cap(rm)
+		{
+			_rm.fault_handler(_fault_dispatcher);
+
+			try {
+				if (origin) {
+					origin->_extents.for_each([&] (Extent const &e) {
+						_add(e.offset, e.size, e.backing, e.backing_offset, false); });
+				} else {
+					_add(0, size(), *new (_alloc) Cow_backing(_ram, size(), _cached),
+					     0, true);
+				}
+			} catch (...) {
+				_release_all();
+				throw;
+			}
+		}
+
+		void free(Ram_session &) override
+		{
+			Lock::Guard guard(_lock);
+
+			/* destroying the region map revokes all mappings of the backing stores */
+			_env.rm.destroy(_rm_cap);
+
+			_release_all();
+		}
+
+		void protect_shared() override
+		{
+			Lock::Guard guard(_lock);
+
+			_extents.for_each([&] (Extent const &e) {
+				if (e.writeable && !e.backing.exclusive())
+					_reattach(const_cast<Extent &>(e), false); });
+		}
+
+		inline Dataspace_capability fork(Ram_session_component &ram,
+		                                 Region_map            &local_rm,
+		                                 Allocator             &alloc,
+		                                 Dataspace_registry    &ds_registry,
+		                                 Rpc_entrypoint        &ep,
+		                                 bool                   vfork) override;
+
+		void poke(Region_map &, addr_t dst_offset, char const *src, size_t len) override
+		{
+			if (!src) return;
+
+			if ((dst_offset >= size()) || (dst_offset + len > size())) {
+				error("illegal attemt to write beyond dataspace boundary");
+				return;
+			}
+
+			Lock::Guard guard(_lock);
+
+			try {
+				while (len) {
+					Extent &e = _make_private(dst_offset);
+
+					addr_t const page = dst_offset & ~((addr_t)PAGE_SIZE - 1);
+					size_t const n    = min(len, (size_t)(page + PAGE_SIZE - dst_offset));
+
+					Attached_page dst(_env.local_rm, e.backing.ds(),
+					                  e.backing_offset + page - e.offset);
+					memcpy(dst.ptr + dst_offset - page, src, n);
+
+					src += n; dst_offset += n; len -= n;
+				}
+			} catch (...) { warning("poke: failed to write to copy-on-write dataspace"); }
+		}
+};
+
+
 class Noux::Ram_session_component : public Rpc_object<Ram_session>
 {
 	private:
@@ -99,6 +802,7 @@ class Noux::Ram_session_component : public Rpc_object<Ram_session>
 
 		Rpc_entrypoint &_ep;
 
+		Lock                     _lock;
 		List<Ram_dataspace_info> _list;
 
 		/*
@@ -110,16 +814,49 @@ class Noux::Ram_session_component : public Rpc_object<Ram_session>
 
 		Dataspace_registry &_registry;
 
+		/* facilities for copy-on-write dataspaces, or nullptr */
+		Cow_env * const _cow;
+
+		void _insert(Ram_dataspace_info &ds_info)
+		{
+			Lock::Guard guard(_lock);
+
+			_used_quota += ds_info.size();
+
+			_registry.insert(&ds_info);
+			_list.insert(&ds_info);
+		}
+
+		Cow_dataspace_info *_alloc_cow(size_t size, Cache_attribute cached,
+		                               Cow_dataspace_info *origin)
+		{
+			Capability<Region_map> rm = _cow->create_region_map(
+				align_addr(size, Cow_dataspace_info::PAGE_SIZE_LOG2));
+
+			try {
+				return new (_alloc)
+					Cow_dataspace_info(*_cow, _alloc, _ram, rm, cached, origin);
+			} catch (...) {
+				_cow->rm.destroy(rm);
+				throw;
+			}
+		}
+
 	public:
 
 		/**
 		 * Constructor
+		 *
+		 * \param cow  facilities for providing dataspaces with
+		 *             copy-on-write semantics, or nullptr for
+		 *             plain RAM dataspaces
 		 */
 		Ram_session_component(Ram_session &ram, Allocator &alloc,
-		                      Rpc_entrypoint &ep, Dataspace_registry &registry)
+		                      Rpc_entrypoint &ep, Dataspace_registry &registry,
+		                      Cow_env *cow = nullptr)
 		:
 			_ram(ram), _alloc(alloc), _ep(ep), _used_quota(0),
-			_registry(registry)
+			_registry(registry), _cow(cow)
 		{
 			_ep.manage(this);
 		}
@@ -135,6 +872,38 @@ class Noux::Ram_session_component : public Rpc_object<Ram_session>
 				free(static_cap_cast<Ram_dataspace>(info->ds_cap()));
 		}
 
+		/**
+		 * Create dataspace that shares the content of 'origin'
+		 *
+		 * \param origin  copy-on-write dataspace locked by the caller
+		 */
+		Dataspace_capability fork_cow(Cow_dataspace_info &origin,
+		                              Cache_attribute cached)
+		{
+			if (!_cow) {
+				error("fork of copy-on-write dataspace into plain RAM session");
+				return Dataspace_capability();
+			}
+
+			Cow_dataspace_info *ds_info = _alloc_cow(origin.size(), cached, &origin);
+			_insert(*ds_info);
+			return ds_info->ds_cap();
+		}
+
+		/**
+		 * Write-protect memory shared with other processes
+		 *
+		 * Called after a process created via vfork executed another binary
+		 * or exited.
+		 */
+		void protect_shared()
+		{
+			Lock::Guard guard(_lock);
+
+			for (Ram_dataspace_info *info = _list.first(); info; info = info->next())
+				info->protect_shared();
+		}
+
 
 		/***************************
 		 ** Ram_session interface **
@@ -142,17 +911,13 @@ class Noux::Ram_session_component : public Rpc_object<Ram_session>
 
 		Ram_dataspace_capability alloc(size_t size, Cache_attribute cached)
 		{
-			Ram_dataspace_capability ds_cap =
-				_ram.alloc(size, cached);
-
-			Ram_dataspace_info *ds_info = new (_alloc) Ram_dataspace_info(ds_cap);
+			Ram_dataspace_info *ds_info = _cow
+				? _alloc_cow(size, cached, nullptr)
+				: new (_alloc) Ram_dataspace_info(_ram.alloc(size, cached));
 
-			_used_quota += ds_info->size();
+			_insert(*ds_info);
 
-			_registry.insert(ds_info);
-			_list.insert(ds_info);
-
-			return ds_cap;
+			return static_cap_cast<Ram_dataspace>(ds_info->ds_cap());
 		}
 
 		void free(Ram_dataspace_capability ds_cap)
@@ -171,10 +936,13 @@ class Noux::Ram_session_component : public Rpc_object<Ram_session>
 
 				ds_info->dissolve_users();
 
-				_list.remove(ds_info);
-				_used_quota -= ds_info->size();
+				{
+					Lock::Guard guard(_lock);
+					_list.remove(ds_info);
+					_used_quota -= ds_info->size();
+				}
 
-				_ram.free(ds_cap);
+				ds_info->free(_ram);
 			};
 			_registry.apply(ds_cap, lambda);
 			destroy(_alloc, ds_info);
@@ -183,7 +951,76 @@ class Noux::Ram_session_component : public Rpc_object<Ram_session>
 		int ref_account(Ram_session_capability) { return 0; }
 		int transfer_quota(Ram_session_capability, size_t) { return 0; }
 		size_t quota() { return _ram.quota(); }
-		size_t used() { return _used_quota; }
+		size_t used()
+		{
+			Lock::Guard guard(_lock);
+
+			/* private copies and metadata of copy-on-write dataspaces */
+			return _used_quota + (_cow ? _cow->used() : 0);
+		}
 };
 
+
+Noux::Dataspace_capability
+Noux::Ram_dataspace_info::fork(Ram_session_component &ram,
+                               Region_map            &local_rm,
+                               Allocator             &,
+                               Dataspace_registry    &,
+                               Rpc_entrypoint        &,
+                               bool)
+{
+	size_t const size = Dataspace_client(ds_cap()).size();
+	Ram_dataspace_capability dst_ds_cap;
+
+	try {
+		/* the allocation registers the new dataspace at the RAM session */
+		dst_ds_cap = ram.alloc(size, CACHED);
+
+		Attached_dataspace src_ds(local_rm, ds_cap());
+		Attached_dataspace dst_ds(local_rm, dst_ds_cap);
+		memcpy(dst_ds.local_addr<char>(), src_ds.local_addr<char>(), size);
+
+		return dst_ds_cap;
+
+	} catch (...) {
+		error("fork of RAM dataspace failed");
+
+		if (dst_ds_cap.valid())
+			ram.free(dst_ds_cap);
+
+		return Dataspace_capability();
+	}
+}
+
+
+Noux::Dataspace_capability
+Noux::Cow_dataspace_info::fork(Ram_session_component &ram,
+                               Region_map            &,
+                               Allocator             &,
+                               Dataspace_registry    &,
+                               Rpc_entrypoint        &,
+                               bool                   vfork)
+{
+	Lock::Guard guard(_lock);
+
+	/*
+	 * A process that forked via vfork is suspended until the new process
+	 * executes another binary or exits. So its memory stays writeable
+	 * meanwhile and is protected afterwards only if still shared
+	 * ('protect_shared').
+	 */
+	try {
+		if (!vfork)
+			_extents.for_each([&] (Extent const &e) {
+				if (e.writeable)
+					_reattach(const_cast<Extent &>(e), false); });
+
+		return ram.fork_cow(*this, _cached);
+	}
+	catch (...) {
+		error("fork of copy-on-write dataspace failed");
+		return Dataspace_capability();
+	}
+}
+
 #endif /* _NOUX__RAM_SESSION_COMPONENT_H_ */
@@ -158,13 +158,17 @@ class Noux::Region_map_component : public Rpc_object<Region_map>,
 		 *                     of newly created dataspaces
 		 * \param ep           entrypoint used to serve the RPC interface
 		 *                     of forked managed dataspaces
+		 * \param vfork        true if the forking process is suspended
+		 *                     until the new process executes another
+		 *                     binary or exits
 		 */
-		void replay(Ram_session        &dst_ram,
-		            Region_map         &dst_rm,
-		            Region_map         &local_rm,
-		            Allocator          &alloc,
-		            Dataspace_registry &ds_registry,
-		            Rpc_entrypoint     &ep)
+		void replay(Ram_session_component &dst_ram,
+		            Region_map            &dst_rm,
+		            Region_map            &local_rm,
+		            Allocator             &alloc,
+		            Dataspace_registry    &ds_registry,
+		            Rpc_entrypoint        &ep,
+		            bool                   vfork)
 		{
 			Lock::Guard guard(_region_lock);
 			for (Region *curr = _regions.first(); curr; curr = curr->next_region()) {
@@ -174,7 +178,7 @@ class Noux::Region_map_component : public Rpc_object<Region_map>,
 					Dataspace_capability ds;
 					if (info) {
 
-						ds = info->fork(dst_ram, local_rm, alloc, ds_registry, ep);
+						ds = info->fork(dst_ram, local_rm, alloc, ds_registry, ep, vfork);
 
 						/*
 						 * XXX We could detect dataspaces that are attached
@@ -229,7 +233,8 @@ class Noux::Region_map_component : public Rpc_object<Region_map>,
 		                  size_t size = 0, off_t offset = 0,
 		                  bool use_local_addr = false,
 		                  Local_addr local_addr = (addr_t)0,
-		                  bool executable = false) override
+		                  bool executable = false,
+		                  bool writeable = true) override
 		{
 			/*
 			 * Region map subtracts offset from size if size is 0
@@ -239,7 +244,7 @@ class Noux::Region_map_component : public Rpc_object<Region_map>,
 			for (;;) {
 				try {
 					local_addr = _rm.attach(ds, size, offset, use_local_addr,
-					                        local_addr, executable);
+					                        local_addr, executable, writeable);
 					break;
 				} catch (Region_map::Out_of_metadata) {
 					_pd.upgrade_ram(8*1024);
@@ -298,6 +303,11 @@ class Noux::Region_map_component : public Rpc_object<Region_map>,
 			_rm.detach(local_addr);
 		}
 
+		void populate(Local_addr local_addr, size_t size) override
+		{
+			_rm.populate(local_addr, size);
+		}
+
 		void fault_handler(Signal_context_capability handler) override
 		{
 			return _rm.fault_handler(handler);
@@ -325,11 +335,12 @@ class Noux::Region_map_component : public Rpc_object<Region_map>,
 		 ** Dataspace_info interface **
 		 ******************************/
 
-		Dataspace_capability fork(Ram_session        &,
-		                          Region_map         &,
-		                          Allocator          &,
-		                          Dataspace_registry &,
-		                          Rpc_entrypoint     &) override
+		Dataspace_capability fork(Ram_session_component &,
+		                          Region_map            &,
+		                          Allocator             &,
+		                          Dataspace_registry    &,
+		                          Rpc_entrypoint        &,
+		                          bool) override
 		{
 			return Dataspace_capability();
 		}
@@ -31,11 +31,12 @@ struct Noux::Rom_dataspace_info : Dataspace_info
 
 	~Rom_dataspace_info() { }
 
-	Dataspace_capability fork(Ram_session        &,
-	                          Region_map         &,
-	                          Allocator          &alloc,
-	                          Dataspace_registry &ds_registry,
-	                          Rpc_entrypoint     &) override
+	Dataspace_capability fork(Ram_session_component &,
+	                          Region_map            &,
+	                          Allocator             &alloc,
+	                          Dataspace_registry    &ds_registry,
+	                          Rpc_entrypoint        &,
+	                          bool) override
 	{
 		ds_registry.insert(new (alloc) Rom_dataspace_info(ds_cap()));
 		return ds_cap();
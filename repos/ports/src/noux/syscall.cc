@@ -474,6 +474,7 @@ bool Noux::Child::syscall(Noux::Session::Syscall sc)
 				Genode::addr_t ip              = _sysio.fork_in.ip;
 				Genode::addr_t sp              = _sysio.fork_in.sp;
 				Genode::addr_t parent_cap_addr = _sysio.fork_in.parent_cap_addr;
+				bool     const vfork           = _sysio.fork_in.vfork;
 
 				int const new_pid = _pid_allocator.alloc();
 				Child * child = nullptr;
@@ -514,7 +515,10 @@ bool Noux::Child::syscall(Noux::Session::Syscall sc)
 				/* copy our address space into the new child */
 				try {
 					_pd.replay(child->ram(), child->pd(), _env.rm(), _heap,
-					           child->ds_registry(), _ep);
+					           child->ds_registry(), _ep, vfork);
+
+					if (vfork)
+						child->suspend_parent(*this);
 
 					/* start executing the main thread of the new process */
 					child->start_forked_main_thread(ip, sp, parent_cap_addr);
@@ -524,6 +528,17 @@ bool Noux::Child::syscall(Noux::Session::Syscall sc)
 
 					_sysio.fork_out.pid = new_pid;
 
+					/*
+					 * Our memory was not write-protected for the child,
+					 * which usually executes another binary right away.
+					 * Protect what is still shared afterwards, e.g., with
+					 * a process forked by the child.
+					 */
+					if (vfork) {
+						wait_for_vfork_child();
+						_ram.protect_shared();
+					}
+
 					result = true;
 				}
 				catch (Region_map::Region_conflict) {
@@ -11,10 +11,26 @@
 
 enum { MAX_COUNT = 1000 };
 
+/* written by parent and child after fork, each must see its own value */
+static int volatile value = 0;
+
 int main(int, char **)
 {
 	printf("--- test-noux_fork started ---\n");
 
+	/* the caller of vfork resumes after the new process exited */
+	pid_t vfork_ret = vfork();
+	if (vfork_ret == 0)
+		_exit(0);
+
+	if (vfork_ret < 0) {
+		printf("Error: vfork returned %d, errno=%d\n", vfork_ret, errno);
+		return -1;
+	}
+
+	waitpid(vfork_ret, nullptr, 0);
+	printf("pid %d: vfork returned %d\n", getpid(), vfork_ret);
+
 	pid_t fork_ret = fork();
 	if (fork_ret < 0) {
 		printf("Error: fork returned %d, errno=%d\n", fork_ret, errno);
@@ -27,6 +43,8 @@ int main(int, char **)
 	if (fork_ret == 0) {
 		printf("pid %d: child says hello\n", getpid());
 
+		value = 2;
+
 		pid_t fork_ret = fork();
 		if (fork_ret < 0) {
 			printf("Error: fork returned %d, errno=%d\n", fork_ret, errno);
@@ -55,12 +73,19 @@ int main(int, char **)
 			waitpid(fork_ret, nullptr, 0);
 		}
 
+		if (value != 2) {
+			printf("Error: child sees value %d\n", value);
+			return -1;
+		}
+
 		return 0;
 	}
 
 	printf("pid %d: parent received child pid %d, starts counting...\n",
 	       getpid(), fork_ret);
 
+	value = 1;
+
 	for (int i = 0; i < MAX_COUNT; ) {
 		printf("pid %d: parent      i = %d\n", getpid(), i++);
 	}
@@ -68,6 +93,11 @@ int main(int, char **)
 	printf("pid %d: parent waits for child exit\n", getpid());
 	waitpid(fork_ret, nullptr, 0);
 
+	if (value != 1) {
+		printf("Error: parent sees value %d\n", value);
+		return -1;
+	}
+
 	printf("--- parent done ---\n");
 	return 0;
 }
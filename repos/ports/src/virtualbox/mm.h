@@ -47,14 +47,16 @@ class Sub_rm_connection : private Genode::Rm_connection,
 		                  Genode::size_t size = 0, Genode::off_t offset = 0,
 		                  bool use_local_addr = false,
 		                  Local_addr local_addr = (void *)0,
-		                  bool executable = false) override
+		                  bool executable = false,
+		                  bool writeable = true) override
 		{
 			Local_addr addr = Genode::retry<Rm_session::Out_of_metadata>(
 				[&] () {
 					return Region_map_client::attach(ds, size, offset,
 					                                 use_local_addr,
 					                                 local_addr,
-					                                 executable); },
+					                                 executable,
+					                                 writeable); },
 				[&] () { upgrade_ram(8192); });
 
 			Genode::addr_t new_addr = addr;